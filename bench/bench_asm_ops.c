@@ -0,0 +1,459 @@
+// bench/bench_asm_ops.c
+// asm_optimized 原语与 libc 对应实现的微基准
+//
+// 每个测量点：绑定 CPU、预热、自动校准每批次迭代数，采集多批样本，
+// 报告每次操作耗时的中位数与 p99（ns/op）以及按中位数计算的吞吐（GB/s）。
+// 结果以 JSON 写出，便于在内核实现改动时比较回归。
+//
+// 用法: bench_asm_ops [-o results.json] [-c cpu] [-f op] [-q]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/sysinfo.h>
+#include "../include/common_defs.h"
+#include "../include/asm_optimized/cpu_features.h"
+#include "../include/asm_optimized/crc32c.h"
+#include "../include/asm_optimized/simd_string.h"
+#include "../include/asm_optimized/fast_hash.h"
+
+#ifdef HAVE_NASM
+// src/system/syscalls.asm（寄存器传参，可直接从 C 调用）
+// asm_optimized/*.asm 中其余函数从栈上读取参数，与 SysV 调用约定不兼容，不参与测试
+extern long fast_file_check(const char *path);
+extern long get_system_info(int type, struct sysinfo *info);
+#endif
+
+#define MAX_SAMPLES 101
+#define MIN_SAMPLES 11
+#define TARGET_BATCH_NS 50000.0
+#define POINT_BUDGET_NS 20000000.0
+#define BUFFER_PAD 256
+#define MAX_CASES 48
+
+typedef enum {
+    OP_STRLEN,
+    OP_MEMCMP,
+    OP_MEMSET,
+    OP_CRC32C,
+    OP_HASH64,
+    OP_FILE_CHECK,
+    OP_SYSINFO
+} BenchOp;
+
+typedef struct {
+    BenchOp op;
+    const char *op_name;
+    const char *impl;
+    int sized;                  // 0 表示与数据量无关（系统调用类）
+    size_t (*strlen_fn)(const char *str);
+    int (*memcmp_fn)(const void *s1, const void *s2, size_t n);
+    void *(*memset_fn)(void *ptr, int value, size_t n);
+    uint32_t (*crc_fn)(uint32_t crc, const void *data, size_t len);
+    uint64_t (*hash_fn)(const void *key, size_t len, uint64_t seed);
+    long (*file_check_fn)(const char *path);
+    long (*sysinfo_fn)(struct sysinfo *info);
+} BenchCase;
+
+typedef struct {
+    double median_ns;
+    double p99_ns;
+    double gbps;
+    int samples;
+    size_t iters;
+} BenchResult;
+
+static unsigned char *buf_a;
+static unsigned char *buf_b;
+static volatile uint64_t bench_sink;
+
+static const size_t bench_sizes[] = {
+    8, 32, 128, 512, 2048, 8192, 32768, 131072, 524288,
+    2097152, 8388608, 33554432, 67108864
+};
+static const size_t quick_sizes[] = {8, 512, 32768, 2097152};
+static const size_t bench_aligns[] = {0, 1, 31};
+
+// 阻止编译器把纯函数调用提出循环或消除写入
+#define CLOBBER(p) __asm__ volatile("" : : "r"(p) : "memory")
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static long libc_file_check(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    close(fd);
+    return 0;
+}
+
+static long libc_sysinfo(struct sysinfo *info) {
+    return sysinfo(info);
+}
+
+// fast_hash64 是内联函数，取地址需要一层包装
+static uint64_t dispatch_hash64(const void *key, size_t len, uint64_t seed) {
+    return fast_hash64(key, len, seed);
+}
+
+#ifdef HAVE_NASM
+static long asm_file_check(const char *path) {
+    return fast_file_check(path);
+}
+
+static long asm_sysinfo(struct sysinfo *info) {
+    return get_system_info(0, info);
+}
+#endif
+
+// 执行一批 iters 次操作，返回耗时（ns）
+static double run_batch(const BenchCase *bc, unsigned char *a, unsigned char *b,
+                        size_t size, size_t iters) {
+    uint64_t acc = 0;
+    struct sysinfo si;
+    double start = now_ns();
+
+    switch (bc->op) {
+    case OP_STRLEN:
+        for (size_t i = 0; i < iters; i++) {
+            CLOBBER(a);
+            acc += bc->strlen_fn((const char *)a);
+        }
+        break;
+    case OP_MEMCMP:
+        for (size_t i = 0; i < iters; i++) {
+            CLOBBER(a);
+            acc += (uint64_t)bc->memcmp_fn(a, b, size);
+        }
+        break;
+    case OP_MEMSET:
+        for (size_t i = 0; i < iters; i++) {
+            bc->memset_fn(a, (int)(i & 0x7f), size);
+            CLOBBER(a);
+        }
+        break;
+    case OP_CRC32C:
+        for (size_t i = 0; i < iters; i++) {
+            CLOBBER(a);
+            acc += bc->crc_fn(0, a, size);
+        }
+        break;
+    case OP_HASH64:
+        for (size_t i = 0; i < iters; i++) {
+            CLOBBER(a);
+            acc += bc->hash_fn(a, size, 0);
+        }
+        break;
+    case OP_FILE_CHECK:
+        for (size_t i = 0; i < iters; i++) {
+            acc += (uint64_t)bc->file_check_fn("/proc/self/stat");
+        }
+        break;
+    case OP_SYSINFO:
+        for (size_t i = 0; i < iters; i++) {
+            acc += (uint64_t)bc->sysinfo_fn(&si);
+        }
+        break;
+    }
+
+    double elapsed = now_ns() - start;
+    bench_sink += acc;
+    return elapsed;
+}
+
+// 准备输入：strlen 需要 size 字节非零后跟终止符，memcmp 需要两份相同数据（最坏情况全扫描）
+static void prepare_buffers(const BenchCase *bc, unsigned char *a, unsigned char *b, size_t size) {
+    switch (bc->op) {
+    case OP_STRLEN:
+        memset(a, 'x', size);
+        a[size] = '\0';
+        break;
+    case OP_MEMCMP:
+    case OP_CRC32C:
+    case OP_HASH64:
+        for (size_t i = 0; i < size; i++) {
+            a[i] = (unsigned char)(i * 131 + 7);
+        }
+        memcpy(b, a, size);
+        break;
+    default:
+        break;
+    }
+}
+
+static int compare_double(const void *x, const void *y) {
+    double a = *(const double *)x;
+    double b = *(const double *)y;
+    return (a > b) - (a < b);
+}
+
+static BenchResult measure(const BenchCase *bc, size_t size, size_t align) {
+    BenchResult result = {0};
+    double samples[MAX_SAMPLES];
+    unsigned char *a = buf_a + align;
+    unsigned char *b = buf_b + (align * 3) % 64;
+
+    prepare_buffers(bc, a, b, size);
+
+    // 预热并校准：使每批耗时接近 TARGET_BATCH_NS
+    size_t iters = 1;
+    double batch = run_batch(bc, a, b, size, iters);
+    while (batch < TARGET_BATCH_NS && iters < ((size_t)1 << 30)) {
+        iters *= 2;
+        batch = run_batch(bc, a, b, size, iters);
+    }
+    run_batch(bc, a, b, size, iters);
+
+    int count = (int)(POINT_BUDGET_NS / batch);
+    if (count < MIN_SAMPLES) count = MIN_SAMPLES;
+    if (count > MAX_SAMPLES) count = MAX_SAMPLES;
+
+    for (int i = 0; i < count; i++) {
+        samples[i] = run_batch(bc, a, b, size, iters) / (double)iters;
+    }
+    qsort(samples, count, sizeof(double), compare_double);
+
+    int p99_index = (count * 99 + 99) / 100 - 1;
+    if (p99_index >= count) p99_index = count - 1;
+
+    result.median_ns = samples[count / 2];
+    result.p99_ns = samples[p99_index];
+    result.gbps = (bc->sized && result.median_ns > 0) ? (double)size / result.median_ns : 0.0;
+    result.samples = count;
+    result.iters = iters;
+    return result;
+}
+
+static int build_cases(BenchCase *cases, int max_cases) {
+    const StringOpsImpl *impls;
+    int impl_count = string_ops_get_impls(&impls);
+    const CpuFeatures *cpu = cpu_features_get();
+    int n = 0;
+
+#define ADD_CASE(...) do { if (n < max_cases) cases[n++] = (BenchCase){__VA_ARGS__}; } while (0)
+
+    // "dispatch" 测量调用方实际使用的 fast_* 入口（含分派开销），其余测量实现表中的各个版本
+    ADD_CASE(.op = OP_STRLEN, .op_name = "strlen", .impl = "libc", .sized = 1, .strlen_fn = strlen);
+    ADD_CASE(.op = OP_STRLEN, .op_name = "strlen", .impl = "dispatch", .sized = 1, .strlen_fn = fast_strlen);
+    for (int i = 0; i < impl_count; i++) {
+        if (impls[i].available) {
+            ADD_CASE(.op = OP_STRLEN, .op_name = "strlen", .impl = impls[i].name, .sized = 1,
+                     .strlen_fn = impls[i].strlen_fn);
+        }
+    }
+
+    ADD_CASE(.op = OP_MEMCMP, .op_name = "memcmp", .impl = "libc", .sized = 1, .memcmp_fn = memcmp);
+    ADD_CASE(.op = OP_MEMCMP, .op_name = "memcmp", .impl = "dispatch", .sized = 1, .memcmp_fn = fast_memcmp);
+
+    ADD_CASE(.op = OP_MEMSET, .op_name = "memset", .impl = "libc", .sized = 1, .memset_fn = memset);
+    ADD_CASE(.op = OP_MEMSET, .op_name = "memset", .impl = "dispatch", .sized = 1, .memset_fn = fast_memset);
+
+    // libc 没有 CRC32C，以查表实现作为基线
+    ADD_CASE(.op = OP_CRC32C, .op_name = "crc32c", .impl = "slice-by-8", .sized = 1, .crc_fn = crc32c_sw);
+    ADD_CASE(.op = OP_CRC32C, .op_name = "crc32c", .impl = "dispatch", .sized = 1, .crc_fn = crc32c);
+    if (cpu->sse42) {
+        ADD_CASE(.op = OP_CRC32C, .op_name = "crc32c", .impl = "sse4.2", .sized = 1, .crc_fn = crc32c_sse42);
+    }
+    if (cpu->sse42 && cpu->pclmul) {
+        ADD_CASE(.op = OP_CRC32C, .op_name = "crc32c", .impl = "pclmul", .sized = 1, .crc_fn = crc32c_pclmul);
+    }
+
+    // libc 没有对应的哈希，各实现之间相互比较
+    const FastHashImpl *hash_impls;
+    int hash_count = fast_hash_get_impls(&hash_impls);
+    ADD_CASE(.op = OP_HASH64, .op_name = "hash64", .impl = "dispatch", .sized = 1, .hash_fn = dispatch_hash64);
+    for (int i = 0; i < hash_count; i++) {
+        if (hash_impls[i].available) {
+            ADD_CASE(.op = OP_HASH64, .op_name = "hash64", .impl = hash_impls[i].name, .sized = 1,
+                     .hash_fn = hash_impls[i].hash_fn);
+        }
+    }
+
+    ADD_CASE(.op = OP_FILE_CHECK, .op_name = "file_check", .impl = "libc", .file_check_fn = libc_file_check);
+    ADD_CASE(.op = OP_SYSINFO, .op_name = "sysinfo", .impl = "libc", .sysinfo_fn = libc_sysinfo);
+#ifdef HAVE_NASM
+    ADD_CASE(.op = OP_FILE_CHECK, .op_name = "file_check", .impl = "asm", .file_check_fn = asm_file_check);
+    ADD_CASE(.op = OP_SYSINFO, .op_name = "sysinfo", .impl = "asm", .sysinfo_fn = asm_sysinfo);
+#endif
+
+#undef ADD_CASE
+    return n;
+}
+
+static int pin_cpu(int cpu) {
+    if (cpu < 0) {
+        cpu = sched_getcpu();
+        if (cpu < 0) {
+            cpu = 0;
+        }
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+        return -1;
+    }
+    return cpu;
+}
+
+static void read_cpu_model(char *model, size_t size) {
+    FILE *fp = fopen("/proc/cpuinfo", "r");
+    char line[256];
+
+    snprintf(model, size, "unknown");
+    if (!fp) {
+        return;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, "model name", 10) == 0) {
+            char *value = strchr(line, ':');
+            if (value) {
+                value++;
+                while (*value == ' ') value++;
+                value[strcspn(value, "\n")] = '\0';
+                snprintf(model, size, "%s", value);
+            }
+            break;
+        }
+    }
+    fclose(fp);
+}
+
+// CPU 型号字符串中可能含有引号或反斜杠
+static void json_write_string(FILE *fp, const char *str) {
+    fputc('"', fp);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', fp);
+        }
+        fputc(*str, fp);
+    }
+    fputc('"', fp);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-o results.json] [-c cpu] [-f op] [-q]\n", prog);
+    fprintf(stderr, "  -o FILE  write results as JSON\n");
+    fprintf(stderr, "  -c CPU   pin to CPU (default: current CPU)\n");
+    fprintf(stderr, "  -f OP    only run OP (strlen, memcmp, memset, crc32c, hash64,\n"
+                    "           file_check, sysinfo)\n");
+    fprintf(stderr, "  -q       quick run with fewer sizes\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *json_path = NULL;
+    const char *filter = NULL;
+    int cpu = -1;
+    int quick = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:c:f:qh")) != -1) {
+        switch (opt) {
+        case 'o': json_path = optarg; break;
+        case 'c': cpu = atoi(optarg); break;
+        case 'f': filter = optarg; break;
+        case 'q': quick = 1; break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    cpu = pin_cpu(cpu);
+
+    const size_t *sizes = quick ? quick_sizes : bench_sizes;
+    int size_count = quick ? (int)(sizeof(quick_sizes) / sizeof(quick_sizes[0]))
+                           : (int)(sizeof(bench_sizes) / sizeof(bench_sizes[0]));
+    size_t max_size = sizes[size_count - 1];
+
+    buf_a = aligned_alloc(64, max_size + BUFFER_PAD);
+    buf_b = aligned_alloc(64, max_size + BUFFER_PAD);
+    if (!buf_a || !buf_b) {
+        fprintf(stderr, "Failed to allocate %zu byte buffers\n", max_size);
+        return 1;
+    }
+    memset(buf_a, 0, max_size + BUFFER_PAD);
+    memset(buf_b, 0, max_size + BUFFER_PAD);
+
+    BenchCase cases[MAX_CASES];
+    int case_count = build_cases(cases, MAX_CASES);
+
+    char model[128];
+    read_cpu_model(model, sizeof(model));
+
+    FILE *json = NULL;
+    if (json_path) {
+        json = fopen(json_path, "w");
+        if (!json) {
+            perror(json_path);
+            return 1;
+        }
+        fprintf(json, "{\n  \"cpu_model\": ");
+        json_write_string(json, model);
+        fprintf(json, ",\n  \"pinned_cpu\": %d,\n", cpu);
+        fprintf(json, "  \"string_ops_impl\": \"%s\",\n", string_ops_impl_name());
+        fprintf(json, "  \"crc32c_impl\": \"%s\",\n", crc32c_impl_name());
+        fprintf(json, "  \"hash64_impl\": \"%s\",\n", fast_hash_impl_name());
+        fprintf(json, "  \"timestamp\": %ld,\n", (long)time(NULL));
+        fprintf(json, "  \"results\": [");
+    }
+
+    printf("CPU: %s (pinned to %d)\n", model, cpu);
+    printf("Dispatch: string_ops=%s crc32c=%s hash64=%s\n\n",
+           string_ops_impl_name(), crc32c_impl_name(), fast_hash_impl_name());
+    printf("%-11s %-11s %10s %5s %12s %12s %9s\n",
+           "op", "impl", "size", "align", "median ns", "p99 ns", "GB/s");
+
+    int first = 1;
+    for (int c = 0; c < case_count; c++) {
+        const BenchCase *bc = &cases[c];
+        if (filter && strcmp(filter, bc->op_name) != 0) {
+            continue;
+        }
+
+        int point_sizes = bc->sized ? size_count : 1;
+        int point_aligns = bc->sized ? (int)(sizeof(bench_aligns) / sizeof(bench_aligns[0])) : 1;
+
+        for (int s = 0; s < point_sizes; s++) {
+            for (int al = 0; al < point_aligns; al++) {
+                size_t size = bc->sized ? sizes[s] : 0;
+                size_t align = bench_aligns[al];
+                BenchResult r = measure(bc, size, align);
+
+                printf("%-11s %-11s %10zu %5zu %12.2f %12.2f %9.2f\n",
+                       bc->op_name, bc->impl, size, align, r.median_ns, r.p99_ns, r.gbps);
+                fflush(stdout);
+
+                if (json) {
+                    fprintf(json, "%s\n    {\"op\": \"%s\", \"impl\": \"%s\", \"size\": %zu, "
+                            "\"align\": %zu, \"median_ns\": %.3f, \"p99_ns\": %.3f, "
+                            "\"gbps\": %.3f, \"samples\": %d, \"iters\": %zu}",
+                            first ? "" : ",", bc->op_name, bc->impl, size, align,
+                            r.median_ns, r.p99_ns, r.gbps, r.samples, r.iters);
+                    first = 0;
+                }
+            }
+        }
+    }
+
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+        printf("\nResults written to %s\n", json_path);
+    }
+
+    free(buf_a);
+    free(buf_b);
+    return 0;
+}
@@ -0,0 +1,22 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include "../common_defs.h"
+
+// CPU 指令集特性（启动时通过 cpuid 检测一次）
+typedef struct {
+    int detected;
+    int sse2;
+    int sse42;
+    int pclmul;
+    int avx2;
+    int avx512f;
+    int avx512bw;
+    int avx512vl;
+} CpuFeatures;
+
+// 获取 CPU 特性（首次调用时检测，之后返回缓存结果）
+// 设置环境变量 SWIKERNEL_NO_SIMD=1 可强制使用标量实现
+const CpuFeatures *cpu_features_get(void);
+
+#endif
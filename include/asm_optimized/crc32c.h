@@ -0,0 +1,19 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include "../common_defs.h"
+
+// CRC32C (Castagnoli, 多项式 0x1EDC6F41)
+// 日志帧、备份分块和日志记录统一使用的校验和。
+// 用法与 zlib 的 crc32() 相同：首次传入 0，之后传入上一次的结果即可分段计算。
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+
+// 返回运行时选中的实现名称（"pclmul"、"sse4.2" 或 "slice-by-8"）
+const char *crc32c_impl_name(void);
+
+// 各实现的直接入口（供测试和基准程序对比使用）
+uint32_t crc32c_sw(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_pclmul(uint32_t crc, const void *data, size_t len);
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef FAST_HASH_H
+#define FAST_HASH_H
+
+#include <string.h>
+#include "../common_defs.h"
+
+// 64 位非加密哈希，用于内存中的查找表（配置键、i18n 消息键、清单名称、
+// uid/gid 名称缓存等），不能用于校验或任何安全相关场景。
+//
+// 短键（<= 16 字节）走 wyhash 风格的内联路径，长度为常量时可在编译期
+// 展开；中等长度走三路 64 位乘法混合；长输入走 XXH3 风格的 8 路累加器，
+// 按 CPU 特性选择 scalar/sse2/avx2/avx512 实现，所有实现结果完全一致。
+
+#define FAST_HASH_P0 0xa0761d6478bd642fULL
+#define FAST_HASH_P1 0xe7037ed1a0b428dbULL
+#define FAST_HASH_P2 0x8ebc6af09c88c6e3ULL
+#define FAST_HASH_P3 0x589965cc75374cc3ULL
+
+// 超过该长度时调用 fast_hash64_long
+#define FAST_HASH_INLINE_MAX 16
+
+// 长输入实现（scalar、sse2、avx2、avx512）
+typedef struct {
+    const char *name;
+    int available;
+    uint64_t (*hash_fn)(const void *key, size_t len, uint64_t seed);
+} FastHashImpl;
+
+// 处理 len > FAST_HASH_INLINE_MAX 的输入
+uint64_t fast_hash64_long(const void *key, size_t len, uint64_t seed);
+
+// 当前选中的长输入实现名称
+const char *fast_hash_impl_name(void);
+
+// 获取全部实现（供测试和基准程序使用），返回数量
+int fast_hash_get_impls(const FastHashImpl **impls);
+
+static FORCE_INLINE uint64_t fast_hash_mix(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static FORCE_INLINE uint64_t fast_hash_read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// 短键与中等长度共用的收尾：把最后两个字与状态混合
+static FORCE_INLINE uint64_t fast_hash_finish(uint64_t a, uint64_t b, uint64_t seed, size_t len) {
+    __uint128_t r = (__uint128_t)(a ^ FAST_HASH_P1) * (b ^ seed);
+    return fast_hash_mix((uint64_t)r ^ FAST_HASH_P0 ^ len, (uint64_t)(r >> 64) ^ FAST_HASH_P1);
+}
+
+// 计算 64 位哈希
+static FORCE_INLINE uint64_t fast_hash64(const void *key, size_t len, uint64_t seed) {
+    const unsigned char *p = key;
+    uint64_t a, b;
+
+    if (len > FAST_HASH_INLINE_MAX) {
+        return fast_hash64_long(key, len, seed);
+    }
+
+    seed ^= fast_hash_mix(seed ^ FAST_HASH_P0, FAST_HASH_P1);
+    if (len >= 4) {
+        size_t mid = (len >> 3) << 2;
+        a = (fast_hash_read32(p) << 32) | fast_hash_read32(p + mid);
+        b = (fast_hash_read32(p + len - 4) << 32) | fast_hash_read32(p + len - 4 - mid);
+    } else if (len > 0) {
+        a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+        b = 0;
+    } else {
+        a = b = 0;
+    }
+
+    return fast_hash_finish(a, b, seed, len);
+}
+
+// 字符串键的便捷入口
+static FORCE_INLINE uint64_t fast_hash_str(const char *str) {
+    return fast_hash64(str, strlen(str), 0);
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SIMD_STRING_H
+#define SIMD_STRING_H
+
+#include "../common_defs.h"
+
+// 字符串操作的一组实现（scalar、sse2、avx2、avx512）
+typedef struct {
+    const char *name;
+    int available;
+    size_t (*strlen_fn)(const char *str);
+    size_t (*memchr_all_fn)(const void *data, size_t n, int c, uint64_t base,
+                            uint64_t *out, size_t max, size_t *scanned);
+} StringOpsImpl;
+
+// 运行时分派的入口，语义与 libc 对应函数一致
+// fast_strstr、fast_memcmp、fast_memset 直接使用 libc 实现（见 simd_string.c）
+size_t fast_strlen(const char *str);
+char *fast_strstr(const char *haystack, const char *needle);
+int fast_memcmp(const void *s1, const void *s2, size_t n);
+void *fast_memset(void *ptr, int value, size_t n);
+
+// 依次把 data[0, n) 中所有等于 c 的字节位置（加上 base）写入 out，最多 max 个，返回写出的个数。
+// *scanned 为已检查的字节数：out 写满时停在最后一个写出位置之后，调用方从那里继续
+size_t fast_memchr_all(const void *data, size_t n, int c, uint64_t base,
+                       uint64_t *out, size_t max, size_t *scanned);
+
+// 当前选中的实现名称
+const char *string_ops_impl_name(void);
+
+// 获取全部实现（供差分测试和基准程序使用），返回数量
+int string_ops_get_impls(const StringOpsImpl **impls);
+
+#endif
@@ -14,6 +14,7 @@ int copy_file(const char *src, const char *dst);
 int remove_directory(const char *path);
 int verify_file_integrity(const char *path, const char *expected_hash);
 int calculate_sha256(const unsigned char *data, size_t len, char *output);
+char* get_file_checksum(const char *path);
 
 // 进程管理
 int execute_command(const char *command);
@@ -0,0 +1,74 @@
+#ifndef CPU_SAMPLER_H
+#define CPU_SAMPLER_H
+
+#include "../common_defs.h"
+
+// CPU 使用率采样
+//
+// /proc/stat 中的计数是开机以来的累计值，直接相除得到的是开机以来的平均
+// 使用率。采样器保持 /proc/stat 打开，每次用 pread 从头读入复用的缓冲区，
+// 只手工解析开头的 "cpu" 与 "cpuN" 行，用相邻两次采样的差值计算总的与
+// 每个 CPU 的当前使用率。第一次采样没有上一次可比，结果为开机以来的平均值。
+//
+// guest/guest_nice 已经计入 user/nice，计算总时间时不再重复相加；
+// 差值为负（CPU 下线后重新上线时计数被重置）时按 0 处理。
+
+#define CPU_SAMPLER_PATH "/proc/stat"
+#define CPU_SAMPLER_BUFFER 16384     // 缓冲区初始大小，容不下全部 cpu 行时加倍
+
+// 一个 CPU 的累计时间（单位为 USER_HZ）
+typedef struct {
+    uint64_t user;
+    uint64_t nice;
+    uint64_t system;
+    uint64_t idle;
+    uint64_t iowait;
+    uint64_t irq;
+    uint64_t softirq;
+    uint64_t steal;
+    uint64_t guest;
+    uint64_t guest_nice;
+} CpuTimes;
+
+// 两次采样之间各类时间所占的百分比
+typedef struct {
+    double usage;            // 非空闲（不含 iowait）
+    double user;             // user + nice，不含 guest
+    double system;
+    double iowait;
+    double irq;              // irq + softirq
+    double steal;
+    double guest;            // guest + guest_nice
+    int online;              // 本次采样中是否出现
+} CpuUsage;
+
+typedef struct {
+    int fd;                  // 未打开时为 -1
+    char *buffer;
+    size_t capacity;
+
+    int cpu_count;           // 出现过的最大 CPU 编号 + 1
+    int cpu_capacity;
+    CpuTimes total_times;    // 上一次采样的 "cpu" 行
+    CpuTimes *cpu_times;     // 上一次采样的各 "cpuN" 行
+
+    CpuUsage total;          // 最近一次采样的结果
+    CpuUsage *cpus;
+    int online_count;        // 最近一次采样中在线的 CPU 数
+    uint64_t samples;
+} CpuSampler;
+
+// 打开 path（NULL 表示 /proc/stat）
+int cpu_sampler_open(CpuSampler *sampler, const char *path);
+void cpu_sampler_close(CpuSampler *sampler);
+
+// 重新读取并计算与上一次采样之间的使用率
+int cpu_sampler_sample(CpuSampler *sampler);
+
+// 第 cpu 个 CPU 的最近结果，编号越界时返回 NULL
+const CpuUsage *cpu_sampler_cpu(const CpuSampler *sampler, int cpu);
+
+// 由两次累计值计算使用率
+void cpu_sampler_usage(const CpuTimes *before, const CpuTimes *after, CpuUsage *usage);
+
+#endif
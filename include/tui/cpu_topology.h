@@ -0,0 +1,88 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include "../common_defs.h"
+#include "cpu_sampler.h"
+
+// CPU/NUMA 拓扑
+//
+// 启动时从 /sys/devices/system/cpu 与 /sys/devices/system/node 读取一次：
+// 每个逻辑 CPU 所在的插槽、物理核、SMT 序号与 NUMA 节点，以及缓存层次。
+// /proc/cpuinfo 中的 "cpu cores" 只是单个插槽的核数，"cpu MHz" 只是某一个核
+// 的瞬时频率，都不再使用。
+//
+// 之后每次检查只用 pread 读取 cpu/online（保持打开），内容变化（CPU 热插拔）
+// 时才重建。各 CPU 的当前频率来自 cpufreq/scaling_cur_freq，同样保持打开；
+// 没有 cpufreq（多见于虚拟机）时使用建立拓扑时从 /proc/cpuinfo 读到的频率。
+// 插槽与节点编号映射为从 0 开始的连续序号，面板按插槽或节点汇总使用率时
+// 只需一次遍历。
+
+#define CPU_TOPOLOGY_ROOT "/sys/devices/system"
+#define CPU_TOPOLOGY_MAX_GROUPS 64     // 插槽数与节点数的上限
+#define CPU_TOPOLOGY_MAX_CACHES 8
+#define CPU_TOPOLOGY_MASK_MAX 256      // cpu/online 内容的最大长度
+
+// 汇总方式
+#define CPU_TOPOLOGY_BY_PACKAGE 0
+#define CPU_TOPOLOGY_BY_NODE 1
+
+typedef struct {
+    int online;
+    int package;             // 插槽序号（连续编号）
+    int node;                // NUMA 节点序号（连续编号）
+    int core;                // 物理核序号（全局连续编号）
+    int thread;              // 在所在物理核中的 SMT 序号
+    int freq_fd;             // cpufreq/scaling_cur_freq，-1 表示不可用
+    double mhz;              // 最近读取的频率
+} CpuTopologyCpu;
+
+typedef struct {
+    int level;
+    char type[16];           // "Data"、"Instruction" 或 "Unified"
+    uint64_t size_kb;
+    int shared_cpus;         // 共享这一缓存的逻辑 CPU 数
+    int instances;           // 系统中这一缓存的个数
+} CpuTopologyCache;
+
+typedef struct {
+    char root[MAX_PATH_LENGTH];
+    int online_fd;           // cpu/online，-1 表示不可用（不再检查热插拔）
+    char online_mask[CPU_TOPOLOGY_MASK_MAX];
+
+    int cpu_count;           // 最大在线 CPU 编号 + 1
+    CpuTopologyCpu *cpus;
+    int online_count;
+    int package_count;
+    int core_count;          // 物理核总数
+    int node_count;
+    int threads_per_core;    // 最多的 SMT 线程数
+    int package_ids[CPU_TOPOLOGY_MAX_GROUPS];  // 序号对应的 physical_package_id
+    int node_ids[CPU_TOPOLOGY_MAX_GROUPS];     // 序号对应的节点编号
+
+    CpuTopologyCache caches[CPU_TOPOLOGY_MAX_CACHES];  // 第一个在线 CPU 的缓存
+    int cache_count;
+
+    double base_mhz;         // 没有 cpufreq 时使用的频率
+    int has_cpufreq;
+    uint64_t generation;     // 建立（含热插拔后重建）的次数
+} CpuTopology;
+
+// 读取 root（NULL 表示 /sys/devices/system）下的拓扑
+int cpu_topology_build(CpuTopology *topology, const char *root);
+void cpu_topology_free(CpuTopology *topology);
+
+// 在线 CPU 变化时重建，重建了返回 1，否则返回 0
+int cpu_topology_check(CpuTopology *topology);
+
+// 读取各在线 CPU 的当前频率，返回平均值 (MHz)
+double cpu_topology_update_frequency(CpuTopology *topology);
+
+// 按插槽或节点汇总 sampler 最近一次采样的使用率，写入 usage[组序号]，返回组数
+int cpu_topology_aggregate(const CpuTopology *topology, const CpuSampler *sampler, int by,
+                           double *usage, int max);
+
+// 解析 "0-3,8,10-11" 形式的 CPU 列表，对其中每个 < max 的编号置 set[cpu] = 1，
+// 返回列表中的 CPU 数（格式错误返回 -1）
+int cpu_topology_parse_list(const char *text, uint8_t *set, int max);
+
+#endif
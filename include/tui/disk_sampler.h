@@ -0,0 +1,100 @@
+#ifndef DISK_SAMPLER_H
+#define DISK_SAMPLER_H
+
+#include "../common_defs.h"
+
+// 块设备 I/O 采样
+//
+// /proc/diskstats 保持打开，每次采样只是一次 pread 加手写的解析；所有量都取
+// 相邻两次采样的差值除以间隔：
+//   IOPS        完成的读/写请求数
+//   吞吐量      读/写扇区数 × 512
+//   平均延迟    读/写耗时（毫秒）除以完成的请求数
+//   利用率      io_ticks（设备有请求在处理的毫秒数）占间隔的比例
+//   队列深度    加权排队时间（每毫秒乘以当时的请求数）除以间隔，即平均在途请求数
+//
+// 设备集合变化时，以及每 DISK_SAMPLER_RESCAN 次采样，重新读取一次元数据：
+// <block>/<设备>/partition 存在的是分区，分区所在的磁盘取 <block>/<设备>
+// 实际路径的上一级目录；挂载点按设备号从 mountinfo 中查找。
+
+#define DISK_SAMPLER_PATH "/proc/diskstats"
+#define DISK_SAMPLER_BLOCK "/sys/class/block"
+#define DISK_SAMPLER_MOUNTINFO "/proc/self/mountinfo"
+#define DISK_SAMPLER_BUFFER 8192      // 初始大小，装不下整个文件时加倍
+#define DISK_SAMPLER_RESCAN 30
+#define DISK_SECTOR_SIZE 512
+#define DISK_NAME_MAX 32
+#define DISK_MOUNT_MAX 64
+
+// 与 /proc/diskstats 中设备名之后的字段顺序一致
+typedef struct {
+    uint64_t reads;              // 完成的读请求
+    uint64_t reads_merged;
+    uint64_t read_sectors;
+    uint64_t read_ms;            // 读请求耗时的总和
+    uint64_t writes;
+    uint64_t writes_merged;
+    uint64_t write_sectors;
+    uint64_t write_ms;
+    uint64_t in_flight;          // 当前在途请求数（不是累计值）
+    uint64_t io_ms;              // 有请求在处理的时间
+    uint64_t weighted_ms;        // 加权排队时间
+} DiskCounters;
+
+typedef struct {
+    double read_iops;
+    double write_iops;
+    double read_rate;            // 字节/秒
+    double write_rate;
+    double read_latency;         // 每个读请求的平均耗时（毫秒）
+    double write_latency;
+    double latency;              // 所有请求的平均耗时（毫秒）
+    double utilization;          // %
+    double queue_depth;          // 平均在途请求数
+} DiskRates;
+
+typedef struct {
+    char name[DISK_NAME_MAX];
+    unsigned int major;
+    unsigned int minor;
+    int partition;                   // 是分区
+    int parent;                      // 分区所在磁盘的下标，-1 表示没有
+    char mount[DISK_MOUNT_MAX];      // 第一个挂载点，空表示没有挂载
+    DiskCounters counters;           // 最近一次采样的累计值
+    DiskRates rates;                 // 与上一次采样之间的速率
+    int sampled;                     // 已有一次采样，可以计算差值
+} DiskDevice;
+
+typedef struct {
+    int fd;
+    char *buffer;
+    size_t capacity;
+    char block[MAX_PATH_LENGTH];
+    char mountinfo[MAX_PATH_LENGTH];
+
+    DiskDevice *devices;     // 按 /proc/diskstats 中的顺序
+    DiskDevice *next;        // 解析时的另一份数组，与 devices 交替使用
+    int count;
+    int device_capacity;
+
+    double last;             // 上一次采样的时间（秒，单调时钟）
+    double interval;         // 最近两次采样的间隔（秒），0 表示还没有差值
+    uint64_t samples;
+} DiskSampler;
+
+// path、block、mountinfo 为 NULL 时分别使用 /proc/diskstats、/sys/class/block、
+// /proc/self/mountinfo
+int disk_sampler_open(DiskSampler *sampler, const char *path, const char *block, const char *mountinfo);
+void disk_sampler_close(DiskSampler *sampler);
+
+// 读取所有设备的计数并计算速率，now 为单调时钟的秒数
+int disk_sampler_sample(DiskSampler *sampler, double now);
+
+// 按名称或设备号查找，找不到时返回 NULL
+const DiskDevice *disk_sampler_find(const DiskSampler *sampler, const char *name);
+const DiskDevice *disk_sampler_find_dev(const DiskSampler *sampler, unsigned int major, unsigned int minor);
+
+// 设备本身或其任一分区的第一个挂载点，没有时返回空字符串
+const char *disk_sampler_mount(const DiskSampler *sampler, const DiskDevice *device);
+
+#endif
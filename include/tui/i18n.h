@@ -37,6 +37,8 @@ typedef struct {
     Language current_language;     // 当前语言
     I18nMessage *messages;         // 消息数组
     int message_count;             // 消息数量
+    int *key_index;                // 消息键哈希索引（开放寻址，存放下标 + 1）
+    int key_index_capacity;        // 索引槽位数（2 的幂）
     char locale_dir[MAX_PATH_LENGTH]; // 语言文件目录
     int fallback_to_english;       // 是否回退到英语
 } I18nSystem;
@@ -0,0 +1,107 @@
+#ifndef LOG_FILTER_H
+#define LOG_FILTER_H
+
+#include <regex.h>
+#include "../common_defs.h"
+#include "../utils/logger.h"
+#include "log_index.h"
+
+// 日志过滤引擎
+//
+// 每个级别维护一个覆盖整个行索引的位图（每行 1 位）。模式与来源过滤各自
+// 预编译一次：普通字符串在整段文本上用 memmem 查找，再把命中位置映射回行号；
+// 含正则元字符时编译为 POSIX 扩展正则，先用其中必须出现的字面量粗筛，
+// 只对候选行执行正则。匹配结果同样保存为位图，
+// 组合过滤就是按字（64 行）做位图与运算，计数只需 popcount。时间范围
+// 在时间列上二分换算成行号范围，求值时只是再与一个掩码。过滤后的视图
+// 在按位置访问时才物化为行号数组。新追加的行按需补算；过滤条件变化时只
+// 重算变化的那一项。
+//
+// 文本日志行中没有单独的来源字段，来源过滤同样在整行上匹配（通常是消息中
+// 的模块名或文件名）。
+
+#define LOG_FILTER_LEVELS (LOG_FATAL + 1)
+#define LOG_FILTER_PATTERN_MAX 256
+#define LOG_FILTER_REGEX_CHARS ".[]()*+?{}|^$\\"  // 含这些字符的模式按正则匹配
+
+// 一个预编译的匹配条件
+typedef struct {
+    int active;
+    int regex;                          // 按正则匹配，否则按字面量查找
+    regex_t compiled;
+    char text[LOG_FILTER_PATTERN_MAX];
+    size_t length;
+    char literal[LOG_FILTER_PATTERN_MAX];  // 正则中必须出现的最长字面量，用于粗筛
+    size_t literal_length;
+    uint64_t *bits;                     // 匹配的行
+    size_t lines;                       // 已匹配过的行数
+} LogFilterMatcher;
+
+typedef struct {
+    uint64_t *level_bits[LOG_FILTER_LEVELS];
+    int level_counts[LOG_FILTER_LEVELS];
+    size_t lines;                       // 已计算级别的行数
+    size_t words;                       // 各位图已分配的字数
+
+    LogLevel min_level;
+    LogFilterMatcher pattern;
+    LogFilterMatcher source;
+
+    // 行号范围 [range_first, range_end)（由时间范围换算而来）
+    int range_active;
+    size_t range_first;
+    size_t range_end;
+
+    // 过滤后的视图：通过过滤的行号，按需物化
+    uint32_t *rows;
+    size_t row_count;
+    size_t row_capacity;
+    size_t row_lines;                   // rows 已覆盖的行数
+    int rows_valid;
+} LogFilter;
+
+void log_filter_init(LogFilter *filter);
+void log_filter_free(LogFilter *filter);
+
+// 行索引被重建时丢弃所有按行计算的结果，保留过滤条件
+void log_filter_reset(LogFilter *filter);
+
+// 设置过滤条件，空字符串表示不过滤；正则编译失败时按字面量查找
+void log_filter_set_level(LogFilter *filter, LogLevel min_level);
+void log_filter_set_pattern(LogFilter *filter, const char *pattern);
+void log_filter_set_source(LogFilter *filter, const char *source);
+// 只保留 [first, end) 中的行；active 为 0 时取消
+void log_filter_set_range(LogFilter *filter, int active, size_t first, size_t end);
+
+// 是否设置了任何过滤条件（未设置时视图就是全部行）
+int log_filter_active(const LogFilter *filter);
+
+// 为 index 中新增的行补算级别与匹配结果（text 为索引对应的文本）
+int log_filter_update(LogFilter *filter, const char *text, size_t text_size, const LogLineIndex *index);
+
+// 以下查询反映最近一次 log_filter_update 覆盖的行
+int log_filter_level_count(const LogFilter *filter, LogLevel level);
+size_t log_filter_count(const LogFilter *filter);
+int log_filter_contains(const LogFilter *filter, size_t line);
+
+// 视图中第 position 行对应的行号，越界返回 -1
+long log_filter_row(LogFilter *filter, size_t position);
+
+// 不早于 line 的第一条通过过滤的行在视图中的位置（都更早时返回视图长度）
+size_t log_filter_position(LogFilter *filter, size_t line);
+
+// 单独使用的匹配条件（搜索）：编译 text，空字符串返回 0
+int log_filter_matcher_compile(LogFilterMatcher *matcher, const char *text);
+void log_filter_matcher_free(LogFilterMatcher *matcher);
+// line[0, length) 是否匹配
+int log_filter_matcher_test(const LogFilterMatcher *matcher, const char *line, size_t length);
+
+// 正则中任何匹配都必须包含的最长字面量，写入 literal 并返回长度，没有时返回 0
+size_t log_filter_required_literal(const char *regex, char *literal, size_t size);
+
+// 从行首提取 "[时间] [级别]" 中的级别，无法识别时为 LOG_INFO
+LogLevel log_filter_line_level(const char *line, size_t length);
+// 同时返回级别之后的消息正文（没有 "[时间] [级别]" 时为整行）
+const char *log_filter_line_header(const char *line, size_t length, LogLevel *level);
+
+#endif
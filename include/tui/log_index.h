@@ -0,0 +1,70 @@
+#ifndef LOG_INDEX_H
+#define LOG_INDEX_H
+
+#include <sys/stat.h>
+#include "../common_defs.h"
+
+// 日志行索引
+//
+// 记录文本中每个非空行的起始偏移。换行由 fast_memchr_all（SIMD）批量查找；
+// 大文件切成若干块并行建立，块边界对齐到换行之后，各块结果按顺序拼接。
+// 索引可以保存在日志旁边的 "<日志>.lidx" 中，用 inode、大小和 mtime 校验：
+// 文件未变化时直接载入；只是追加了内容时沿用已有部分，只索引新增的尾部。
+
+#define LOG_INDEX_SUFFIX ".lidx"
+#define LOG_INDEX_MAGIC "SWKLNDX1"
+#define LOG_INDEX_VERSION 1
+#define LOG_INDEX_PARALLEL_MIN (16 * 1024 * 1024)  // 小于该大小时单线程建立
+#define LOG_INDEX_MAX_THREADS 8
+#define LOG_INDEX_SAVE_MIN (8 * 1024 * 1024)       // 新索引的内容少于该大小时不写索引文件
+#define LOG_INDEX_TAIL_CHECK 4096                  // 校验已索引部分末尾的字节数
+
+typedef struct {
+    uint64_t *offsets;      // 每个非空行的起始偏移
+    size_t count;
+    size_t capacity;
+} LogLineIndex;
+
+// 索引文件头，其后是 line_count 个 uint64_t 偏移
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t inode;
+    uint64_t file_size;      // 保存时的文件大小
+    int64_t mtime_ns;        // 保存时的修改时间
+    uint64_t indexed_size;   // 已索引的字节数（最后一个换行之后）
+    uint64_t tail_hash;      // 已索引部分末尾的指纹，确认文件只是被追加
+    uint64_t line_count;
+} LogIndexFileHeader;
+
+// 建立进度：done/total 为已扫描/需要扫描的字节数
+typedef void (*LogIndexProgress)(uint64_t done, uint64_t total, void *context);
+
+void log_index_init(LogLineIndex *index);
+void log_index_free(LogLineIndex *index);
+
+// 索引 text[start, end) 中的完整行（start 须为行首），跳过空行，
+// 返回最后一个换行之后的偏移；内存不足时停在已索引处
+size_t log_index_scan(LogLineIndex *index, const char *text, size_t start, size_t end);
+
+// 同 log_index_scan，范围较大时分块并行建立，并定期报告进度（progress 可为 NULL）
+size_t log_index_build(LogLineIndex *index, const char *text, size_t start, size_t end,
+                       LogIndexProgress progress, void *context);
+
+// [first, count) 中起始偏移不大于 offset 的最后一行
+size_t log_index_line_of(const LogLineIndex *index, size_t first, size_t count, uint64_t offset);
+
+// 文本 [0, indexed) 末尾 LOG_INDEX_TAIL_CHECK 字节的指纹，用于确认文件只是被追加
+uint64_t log_index_fingerprint(const char *text, size_t indexed);
+int64_t log_index_mtime_ns(const struct stat *st);
+
+// 载入 log_path 的索引文件。st 与 text 为日志当前的状态和内容，
+// 校验通过时返回已索引的字节数，否则返回 0 且 index 为空
+size_t log_index_load(LogLineIndex *index, const char *log_path, const struct stat *st, const char *text);
+
+// 保存索引文件（先写临时文件再改名），indexed 为已索引的字节数
+int log_index_save(const LogLineIndex *index, const char *log_path, const struct stat *st,
+                   const char *text, size_t indexed);
+
+#endif
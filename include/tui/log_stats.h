@@ -0,0 +1,97 @@
+#ifndef LOG_STATS_H
+#define LOG_STATS_H
+
+#include "../common_defs.h"
+#include "../utils/logger.h"
+#include "log_index.h"
+
+// 日志统计
+//
+// 在建立行索引和跟随尾部时增量维护，统计对话框只读取结果，不再遍历日志。
+// 每行只解析一次：级别、来源标签、时间戳（落入分钟/小时/天的环形桶）以及
+// 消息模板（数字串折叠为 '#'）。重复最多的消息用 Space-Saving 算法在
+// LOG_STATS_TOP 个计数器内近似统计，计数的高估量不超过 error。
+// 大段新内容分块并行统计后合并（各项计数可直接相加，Space-Saving 摘要可合并）。
+//
+// 文本日志行中没有记录子系统，来源标签取自消息开头的 "[标签]" 或 "标签:"，
+// 都没有时计入 "other"。
+
+#define LOG_STATS_LEVELS (LOG_FATAL + 1)
+#define LOG_STATS_SOURCES 32         // 单独统计的来源标签数，之后出现的计入 "other"
+#define LOG_STATS_SOURCE_NAME 24
+#define LOG_STATS_TOP 64             // 重复消息的计数器数
+#define LOG_STATS_SAMPLE 96          // 保存的消息模板长度
+#define LOG_STATS_MINUTES 1440       // 保留最近 24 小时的分钟桶
+#define LOG_STATS_HOURS 168          // 保留最近 7 天的小时桶
+#define LOG_STATS_DAYS 90
+#define LOG_STATS_PARALLEL_MIN 262144  // 新增行数达到该值时并行统计
+#define LOG_STATS_STAMP 17           // "[YYYY-MM-DD HH:MM"
+
+// 一个时间桶，key 为自 1970-01-01 起的分钟/小时/天数（按日志中的本地时间），-1 表示空
+typedef struct {
+    int64_t key;
+    uint32_t total;
+    uint32_t errors;         // ERROR 及以上
+} LogStatsBucket;
+
+typedef struct {
+    char name[LOG_STATS_SOURCE_NAME];
+    uint64_t count;
+    uint64_t errors;
+} LogStatsSource;
+
+// Space-Saving 计数器
+typedef struct {
+    uint64_t hash;           // 消息模板的哈希
+    uint64_t count;
+    uint64_t error;          // count 可能的高估量
+    LogLevel level;          // 最近一次出现的级别
+    char text[LOG_STATS_SAMPLE];
+} LogStatsMessage;
+
+typedef struct {
+    size_t lines;            // 已统计的行数
+    uint64_t level_counts[LOG_STATS_LEVELS];
+    uint64_t untimed;        // 没有可识别时间戳的行
+    int64_t first_minute;    // 最早/最晚的时间戳（分钟），没有时为 -1
+    int64_t last_minute;
+
+    LogStatsSource sources[LOG_STATS_SOURCES + 1];  // 最后一项为 "other"
+    int source_count;
+
+    LogStatsBucket minutes[LOG_STATS_MINUTES];
+    LogStatsBucket hours[LOG_STATS_HOURS];
+    LogStatsBucket days[LOG_STATS_DAYS];
+
+    LogStatsMessage top[LOG_STATS_TOP];
+    int top_count;
+
+    // 上一个解析过的时间戳前缀
+    char stamp[LOG_STATS_STAMP];
+    int64_t stamp_minute;
+} LogStats;
+
+void log_stats_init(LogStats *stats);
+
+// 统计 index 中新增的行（text 为索引对应的文本）
+void log_stats_update(LogStats *stats, const char *text, size_t text_size, const LogLineIndex *index);
+
+// 把 other 的结果并入 stats（other 统计的行在 stats 之后）
+void log_stats_merge(LogStats *stats, const LogStats *other);
+
+// 某个时间点所在的桶，不在保留范围内时返回 NULL
+const LogStatsBucket *log_stats_minute(const LogStats *stats, int64_t minute);
+const LogStatsBucket *log_stats_hour(const LogStats *stats, int64_t hour);
+const LogStatsBucket *log_stats_day(const LogStats *stats, int64_t day);
+
+// 按次数降序复制最多 max 条重复消息，返回条数
+int log_stats_top_messages(const LogStats *stats, LogStatsMessage *out, int max);
+
+// 截至最后一条日志的 hours 个小时的错误率迷你图（UTF-8，每小时一个字符，
+// 没有日志的小时为空格），返回写入的字节数
+size_t log_stats_error_sparkline(const LogStats *stats, int hours, char *out, size_t size);
+
+// 行首时间戳（见 log_time_parse）所在的分钟，无法识别时返回 -1
+int64_t log_stats_line_minute(const char *line, size_t length);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef LOG_TIME_H
+#define LOG_TIME_H
+
+#include "../common_defs.h"
+#include "log_index.h"
+
+// 日志时间列
+//
+// 与行索引并列，为每一行保存 "[YYYY-MM-DD HH:MM:SS.mmm]" 对应的毫秒数
+// （按日志中写下的本地时间，自 1970-01-01 00:00:00.000 起计）。时间戳是定长格式，
+// 直接按位解析数字并换算天数，不调用 strptime/mktime；相邻行的
+// "[YYYY-MM-DD HH:MM" 通常相同，此时只解析秒和毫秒。
+//
+// 列按 LOG_TIME_BLOCK 行分块：每块保存首行的完整时间，块内每行只保存相对
+// 首行的 32 位增量（每行 4 字节）。列中的值单调不减：没有时间戳的行（多行消息
+// 的后续行）以及比前面更早的乱序行都取到该行为止的最大时间，日志开头没有
+// 时间戳的行记为 0。因此跳到某个时间、按时间范围过滤都是二分查找。
+
+#define LOG_TIME_BLOCK 1024
+#define LOG_TIME_PREFIX 17        // "[YYYY-MM-DD HH:MM"，相同时只解析秒和毫秒
+#define LOG_TIME_STAMP_LENGTH 25  // "[YYYY-MM-DD HH:MM:SS.mmm]"
+
+typedef struct {
+    int64_t *bases;          // 每块首行的时间
+    uint32_t *deltas;        // 每行相对所在块首行的增量
+    size_t count;            // 已计算的行数
+    size_t capacity;
+    int64_t last;            // 到目前为止的最大时间
+
+    // 上一个解析过的时间戳前缀
+    char prefix[LOG_TIME_PREFIX];
+    int64_t prefix_ms;
+} LogTimeColumn;
+
+void log_time_init(LogTimeColumn *column);
+void log_time_free(LogTimeColumn *column);
+
+// 为 index 中新增的行计算时间（text 为索引对应的文本）；行数变少时从头计算
+int log_time_update(LogTimeColumn *column, const char *text, size_t text_size, const LogLineIndex *index);
+
+// 第 line 行的时间
+int64_t log_time_at(const LogTimeColumn *column, size_t line);
+
+// 第一条时间不早于 ms 的行，都更早时返回行数
+size_t log_time_lower_bound(const LogTimeColumn *column, int64_t ms);
+
+// 解析行首的 "[YYYY-MM-DD HH:MM:SS.mmm]"，无法识别时返回 -1
+int64_t log_time_parse(const char *line, size_t length);
+
+// 解析用户输入的时间：可以只写前缀（"2024-01-01"、"2024-01-01 12:30" 等），
+// 省略的部分取最小值，无法识别时返回 -1
+int64_t log_time_parse_input(const char *text);
+
+// 公历日期到 1970-01-01 起的天数
+int64_t log_time_days(int year, int month, int day);
+
+// 系统时间（Unix 毫秒）换算为日志中的本地时间，用于对照监控数据等外部事件
+int64_t log_time_from_epoch(int64_t epoch_ms);
+
+// 格式化为 "YYYY-MM-DD HH:MM:SS.mmm"
+void log_time_format(int64_t ms, char *buf, size_t size);
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef LOG_TIMELINE_H
+#define LOG_TIMELINE_H
+
+#include "../common_defs.h"
+#include "../utils/log_archive.h"
+
+// 跨轮转段的合并时间线
+//
+// 把 "<日志>" 与轮转出的 "<日志>.1"、"<日志>.2"……（包括压缩的 ".N.zst"）
+// 当作一个按时间排序的日志浏览。每个段是一串块：明文日志按 1MB 切块并直接
+// 引用映射，压缩归档每帧一块，未压缩的二进制日志按归档的方式在记录边界上
+// 切块（二进制日志都逐块解码渲染为文本）。每段只缓存最近用过的几块，
+// 从不整体读入内存。
+//
+// 每段有一个游标（下一条未读的行），所有段的游标合起来就是时间线上的位置。
+// 向后读取用按"下一行时间戳"排序的最小堆做 k 路归并，向前读取用按"上一行
+// 时间戳"排序的最大堆；时间戳相同时较早的段在前。时间戳按
+// "YYYY-MM-DD HH:MM:SS.mmm" 的字典序比较，没有时间戳的行（如多行消息的后续行）
+// 沿用同一块中前一行的时间戳。跳转到某个时间时，每段在块的首行时间戳上二分
+// 查找，再在块内找到第一条不早于该时间的行。
+
+#define LOG_TIMELINE_MAX_SOURCES 64
+#define LOG_TIMELINE_STAMP 23                 // "YYYY-MM-DD HH:MM:SS.mmm"
+#define LOG_TIMELINE_BLOCK (1024 * 1024)      // 明文日志的块大小
+#define LOG_TIMELINE_CACHE 3                  // 每段缓存的块数
+#define LOG_TIMELINE_LINE_MAX 2048
+
+// 段的类型
+#define LOG_TIMELINE_TEXT 0        // 明文日志，直接映射
+#define LOG_TIMELINE_ARCHIVE 1     // .zst 归档，每帧一块
+#define LOG_TIMELINE_RENDERED 2    // 未压缩的二进制日志，按记录切块渲染
+
+#define LOG_TIMELINE_HEAP_NEXT 0
+#define LOG_TIMELINE_HEAP_PREV 1
+
+typedef struct {
+    uint32_t number;           // 块号，UINT32_MAX 表示空槽
+    char *buffer;              // 解压或渲染得到的文本（明文日志为 NULL，text 指向映射）
+    const char *text;
+    size_t size;
+    uint32_t *lines;           // 每个非空行在 text 中的偏移
+    uint32_t *stamps;          // 每行适用的时间戳在 text 中的偏移，UINT32_MAX 表示没有
+    uint32_t line_count;
+    uint64_t used;             // 最近使用的时刻，用于替换
+} LogTimelineBlock;
+
+typedef struct {
+    char path[MAX_PATH_LENGTH];
+    int kind;                  // LOG_TIMELINE_*
+    int fd;
+    const char *map;
+    size_t map_size;
+    LogArchive archive;        // 归档的索引；未压缩的二进制日志只有帧表与前导区
+    uint32_t block_count;
+    LogTimelineBlock cache[LOG_TIMELINE_CACHE];
+    uint64_t clock;
+
+    // 游标：下一条未读的行，block == block_count 表示已到末尾
+    uint32_t block;
+    uint32_t line;
+    int has_next;
+    int has_prev;
+    char next_key[LOG_TIMELINE_STAMP];
+    char prev_key[LOG_TIMELINE_STAMP];
+    int heap_pos[2];           // 在两个堆中的位置，-1 表示不在堆中
+} LogTimelineSource;
+
+typedef struct {
+    int items[LOG_TIMELINE_MAX_SOURCES];
+    int count;
+} LogTimelineHeap;
+
+typedef struct {
+    LogTimelineSource *sources;  // 从最早的段到当前日志
+    int source_count;
+    LogTimelineHeap heaps[2];
+} LogTimeline;
+
+// 时间线上的一条
+typedef struct {
+    char line[LOG_TIMELINE_LINE_MAX];  // 行内容（不含换行），过长时截断
+    size_t length;
+    int source;                        // 所在的段
+} LogTimelineEntry;
+
+// 时间线上的位置（各段的游标）
+typedef struct {
+    uint32_t block[LOG_TIMELINE_MAX_SOURCES];
+    uint32_t line[LOG_TIMELINE_MAX_SOURCES];
+} LogTimelinePosition;
+
+// 打开 log_path 及其全部轮转段，位置在最开始
+int log_timeline_open(LogTimeline *tl, const char *log_path);
+void log_timeline_close(LogTimeline *tl);
+
+// 读取位置之后的一条并前进 / 位置之前的一条并后退，没有时返回 0
+int log_timeline_next(LogTimeline *tl, LogTimelineEntry *entry);
+int log_timeline_prev(LogTimeline *tl, LogTimelineEntry *entry);
+
+void log_timeline_seek_start(LogTimeline *tl);
+void log_timeline_seek_end(LogTimeline *tl);
+// 移动到第一条时间戳不早于 stamp 的行之前；stamp 可以是
+// "YYYY-MM-DD HH:MM:SS.mmm" 的任意前缀（如 "2024-01-01 12:30"）
+void log_timeline_seek_time(LogTimeline *tl, const char *stamp);
+
+void log_timeline_tell(const LogTimeline *tl, LogTimelinePosition *position);
+void log_timeline_restore(LogTimeline *tl, const LogTimelinePosition *position);
+
+// 段的路径（用于显示）
+const char *log_timeline_source_path(const LogTimeline *tl, int source);
+
+#endif
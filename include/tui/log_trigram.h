@@ -0,0 +1,105 @@
+#ifndef LOG_TRIGRAM_H
+#define LOG_TRIGRAM_H
+
+#include <pthread.h>
+#include <sys/stat.h>
+#include "../common_defs.h"
+
+// 日志三元组倒排索引
+//
+// 文本按行对齐切成约 LOG_TRIGRAM_BLOCK 字节的块，记录每个三字节序列出现在
+// 哪些块中：每个三元组一个按块号递增的倒排表，用差分 varint 压缩。搜索时
+// 取出模式（或正则必须包含的字面量）的全部三元组，倒排表求交得到少数
+// 候选块，只在这些块里做精确匹配。
+//
+// 大日志打开后由后台线程建立（线程自己映射文件，不受查看器重新映射的影响），
+// 并保存为 "<日志>.tgi"。校验方式与行索引文件相同，日志只是被追加时沿用
+// 已有部分，继续索引新增的块。
+
+#define LOG_TRIGRAM_SUFFIX ".tgi"
+#define LOG_TRIGRAM_MAGIC "SWKTGRM1"
+#define LOG_TRIGRAM_VERSION 2
+#define LOG_TRIGRAM_BLOCK (128 * 1024)          // 块的目标大小
+#define LOG_TRIGRAM_MIN (4 * 1024 * 1024)       // 小于该大小的日志直接线性查找
+
+// 后台建立的状态
+#define LOG_TRIGRAM_IDLE 0
+#define LOG_TRIGRAM_BUILDING 1
+#define LOG_TRIGRAM_READY 2
+#define LOG_TRIGRAM_FAILED 3
+
+// 一个三元组的倒排表
+typedef struct {
+    uint32_t key;            // 三个字节
+    uint32_t count;          // 出现的块数，0 表示空槽
+    uint32_t last_block;     // 最后追加的块号（差分编码的基准）
+    uint32_t length;         // data 中已用的字节数
+    uint32_t capacity;
+    uint8_t *data;
+} LogTrigramPosting;
+
+typedef struct {
+    uint64_t *blocks;        // 块起始偏移，blocks[block_count] 为已覆盖的结束偏移
+    uint32_t block_count;
+    uint32_t block_capacity;
+    LogTrigramPosting *table;  // 按三元组开放寻址
+    uint32_t table_size;
+    uint32_t used;
+} LogTrigramIndex;
+
+// 索引文件头，其后依次是 block_count + 1 个块偏移、trigram_count 个
+// {key, count, last_block, length}，以及 data_size 字节的倒排表数据；
+// crc 为这些内容的 CRC32C
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_size;
+    uint64_t inode;
+    uint64_t file_size;
+    int64_t mtime_ns;
+    uint64_t covered;        // 已索引的字节数
+    uint64_t tail_hash;
+    uint32_t block_count;
+    uint32_t trigram_count;
+    uint64_t data_size;
+    uint32_t crc;
+    uint32_t reserved;
+} LogTrigramFileHeader;
+
+// 后台建立
+typedef struct {
+    LogTrigramIndex index;
+    pthread_t thread;
+    int state;               // LOG_TRIGRAM_*
+    int cancel;
+    int fd;                  // 线程自己的文件描述符
+    struct stat st;
+    char path[MAX_PATH_LENGTH];
+} LogTrigramBuilder;
+
+void log_trigram_init(LogTrigramIndex *index);
+void log_trigram_free(LogTrigramIndex *index);
+
+// 已索引的字节数（之后的内容需要线性查找）
+size_t log_trigram_covered(const LogTrigramIndex *index);
+
+// 从已覆盖处继续索引 text[.., size) 中以换行结尾的部分；*cancel 变为非 0 时提前返回
+int log_trigram_extend(LogTrigramIndex *index, const char *text, size_t size, const int *cancel);
+
+// 可能包含 literal 的块号（升序，*blocks 由调用方 free），返回块数；
+// literal 短于 3 字节时返回 -1，表示无法缩小范围
+long log_trigram_candidates(const LogTrigramIndex *index, const char *literal, size_t length, uint32_t **blocks);
+
+// 载入/保存 log_path 的索引文件，st 与 text 为日志当前的状态和内容
+int log_trigram_load(LogTrigramIndex *index, const char *log_path, const struct stat *st, const char *text);
+int log_trigram_save(const LogTrigramIndex *index, const char *log_path, const struct stat *st, const char *text);
+
+// 为 fd 打开的日志启动后台建立（小于 LOG_TRIGRAM_MIN 时不启动，返回 SWK_ERROR）
+void log_trigram_builder_init(LogTrigramBuilder *builder);
+int log_trigram_builder_start(LogTrigramBuilder *builder, int fd, const char *log_path);
+// 建立完成后返回索引（此后只读），否则返回 NULL
+const LogTrigramIndex *log_trigram_builder_ready(LogTrigramBuilder *builder);
+// 取消并等待后台线程，释放索引
+void log_trigram_builder_stop(LogTrigramBuilder *builder);
+
+#endif
@@ -2,6 +2,14 @@
 #define LOG_VIEWER_H
 
 #include "../common_defs.h"
+#include "../utils/logger.h"
+#include "log_index.h"
+#include "log_filter.h"
+#include "log_trigram.h"
+#include "log_stats.h"
+#include "log_time.h"
+
+struct LogBinaryDecoder;
 
 // 日志条目结构
 typedef struct LogEntry {
@@ -10,23 +18,31 @@ typedef struct LogEntry {
     char message[1024];
     char source_file[256];
     int line_number;
-    struct LogEntry *next;
-    struct LogEntry *prev;
 } LogEntry;
 
+#define LOG_VIEWER_CACHE_SIZE 256   // 已解析条目缓存的槽数（按行号直接映射）
+
 // 日志查看器状态
+//
+// 不再把整个日志解析成条目链表：文本日志整体 mmap，只保存每行的起始偏移
+// （每行 8 字节），条目在显示或查询时才解析，并缓存在按行号直接映射的槽位中。
+// 二进制日志、归档帧和内存环先渲染成文本放在堆上，再用同样的方式索引。
+// 大文本日志的行索引并行建立并保存在 "<日志>.lidx"，再次打开未变化的日志时直接载入。
+// 搜索使用后台建立的三元组索引（"<日志>.tgi"）跳过不可能匹配的块。
+// 每行的时间解析一次存入时间列，按时间定位与过滤不再逐行解析。
 typedef struct {
-    LogEntry *entries;
-    LogEntry *current_entry;
     int total_entries;
     int visible_entries;
-    int current_position;
+    int current_position;       // 在过滤后视图中的位置
     int scroll_offset;
 
-    // 过滤选项
+    // 过滤选项（通过 log_viewer_set_*_filter 设置，由 filter 求值）
     LogLevel min_level;
     char filter_pattern[256];
     char source_filter[256];
+    LogFilter filter;
+    int64_t time_from;          // 时间范围过滤（日志时间的毫秒数），-1 表示不限
+    int64_t time_to;
 
     // 显示选项
     int show_timestamp;
@@ -36,18 +52,78 @@ typedef struct {
 
     // 文件信息
     char log_file_path[MAX_PATH_LENGTH];
-    FILE *log_file;
-    long last_file_size;
+    int fd;                     // 未打开文件时为 -1
+    const char *map;            // 日志文件的只读映射
+    size_t map_size;
+    long last_file_size;        // 已索引到的文件偏移
+
+    // inotify 跟随：监视打开的文件（追加、移走）及其所在目录（轮转后新建同名文件）
+    int watch_fd;               // inotify 不可用时为 -1，退回到每次刷新 stat
+    int watch_file;
+    int watch_dir;
+
+    // 行索引：text 指向文本日志的映射，或 text_buffer（由二进制日志、归档帧、内存环渲染）
+    const char *text;
+    size_t text_size;           // text 中已索引的字节数
+    char *text_buffer;
+    size_t text_capacity;
+    LogLineIndex index;         // 每个非空行的起始偏移，条数与 total_entries 一致
+
+    // 首次建立大文件索引时的进度回调
+    LogIndexProgress progress;
+    void *progress_context;
+
+    // 索引和跟随尾部时增量维护的统计
+    LogStats stats;
+
+    // 每行的时间，与行索引并列，跳到某个时间和时间范围过滤都在其上二分
+    LogTimeColumn times;
+
+    // 搜索用的三元组索引（大文本日志打开后在后台建立）
+    LogTrigramBuilder search;
+
+    // 已解析条目的缓存
+    LogEntry *cache;
+    int cache_lines[LOG_VIEWER_CACHE_SIZE];  // 每个槽位缓存的行号，-1 表示空
+
+    // 二进制日志（logger 的 binary 格式）
+    int binary;
+    struct LogBinaryDecoder *decoder;
+
+    // 当前显示的归档帧（log_viewer_open_archive 打开归档时有效）
+    uint32_t archive_frame;
+
+    // 读取 logger 内存环而不是文件（log_viewer_open_memory）
+    int memory;
+    uint64_t memory_cursor;     // 下一次从内存环读取的序号
 } LogViewer;
 
 // 日志查看器函数
 int log_viewer_init(LogViewer *lv, const char *log_file_path);
+// 同 log_viewer_init，建立索引期间（以及之后的重新加载）通过 progress 报告进度
+int log_viewer_open(LogViewer *lv, const char *log_file_path, LogIndexProgress progress, void *context);
 void log_viewer_cleanup(LogViewer *lv);
+// 只在 inotify 报告变化时检查文件：追加的内容增量索引，轮转（路径指向
+// 另一个 dev/inode）或截断时重新打开
 int log_viewer_refresh(LogViewer *lv);
 int log_viewer_reload(LogViewer *lv);
 
-// 导航函数
+// 可供 poll() 等待日志变化的描述符，不可用时返回 -1
+int log_viewer_get_watch_fd(LogViewer *lv);
+// 等待日志变化（最多 timeout_ms 毫秒）后刷新
+int log_viewer_wait(LogViewer *lv, int timeout_ms);
+
+// 轮转归档（.zst）：按时间或按搜索结果只解压其中一帧，time_ms 与时间列相同（log_time_parse）
+int log_viewer_open_archive(LogViewer *lv, const char *archive_path, int64_t time_ms);
+int log_viewer_search_archive(LogViewer *lv, const char *archive_path, const char *pattern);
+
+// 查看 logger 内存环中最近的日志（日志文件不可读或文件汇点停用时使用）
+int log_viewer_open_memory(LogViewer *lv);
+
+// 导航函数：位置都是过滤后视图中的位置（log_viewer_get_entry_at 按行号访问）
+// 返回的条目位于缓存中，访问另一个映射到同一槽位的位置后失效
 LogEntry *log_viewer_get_current_entry(LogViewer *lv);
+LogEntry *log_viewer_get_view_entry(LogViewer *lv, int position);
 LogEntry *log_viewer_get_entry_at(LogViewer *lv, int position);
 int log_viewer_scroll_up(LogViewer *lv, int lines);
 int log_viewer_scroll_down(LogViewer *lv, int lines);
@@ -61,8 +137,14 @@ void log_viewer_set_level_filter(LogViewer *lv, LogLevel min_level);
 void log_viewer_set_pattern_filter(LogViewer *lv, const char *pattern);
 void log_viewer_set_source_filter(LogViewer *lv, const char *source);
 void log_viewer_clear_filters(LogViewer *lv);
+// 只显示时间在 [from_ms, to_ms] 中的条目，-1 表示该端不限
+void log_viewer_set_time_filter(LogViewer *lv, int64_t from_ms, int64_t to_ms);
+// 移动到第一条时间不早于 ms 的条目（都更早时到最后一条）
+int log_viewer_jump_to_time(LogViewer *lv, int64_t ms);
 int log_viewer_search_next(LogViewer *lv, const char *pattern);
 int log_viewer_search_prev(LogViewer *lv, const char *pattern);
+// 三元组索引是否已可用于搜索（否则线性查找）
+int log_viewer_search_indexed(LogViewer *lv);
 
 // 显示选项
 void log_viewer_toggle_timestamp(LogViewer *lv);
@@ -74,11 +156,13 @@ void log_viewer_toggle_follow_tail(LogViewer *lv);
 int log_viewer_get_total_entries(LogViewer *lv);
 int log_viewer_get_filtered_entries(LogViewer *lv);
 int log_viewer_get_entries_by_level(LogViewer *lv, LogLevel level);
+const LogStats *log_viewer_get_stats(LogViewer *lv);
 
 // TUI 对话框函数
 void show_log_viewer_dialog(void);
 void show_log_filter_dialog(LogViewer *lv);
 void show_log_search_dialog(LogViewer *lv);
+void show_log_timeline_dialog(const char *log_path);
 void show_log_statistics_dialog(LogViewer *lv);
 
 // 日志解析函数
@@ -0,0 +1,72 @@
+#ifndef NET_SAMPLER_H
+#define NET_SAMPLER_H
+
+#include "../common_defs.h"
+
+// 网络接口流量采样
+//
+// 从 /sys/class/net/<接口>/statistics 读取所有接口的计数，每个计数文件保持
+// 打开，每次采样只是一次 pread；速率取相邻两次采样的差值除以间隔。
+// 接口列表每 NET_SAMPLER_RESCAN 次采样重新枚举一次，某个计数读取失败
+// （接口被删除）时下一次采样立即重新枚举。枚举时只有读取失败过的接口重新
+// 打开计数文件，其余接口沿用原有描述符。
+//
+// 主接口取 /proc/net/route 中度量最小的默认路由所在的接口；没有默认路由时
+// 取第一个不是 lo 的接口。
+
+#define NET_SAMPLER_ROOT "/sys/class/net"
+#define NET_SAMPLER_ROUTE "/proc/net/route"
+#define NET_SAMPLER_RESCAN 30
+#define NET_IFNAME_MAX 16
+
+// 计数的下标
+enum {
+    NET_RX_BYTES,
+    NET_TX_BYTES,
+    NET_RX_PACKETS,
+    NET_TX_PACKETS,
+    NET_RX_DROPPED,
+    NET_TX_DROPPED,
+    NET_RX_ERRORS,
+    NET_TX_ERRORS,
+    NET_COUNTERS
+};
+
+typedef struct {
+    char name[NET_IFNAME_MAX];
+    int fds[NET_COUNTERS];           // statistics/<计数>，-1 表示不可用
+    uint64_t counters[NET_COUNTERS]; // 最近一次采样的累计值
+    double rates[NET_COUNTERS];      // 与上一次采样之间的每秒增量
+    int loopback;
+    int sampled;                     // 已有一次采样，可以计算差值
+    int reopen;                      // 读取失败过，下一次枚举时重新打开
+} NetInterface;
+
+typedef struct {
+    char root[MAX_PATH_LENGTH];
+    char route[MAX_PATH_LENGTH];
+    NetInterface *interfaces;
+    int count;
+    int capacity;
+    int primary;             // 主接口的下标，-1 表示没有
+    int rescan;              // 下一次采样前重新枚举
+
+    double last;             // 上一次采样的时间（秒，单调时钟）
+    double interval;         // 最近两次采样的间隔（秒），0 表示还没有差值
+    uint64_t samples;
+} NetSampler;
+
+// 打开 root（NULL 表示 /sys/class/net）下的接口，route 为 NULL 表示 /proc/net/route
+int net_sampler_open(NetSampler *sampler, const char *root, const char *route);
+void net_sampler_close(NetSampler *sampler);
+
+// 读取所有接口的计数并计算速率，now 为单调时钟的秒数
+int net_sampler_sample(NetSampler *sampler, double now);
+
+// 按名称查找接口，找不到时返回 NULL
+const NetInterface *net_sampler_find(const NetSampler *sampler, const char *name);
+
+// 主接口，没有时返回 NULL
+const NetInterface *net_sampler_primary(const NetSampler *sampler);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+#include "../common_defs.h"
+#include "proc_scanner.h"
+#include "proc_table.h"
+
+// 进程事件跟踪
+//
+// 通过 netlink 进程连接器（NETLINK_CONNECTOR / CN_IDX_PROC）订阅 FORK、EXEC
+// 与 EXIT 事件，增量维护一张实时进程表：两次采集之间出现又退出的短命进程
+// 也会计入 forks/exits，没有进程变化时每次采集只是一次不阻塞的 recv。
+//
+// 订阅需要 CAP_NET_ADMIN（且不能在非初始的用户命名空间中），打开失败时调用方
+// 继续用 ProcScanner 轮询。
+//
+// 进程表在订阅成功后用一次完整扫描建立；接收缓冲区溢出（ENOBUFS）丢失事件时
+// 以及每 PROC_EVENTS_RESYNC 次采集重新扫描一次。线程组组长的 EXIT 之后进程
+// 成为僵尸，回收没有事件，每次采集检查僵尸进程的 /proc/<pid> 是否还在。
+
+#define PROC_EVENTS_BUFFER 65536
+#define PROC_EVENTS_RCVBUF (4 * 1024 * 1024)
+#define PROC_EVENTS_ACK_MS 200          // 等待订阅确认的时间
+#define PROC_EVENTS_RESYNC 300          // 每隔多少次采集完整扫描一次
+
+// 事件类型
+#define PROC_EVENTS_FORK 1
+#define PROC_EVENTS_EXEC 2
+#define PROC_EVENTS_EXIT 3
+
+typedef struct {
+    int fd;                  // netlink 套接字，未订阅时为 -1
+    char *buffer;
+    ProcTable table;
+    int resync;              // 丢失过事件，下一次采集时重新扫描
+    int polls;               // 上一次完整扫描之后的采集次数
+
+    int process_count;
+    int thread_count;
+    int zombie_count;
+
+    uint64_t forks;          // 累计事件数
+    uint64_t execs;
+    uint64_t exits;
+    uint64_t overflows;      // 接收缓冲区溢出的次数
+} ProcEvents;
+
+// 订阅进程事件；没有权限时返回 SWK_ERROR_PERMISSION_DENIED
+int proc_events_open(ProcEvents *events);
+void proc_events_close(ProcEvents *events);
+
+// 取出所有待处理的事件并更新进程表（scanner 用于建立与重新扫描）
+int proc_events_poll(ProcEvents *events, ProcScanner *scanner);
+
+// 用一次完整扫描重建进程表
+int proc_events_sync(ProcEvents *events, ProcScanner *scanner);
+
+// 应用一个事件：FORK 时 pid/tgid 为子任务、ppid 为父进程；EXEC/EXIT 时为该任务
+void proc_events_apply(ProcEvents *events, int type, int pid, int tgid, int ppid);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PROC_SCANNER_H
+#define PROC_SCANNER_H
+
+#include "../common_defs.h"
+
+// /proc 进程扫描
+//
+// 每次扫描先用 getdents64 读取保持打开的 /proc 目录描述符（lseek 回到开头，
+// 目录项读入复用的缓冲区），收集数字目录名得到 PID 列表；再用相对该描述符的
+// openat("<pid>/stat") 逐个读取，手工解析需要的字段。路径不经过 snprintf，
+// 也不经过 stdio 与 sscanf。需要时同样读取 <pid>/io。
+//
+// 进程很多时按 PID 列表切分给多个线程解析，每个线程只写自己那一段结果，
+// 各自使用栈上的读缓冲区；解析期间消失的进程在合并时剔除。
+
+#define PROC_SCANNER_ROOT "/proc"
+#define PROC_SCANNER_DIRENTS 32768      // getdents64 缓冲区大小
+#define PROC_SCANNER_STAT_MAX 1024      // /proc/<pid>/stat 的读缓冲区
+#define PROC_SCANNER_MAX_THREADS 8
+#define PROC_SCANNER_SHARD_MIN 2048     // 每个线程至少分到的进程数
+#define PROC_COMM_MAX 64
+
+// /proc/<pid>/stat 中用到的字段
+typedef struct {
+    int pid;
+    int ppid;
+    char state;              // R、S、D、Z、T 等
+    char comm[PROC_COMM_MAX];
+    int threads;
+    uint64_t utime;          // 单位为时钟滴答
+    uint64_t stime;
+    uint64_t start_time;     // 开机后的时钟滴答，与 PID 一起唯一确定进程
+    uint64_t rss;            // 页数
+    uint64_t read_bytes;     // /proc/<pid>/io，只在 has_io 时有效
+    uint64_t write_bytes;
+    int has_io;
+} ProcStat;
+
+typedef struct {
+    int fd;                  // /proc 目录，未打开时为 -1
+    int threads;             // 最多使用的解析线程数
+    int read_io;             // 同时读取 /proc/<pid>/io（其他用户的进程需要权限）
+    char *dirents;           // getdents64 缓冲区
+
+    ProcStat *procs;         // 最近一次扫描的结果，按目录顺序
+    int count;
+    int capacity;
+
+    int process_count;
+    int thread_count;
+    int zombie_count;
+    int running_count;
+    uint64_t scans;
+} ProcScanner;
+
+// 打开 root（NULL 表示 /proc），threads 为最多使用的解析线程数（<= 1 表示单线程）
+int proc_scanner_open(ProcScanner *scanner, const char *root, int threads);
+void proc_scanner_close(ProcScanner *scanner);
+
+// 重新扫描全部进程
+int proc_scanner_scan(ProcScanner *scanner);
+
+// 解析一行 /proc/<pid>/stat（comm 中可以含有空格与括号）
+int proc_scanner_parse_stat(const char *text, size_t length, ProcStat *stat);
+
+// 解析 /proc/<pid>/io 中的 read_bytes 与 write_bytes
+int proc_scanner_parse_io(const char *text, size_t length, ProcStat *stat);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef PROC_TABLE_H
+#define PROC_TABLE_H
+
+#include "../common_defs.h"
+#include "proc_scanner.h"
+
+// 以 PID 为键的进程表
+//
+// 开放寻址、线性探测，删除时把后面的元素前移（不留墓碑），负载超过 3/4
+// 时容量加倍。PID 0 不是有效的用户进程，用来表示空槽。
+
+#define PROC_TABLE_MIN 1024
+
+typedef struct {
+    int pid;                 // 0 表示空槽
+    int ppid;
+    int threads;
+    char state;
+    uint64_t start_time;     // 开机后的时钟滴答，0 表示未知（由事件得知的进程）
+
+    // 逐进程采样（ProcTop），累计值为上一次采样时的值
+    char comm[PROC_COMM_MAX];
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t read_bytes;
+    uint64_t write_bytes;
+    uint64_t rss_kb;
+    uint64_t seen;           // 最近一次出现的采样序号
+    double cpu;              // 两次采样之间的 CPU 使用率 (%，单核为 100)
+    double read_rate;        // 字节/秒
+    double write_rate;
+} ProcEntry;
+
+typedef struct {
+    ProcEntry *slots;
+    uint32_t mask;           // 容量 - 1
+    int count;
+} ProcTable;
+
+int proc_table_init(ProcTable *table, int capacity);
+void proc_table_free(ProcTable *table);
+void proc_table_clear(ProcTable *table);
+
+ProcEntry *proc_table_find(const ProcTable *table, int pid);
+
+// 返回 pid 对应的项，不存在时插入一个只设置了 pid 的新项（*created 置 1）；
+// 内存不足时返回 NULL。插入可能移动其他项，之前取得的指针随之失效
+ProcEntry *proc_table_insert(ProcTable *table, int pid, int *created);
+
+// 删除 pid，不存在时返回 0
+int proc_table_remove(ProcTable *table, int pid);
+
+#endif
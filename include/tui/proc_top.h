@@ -0,0 +1,47 @@
+#ifndef PROC_TOP_H
+#define PROC_TOP_H
+
+#include "../common_defs.h"
+#include "proc_scanner.h"
+#include "proc_table.h"
+
+// 逐进程资源排行
+//
+// 每次采样把 ProcScanner 的结果并入以 PID 为键的进程表，PID 相同但启动时间
+// 不同的项视为新进程（PID 被复用）。CPU 使用率与 I/O 速率取相邻两次采样的
+// 差值；上一次采样之后才出现的进程从 0 开始计算，第一次采样只建立基准。
+// 本次采样中没有出现的进程从表中删除。
+//
+// 排行用大小为 N 的最小堆一次遍历选出，不对整张表排序。
+
+#define PROC_TOP_MAX 64              // 一次最多选出的进程数
+#define PROC_TOP_INTERVAL_MS 500     // 没有近期采样时，两次采样之间的间隔
+#define PROC_TOP_MAX_AGE 10          // 上一次采样超过该秒数时重新建立基准
+
+// 排行依据
+#define PROC_TOP_CPU 0
+#define PROC_TOP_RSS 1
+#define PROC_TOP_IO 2                // 读写速率之和，只列出有 I/O 的进程
+
+typedef struct {
+    ProcTable table;
+    int *stale;              // 删除消失进程时的临时数组
+    int stale_capacity;
+
+    uint64_t samples;
+    double last;             // 上一次采样的时间（秒，单调时钟）
+    double interval;         // 最近两次采样的间隔（秒），0 表示还没有差值
+    long ticks;              // 每秒时钟滴答数
+    long page_kb;
+} ProcTop;
+
+int proc_top_init(ProcTop *top);
+void proc_top_free(ProcTop *top);
+
+// 并入 scanner 最近一次扫描的结果，now 为单调时钟的秒数
+int proc_top_update(ProcTop *top, const ProcScanner *scanner, double now);
+
+// 按 metric 选出前 n 个进程（从大到小）写入 out，返回个数；指针在下一次更新前有效
+int proc_top_select(const ProcTop *top, int metric, const ProcEntry **out, int n);
+
+#endif
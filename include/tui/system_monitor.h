@@ -2,13 +2,44 @@
 #define SYSTEM_MONITOR_H
 
 #include "../common_defs.h"
+#include "cpu_sampler.h"
+#include "cpu_topology.h"
+#include "proc_scanner.h"
+#include "proc_events.h"
+#include "proc_top.h"
+#include "net_sampler.h"
+#include "disk_sampler.h"
+
+#define SYSTEM_MONITOR_MAX_DISKS 8   // 每条记录中保存的磁盘数
+
+// 一个磁盘与上一次采样之间的 I/O
+typedef struct {
+    char name[DISK_NAME_MAX];
+    char mount[DISK_MOUNT_MAX];    // 磁盘或其分区的第一个挂载点
+    double read_iops;
+    double write_iops;
+    double read_rate;              // KB/s
+    double write_rate;             // KB/s
+    double latency;                // 平均每个请求的耗时 (ms)
+    double utilization;            // %
+    double queue_depth;            // 平均在途请求数
+} DiskIoStats;
 
 // 系统统计信息结构
 typedef struct {
     // CPU 信息
-    double cpu_usage;           // CPU 使用率 (%)
-    int cpu_cores;             // CPU 核心数
-    double cpu_frequency;      // CPU 频率 (MHz)
+    double cpu_usage;           // CPU 使用率 (%)，与上一次采样之间的平均值
+    double cpu_user;            // 其中用户态（不含 guest）(%)
+    double cpu_system;          // 内核态 (%)
+    double cpu_iowait;          // 等待 I/O (%)
+    double cpu_irq;             // 硬中断与软中断 (%)
+    double cpu_steal;           // 被虚拟化宿主占用 (%)
+    double cpu_guest;           // 运行虚拟机 (%)
+    int cpu_online;             // 在线的逻辑 CPU 数
+    int cpu_cores;             // 物理核总数（所有插槽）
+    int cpu_sockets;           // 插槽数
+    int numa_nodes;            // NUMA 节点数
+    double cpu_frequency;      // 各在线 CPU 当前频率的平均值 (MHz)
     double cpu_temperature;    // CPU 温度 (°C)
 
     // 内存信息
@@ -32,16 +63,38 @@ typedef struct {
     double disk_usage_percent;     // 磁盘使用率 (%)
     char disk_mount_point[256];    // 挂载点
 
-    // 网络信息
+    // 块设备 I/O：挂载点所在的设备（找不到时为第一个有 I/O 的磁盘）
+    char disk_device_name[DISK_NAME_MAX];
+    double disk_read_iops;
+    double disk_write_iops;
+    double disk_read_rate;         // KB/s
+    double disk_write_rate;        // KB/s
+    double disk_read_latency;      // 平均每个读请求的耗时 (ms)
+    double disk_write_latency;     // 平均每个写请求的耗时 (ms)
+    double disk_utilization;       // %
+    double disk_queue_depth;       // 平均在途请求数
+    int disk_io_count;             // disk_io 中的磁盘数（不含分区、从未有过 I/O 的设备）
+    DiskIoStats disk_io[SYSTEM_MONITOR_MAX_DISKS];
+
+    // 网络信息（配置的接口，未配置时为默认路由所在的接口）
+    char network_interface[16];       // 接口名称
     unsigned long network_rx_bytes;    // 接收字节数
     unsigned long network_tx_bytes;    // 发送字节数
     double network_rx_rate;           // 接收速率 (KB/s)
     double network_tx_rate;           // 发送速率 (KB/s)
+    double network_rx_packets;        // 接收包速率 (包/秒)
+    double network_tx_packets;        // 发送包速率 (包/秒)
+    double network_drops;             // 收发丢包速率 (包/秒)
+    double network_errors;            // 收发错误速率 (包/秒)
+    double network_total_rx_rate;     // 除 lo 外所有接口的接收速率 (KB/s)
+    double network_total_tx_rate;     // 除 lo 外所有接口的发送速率 (KB/s)
 
     // 进程信息
     int process_count;         // 进程总数
     int thread_count;          // 线程总数
     int zombie_processes;      // 僵尸进程数
+    int process_forks;         // 上次采集以来创建的进程（仅事件跟踪时可用）
+    int process_exits;         // 上次采集以来退出的进程（仅事件跟踪时可用）
 
     // 系统负载
     double load_average_1;     // 1分钟平均负载
@@ -61,8 +114,9 @@ typedef struct {
     int enable_disk_monitor;   // 启用磁盘监控
     int enable_network_monitor; // 启用网络监控
     int enable_process_monitor; // 启用进程监控
+    int enable_process_events; // 有权限时通过进程连接器跟踪进程（否则轮询 /proc）
     char disk_device[64];      // 磁盘设备路径
-    char network_interface[32]; // 网络接口名称
+    char network_interface[32]; // 网络接口名称，留空表示默认路由所在的接口
 } MonitorConfig;
 
 // 系统监控器状态
@@ -72,6 +126,15 @@ typedef struct {
     int history_count;             // 历史记录数量
     int history_index;             // 当前历史记录索引
     MonitorConfig config;          // 监控配置
+    CpuSampler cpu;                // CPU 使用率采样（保持 /proc/stat 打开）
+    CpuTopology topology;          // CPU/NUMA 拓扑（启动时读取，热插拔时重建）
+    ProcScanner procs;             // 进程扫描（保持 /proc 打开）
+    ProcEvents events;             // 进程事件（未订阅时 fd 为 -1）
+    uint64_t reported_forks;       // 上一次采集时的累计事件数
+    uint64_t reported_exits;
+    ProcTop top;                   // 逐进程排行（进程面板打开时采样）
+    NetSampler net;                // 所有网络接口（保持统计文件打开）
+    DiskSampler disk;              // 块设备 I/O（保持 /proc/diskstats 打开）
     time_t last_update;            // 最后更新时间
     int running;                   // 运行状态
 } SystemMonitor;
@@ -84,13 +147,17 @@ int system_monitor_stop(SystemMonitor *sm);
 int system_monitor_update(SystemMonitor *sm);
 
 // 统计信息采集函数
-int system_monitor_collect_cpu_stats(SystemStats *stats);
+int system_monitor_collect_cpu_stats(SystemMonitor *sm, SystemStats *stats);
 int system_monitor_collect_memory_stats(SystemStats *stats);
 int system_monitor_collect_disk_stats(SystemStats *stats, const char *device);
-int system_monitor_collect_network_stats(SystemStats *stats, const char *interface);
-int system_monitor_collect_process_stats(SystemStats *stats);
+int system_monitor_collect_disk_io_stats(SystemMonitor *sm, SystemStats *stats);
+int system_monitor_collect_network_stats(SystemMonitor *sm, SystemStats *stats);
+int system_monitor_collect_process_stats(SystemMonitor *sm, SystemStats *stats);
 int system_monitor_collect_load_stats(SystemStats *stats);
 
+// 为进程排行采样（包括 /proc/<pid>/io）；没有近期采样时先建立基准再间隔采样一次
+int system_monitor_collect_top(SystemMonitor *sm);
+
 // 配置函数
 int system_monitor_load_config(SystemMonitor *sm, const char *config_file);
 int system_monitor_save_config(SystemMonitor *sm, const char *config_file);
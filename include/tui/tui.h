@@ -45,6 +45,7 @@ void show_log_viewer_dialog(void);
 void show_log_filter_dialog(LogViewer *lv);
 void show_log_search_dialog(LogViewer *lv);
 void show_log_statistics_dialog(LogViewer *lv);
+void show_log_level_dialog(void);
 
 // 配置管理器对话框
 void show_config_manager_dialog(void);
@@ -11,4 +11,10 @@ int set_config_value(SwikernelConfig *config, const char *section, const char *k
 char* trim_whitespace(char *str);
 int load_config_from_file(SwikernelConfig *config, const char *filename);
 
+// 把配置中的全局与子系统日志级别应用到日志库（可在运行中重复调用）
+void apply_log_levels(const SwikernelConfig *config);
+
+// 把配置中的输出端（文件、终端、套接字、内存环）设置应用到日志库
+void apply_log_sinks(const SwikernelConfig *config);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef LOG_ARCHIVE_H
+#define LOG_ARCHIVE_H
+
+#include "../common_defs.h"
+
+// 轮转日志归档
+//
+// 轮转出的日志段被切成若干块，每块压缩成一个独立的 zstd 帧，首尾相接写入
+// "<段>.zst"（标准 zstd 多帧文件，zstdcat 可直接查看）。旁边的 "<段>.zst.idx"
+// 记录每一帧的偏移、大小和帧内第一条记录的时间戳，读取时按时间或按帧号
+// 只解压需要的那一帧。块总是在记录边界上切分，单独解压一帧就能得到完整记录。
+// 时间戳与查看器的时间列使用同一时间轴（log_time_parse 的毫秒数），二进制
+// 记录的墙钟时间先换算为日志中显示的本地时间。
+//
+// 二进制日志的文件头和格式串定义集中保存在索引的前导区中，解码任意一帧前
+// 先把前导区喂给解码器即可。
+//
+// 每帧解压后的内容带 CRC32C，读取时校验；索引本身的帧表与前导区也带一个。
+
+#define LOG_ARCHIVE_SUFFIX ".zst"
+#define LOG_ARCHIVE_INDEX_SUFFIX ".idx"
+#define LOG_ARCHIVE_INDEX_MAGIC "SWKLIDX1"
+#define LOG_ARCHIVE_INDEX_VERSION 3
+#define LOG_ARCHIVE_FRAME_SIZE (256 * 1024)  // 每帧解压后的目标大小
+#define LOG_ARCHIVE_LEVEL 3                  // zstd 压缩级别
+
+// 索引文件头
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t frame_count;
+    uint32_t binary;          // 日志段是否为二进制格式
+    uint32_t preamble_size;   // 前导区字节数（二进制日志的文件头与格式串定义）
+    uint64_t total_size;      // 解压后总字节数
+    uint32_t crc;             // 帧表与前导区的 CRC32C
+    uint32_t reserved;
+} LogArchiveIndexHeader;
+
+// 每一帧的索引项
+typedef struct {
+    uint64_t compressed_offset;
+    uint64_t decompressed_offset;
+    uint32_t compressed_size;
+    uint32_t decompressed_size;
+    int64_t first_time_ms;       // 帧内第一条记录的时间（同 log_time_parse），未知时为 -1
+    uint32_t preamble_length;    // 解码本帧前需要喂给解码器的前导区长度
+    uint32_t crc;                // 解压后内容的 CRC32C
+} LogArchiveFrame;
+
+// 打开的归档
+typedef struct {
+    int fd;
+    int binary;
+    uint32_t frame_count;
+    uint64_t total_size;
+    LogArchiveFrame *frames;
+    uint8_t *preamble;
+    size_t preamble_size;
+} LogArchive;
+
+// 是否编译了 zstd 支持
+int log_archive_supported(void);
+
+// 把日志段 source 压缩为 archive_path，并写出 archive_path.idx
+// 先写临时文件再改名，读者不会看到写了一半的归档
+int log_archive_compress(const char *source, const char *archive_path);
+
+// 打开/关闭归档（只读取索引，不解压任何数据；索引与归档大小不符时失败）
+int log_archive_open(LogArchive *archive, const char *archive_path);
+void log_archive_close(LogArchive *archive);
+
+// 按归档的方式切分未压缩的二进制日志段 data：只填写帧表与前导区，
+// 帧的 decompressed_offset/decompressed_size 即 data 中的范围，不能 read_frame
+int log_archive_plan_binary(LogArchive *archive, const uint8_t *data, size_t length);
+
+// 找到包含 time_ms 的帧（第一条记录不晚于该时间的最后一帧）
+uint32_t log_archive_find_frame(const LogArchive *archive, int64_t time_ms);
+
+// 解压一帧并校验，*data 由调用方 free
+int log_archive_read_frame(const LogArchive *archive, uint32_t index, uint8_t **data, size_t *length);
+
+#endif
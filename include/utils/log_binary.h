@@ -0,0 +1,159 @@
+#ifndef LOG_BINARY_H
+#define LOG_BINARY_H
+
+#include <stdarg.h>
+#include "../common_defs.h"
+#include "logger.h"
+
+// 二进制日志（延迟格式化）
+//
+// 调用线程只记录格式串编号、单调时钟时间戳和原始参数，不调用 vsnprintf；
+// 格式串本身在每个文件中首次用到时以定义记录写出一次，解码时再还原为
+// 与文本模式一致的 "[YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] msg" 行。
+// 定长字段按主机字节序（x86-64 小端）存储。
+//
+// 每条记录以同步标记开头并带 CRC32C；解码遇到损坏的记录时用
+// log_binary_resync 找到下一个标记与校验和都正确的记录继续，
+// 损坏只影响它所在的那几条记录。
+
+#define LOG_BINARY_MAGIC "SWKBLOG1"
+#define LOG_BINARY_MAGIC_SIZE 8
+#define LOG_BINARY_VERSION 2
+#define LOG_RECORD_SYNC 0xB10C        // 记录头开头的同步标记
+
+#define LOG_BINARY_MAX_ARGS 16         // 单个格式串最多的参数个数（含 * 宽度/精度）
+#define LOG_BINARY_MAX_FORMATS 4096    // 进程内最多登记的格式串数量
+#define LOG_BINARY_MAX_FORMAT_LEN 1024 // 更长的格式串退回文本记录
+#define LOG_BINARY_RECORD_MAX 4096     // 单条记录的最大字节数
+
+// 记录类型
+typedef enum {
+    LOG_RECORD_FORMAT = 1,   // 格式串定义：参数个数、参数类型、以 NUL 结尾的格式串
+    LOG_RECORD_EVENT = 2,    // 日志事件：按参数类型依次排列的原始参数
+    LOG_RECORD_TEXT = 3      // 已格式化的消息（格式串无法延迟格式化时使用）
+} LogRecordType;
+
+// 参数类型（决定 va_arg 的读取类型和渲染时传给 snprintf 的类型）
+// 整数以 zigzag 变长编码存储，小数值只占一两个字节；指针和浮点数固定 8 字节
+typedef enum {
+    LOG_ARG_INT = 1,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_INTMAX,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,          // 变长编码的长度 + 内容（不含 NUL）
+    LOG_ARG_POINTER
+} LogArgType;
+
+// 文件头（每个日志文件开头一个，轮转后的新文件重新写入）
+typedef struct {
+    char magic[LOG_BINARY_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t header_size;
+    int64_t wall_base_ns;    // 创建文件时的 CLOCK_REALTIME
+    int64_t mono_base_ns;    // 同一时刻的 CLOCK_MONOTONIC_COARSE
+} LogBinaryHeader;
+
+// 记录头（紧凑排列，读写一律经 memcpy，不要求对齐）
+typedef struct PACKED {
+    uint16_t sync;           // LOG_RECORD_SYNC
+    uint16_t length;         // 整条记录的字节数（含记录头）
+    uint8_t type;            // LogRecordType
+    uint8_t level;           // LogLevel
+    uint16_t format_id;
+    int64_t timestamp_ns;    // CLOCK_MONOTONIC_COARSE（格式定义记录为 0）
+    uint32_t crc;            // CRC32C：本字段之前的记录头与全部负载
+} LogRecordHeader;
+
+// 进程内登记的格式串
+typedef struct {
+    const char *format;
+    uint32_t id;
+    uint16_t arg_count;
+    uint8_t binary_ok;       // 0 表示含有不支持的转换，需退回文本记录
+    uint8_t types[LOG_BINARY_MAX_ARGS];
+} LogFormatInfo;
+
+// 解码出的格式串
+typedef struct {
+    char *format;
+    uint16_t arg_count;
+    uint8_t types[LOG_BINARY_MAX_ARGS];
+} LogDecodedFormat;
+
+// 解码出的一条事件
+typedef struct {
+    LogLevel level;
+    int64_t wall_ns;         // 墙钟时间（纳秒）
+    uint32_t format_id;
+    const char *message;     // 指向解码器内部缓冲区，下一次解码前有效
+    size_t message_length;
+} LogBinaryEvent;
+
+// 流式解码器：依次喂入文件内容（可以是多个文件首尾相接）
+typedef struct LogBinaryDecoder {
+    LogDecodedFormat *formats;
+    uint32_t format_capacity;
+    int64_t wall_base_ns;
+    int64_t mono_base_ns;
+    int have_header;
+    uint64_t skipped_bytes;  // 因记录损坏跳过的字节数
+    char message[LOG_BINARY_RECORD_MAX];
+} LogBinaryDecoder;
+
+/* ---------------- 编码（日志库使用） ---------------- */
+
+// 当前单调时钟（粗粒度，vDSO 读取，无系统调用）
+int64_t log_binary_now(void);
+
+// 填充文件头
+void log_binary_header_init(LogBinaryHeader *header);
+
+// 检查数据开头是否为二进制日志文件头
+int log_binary_check_magic(const void *data, size_t length);
+int log_binary_is_binary_file(const char *path);
+
+// 解析格式串的参数类型，不支持时返回 -1
+int log_format_parse(const char *format, uint8_t *types, int max_types);
+
+// 按格式串地址查找（首次使用时登记）。format 必须是字符串字面量等生命周期
+// 贯穿进程的常量，表满时返回 NULL
+const LogFormatInfo *log_format_lookup(const char *format);
+const LogFormatInfo *log_format_get(uint32_t id);
+
+// 编码记录，返回字节数（缓冲区不足时返回 0）
+size_t log_binary_encode_event(uint8_t *buf, size_t size, LogLevel level, int64_t timestamp,
+                               const LogFormatInfo *info, va_list args);
+size_t log_binary_encode_text(uint8_t *buf, size_t size, LogLevel level, int64_t timestamp,
+                              const char *text, size_t length);
+size_t log_binary_encode_format(uint8_t *buf, size_t size, const LogFormatInfo *info);
+
+// 用进程内的格式串表把一条事件/文本记录渲染为文本行（含换行）
+size_t log_binary_record_to_line(const uint8_t *record, size_t length, int64_t wall_offset_ns,
+                                 char *out, size_t size);
+
+/* ---------------- 解码（logdump 与日志查看器使用） ---------------- */
+
+void log_binary_decoder_init(LogBinaryDecoder *decoder);
+void log_binary_decoder_free(LogBinaryDecoder *decoder);
+
+// 解码 data 开头的一条记录（或文件头）
+// 返回消耗的字节数；数据不完整返回 0；数据损坏返回 -1。
+// 若是一条日志事件则填充 event 并把 *has_event 置 1
+long log_binary_decode(LogBinaryDecoder *decoder, const uint8_t *data, size_t length,
+                       LogBinaryEvent *event, int *has_event);
+
+// log_binary_decode 返回 -1 后调用：返回应跳过的字节数（length > 0 时至少为 1），
+// 跳过后 data 处是下一个文件头或同步标记与校验和都正确的记录；候选记录
+// 不完整时也停在它的开头，由调用方补齐数据后再解码
+size_t log_binary_resync(LogBinaryDecoder *decoder, const uint8_t *data, size_t length);
+
+// 把事件格式化为 "[YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] msg\n"，返回长度
+size_t log_binary_format_line(const LogBinaryEvent *event, char *out, size_t size);
+
+// 格式化时间戳 "YYYY-MM-DD HH:MM:SS.mmm"
+void log_binary_format_time(int64_t wall_ns, char *out, size_t size);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include "../common_defs.h"
+
+// 单条记录内联存储的字节数，超长记录另行分配
+#define LOG_RING_INLINE_SIZE 448
+
+// 环形队列槽位（按缓存行对齐，避免生产者之间伪共享）
+typedef struct {
+    uint64_t sequence;      // 槽位状态序号（Vyukov 有界队列）
+    int level;              // 日志级别
+    uint32_t length;        // 文本长度（含换行）
+    char *heap_text;        // 超过内联大小时指向堆上的副本
+    char text[LOG_RING_INLINE_SIZE];
+} __attribute__((aligned(64))) LogRingSlot;
+
+// 多生产者单消费者的有界无锁队列
+// 生产者通过 CAS 抢占写入位置，消费者独占读取位置，不需要任何锁。
+typedef struct {
+    LogRingSlot *slots;
+    size_t capacity;        // 2 的幂
+    size_t mask;
+    uint64_t tail __attribute__((aligned(64)));  // 生产者写入位置
+    uint64_t head __attribute__((aligned(64)));  // 消费者读取位置
+} LogRing;
+
+// 初始化/销毁（capacity 会向上取整为 2 的幂）
+int log_ring_init(LogRing *ring, size_t capacity);
+void log_ring_destroy(LogRing *ring);
+
+// 生产者：写入一条记录，队列满时返回 SWK_ERROR，超长记录分配失败时返回
+// SWK_ERROR_OUT_OF_MEMORY（两种情况都不写入）
+int log_ring_push(LogRing *ring, int level, const char *text, size_t length);
+
+// 消费者：查看第 index 条已就绪的记录（从队头开始计数），未就绪返回 NULL
+LogRingSlot *log_ring_peek(LogRing *ring, size_t index);
+
+// 消费者：释放队头的 count 条记录
+void log_ring_release(LogRing *ring, size_t count);
+
+// 取得槽位中的文本
+static inline const char *log_ring_slot_text(const LogRingSlot *slot) {
+    return slot->heap_text ? slot->heap_text : slot->text;
+}
+
+#endif
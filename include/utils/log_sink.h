@@ -0,0 +1,64 @@
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+#include "../common_defs.h"
+#include "logger.h"
+
+// 日志输出端（汇点）
+//
+// 每条记录只在调用线程格式化一次（文本行或二进制记录），路由器把同一批
+// 记录分发给所有汇点；每个汇点按自己的级别过滤，再用一次系统调用写出整批。
+// 二进制格式下需要文本的汇点（终端、套接字、内存环）共用路由器渲染出的
+// 文本，不会各自重新格式化。
+
+#define LOG_MEMORY_LINE_SIZE 512     // 内存环中每条记录保留的最大字节数
+#define LOG_SOCKET_RETRY_NS 1000000000LL  // 流式套接字断开后的重连间隔
+
+// 交给汇点的一条记录
+typedef struct {
+    LogLevel level;
+    const char *data;        // 编码后的记录（文本行或二进制记录）
+    size_t length;
+    const char *text;        // 文本行（含换行）；文本格式下与 data 相同
+    size_t text_length;
+} LogSinkRecord;
+
+typedef struct LogSink LogSink;
+
+typedef struct {
+    const char *name;
+    int needs_text;          // 是否需要文本行（二进制格式下由路由器渲染）
+    // 写出一批记录，返回写出的条数
+    size_t (*write)(LogSink *sink, const LogSinkRecord *records, size_t count);
+    void (*destroy)(LogSink *sink);
+} LogSinkOps;
+
+struct LogSink {
+    const LogSinkOps *ops;
+    int enabled;
+    int min_level;           // 低于该级别的记录不写出
+    uint64_t written;        // 写出的记录数
+    uint64_t dropped;        // 发送失败丢弃的记录数
+};
+
+// 汇点是否接收该级别的记录
+static inline int log_sink_accepts(const LogSink *sink, LogLevel level) {
+    return sink && sink->enabled && (int)level >= sink->min_level;
+}
+
+// 终端：fd 为终端时按级别着色，否则输出纯文本
+LogSink *log_sink_tty_create(int fd);
+
+// unix 套接字：数据报或流式逐行发送文本，journal 模式按 journald 原生协议发送
+LogSink *log_sink_socket_create(const char *path, LogSocketMode mode);
+
+// 内存环：保留最近 capacity 条文本记录，供 TUI 读取
+LogSink *log_sink_memory_create(size_t capacity);
+
+// 读取序号不小于 cursor 的记录（过旧的从最早一条开始），返回下一次读取的序号
+// 与写入之间由调用方互斥（logger 持有自身的 mutex 调用），回调中不能写日志
+uint64_t log_sink_memory_read(LogSink *sink, uint64_t cursor, LogMemoryCallback callback, void *context);
+
+void log_sink_destroy(LogSink *sink);
+
+#endif
@@ -12,6 +12,90 @@ typedef enum {
     LOG_FATAL
 } LogLevel;
 
+// 子系统：各自可以设置独立于全局级别的运行时日志级别
+typedef enum {
+    LOG_SUBSYS_CORE,          // 主程序、工具函数与系统封装（log_message 使用）
+    LOG_SUBSYS_KERNEL,        // 内核管理、安装与回滚
+    LOG_SUBSYS_TUI,           // 界面与对话框
+    LOG_SUBSYS_MONITOR,       // 系统监控
+    LOG_SUBSYS_PLUGINS,       // 插件系统
+    LOG_SUBSYS_I18N,          // 国际化
+    LOG_SUBSYS_COUNT
+} LogSubsystem;
+
+// 异步模式下队列满时的处理策略
+typedef enum {
+    LOG_OVERFLOW_BLOCK,       // 等待写线程腾出空间
+    LOG_OVERFLOW_DROP_DEBUG,  // 丢弃 DEBUG 记录，其余级别等待
+    LOG_OVERFLOW_DROP         // 丢弃任何级别的记录并计数
+} LogOverflowPolicy;
+
+// 日志文件格式
+typedef enum {
+    LOG_FORMAT_TEXT,          // 每条记录格式化为一行文本
+    LOG_FORMAT_BINARY         // 延迟格式化的二进制记录，用 swikernel-logdump 还原
+} LogFileFormat;
+
+// 输出端（汇点）
+typedef enum {
+    LOG_SINK_FILE,            // 日志文件（轮转、二进制格式都只作用于它）
+    LOG_SINK_TTY,             // stderr，终端上才着色
+    LOG_SINK_SOCKET,          // unix 套接字（本地收集器或 journald）
+    LOG_SINK_MEMORY,          // 内存环，供 TUI 查看最近的日志
+    LOG_SINK_COUNT
+} LogSinkType;
+
+// 套接字汇点的发送方式
+typedef enum {
+    LOG_SOCKET_DGRAM,         // 每条记录一个数据报（文本行）
+    LOG_SOCKET_STREAM,        // 流式连接，逐行发送
+    LOG_SOCKET_JOURNAL        // journald 原生协议（/run/systemd/journal/socket）
+} LogSocketMode;
+
+// 内存环读取回调：line 为文本行（含换行）
+typedef void (*LogMemoryCallback)(LogLevel level, const char *line, size_t length, void *context);
+
+// 日志统计
+typedef struct {
+    uint64_t records_written;  // 已写入文件的记录数
+    uint64_t records_dropped;  // 队列满时丢弃的记录数
+    uint64_t bytes_written;    // 已写入文件的字节数
+    uint64_t rotations;        // 轮转次数
+    uint64_t queue_high_water; // 队列最高占用（仅异步模式）
+    uint64_t records_rate_limited; // 被调用点限流抑制的记录数
+    uint64_t records_coalesced;    // 合并为 "repeated N times" 的重复记录数
+    uint64_t sink_dropped;         // 套接字等汇点发送失败丢弃的记录数
+} LoggerStats;
+
+// 编译期最低级别：低于它的 SWK_LOG_* 调用连同参数求值一起被编译掉
+// 例如 make CFLAGS+=-DSWK_LOG_MIN_LEVEL=1 去掉全部 DEBUG 日志
+#ifndef SWK_LOG_MIN_LEVEL
+#define SWK_LOG_MIN_LEVEL 0
+#endif
+
+// 各子系统的生效级别（未单独设置的子系统跟随全局级别），只由 logger.c 写入
+extern uint8_t logger_thresholds[LOG_SUBSYS_COUNT];
+
+// 运行时检查只有一次比较和一个分支，不调用函数
+static inline int logger_enabled(LogSubsystem subsystem, LogLevel level) {
+    return (int)level >= (int)__atomic_load_n(&logger_thresholds[subsystem], __ATOMIC_RELAXED);
+}
+
+// 日志前端：级别为常量时编译期检查被折叠，未启用时参数不会被求值
+#define SWK_LOG(subsystem, level, ...) \
+    do { \
+        if ((level) >= SWK_LOG_MIN_LEVEL && \
+            __builtin_expect(logger_enabled((subsystem), (level)), 0)) { \
+            logger_emit((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define SWK_LOG_DEBUG(subsystem, ...) SWK_LOG(subsystem, LOG_DEBUG, __VA_ARGS__)
+#define SWK_LOG_INFO(subsystem, ...) SWK_LOG(subsystem, LOG_INFO, __VA_ARGS__)
+#define SWK_LOG_WARN(subsystem, ...) SWK_LOG(subsystem, LOG_WARNING, __VA_ARGS__)
+#define SWK_LOG_ERROR(subsystem, ...) SWK_LOG(subsystem, LOG_ERROR, __VA_ARGS__)
+#define SWK_LOG_FATAL(subsystem, ...) SWK_LOG(subsystem, LOG_FATAL, __VA_ARGS__)
+
 // 日志初始化
 int logger_init(const char *filename, LogLevel level, int rotate);
 void log_message(LogLevel level, const char *format, ...);
@@ -20,4 +104,65 @@ void logger_set_level(LogLevel level);
 LogLevel logger_get_level(void);
 void rotate_log_files(void);
 
-#endif
\ No newline at end of file
+// 写出一条已通过级别检查的记录（供 SWK_LOG 使用）
+void logger_emit(LogLevel level, const char *format, ...);
+
+// 子系统级别：level 为 -1 表示跟随全局级别
+int logger_set_subsystem_level(LogSubsystem subsystem, int level);
+int logger_get_subsystem_level(LogSubsystem subsystem);
+LogLevel logger_get_effective_level(LogSubsystem subsystem);
+const char *logger_subsystem_name(LogSubsystem subsystem);
+int logger_parse_subsystem(const char *name);
+
+// 解析级别名（DEBUG/INFO/WARN/WARNING/ERROR/FATAL）或数字，无法识别时返回 -1
+int logger_parse_level(const char *name);
+const char *logger_level_name(LogLevel level);
+
+// 轮转参数（文件大小上限，保留文件数）
+void logger_set_rotation(size_t max_size, int max_files);
+
+// 轮转出的日志段是否由后台线程压缩为可随机访问的 zstd 归档（需编译 zstd 支持）
+void logger_set_compression(int enabled);
+
+// 按调用点（格式串）的令牌桶限流：每秒 per_second 条，允许突发 burst 条
+// per_second 为 0 时关闭限流；FATAL 记录不受限制
+void logger_set_rate_limit(unsigned per_second, unsigned burst);
+
+// 合并连续的相同记录（忽略时间戳），由一条 "Last message repeated N times" 代替
+void logger_set_coalescing(int enabled);
+
+// 是否同时输出到 stderr（即启用/停用 tty 汇点）
+void logger_set_console(int enabled);
+
+// 汇点：各自的级别过滤（level 为 -1 表示停用），在全局/子系统级别之后生效
+int logger_set_sink_level(LogSinkType type, int level);
+int logger_get_sink_level(LogSinkType type);
+int logger_open_socket_sink(const char *path, LogSocketMode mode, LogLevel level);
+int logger_open_memory_sink(size_t capacity, LogLevel level);
+void logger_close_sink(LogSinkType type);
+int logger_parse_socket_mode(const char *name);
+const char *logger_socket_mode_name(LogSocketMode mode);
+
+// 读取内存环中序号不小于 cursor 的记录，返回下一次读取的序号（未开启时返回 cursor）
+uint64_t logger_memory_read(uint64_t cursor, LogMemoryCallback callback, void *context);
+
+// 文件格式（需在 logger_start_async 之前设置）
+// 二进制模式下 log_message 的格式串必须是字符串字面量
+int logger_set_format(LogFileFormat format);
+LogFileFormat logger_get_format(void);
+LogFileFormat logger_parse_format(const char *name);
+const char *logger_format_name(LogFileFormat format);
+
+// 异步模式：调用线程只格式化并入队，由后台写线程批量 writev 到文件
+int logger_start_async(size_t queue_size, LogOverflowPolicy policy);
+void logger_stop_async(void);
+int logger_is_async(void);
+
+// 等待已入队的记录全部写出，以及进行中的归档完成
+void logger_flush(void);
+
+void logger_get_stats(LoggerStats *stats);
+LogOverflowPolicy logger_parse_overflow_policy(const char *name);
+const char *logger_overflow_policy_name(LogOverflowPolicy policy);
+
+#endif
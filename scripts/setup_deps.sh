@@ -92,6 +92,7 @@ install_apt_deps() {
     local tool_deps=(
         "dialog"
         "ncurses-dev"
+        "libzstd-dev"
         "git"
         "wget"
         "curl"
@@ -141,6 +142,7 @@ install_yum_deps() {
     local tool_deps=(
         "dialog"
         "ncurses-devel"
+        "libzstd-devel"
         "git"
         "wget"
         "curl"
@@ -188,6 +190,7 @@ install_pacman_deps() {
     local tool_deps=(
         "dialog"
         "ncurses"
+        "zstd"
         "git"
         "wget"
         "curl"
@@ -0,0 +1,67 @@
+// src/asm_optimized/cpu_features.c
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#include "cpu_features.h"
+
+static CpuFeatures g_cpu_features;
+static pthread_once_t g_cpu_features_once = PTHREAD_ONCE_INIT;
+
+#if defined(__x86_64__) || defined(__i386__)
+// 读取 XCR0，确认操作系统保存了 YMM/ZMM 寄存器状态
+static uint64_t read_xcr0(void) {
+    uint32_t eax, edx;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+}
+#endif
+
+static void detect_cpu_features(void) {
+    CpuFeatures f;
+    memset(&f, 0, sizeof(f));
+    f.detected = 1;
+
+    const char *no_simd = getenv("SWIKERNEL_NO_SIMD");
+    if (no_simd && no_simd[0] == '1') {
+        g_cpu_features = f;
+        return;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int max_leaf = __get_cpuid_max(0, NULL);
+
+    if (max_leaf >= 1 && __get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        f.sse2 = (edx >> 26) & 1;
+        f.sse42 = (ecx >> 20) & 1;
+        f.pclmul = (ecx >> 1) & 1;
+
+        int osxsave = (ecx >> 27) & 1;
+        int avx = (ecx >> 28) & 1;
+        uint64_t xcr0 = osxsave ? read_xcr0() : 0;
+        int os_ymm = (xcr0 & 0x06) == 0x06;
+        int os_zmm = (xcr0 & 0xe6) == 0xe6;
+
+        if (max_leaf >= 7 && avx && os_ymm) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            f.avx2 = (ebx >> 5) & 1;
+            if (os_zmm) {
+                f.avx512f = (ebx >> 16) & 1;
+                f.avx512bw = (ebx >> 30) & 1;
+                f.avx512vl = (ebx >> 31) & 1;
+            }
+        }
+    }
+#endif
+
+    g_cpu_features = f;
+}
+
+// 获取 CPU 特性
+const CpuFeatures *cpu_features_get(void) {
+    pthread_once(&g_cpu_features_once, detect_cpu_features);
+    return &g_cpu_features;
+}
@@ -0,0 +1,326 @@
+// src/asm_optimized/crc32c.c
+// CRC32C (Castagnoli) 校验和
+//
+// 三种实现，运行时按 CPU 特性选择：
+//   slice-by-8  - 纯 C 查表实现，任何平台可用
+//   sse4.2      - crc32 指令三路交错，流合并使用移位查找表
+//   pclmul      - crc32 指令三路交错，流合并使用 pclmulqdq 乘法，
+//                 可以在中等长度的缓冲区上也保持三路并行
+// 参考 Intel 白皮书 "Fast CRC Computation for iSCSI Polynomial Using CRC32 Instruction"。
+#include <string.h>
+#include <pthread.h>
+#include "crc32c.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#define CRC32C_HAVE_X86 1
+#else
+#define CRC32C_HAVE_X86 0
+#endif
+
+#define CRC32C_POLY 0x82f63b78u   // 反射形式的 0x1EDC6F41
+
+// sse4.2 实现使用的两种交错块长度（每路字节数）
+#define CRC32C_LONG 8192
+#define CRC32C_SHORT 256
+
+// pclmul 实现的每路块长度：128 << i，i = 0..5
+#define CRC32C_PCL_BLOCKS 6
+#define CRC32C_PCL_MIN 128
+
+typedef uint32_t (*Crc32cFunc)(uint32_t crc, const void *data, size_t len);
+
+static uint32_t crc32c_table[8][256];
+static uint32_t crc32c_long_shift[4][256];
+static uint32_t crc32c_short_shift[4][256];
+static uint32_t crc32c_pcl_k1[CRC32C_PCL_BLOCKS]; // x^(8*b) mod P
+static uint32_t crc32c_pcl_k2[CRC32C_PCL_BLOCKS]; // x^(16*b) mod P
+
+static Crc32cFunc crc32c_impl = NULL;
+static const char *crc32c_impl_label = "slice-by-8";
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+
+// GF(2) 上模 P 乘法（反射表示，bit31 为 x^0）
+static uint32_t crc32c_multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = 1u << 31;
+    uint32_t p = 0;
+
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+    }
+
+    return p;
+}
+
+// 计算 x^(8*n) mod P，即 CRC 寄存器跨越 n 个零字节的移位算子
+static uint32_t crc32c_x8nmodp(size_t n) {
+    uint32_t p = 1u << 31;       // x^0
+    uint32_t sq = 1u << 23;      // x^8
+
+    while (n) {
+        if (n & 1) {
+            p = crc32c_multmodp(sq, p);
+        }
+        sq = crc32c_multmodp(sq, sq);
+        n >>= 1;
+    }
+
+    return p;
+}
+
+static void crc32c_build_shift_table(uint32_t table[4][256], size_t len) {
+    uint32_t op = crc32c_x8nmodp(len);
+
+    for (int k = 0; k < 4; k++) {
+        for (uint32_t n = 0; n < 256; n++) {
+            table[k][n] = crc32c_multmodp(op, n << (8 * k));
+        }
+    }
+}
+
+static inline uint32_t crc32c_shift(const uint32_t table[4][256], uint32_t crc) {
+    return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff] ^
+           table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+static void crc32c_init_tables(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = n;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+        }
+        crc32c_table[0][n] = crc;
+    }
+
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = crc32c_table[0][n];
+        for (int k = 1; k < 8; k++) {
+            crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
+            crc32c_table[k][n] = crc;
+        }
+    }
+
+    crc32c_build_shift_table(crc32c_long_shift, CRC32C_LONG);
+    crc32c_build_shift_table(crc32c_short_shift, CRC32C_SHORT);
+
+    for (int i = 0; i < CRC32C_PCL_BLOCKS; i++) {
+        size_t block = (size_t)CRC32C_PCL_MIN << i;
+        crc32c_pcl_k1[i] = crc32c_x8nmodp(block);
+        crc32c_pcl_k2[i] = crc32c_x8nmodp(block * 2);
+    }
+}
+
+// 选择实现
+static void crc32c_select_impl(void) {
+    crc32c_init_tables();
+
+    const CpuFeatures *cpu = cpu_features_get();
+    crc32c_impl = crc32c_sw;
+    crc32c_impl_label = "slice-by-8";
+
+#if CRC32C_HAVE_X86
+    if (cpu->sse42 && cpu->pclmul) {
+        crc32c_impl = crc32c_pclmul;
+        crc32c_impl_label = "pclmul";
+    } else if (cpu->sse42) {
+        crc32c_impl = crc32c_sse42;
+        crc32c_impl_label = "sse4.2";
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+// 计算 CRC32C
+uint32_t crc32c(uint32_t crc, const void *data, size_t len) {
+    pthread_once(&crc32c_once, crc32c_select_impl);
+    return crc32c_impl(crc, data, len);
+}
+
+// 获取当前实现名称
+const char *crc32c_impl_name(void) {
+    pthread_once(&crc32c_once, crc32c_select_impl);
+    return crc32c_impl_label;
+}
+
+// slice-by-8 查表实现
+uint32_t crc32c_sw(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = data;
+
+    pthread_once(&crc32c_once, crc32c_select_impl);
+    crc = ~crc;
+
+    while (len && ((uintptr_t)p & 7)) {
+        crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+        len--;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        word ^= crc;
+        crc = crc32c_table[7][word & 0xff] ^
+              crc32c_table[6][(word >> 8) & 0xff] ^
+              crc32c_table[5][(word >> 16) & 0xff] ^
+              crc32c_table[4][(word >> 24) & 0xff] ^
+              crc32c_table[3][(word >> 32) & 0xff] ^
+              crc32c_table[2][(word >> 40) & 0xff] ^
+              crc32c_table[1][(word >> 48) & 0xff] ^
+              crc32c_table[0][word >> 56];
+        p += 8;
+        len -= 8;
+    }
+#endif
+
+    while (len--) {
+        crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+#if CRC32C_HAVE_X86
+
+// 单路 crc32 指令循环（处理头尾和短缓冲区）
+__attribute__((target("sse4.2")))
+static inline uint64_t crc32c_hw_serial(uint64_t crc, const unsigned char *p, size_t len) {
+    while (len && ((uintptr_t)p & 7)) {
+        crc = _mm_crc32_u8((uint32_t)crc, *p++);
+        len--;
+    }
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        crc = _mm_crc32_u64(crc, word);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = _mm_crc32_u8((uint32_t)crc, *p++);
+    }
+    return crc;
+}
+
+// 三路交错：三条独立依赖链填满 crc32 指令的 3 周期延迟
+__attribute__((target("sse4.2")))
+static inline void crc32c_hw_3way(uint64_t *c0, uint64_t *c1, uint64_t *c2,
+                                  const unsigned char *p, size_t block) {
+    const unsigned char *end = p + block;
+    uint64_t crc0 = *c0, crc1 = *c1, crc2 = *c2;
+
+    while (p < end) {
+        uint64_t w0, w1, w2;
+        memcpy(&w0, p, 8);
+        memcpy(&w1, p + block, 8);
+        memcpy(&w2, p + 2 * block, 8);
+        crc0 = _mm_crc32_u64(crc0, w0);
+        crc1 = _mm_crc32_u64(crc1, w1);
+        crc2 = _mm_crc32_u64(crc2, w2);
+        p += 8;
+    }
+
+    *c0 = crc0;
+    *c1 = crc1;
+    *c2 = crc2;
+}
+
+// sse4.2 实现
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t crc0 = ~crc;
+
+    pthread_once(&crc32c_once, crc32c_select_impl);
+
+    // 对齐到 8 字节
+    while (len && ((uintptr_t)p & 7)) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *p++);
+        len--;
+    }
+
+    while (len >= 3 * CRC32C_LONG) {
+        uint64_t crc1 = 0, crc2 = 0;
+        crc32c_hw_3way(&crc0, &crc1, &crc2, p, CRC32C_LONG);
+        crc0 = crc32c_shift(crc32c_long_shift, (uint32_t)crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_long_shift, (uint32_t)crc0) ^ crc2;
+        p += 3 * CRC32C_LONG;
+        len -= 3 * CRC32C_LONG;
+    }
+
+    while (len >= 3 * CRC32C_SHORT) {
+        uint64_t crc1 = 0, crc2 = 0;
+        crc32c_hw_3way(&crc0, &crc1, &crc2, p, CRC32C_SHORT);
+        crc0 = crc32c_shift(crc32c_short_shift, (uint32_t)crc0) ^ crc1;
+        crc0 = crc32c_shift(crc32c_short_shift, (uint32_t)crc0) ^ crc2;
+        p += 3 * CRC32C_SHORT;
+        len -= 3 * CRC32C_SHORT;
+    }
+
+    return ~(uint32_t)crc32c_hw_serial(crc0, p, len);
+}
+
+// pclmul 实现：a * k mod P，乘积 64 位部分用 crc32 指令完成归约
+__attribute__((target("sse4.2,pclmul")))
+static inline uint32_t crc32c_clmul_reduce(__m128i product) {
+    product = _mm_slli_epi64(product, 1);
+    uint64_t r = (uint64_t)_mm_cvtsi128_si64(product);
+    return _mm_crc32_u32(0, (uint32_t)r) ^ (uint32_t)(r >> 32);
+}
+
+__attribute__((target("sse4.2,pclmul")))
+uint32_t crc32c_pclmul(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint64_t crc0 = ~crc;
+
+    pthread_once(&crc32c_once, crc32c_select_impl);
+
+    while (len && ((uintptr_t)p & 7)) {
+        crc0 = _mm_crc32_u8((uint32_t)crc0, *p++);
+        len--;
+    }
+
+    while (len >= 3 * CRC32C_PCL_MIN) {
+        int i = CRC32C_PCL_BLOCKS - 1;
+        while (((size_t)CRC32C_PCL_MIN << i) * 3 > len) {
+            i--;
+        }
+        size_t block = (size_t)CRC32C_PCL_MIN << i;
+
+        uint64_t crc1 = 0, crc2 = 0;
+        crc32c_hw_3way(&crc0, &crc1, &crc2, p, block);
+
+        // crc = crc0 * x^(16b) ^ crc1 * x^(8b) ^ crc2，两次乘积异或后只归约一次
+        __m128i m0 = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)(uint32_t)crc0),
+                                          _mm_cvtsi32_si128((int)crc32c_pcl_k2[i]), 0x00);
+        __m128i m1 = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)(uint32_t)crc1),
+                                          _mm_cvtsi32_si128((int)crc32c_pcl_k1[i]), 0x00);
+        crc0 = crc32c_clmul_reduce(_mm_xor_si128(m0, m1)) ^ (uint32_t)crc2;
+
+        p += 3 * block;
+        len -= 3 * block;
+    }
+
+    return ~(uint32_t)crc32c_hw_serial(crc0, p, len);
+}
+
+#else
+
+uint32_t crc32c_sse42(uint32_t crc, const void *data, size_t len) {
+    return crc32c_sw(crc, data, len);
+}
+
+uint32_t crc32c_pclmul(uint32_t crc, const void *data, size_t len) {
+    return crc32c_sw(crc, data, len);
+}
+
+#endif
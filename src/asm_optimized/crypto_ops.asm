@@ -1,38 +1,9 @@
 ; src/asm_optimized/crypto_ops.asm
 section .text
-    global simple_hash
     global xor_encrypt
-    global calculate_crc32
 
-; 简单哈希函数（用于内部使用，非加密安全）
-; unsigned int simple_hash(const char *data, size_t len)
-simple_hash:
-    push rbp
-    mov rbp, rsp
-    push rdi
-    push rsi
-    push rcx
-    push rbx
-    
-    mov rdi, [rbp + 16]  ; data
-    mov rcx, [rbp + 24]  ; len
-    xor rax, rax         ; 哈希值
-    xor rbx, rbx         ; 临时值
-    
-.hash_loop:
-    mov bl, [rdi]
-    add rax, rbx
-    rol rax, 13          ; 左旋转13位
-    xor rax, rbx
-    inc rdi
-    loop .hash_loop
-    
-    pop rbx
-    pop rcx
-    pop rsi
-    pop rdi
-    pop rbp
-    ret
+; simple_hash 已由 fast_hash.c 中的 fast_hash64 取代（64 位，短键内联，
+; 长输入按 CPU 特性分派 SIMD 实现）。
 
 ; XOR加密/解密
 ; void xor_encrypt(char *data, size_t len, const char *key, size_t key_len)
@@ -82,47 +53,5 @@ xor_encrypt:
     pop rbp
     ret
 
-; CRC32计算
-; unsigned int calculate_crc32(const unsigned char *data, size_t len)
-calculate_crc32:
-    push rbp
-    mov rbp, rsp
-    push rdi
-    push rsi
-    push rcx
-    push rbx
-    
-    mov rdi, [rbp + 16]  ; data
-    mov rcx, [rbp + 24]  ; len
-    mov rax, 0xFFFFFFFF  ; CRC初始值
-    
-    ; CRC32查找表（简化版，实际应使用完整表）
-    lea rbx, [crc_table]
-    
-.crc_loop:
-    mov dl, [rdi]
-    xor dl, al           ; dl = data ^ crc
-    
-    movzx rdx, dl
-    mov edx, [rbx + rdx * 4]
-    
-    shr eax, 8
-    xor eax, edx
-    
-    inc rdi
-    dec rcx
-    jnz .crc_loop
-    
-    not eax              ; 最终取反
-    
-    pop rbx
-    pop rcx
-    pop rsi
-    pop rdi
-    pop rbp
-    ret
-
-section .data
-crc_table:
-    dd 0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA
-    ; 简化的CRC表，实际应包含256个条目
\ No newline at end of file
+; CRC32C 校验和已移至 crc32c.c（sse4.2/pclmul/slice-by-8 运行时分派），
+; 原 calculate_crc32 只有 4 项查找表且从栈上读取参数，结果不正确。
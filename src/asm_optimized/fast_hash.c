@@ -0,0 +1,345 @@
+// src/asm_optimized/fast_hash.c
+// 64 位非加密哈希的中等长度与长输入路径
+//
+// 17..FAST_HASH_BULK_MIN 字节：wyhash 风格，每 48 字节三路独立的 64x64->128 乘法混合。
+// 更长的输入：XXH3 风格的 8 路 64 位累加器，每 64 字节一个条带，
+//   acc[i]   += lo32(d[i] ^ k[i]) * hi32(d[i] ^ k[i])
+//   acc[i^1] += d[i]
+// 每 16 个条带（1 KiB）做一次扰乱。这种形式只需 32x32->64 乘法，
+// 可以直接映射到 pmuludq，向量实现与标量实现逐位一致。
+#include <pthread.h>
+#include "fast_hash.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FAST_HASH_HAVE_X86 1
+#else
+#define FAST_HASH_HAVE_X86 0
+#endif
+
+#define FAST_HASH_BULK_MIN 512
+#define FAST_HASH_STRIPE 64
+#define FAST_HASH_STRIPES_PER_BLOCK 16
+#define FAST_HASH_BLOCK (FAST_HASH_STRIPE * FAST_HASH_STRIPES_PER_BLOCK)
+#define FAST_HASH_SCRAMBLE_KEY 16   // secret[16..23] 用于扰乱
+#define FAST_HASH_LAST_KEY 11       // 最后一个（可能重叠的）条带使用的密钥偏移
+#define FAST_HASH_PRIME32 0x9E3779B1ULL
+
+// splitmix64 生成的密钥；条带 s 使用 secret[s..s+7]
+static const uint64_t fast_hash_secret[24] = {
+    0xc984c1e98450239cULL, 0xf4f244e26420692aULL, 0x0532c1cc348dca84ULL,
+    0x7c6845d8fe7a4ed3ULL, 0x3da9636fc295126bULL, 0x8f0eb5cde91e11b2ULL,
+    0x4f5a1b5bb387f6ccULL, 0x9810733e65f6996cULL, 0xa3136542ac2feaf2ULL,
+    0xad69035df3100551ULL, 0x26615a2ae343f291ULL, 0xe44202a7f427d1d7ULL,
+    0x63b57756d723f842ULL, 0xd83e36f5701f1f5dULL, 0xf35cf34f76fa034dULL,
+    0xaa2f3d72600531e5ULL, 0xfbc6ea23f3bd812bULL, 0xe2a73d3b0dadf590ULL,
+    0x0f4de492eac8063aULL, 0xe9a9a652208d0877ULL, 0xa44fb94783708f80ULL,
+    0xa4977f14f6c621a1ULL, 0x35b9d9949eb8b34bULL, 0x9591d2312ec9348fULL,
+};
+
+typedef void (*FastHashStripesFunc)(uint64_t acc[8], const unsigned char *p, size_t stripes,
+                                    const uint64_t *secret);
+typedef void (*FastHashScrambleFunc)(uint64_t acc[8]);
+
+static inline uint64_t read64(const unsigned char *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+/* ---------------- 中等长度 ---------------- */
+
+static uint64_t hash_medium(const unsigned char *p, size_t len, uint64_t seed) {
+    size_t i = len;
+
+    seed ^= fast_hash_mix(seed ^ FAST_HASH_P0, FAST_HASH_P1);
+
+    if (i > 48) {
+        uint64_t s1 = seed;
+        uint64_t s2 = seed;
+        do {
+            seed = fast_hash_mix(read64(p) ^ FAST_HASH_P1, read64(p + 8) ^ seed);
+            s1 = fast_hash_mix(read64(p + 16) ^ FAST_HASH_P2, read64(p + 24) ^ s1);
+            s2 = fast_hash_mix(read64(p + 32) ^ FAST_HASH_P3, read64(p + 40) ^ s2);
+            p += 48;
+            i -= 48;
+        } while (i > 48);
+        seed ^= s1 ^ s2;
+    }
+
+    while (i > 16) {
+        seed = fast_hash_mix(read64(p) ^ FAST_HASH_P1, read64(p + 8) ^ seed);
+        p += 16;
+        i -= 16;
+    }
+
+    return fast_hash_finish(read64(p + i - 16), read64(p + i - 8), seed, len);
+}
+
+/* ---------------- 长输入公共部分 ---------------- */
+
+static uint64_t hash_long(const unsigned char *p, size_t len, uint64_t seed,
+                          FastHashStripesFunc stripes, FastHashScrambleFunc scramble) {
+    uint64_t acc[8] = {
+        FAST_HASH_P0 ^ seed, FAST_HASH_P1, FAST_HASH_P2 ^ seed, FAST_HASH_P3,
+        FAST_HASH_P0, FAST_HASH_P1 ^ seed, FAST_HASH_P2, FAST_HASH_P3 ^ seed
+    };
+    size_t blocks = (len - 1) / FAST_HASH_BLOCK;
+
+    for (size_t b = 0; b < blocks; b++) {
+        stripes(acc, p + b * FAST_HASH_BLOCK, FAST_HASH_STRIPES_PER_BLOCK, fast_hash_secret);
+        scramble(acc);
+    }
+
+    size_t tail = (len - 1) - blocks * FAST_HASH_BLOCK;
+    stripes(acc, p + blocks * FAST_HASH_BLOCK, tail / FAST_HASH_STRIPE, fast_hash_secret);
+    stripes(acc, p + len - FAST_HASH_STRIPE, 1, fast_hash_secret + FAST_HASH_LAST_KEY);
+
+    uint64_t h = len * FAST_HASH_P0 ^ seed;
+    h += fast_hash_mix(acc[0] ^ FAST_HASH_P0, acc[1] ^ FAST_HASH_P1);
+    h += fast_hash_mix(acc[2] ^ FAST_HASH_P2, acc[3] ^ FAST_HASH_P3);
+    h += fast_hash_mix(acc[4] ^ FAST_HASH_P1, acc[5] ^ FAST_HASH_P2);
+    h += fast_hash_mix(acc[6] ^ FAST_HASH_P3, acc[7] ^ FAST_HASH_P0);
+
+    return fast_hash_mix(h ^ (h >> 32) ^ FAST_HASH_P2, seed ^ FAST_HASH_P3);
+}
+
+// 各实现的完整入口（任意长度），短键与中等长度路径与 fast_hash64 相同
+static inline uint64_t hash_any(const void *key, size_t len, uint64_t seed,
+                                FastHashStripesFunc stripes, FastHashScrambleFunc scramble) {
+    if (len <= FAST_HASH_INLINE_MAX) {
+        return fast_hash64(key, len, seed);
+    }
+    if (len < FAST_HASH_BULK_MIN) {
+        return hash_medium(key, len, seed);
+    }
+    return hash_long(key, len, seed, stripes, scramble);
+}
+
+/* ---------------- scalar ---------------- */
+
+static void stripes_scalar(uint64_t acc[8], const unsigned char *p, size_t stripes,
+                           const uint64_t *secret) {
+    for (size_t s = 0; s < stripes; s++) {
+        const unsigned char *q = p + s * FAST_HASH_STRIPE;
+        for (int i = 0; i < 8; i++) {
+            uint64_t data = read64(q + 8 * i);
+            uint64_t key = data ^ secret[s + i];
+            acc[i ^ 1] += data;
+            acc[i] += (key & 0xffffffffULL) * (key >> 32);
+        }
+    }
+}
+
+static void scramble_scalar(uint64_t acc[8]) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= fast_hash_secret[FAST_HASH_SCRAMBLE_KEY + i];
+        acc[i] = a * FAST_HASH_PRIME32;
+    }
+}
+
+static uint64_t hash_scalar(const void *key, size_t len, uint64_t seed) {
+    return hash_any(key, len, seed, stripes_scalar, scramble_scalar);
+}
+
+#if FAST_HASH_HAVE_X86
+
+/* ---------------- sse2 ---------------- */
+
+__attribute__((target("sse2")))
+static void stripes_sse2(uint64_t acc[8], const unsigned char *p, size_t stripes,
+                         const uint64_t *secret) {
+    __m128i a[4];
+
+    for (int i = 0; i < 4; i++) {
+        a[i] = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+    }
+
+    for (size_t s = 0; s < stripes; s++) {
+        const unsigned char *q = p + s * FAST_HASH_STRIPE;
+        for (int i = 0; i < 4; i++) {
+            __m128i data = _mm_loadu_si128((const __m128i *)(q + 16 * i));
+            __m128i key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i *)(secret + s + 2 * i)));
+            __m128i prod = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));
+            __m128i swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            a[i] = _mm_add_epi64(a[i], _mm_add_epi64(prod, swap));
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i *)(acc + 2 * i), a[i]);
+    }
+}
+
+__attribute__((target("sse2")))
+static void scramble_sse2(uint64_t acc[8]) {
+    const __m128i prime = _mm_set1_epi32((int)FAST_HASH_PRIME32);
+
+    for (int i = 0; i < 4; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(acc + 2 * i));
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *)(fast_hash_secret + FAST_HASH_SCRAMBLE_KEY + 2 * i)));
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+        _mm_storeu_si128((__m128i *)(acc + 2 * i), _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+    }
+}
+
+static uint64_t hash_sse2(const void *key, size_t len, uint64_t seed) {
+    return hash_any(key, len, seed, stripes_sse2, scramble_sse2);
+}
+
+/* ---------------- avx2 ---------------- */
+
+__attribute__((target("avx2")))
+static void stripes_avx2(uint64_t acc[8], const unsigned char *p, size_t stripes,
+                         const uint64_t *secret) {
+    __m256i a0 = _mm256_loadu_si256((const __m256i *)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i *)(acc + 4));
+
+    for (size_t s = 0; s < stripes; s++) {
+        const unsigned char *q = p + s * FAST_HASH_STRIPE;
+        __m256i d0 = _mm256_loadu_si256((const __m256i *)q);
+        __m256i d1 = _mm256_loadu_si256((const __m256i *)(q + 32));
+        __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i *)(secret + s)));
+        __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i *)(secret + s + 4)));
+        __m256i p0 = _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32));
+        __m256i p1 = _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32));
+        a0 = _mm256_add_epi64(a0, _mm256_add_epi64(p0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+        a1 = _mm256_add_epi64(a1, _mm256_add_epi64(p1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+
+    _mm256_storeu_si256((__m256i *)acc, a0);
+    _mm256_storeu_si256((__m256i *)(acc + 4), a1);
+}
+
+__attribute__((target("avx2")))
+static void scramble_avx2(uint64_t acc[8]) {
+    const __m256i prime = _mm256_set1_epi32((int)FAST_HASH_PRIME32);
+
+    for (int i = 0; i < 2; i++) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(acc + 4 * i));
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i *)(fast_hash_secret + FAST_HASH_SCRAMBLE_KEY + 4 * i)));
+        __m256i lo = _mm256_mul_epu32(a, prime);
+        __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+        _mm256_storeu_si256((__m256i *)(acc + 4 * i), _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+    }
+}
+
+static uint64_t hash_avx2(const void *key, size_t len, uint64_t seed) {
+    return hash_any(key, len, seed, stripes_avx2, scramble_avx2);
+}
+
+/* ---------------- avx512 ---------------- */
+
+__attribute__((target("avx512f")))
+static void stripes_avx512(uint64_t acc[8], const unsigned char *p, size_t stripes,
+                           const uint64_t *secret) {
+    __m512i a = _mm512_loadu_si512(acc);
+
+    for (size_t s = 0; s < stripes; s++) {
+        __m512i d = _mm512_loadu_si512(p + s * FAST_HASH_STRIPE);
+        __m512i k = _mm512_xor_si512(d, _mm512_loadu_si512(secret + s));
+        __m512i prod = _mm512_mul_epu32(k, _mm512_srli_epi64(k, 32));
+        a = _mm512_add_epi64(a, _mm512_add_epi64(prod, _mm512_shuffle_epi32(d, _MM_PERM_BADC)));
+    }
+
+    _mm512_storeu_si512(acc, a);
+}
+
+__attribute__((target("avx512f")))
+static void scramble_avx512(uint64_t acc[8]) {
+    const __m512i prime = _mm512_set1_epi32((int)FAST_HASH_PRIME32);
+    __m512i a = _mm512_loadu_si512(acc);
+
+    a = _mm512_xor_si512(a, _mm512_srli_epi64(a, 47));
+    a = _mm512_xor_si512(a, _mm512_loadu_si512(fast_hash_secret + FAST_HASH_SCRAMBLE_KEY));
+    __m512i lo = _mm512_mul_epu32(a, prime);
+    __m512i hi = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), prime);
+    _mm512_storeu_si512(acc, _mm512_add_epi64(lo, _mm512_slli_epi64(hi, 32)));
+}
+
+static uint64_t hash_avx512(const void *key, size_t len, uint64_t seed) {
+    return hash_any(key, len, seed, stripes_avx512, scramble_avx512);
+}
+
+#endif
+
+/* ---------------- 分派 ---------------- */
+
+#define FAST_HASH_IMPL_COUNT 4
+
+static FastHashImpl g_fast_hash_impls[FAST_HASH_IMPL_COUNT] = {
+    {"scalar", 1, hash_scalar},
+#if FAST_HASH_HAVE_X86
+    {"sse2", 0, hash_sse2},
+    {"avx2", 0, hash_avx2},
+    {"avx512", 0, hash_avx512},
+#else
+    {"sse2", 0, hash_scalar},
+    {"avx2", 0, hash_scalar},
+    {"avx512", 0, hash_scalar},
+#endif
+};
+
+static const FastHashImpl *g_fast_hash_active = &g_fast_hash_impls[0];
+static pthread_once_t g_fast_hash_once = PTHREAD_ONCE_INIT;
+
+static uint64_t hash_resolve(const void *key, size_t len, uint64_t seed);
+
+// 首次调用经过 resolve 存根，之后直接跳转到选中的实现
+static uint64_t (*g_fast_hash_ptr)(const void *, size_t, uint64_t) = hash_resolve;
+
+static void fast_hash_select(void) {
+    const CpuFeatures *cpu = cpu_features_get();
+    const FastHashImpl *best = &g_fast_hash_impls[0];
+
+#if FAST_HASH_HAVE_X86
+    g_fast_hash_impls[1].available = cpu->sse2;
+    g_fast_hash_impls[2].available = cpu->avx2;
+    g_fast_hash_impls[3].available = cpu->avx2 && cpu->avx512f;
+#else
+    (void)cpu;
+#endif
+
+    for (int i = 0; i < FAST_HASH_IMPL_COUNT; i++) {
+        if (g_fast_hash_impls[i].available) {
+            best = &g_fast_hash_impls[i];
+        }
+    }
+
+    g_fast_hash_active = best;
+    __atomic_store_n(&g_fast_hash_ptr, best->hash_fn, __ATOMIC_RELEASE);
+}
+
+static uint64_t hash_resolve(const void *key, size_t len, uint64_t seed) {
+    pthread_once(&g_fast_hash_once, fast_hash_select);
+    return g_fast_hash_active->hash_fn(key, len, seed);
+}
+
+// 长度大于 FAST_HASH_INLINE_MAX 的输入
+uint64_t fast_hash64_long(const void *key, size_t len, uint64_t seed) {
+    if (len < FAST_HASH_BULK_MIN) {
+        return hash_medium(key, len, seed);
+    }
+    return __atomic_load_n(&g_fast_hash_ptr, __ATOMIC_ACQUIRE)(key, len, seed);
+}
+
+// 当前选中的实现名称
+const char *fast_hash_impl_name(void) {
+    pthread_once(&g_fast_hash_once, fast_hash_select);
+    return g_fast_hash_active->name;
+}
+
+// 获取全部实现
+int fast_hash_get_impls(const FastHashImpl **impls) {
+    pthread_once(&g_fast_hash_once, fast_hash_select);
+    if (impls) {
+        *impls = g_fast_hash_impls;
+    }
+    return FAST_HASH_IMPL_COUNT;
+}
@@ -0,0 +1,350 @@
+// src/asm_optimized/simd_string.c
+// 运行时分派的字符串/内存操作
+//
+// strlen/memchr_all 各提供 scalar、sse2、avx2、avx512 四个版本，启动后第一次
+// 调用时根据 cpuid 选定一次，之后通过函数指针直接调用。strstr/memcmp/memset
+// 直接使用 libc。
+// 向量版本的 strlen 只做按组对齐的加载，读取不会跨越页边界；其余函数
+// 只访问 [ptr, ptr + n) 范围内的内存。
+#include <string.h>
+#include <pthread.h>
+#include "simd_string.h"
+#include "cpu_features.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STRING_OPS_HAVE_X86 1
+#else
+#define STRING_OPS_HAVE_X86 0
+#endif
+
+// 对齐读取可能越过字符串结尾（但不会越过页），需要对 ASan 关闭检查
+#if defined(__SANITIZE_ADDRESS__)
+#define STRING_OPS_NO_ASAN __attribute__((no_sanitize_address))
+#else
+#define STRING_OPS_NO_ASAN
+#endif
+
+#define ONES_64 0x0101010101010101ULL
+#define HIGHS_64 0x8080808080808080ULL
+
+/* ---------------- scalar ---------------- */
+
+static inline int has_zero_byte(uint64_t v) {
+    return ((v - ONES_64) & ~v & HIGHS_64) != 0;
+}
+
+STRING_OPS_NO_ASAN
+static size_t strlen_scalar(const char *str) {
+    const char *p = str;
+
+    while ((uintptr_t)p & 7) {
+        if (*p == '\0') {
+            return (size_t)(p - str);
+        }
+        p++;
+    }
+
+    for (;;) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        if (has_zero_byte(v)) {
+            break;
+        }
+        p += 8;
+    }
+
+    while (*p) {
+        p++;
+    }
+
+    return (size_t)(p - str);
+}
+
+// 逐字节处理剩余部分，out 写满时停下
+static inline size_t memchr_all_tail(const unsigned char *p, size_t i, size_t n, int c, uint64_t base,
+                                     uint64_t *out, size_t count, size_t max, size_t *scanned) {
+    for (; i < n; i++) {
+        if (p[i] == (unsigned char)c) {
+            if (count == max) {
+                break;
+            }
+            out[count++] = base + i;
+        }
+    }
+
+    *scanned = i;
+    return count;
+}
+
+static size_t memchr_all_scalar(const void *data, size_t n, int c, uint64_t base,
+                                uint64_t *out, size_t max, size_t *scanned) {
+    const unsigned char *p = data;
+    size_t count = 0, i = 0;
+
+    // 稀疏匹配（如日志中的换行）交给 libc memchr 跳跃查找
+    while (i < n && count < max) {
+        const unsigned char *hit = memchr(p + i, c, n - i);
+        if (!hit) {
+            i = n;
+            break;
+        }
+        out[count++] = base + (uint64_t)(hit - p);
+        i = (size_t)(hit - p) + 1;
+    }
+
+    *scanned = i;
+    return count;
+}
+
+#if STRING_OPS_HAVE_X86
+
+/* ---------------- sse2 ---------------- */
+
+STRING_OPS_NO_ASAN __attribute__((target("sse2")))
+static size_t strlen_sse2(const char *str) {
+    const char *p = (const char *)((uintptr_t)str & ~(uintptr_t)15);
+    const __m128i zero = _mm_setzero_si128();
+
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p), zero));
+    mask >>= (str - p);
+    if (mask) {
+        return __builtin_ctz(mask);
+    }
+
+    for (;;) {
+        p += 16;
+        mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i *)p), zero));
+        if (mask) {
+            return (size_t)(p - str) + __builtin_ctz(mask);
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+static size_t memchr_all_sse2(const void *data, size_t n, int c, uint64_t base,
+                              uint64_t *out, size_t max, size_t *scanned) {
+    const unsigned char *p = data;
+    const __m128i needle = _mm_set1_epi8((char)c);
+    size_t count = 0, i = 0;
+
+    for (; i + 16 <= n && max - count >= 16; i += 16) {
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), needle));
+        while (mask) {
+            out[count++] = base + i + (uint64_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return memchr_all_tail(p, i, n, c, base, out, count, max, scanned);
+}
+
+/* ---------------- avx2 ---------------- */
+
+STRING_OPS_NO_ASAN __attribute__((target("avx2")))
+static size_t strlen_avx2(const char *str) {
+    const char *p = (const char *)((uintptr_t)str & ~(uintptr_t)31);
+    const __m256i zero = _mm256_setzero_si256();
+
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+    mask >>= (str - p);
+    if (mask) {
+        return __builtin_ctz(mask);
+    }
+
+    // 逐个向量推进到 128 字节对齐，保证后面成组读取不会跨页
+    p += 32;
+    while ((uintptr_t)p & 127) {
+        mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i *)p), zero));
+        if (mask) {
+            return (size_t)(p - str) + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+
+    // 每次检查四个向量，min 合并后只做一次比较
+    for (;;) {
+        __m256i a = _mm256_load_si256((const __m256i *)p);
+        __m256i b = _mm256_load_si256((const __m256i *)(p + 32));
+        __m256i c = _mm256_load_si256((const __m256i *)(p + 64));
+        __m256i d = _mm256_load_si256((const __m256i *)(p + 96));
+        __m256i m = _mm256_min_epu8(_mm256_min_epu8(a, b), _mm256_min_epu8(c, d));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(m, zero))) {
+            uint64_t ab = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, zero)) |
+                          ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, zero)) << 32);
+            if (ab) {
+                return (size_t)(p - str) + __builtin_ctzll(ab);
+            }
+            uint64_t cd = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, zero)) |
+                          ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(d, zero)) << 32);
+            return (size_t)(p - str) + 64 + __builtin_ctzll(cd);
+        }
+        p += 128;
+    }
+}
+
+__attribute__((target("avx2")))
+static size_t memchr_all_avx2(const void *data, size_t n, int c, uint64_t base,
+                              uint64_t *out, size_t max, size_t *scanned) {
+    const unsigned char *p = data;
+    const __m256i needle = _mm256_set1_epi8((char)c);
+    size_t count = 0, i = 0;
+
+    for (; i + 64 <= n && max - count >= 64; i += 64) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i)), needle);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i + 32)), needle);
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(a) |
+                        ((uint64_t)(uint32_t)_mm256_movemask_epi8(b) << 32);
+        while (mask) {
+            out[count++] = base + i + (uint64_t)__builtin_ctzll(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return memchr_all_tail(p, i, n, c, base, out, count, max, scanned);
+}
+
+/* ---------------- avx512 ---------------- */
+
+STRING_OPS_NO_ASAN __attribute__((target("avx512f,avx512bw")))
+static size_t strlen_avx512(const char *str) {
+    const char *p = (const char *)((uintptr_t)str & ~(uintptr_t)63);
+    const __m512i zero = _mm512_setzero_si512();
+
+    uint64_t mask = _mm512_cmpeq_epi8_mask(_mm512_load_si512((const void *)p), zero);
+    mask >>= (str - p);
+    if (mask) {
+        return __builtin_ctzll(mask);
+    }
+
+    for (;;) {
+        p += 64;
+        mask = _mm512_cmpeq_epi8_mask(_mm512_load_si512((const void *)p), zero);
+        if (mask) {
+            return (size_t)(p - str) + __builtin_ctzll(mask);
+        }
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t memchr_all_avx512(const void *data, size_t n, int c, uint64_t base,
+                                uint64_t *out, size_t max, size_t *scanned) {
+    const unsigned char *p = data;
+    const __m512i needle = _mm512_set1_epi8((char)c);
+    size_t count = 0, i = 0;
+
+    for (; i + 64 <= n && max - count >= 64; i += 64) {
+        uint64_t mask = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512((const void *)(p + i)), needle);
+        while (mask) {
+            out[count++] = base + i + (uint64_t)__builtin_ctzll(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return memchr_all_tail(p, i, n, c, base, out, count, max, scanned);
+}
+
+#endif
+
+/* ---------------- 分派 ---------------- */
+
+static StringOpsImpl g_string_ops_impls[] = {
+    {"scalar", 1, strlen_scalar, memchr_all_scalar},
+#if STRING_OPS_HAVE_X86
+    {"sse2", 0, strlen_sse2, memchr_all_sse2},
+    {"avx2", 0, strlen_avx2, memchr_all_avx2},
+    {"avx512", 0, strlen_avx512, memchr_all_avx512},
+#endif
+};
+
+#define STRING_OPS_IMPL_COUNT ((int)(sizeof(g_string_ops_impls) / sizeof(g_string_ops_impls[0])))
+
+static const StringOpsImpl *g_string_ops_active = &g_string_ops_impls[0];
+static pthread_once_t g_string_ops_once = PTHREAD_ONCE_INIT;
+
+static size_t strlen_resolve(const char *str);
+static size_t memchr_all_resolve(const void *data, size_t n, int c, uint64_t base,
+                                 uint64_t *out, size_t max, size_t *scanned);
+
+// 首次调用经过 resolve 存根，之后直接跳转到选中的实现
+static size_t (*g_strlen_ptr)(const char *) = strlen_resolve;
+static size_t (*g_memchr_all_ptr)(const void *, size_t, int, uint64_t, uint64_t *, size_t, size_t *) =
+    memchr_all_resolve;
+
+static void string_ops_select(void) {
+    const CpuFeatures *cpu = cpu_features_get();
+    const StringOpsImpl *best = &g_string_ops_impls[0];
+
+#if STRING_OPS_HAVE_X86
+    g_string_ops_impls[1].available = cpu->sse2;
+    g_string_ops_impls[2].available = cpu->avx2;
+    g_string_ops_impls[3].available = cpu->avx2 && cpu->avx512f && cpu->avx512bw;
+#else
+    (void)cpu;
+#endif
+
+    for (int i = 0; i < STRING_OPS_IMPL_COUNT; i++) {
+        if (g_string_ops_impls[i].available) {
+            best = &g_string_ops_impls[i];
+        }
+    }
+
+    g_string_ops_active = best;
+    __atomic_store_n(&g_strlen_ptr, best->strlen_fn, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_memchr_all_ptr, best->memchr_all_fn, __ATOMIC_RELEASE);
+}
+
+static size_t strlen_resolve(const char *str) {
+    pthread_once(&g_string_ops_once, string_ops_select);
+    return g_string_ops_active->strlen_fn(str);
+}
+
+static size_t memchr_all_resolve(const void *data, size_t n, int c, uint64_t base,
+                                 uint64_t *out, size_t max, size_t *scanned) {
+    pthread_once(&g_string_ops_once, string_ops_select);
+    return g_string_ops_active->memchr_all_fn(data, n, c, base, out, max, scanned);
+}
+
+// 快速字符串长度计算
+size_t fast_strlen(const char *str) {
+    return __atomic_load_n(&g_strlen_ptr, __ATOMIC_ACQUIRE)(str);
+}
+
+// 快速子字符串查找
+// 首尾字符过滤的 SIMD 版本需要先对两个字符串求长度，实测在各个长度上都
+// 慢于 glibc 自带的 ifunc 版本（two-way + 向量化），因此直接使用 libc。
+char *fast_strstr(const char *haystack, const char *needle) {
+    return strstr(haystack, needle);
+}
+
+// 快速内存比较与设置
+// 各向量版本在基准中都没有稳定胜过 glibc（memset 在 8 B 与 512 B 上更慢，
+// memcmp 互有胜负），因此直接使用 libc。
+int fast_memcmp(const void *s1, const void *s2, size_t n) {
+    return memcmp(s1, s2, n);
+}
+
+void *fast_memset(void *ptr, int value, size_t n) {
+    return memset(ptr, value, n);
+}
+
+// 批量查找字节位置
+size_t fast_memchr_all(const void *data, size_t n, int c, uint64_t base,
+                       uint64_t *out, size_t max, size_t *scanned) {
+    return __atomic_load_n(&g_memchr_all_ptr, __ATOMIC_ACQUIRE)(data, n, c, base, out, max, scanned);
+}
+
+// 获取当前实现名称
+const char *string_ops_impl_name(void) {
+    pthread_once(&g_string_ops_once, string_ops_select);
+    return g_string_ops_active->name;
+}
+
+// 获取全部实现
+int string_ops_get_impls(const StringOpsImpl **impls) {
+    pthread_once(&g_string_ops_once, string_ops_select);
+    if (impls) {
+        *impls = g_string_ops_impls;
+    }
+    return STRING_OPS_IMPL_COUNT;
+}
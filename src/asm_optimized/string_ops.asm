@@ -2,9 +2,7 @@
 section .text
     global asm_string_match
     global fast_memcpy
-    global fast_strlen
     global fast_strcmp
-    global fast_strstr
 
 ; 快速字符串前缀匹配:cite[1]
 ; int asm_string_match(const char *str, const char *prefix)
@@ -100,27 +98,6 @@ fast_memcpy:
     pop rbp
     ret
 
-; 快速字符串长度计算
-; size_t fast_strlen(const char *str)
-fast_strlen:
-    push rbp
-    mov rbp, rsp
-    push rdi
-    
-    mov rdi, [rbp + 16]  ; str
-    xor rax, rax         ; 计数器清零
-    
-.test_char:
-    cmp byte [rdi + rax], 0
-    je .done
-    inc rax
-    jmp .test_char
-    
-.done:
-    pop rdi
-    pop rbp
-    ret
-
 ; 快速字符串比较
 ; int fast_strcmp(const char *s1, const char *s2)
 fast_strcmp:
@@ -158,70 +135,5 @@ fast_strcmp:
     pop rbp
     ret
 
-; 快速子字符串查找
-; char* fast_strstr(const char *haystack, const char *needle)
-fast_strstr:
-    push rbp
-    mov rbp, rsp
-    push rdi
-    push rsi
-    push rbx
-    
-    mov rdi, [rbp + 16]  ; haystack
-    mov rsi, [rbp + 24]  ; needle
-    
-    ; 检查空指针
-    test rdi, rdi
-    jz .not_found
-    test rsi, rsi
-    jz .not_found
-    
-    ; 获取 needle 长度
-    mov rdx, rsi
-    call fast_strlen
-    mov rcx, rax         ; needle 长度
-    test rcx, rcx
-    jz .empty_needle
-    
-    ; 主搜索循环
-.search_loop:
-    mov al, [rdi]
-    test al, al
-    jz .not_found
-    
-    ; 比较当前位置
-    mov rbx, rdi
-    mov rdx, rsi
-    mov r8, rcx
-    
-.compare:
-    mov al, [rbx]
-    mov ah, [rdx]
-    cmp al, ah
-    jne .next_char
-    inc rbx
-    inc rdx
-    dec r8
-    jnz .compare
-    
-    ; 找到匹配
-    mov rax, rdi
-    jmp .done
-    
-.next_char:
-    inc rdi
-    jmp .search_loop
-    
-.empty_needle:
-    mov rax, rdi
-    jmp .done
-    
-.not_found:
-    xor rax, rax
-    
-.done:
-    pop rbx
-    pop rsi
-    pop rdi
-    pop rbp
-    ret
\ No newline at end of file
+; fast_strlen 已移至 simd_string.c（sse2/avx2/avx512 运行时分派，带标量回退）；
+; fast_strstr 实测慢于 glibc，直接使用 libc 实现。
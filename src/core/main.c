@@ -1,6 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
 #include <pthread.h>
 #include "swikernel.h"
 #include "logger.h"
@@ -21,13 +25,69 @@ void execute_rollback(void) {
     log_message(LOG_INFO, "Rollback completed");
 }
 
-// 信号处理函数
+// 信号处理
+// 处理函数里只能调用异步信号安全的函数：记下信号并写一个字节到管道，
+// 由 signal_watcher 线程在普通上下文中记录日志、回滚、冲刷日志队列并退出。
+static volatile sig_atomic_t g_signal_received = 0;
+static int g_signal_pipe[2] = {-1, -1};
+
 void signal_handler(int sig) {
-    log_message(LOG_INFO, "Received signal %d, cleaning up...", sig);
+    int saved_errno = errno;
+    unsigned char byte = (unsigned char)sig;
+
+    // 清理还没完成时再次收到信号，或者没有监视线程：直接退出
+    if (!g_signal_received) {
+        g_signal_received = sig;
+        if (g_signal_pipe[1] >= 0 && write(g_signal_pipe[1], &byte, 1) == 1) {
+            errno = saved_errno;
+            return;
+        }
+    }
+
+    static const char message[] = "swikernel: interrupted, exiting without cleanup\n";
+    ssize_t ignored = write(STDERR_FILENO, message, sizeof(message) - 1);
+    (void)ignored;
+    _exit(128 + sig);
+}
+
+static void *signal_watcher(void *arg) {
+    unsigned char byte;
+    ssize_t n;
+
+    (void)arg;
+    do {
+        n = read(g_signal_pipe[0], &byte, 1);
+    } while (n < 0 && errno == EINTR);
+    if (n != 1) {
+        return NULL;
+    }
+
+    log_message(LOG_INFO, "Received signal %d, cleaning up...", byte);
     execute_rollback();
+    logger_flush();
     exit(1);
 }
 
+// 创建管道与监视线程后再注册处理函数；失败时处理函数退化为直接退出
+static void install_signal_handlers(void) {
+    pthread_t thread;
+
+    if (pipe(g_signal_pipe) != 0) {
+        g_signal_pipe[0] = g_signal_pipe[1] = -1;
+    } else if (fcntl(g_signal_pipe[0], F_SETFD, FD_CLOEXEC) != 0 ||
+               fcntl(g_signal_pipe[1], F_SETFD, FD_CLOEXEC) != 0 ||
+               pthread_create(&thread, NULL, signal_watcher, NULL) != 0) {
+        close(g_signal_pipe[0]);
+        close(g_signal_pipe[1]);
+        g_signal_pipe[0] = g_signal_pipe[1] = -1;
+    } else {
+        pthread_detach(thread);
+    }
+
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+}
+
 // 命令行参数解析
 int parse_arguments(int argc, char *argv[]) {
     if (argc == 1) {
@@ -93,14 +153,41 @@ int main(int argc, char *argv[]) {
     FEEDBACK_INFO(_("program_started"), _("swikernel_started_version"), SWIKERNEL_VERSION);
     
     // 注册信号处理
-    signal(SIGINT, signal_handler);
-    signal(SIGTERM, signal_handler);
+    install_signal_handlers();
     
     // 加载配置
     if (load_config(&g_config) != 0) {
         log_message(LOG_WARNING, "Using default configuration");
         set_default_config(&g_config);
     }
+
+    // 全局与各子系统的日志级别
+    apply_log_levels(&g_config);
+
+    // 输出端：各自的级别，可选的 unix 套接字与供 TUI 查看的内存环
+    apply_log_sinks(&g_config);
+
+    // 轮转阈值、保留数量与归档压缩
+    if (g_config.log_rotate) {
+        logger_set_rotation((size_t)g_config.log_max_size, g_config.log_max_files);
+    }
+    logger_set_compression(g_config.log_compress);
+
+    // 限流与重复合并，防止循环中的同一条日志刷满磁盘
+    logger_set_rate_limit((unsigned)g_config.log_rate_limit, (unsigned)g_config.log_rate_burst);
+    logger_set_coalescing(g_config.log_coalesce);
+
+    // 二进制格式需在启动写线程之前切换
+    if (g_config.log_format == LOG_FORMAT_BINARY &&
+        logger_set_format(LOG_FORMAT_BINARY) != SWK_SUCCESS) {
+        log_message(LOG_WARNING, "Failed to switch to binary log format");
+    }
+
+    // 按配置切换到异步日志，采样器等热路径上的日志不再阻塞在文件 I/O 上
+    if (g_config.log_async &&
+        logger_start_async((size_t)g_config.log_queue_size, (LogOverflowPolicy)g_config.log_overflow) != SWK_SUCCESS) {
+        log_message(LOG_WARNING, "Failed to start async logging, staying synchronous");
+    }
     
     // 解析命令行参数
     int mode = parse_arguments(argc, argv);
@@ -2,6 +2,7 @@
 #define SWIKERNEL_H
 
 #include "common_defs.h"
+#include "utils/logger.h"
 
 // 运行模式
 typedef enum {
@@ -16,6 +17,22 @@ typedef enum {
 typedef struct {
     char log_file[256];
     int log_level;
+    int log_max_size;           // 单个日志文件的最大字节数
+    int log_rotate;             // 是否启用日志轮转
+    int log_max_files;          // 保留的日志文件数量（含当前文件）
+    int log_compress;           // 轮转出的日志段是否压缩归档
+    int log_async;              // 是否启用异步日志
+    int log_queue_size;         // 异步日志队列长度
+    int log_overflow;           // 队列满时的策略（LogOverflowPolicy）
+    int log_format;             // 日志文件格式（LogFileFormat）
+    int log_rate_limit;         // 每个调用点每秒允许的记录数，0 不限流
+    int log_rate_burst;         // 限流允许的突发条数
+    int log_coalesce;           // 是否合并连续的相同记录
+    int log_subsystem_levels[LOG_SUBSYS_COUNT];  // 各子系统级别，-1 跟随全局级别
+    int log_sink_levels[LOG_SINK_COUNT];         // 各输出端级别（LogSinkType 顺序），-1 停用
+    char log_socket_path[108];  // 套接字汇点路径，为空时不开启
+    int log_socket_mode;        // 套接字发送方式（LogSocketMode）
+    int log_memory_records;     // 内存环保留的记录数，0 不开启
     int backup_enabled;
     int auto_dependencies;
     int parallel_compilation;
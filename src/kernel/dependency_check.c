@@ -17,7 +17,7 @@ int check_tool_exists(const char *tool) {
     char command[256];
     snprintf(command, sizeof(command), "which %s > /dev/null 2>&1", tool);
     int result = system(command);
-    log_message(LOG_DEBUG, "Checking tool %s: %s", tool, result == 0 ? "found" : "missing");
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "Checking tool %s: %s", tool, result == 0 ? "found" : "missing");
     return result == 0;
 }
 
@@ -49,7 +49,7 @@ char* get_tool_version(const char *tool) {
 DependencyStatus check_system_dependencies(void) {
     DependencyStatus status = {0};
     
-    log_message(LOG_INFO, "Checking system dependencies");
+    SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Checking system dependencies");
     
     // 检查必需工具
     int missing_count = 0;
@@ -58,11 +58,11 @@ DependencyStatus check_system_dependencies(void) {
         
         if (check_tool_exists(tool)) {
             char *version = get_tool_version(tool);
-            log_message(LOG_DEBUG, "Found required tool: %s (%s)", 
+            SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "Found required tool: %s (%s)", 
                     tool, version ? version : "unknown");
             status.required_present++;
         } else {
-            log_message(LOG_ERROR, "Missing required tool: %s", tool);
+            SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Missing required tool: %s", tool);
             missing_count++;
         }
         status.required_total++;
@@ -71,9 +71,9 @@ DependencyStatus check_system_dependencies(void) {
     status.missing_required_count = missing_count;
     
     if (missing_count > 0) {
-        log_message(LOG_ERROR, "Missing %d required dependencies", missing_count);
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Missing %d required dependencies", missing_count);
     } else {
-        log_message(LOG_INFO, "All required dependencies are satisfied");
+        SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "All required dependencies are satisfied");
     }
     
     return status;
@@ -10,19 +10,19 @@
 
 // 从源码安装内核
 int install_kernel_from_source(const char *source_path, const char *kernel_name) {
-    log_message(LOG_INFO, "Installing kernel from source: %s -> %s", 
+    SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Installing kernel from source: %s -> %s", 
             source_path, kernel_name);
     
     // 检查源码目录是否存在
     if (access(source_path, F_OK) != 0) {
-        log_message(LOG_ERROR, "Source path does not exist: %s", source_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Source path does not exist: %s", source_path);
         return -1;
     }
     
     // 检查依赖
     DependencyStatus deps = check_system_dependencies();
     if (deps.missing_required_count > 0) {
-        log_message(LOG_ERROR, "Missing required dependencies");
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Missing required dependencies");
         free_dependency_status(&deps);
         return -1;
     }
@@ -30,7 +30,7 @@ int install_kernel_from_source(const char *source_path, const char *kernel_name)
     
     // 备份当前配置
     if (!backup_system_config()) {
-        log_message(LOG_ERROR, "Failed to backup system configuration");
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Failed to backup system configuration");
         return -1;
     }
     
@@ -48,7 +48,7 @@ int install_kernel_from_source(const char *source_path, const char *kernel_name)
     };
     
     for (int i = 0; steps[i]; i++) {
-        log_message(LOG_INFO, "Executing step %d: %s", i + 1, steps[i]);
+        SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Executing step %d: %s", i + 1, steps[i]);
         
         pid = fork();
         if (pid == 0) {
@@ -60,26 +60,26 @@ int install_kernel_from_source(const char *source_path, const char *kernel_name)
             // 父进程等待
             waitpid(pid, &status, 0);
             if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
-                log_message(LOG_ERROR, "Step %d failed: %s", i + 1, steps[i]);
-                log_message(LOG_ERROR, "Installation failed, manual cleanup may be required");
+                SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Step %d failed: %s", i + 1, steps[i]);
+                SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Installation failed, manual cleanup may be required");
                 return -1;
             }
         } else {
-            log_message(LOG_ERROR, "Fork failed for step %d", i + 1);
-            log_message(LOG_ERROR, "Installation failed, manual cleanup may be required");
+            SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Fork failed for step %d", i + 1);
+            SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Installation failed, manual cleanup may be required");
             return -1;
         }
     }
     
     // 更新引导配置
     if (apply_rolling_updates() != 0) {
-        log_message(LOG_ERROR, "Failed to apply rolling updates");
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Failed to apply rolling updates");
         execute_rollback();
         return -1;
     }
     
     // 记录成功安装
-    log_message(LOG_INFO, "Kernel installed successfully: %s", kernel_name);
+    SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Kernel installed successfully: %s", kernel_name);
     
     // 记录成功安装（回滚栈已在成功时自动清除）
     
@@ -98,7 +98,7 @@ int backup_system_config(void) {
     
     // 创建备份目录
     if (mkdir_p(backup_dir) != 0) {
-        log_message(LOG_ERROR, "Failed to create backup directory: %s", backup_dir);
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Failed to create backup directory: %s", backup_dir);
         return 0;
     }
     
@@ -106,11 +106,11 @@ int backup_system_config(void) {
     char grub_backup[512];
     snprintf(grub_backup, sizeof(grub_backup), "cp /boot/grub/grub.cfg %s/", backup_dir);
     if (system(grub_backup) != 0) {
-        log_message(LOG_WARNING, "Failed to backup GRUB configuration");
+        SWK_LOG_WARN(LOG_SUBSYS_KERNEL, "Failed to backup GRUB configuration");
     }
     
     // 添加回滚步骤（简化版本）
-    log_message(LOG_INFO, "Backup created at: %s", backup_dir);
+    SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Backup created at: %s", backup_dir);
     
     return 1;
 }
\ No newline at end of file
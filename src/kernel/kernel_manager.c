@@ -12,12 +12,12 @@ KernelInfo *scan_installed_kernels(void) {
     KernelInfo *head = NULL;
     KernelInfo **tail = &head;
     
-    log_message(LOG_DEBUG, "Scanning for installed kernels");
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "Scanning for installed kernels");
     
     // 扫描 /boot 目录寻找内核镜像
     DIR *dir = opendir("/boot");
     if (!dir) {
-        log_message(LOG_ERROR, "Cannot open /boot directory");
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Cannot open /boot directory");
         return NULL;
     }
     
@@ -27,7 +27,7 @@ KernelInfo *scan_installed_kernels(void) {
         if (strncmp(entry->d_name, "vmlinuz-", 8) == 0) {
             KernelInfo *info = malloc(sizeof(KernelInfo));
             if (!info) {
-                log_message(LOG_ERROR, "Failed to allocate kernel info");
+                SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Failed to allocate kernel info");
                 continue;
             }
             
@@ -45,7 +45,7 @@ KernelInfo *scan_installed_kernels(void) {
             *tail = info;
             tail = &info->next;
             
-            log_message(LOG_DEBUG, "Found kernel: %s (running: %d)", 
+            SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "Found kernel: %s (running: %d)", 
                     info->name, info->is_running);
         }
     }
@@ -58,7 +58,7 @@ KernelInfo *scan_installed_kernels(void) {
 int get_current_kernel(char *buffer, size_t size) {
     FILE *fp = fopen("/proc/version", "r");
     if (!fp) {
-        log_message(LOG_ERROR, "Cannot open /proc/version");
+        SWK_LOG_ERROR(LOG_SUBSYS_KERNEL, "Cannot open /proc/version");
         return 0;
     }
     
@@ -96,7 +96,7 @@ void free_kernel_list(KernelInfo *list) {
 
 // 列出可用内核（包管理器）
 int list_available_kernels(void) {
-    log_message(LOG_INFO, "Listing available kernels from package manager");
+    SWK_LOG_INFO(LOG_SUBSYS_KERNEL, "Listing available kernels from package manager");
     
     // 尝试不同的包管理器
     const char *package_managers[] = {"apt", "yum", "dnf", "pacman", NULL};
@@ -115,6 +115,6 @@ int list_available_kernels(void) {
         }
     }
 
-    log_message(LOG_WARNING, "No supported package manager found");
+    SWK_LOG_WARN(LOG_SUBSYS_KERNEL, "No supported package manager found");
     return -1;
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 // src/system/file_ops.c
+#include <stdio.h>
+#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
@@ -6,6 +8,7 @@
 #include <dirent.h>
 #include "system.h"
 #include "logger.h"
+#include "crc32c.h"
 
 // 创建目录（递归）
 int mkdir_p(const char *path) {
@@ -35,7 +38,7 @@ int mkdir_p(const char *path) {
         return -1;
     }
 
-    log_message(LOG_DEBUG, "Created directory: %s", path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Created directory: %s", path);
     return 0;
 }
 
@@ -82,7 +85,7 @@ int copy_file(const char *src, const char *dst) {
     close(src_fd);
     close(dst_fd);
     
-    log_message(LOG_DEBUG, "Copied file: %s -> %s", src, dst);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Copied file: %s -> %s", src, dst);
     return 0;
 }
 
@@ -120,10 +123,41 @@ int remove_directory(const char *path) {
     closedir(dir);
     rmdir(path);
     
-    log_message(LOG_DEBUG, "Removed directory: %s", path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Removed directory: %s", path);
     return 0;
 }
 
+// 计算文件校验和（CRC32C，8 位十六进制字符串，调用者负责释放）
+char* get_file_checksum(const char *path) {
+    unsigned char buffer[65536];
+    ssize_t bytes_read;
+    uint32_t crc = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        log_message(LOG_ERROR, "Failed to open file for checksum: %s", path);
+        return NULL;
+    }
+
+    while ((bytes_read = read(fd, buffer, sizeof(buffer))) > 0) {
+        crc = crc32c(crc, buffer, (size_t)bytes_read);
+    }
+
+    close(fd);
+
+    if (bytes_read < 0) {
+        log_message(LOG_ERROR, "Read error while computing checksum: %s", path);
+        return NULL;
+    }
+
+    char *checksum = malloc(9);
+    if (!checksum) {
+        return NULL;
+    }
+    snprintf(checksum, 9, "%08x", crc);
+    return checksum;
+}
+
 // 文件完整性校验
 int verify_file_integrity(const char *path, const char *expected_hash) {
     int fd;
@@ -154,7 +188,7 @@ int verify_file_integrity(const char *path, const char *expected_hash) {
     close(fd);
     
     if (strcmp(actual_hash, expected_hash) == 0) {
-        log_message(LOG_DEBUG, "File integrity verified: %s", path);
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "File integrity verified: %s", path);
         return 0;
     } else {
         log_message(LOG_ERROR, "File integrity check failed: %s", path);
@@ -7,7 +7,7 @@
 
 // 执行命令并返回退出状态
 int execute_command(const char *command) {
-    log_message(LOG_DEBUG, "Executing command: %s", command);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Executing command: %s", command);
     
     int status = system(command);
     if (status == -1) {
@@ -38,7 +38,7 @@ char* execute_command_capture(const char *command) {
     size_t total_size = 0;
     char buffer[1024];
 
-    log_message(LOG_DEBUG, "Executing command with output capture: %s", command);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Executing command with output capture: %s", command);
     
     fp = popen(command, "r");
     if (fp == NULL) {
@@ -83,7 +83,7 @@ pid_t execute_background(const char *command) {
         execl("/bin/sh", "sh", "-c", command, NULL);
         exit(1); // 如果execl失败
     } else if (pid > 0) {
-        log_message(LOG_DEBUG, "Started background process %d: %s", pid, command);
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Started background process %d: %s", pid, command);
         return pid;
     } else {
         log_message(LOG_ERROR, "Failed to fork for background command: %s", command);
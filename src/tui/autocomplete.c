@@ -27,7 +27,7 @@ char** path_autocomplete(const char *partial_path, int *match_count) {
     
     DIR *dir = opendir(dir_path);
     if (!dir) {
-        log_message(LOG_DEBUG, "Cannot open directory: %s", dir_path);
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Cannot open directory: %s", dir_path);
         return NULL;
     }
     
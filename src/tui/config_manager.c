@@ -48,7 +48,7 @@ int config_manager_load(ConfigManager *cm) {
 
     FILE *file = fopen(cm->config_file_path, "r");
     if (!file) {
-        log_message(LOG_ERROR, "Cannot open config file: %s", cm->config_file_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Cannot open config file: %s", cm->config_file_path);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
@@ -108,7 +108,7 @@ int config_manager_load(ConfigManager *cm) {
     }
 
     fclose(file);
-    log_message(LOG_DEBUG, "Loaded %d config items from %s", cm->item_count, cm->config_file_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded %d config items from %s", cm->item_count, cm->config_file_path);
     return SWK_SUCCESS;
 }
 
@@ -120,7 +120,7 @@ int config_manager_save(ConfigManager *cm) {
 
     FILE *file = fopen(cm->config_file_path, "w");
     if (!file) {
-        log_message(LOG_ERROR, "Cannot write config file: %s", cm->config_file_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Cannot write config file: %s", cm->config_file_path);
         return SWK_ERROR_PERMISSION_DENIED;
     }
 
@@ -144,7 +144,7 @@ int config_manager_save(ConfigManager *cm) {
 
     fclose(file);
     cm->modified = 0;
-    log_message(LOG_INFO, "Saved config to %s", cm->config_file_path);
+    SWK_LOG_INFO(LOG_SUBSYS_TUI, "Saved config to %s", cm->config_file_path);
     return SWK_SUCCESS;
 }
 
@@ -337,7 +337,7 @@ int config_manager_validate_all(ConfigManager *cm) {
 
     while (current) {
         if (config_manager_validate_item(cm, current) != SWK_SUCCESS) {
-            log_message(LOG_ERROR, "Invalid config item: %s.%s = %s",
+            SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Invalid config item: %s.%s = %s",
                        current->section, current->key, current->value);
             errors++;
         }
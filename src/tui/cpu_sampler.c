@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "cpu_sampler.h"
+#include "logger.h"
+
+int cpu_sampler_open(CpuSampler *sampler, const char *path) {
+    if (!sampler) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(sampler, 0, sizeof(CpuSampler));
+    sampler->fd = open(path ? path : CPU_SAMPLER_PATH, O_RDONLY | O_CLOEXEC);
+    if (sampler->fd < 0) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Cannot open %s", path ? path : CPU_SAMPLER_PATH);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    sampler->capacity = CPU_SAMPLER_BUFFER;
+    sampler->buffer = malloc(sampler->capacity);
+    if (!sampler->buffer) {
+        cpu_sampler_close(sampler);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    return SWK_SUCCESS;
+}
+
+void cpu_sampler_close(CpuSampler *sampler) {
+    if (!sampler) return;
+
+    if (sampler->fd >= 0) {
+        close(sampler->fd);
+    }
+    free(sampler->buffer);
+    free(sampler->cpu_times);
+    free(sampler->cpus);
+    memset(sampler, 0, sizeof(CpuSampler));
+    sampler->fd = -1;
+}
+
+static double cpu_sampler_percent(uint64_t part, uint64_t total) {
+    return total > 0 ? (double)part * 100.0 / (double)total : 0.0;
+}
+
+static uint64_t cpu_sampler_delta(uint64_t before, uint64_t after) {
+    return after > before ? after - before : 0;
+}
+
+void cpu_sampler_usage(const CpuTimes *before, const CpuTimes *after, CpuUsage *usage) {
+    uint64_t user = cpu_sampler_delta(before->user, after->user);
+    uint64_t nice = cpu_sampler_delta(before->nice, after->nice);
+    uint64_t system = cpu_sampler_delta(before->system, after->system);
+    uint64_t idle = cpu_sampler_delta(before->idle, after->idle);
+    uint64_t iowait = cpu_sampler_delta(before->iowait, after->iowait);
+    uint64_t irq = cpu_sampler_delta(before->irq, after->irq) + cpu_sampler_delta(before->softirq, after->softirq);
+    uint64_t steal = cpu_sampler_delta(before->steal, after->steal);
+    uint64_t guest = cpu_sampler_delta(before->guest, after->guest) +
+                     cpu_sampler_delta(before->guest_nice, after->guest_nice);
+
+    // guest 已计入 user/nice
+    uint64_t total = user + nice + system + idle + iowait + irq + steal;
+    uint64_t host_user = user + nice > guest ? user + nice - guest : 0;
+
+    usage->usage = cpu_sampler_percent(total - idle - iowait, total);
+    usage->user = cpu_sampler_percent(host_user, total);
+    usage->system = cpu_sampler_percent(system, total);
+    usage->iowait = cpu_sampler_percent(iowait, total);
+    usage->irq = cpu_sampler_percent(irq, total);
+    usage->steal = cpu_sampler_percent(steal, total);
+    usage->guest = cpu_sampler_percent(guest, total);
+    usage->online = 1;
+}
+
+// 从头读取整个文件（文件比缓冲区大时只需要开头的 cpu 行，见调用方）
+static ssize_t cpu_sampler_read(CpuSampler *sampler) {
+    size_t length = 0;
+
+    while (length < sampler->capacity - 1) {
+        ssize_t n = pread(sampler->fd, sampler->buffer + length, sampler->capacity - 1 - length, (off_t)length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0) {
+            break;
+        }
+        length += (size_t)n;
+    }
+    sampler->buffer[length] = '\0';
+    return (ssize_t)length;
+}
+
+// 解析一行中空格分隔的计数，缺少的字段（旧内核）为 0
+static void cpu_sampler_parse_times(const char *p, CpuTimes *times) {
+    uint64_t *fields = (uint64_t *)times;
+    const int field_count = (int)(sizeof(CpuTimes) / sizeof(uint64_t));
+
+    memset(times, 0, sizeof(CpuTimes));
+    for (int i = 0; i < field_count; i++) {
+        while (*p == ' ') {
+            p++;
+        }
+        if (*p < '0' || *p > '9') {
+            break;
+        }
+        uint64_t value = 0;
+        while (*p >= '0' && *p <= '9') {
+            value = value * 10 + (uint64_t)(*p++ - '0');
+        }
+        fields[i] = value;
+    }
+}
+
+static int cpu_sampler_reserve(CpuSampler *sampler, int cpu) {
+    if (cpu < sampler->cpu_capacity) {
+        return SWK_SUCCESS;
+    }
+
+    int capacity = sampler->cpu_capacity ? sampler->cpu_capacity : 64;
+    while (capacity <= cpu) {
+        capacity *= 2;
+    }
+
+    CpuTimes *times = realloc(sampler->cpu_times, (size_t)capacity * sizeof(CpuTimes));
+    if (!times) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    sampler->cpu_times = times;
+    CpuUsage *cpus = realloc(sampler->cpus, (size_t)capacity * sizeof(CpuUsage));
+    if (!cpus) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    sampler->cpus = cpus;
+
+    // 新出现的 CPU 没有上一次采样，从 0 开始比较
+    memset(times + sampler->cpu_capacity, 0, (size_t)(capacity - sampler->cpu_capacity) * sizeof(CpuTimes));
+    memset(cpus + sampler->cpu_capacity, 0, (size_t)(capacity - sampler->cpu_capacity) * sizeof(CpuUsage));
+    sampler->cpu_capacity = capacity;
+    return SWK_SUCCESS;
+}
+
+int cpu_sampler_sample(CpuSampler *sampler) {
+    if (!sampler || sampler->fd < 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    // cpu 行都在文件开头，缓冲区被填满且还没有读到其后的行时加倍重读
+    const char *end;
+    while (1) {
+        ssize_t length = cpu_sampler_read(sampler);
+        if (length < 0) {
+            return SWK_ERROR_SYSTEM_CALL;
+        }
+
+        const char *p = sampler->buffer;
+        while (strncmp(p, "cpu", 3) == 0) {
+            const char *newline = strchr(p, '\n');
+            if (!newline) {
+                break;
+            }
+            p = newline + 1;
+        }
+        end = p;
+        if ((size_t)length < sampler->capacity - 1 || (*end != '\0' && strncmp(end, "cpu", 3) != 0)) {
+            break;
+        }
+
+        char *buffer = realloc(sampler->buffer, sampler->capacity * 2);
+        if (!buffer) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        sampler->buffer = buffer;
+        sampler->capacity *= 2;
+    }
+
+    for (int i = 0; i < sampler->cpu_count; i++) {
+        sampler->cpus[i].online = 0;
+    }
+    sampler->online_count = 0;
+
+    const char *p = sampler->buffer;
+    while (p < end) {
+        CpuTimes times;
+        const char *newline = strchr(p, '\n');
+
+        if (p[3] == ' ') {
+            cpu_sampler_parse_times(p + 3, &times);
+            cpu_sampler_usage(&sampler->total_times, &times, &sampler->total);
+            sampler->total_times = times;
+        } else if (p[3] >= '0' && p[3] <= '9') {
+            int cpu = 0;
+            const char *q = p + 3;
+            while (*q >= '0' && *q <= '9' && cpu < 1000000) {
+                cpu = cpu * 10 + (*q++ - '0');
+            }
+            if (cpu_sampler_reserve(sampler, cpu) != SWK_SUCCESS) {
+                return SWK_ERROR_OUT_OF_MEMORY;
+            }
+            cpu_sampler_parse_times(q, &times);
+            cpu_sampler_usage(&sampler->cpu_times[cpu], &times, &sampler->cpus[cpu]);
+            sampler->cpu_times[cpu] = times;
+            sampler->online_count++;
+            if (cpu >= sampler->cpu_count) {
+                sampler->cpu_count = cpu + 1;
+            }
+        }
+        p = newline + 1;
+    }
+
+    sampler->samples++;
+    return SWK_SUCCESS;
+}
+
+const CpuUsage *cpu_sampler_cpu(const CpuSampler *sampler, int cpu) {
+    if (!sampler || cpu < 0 || cpu >= sampler->cpu_count) {
+        return NULL;
+    }
+    return &sampler->cpus[cpu];
+}
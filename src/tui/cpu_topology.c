@@ -0,0 +1,443 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "cpu_topology.h"
+#include "logger.h"
+
+// 读取一个小的 sysfs 文件（去掉末尾换行），返回长度，失败返回 -1
+static int cpu_topology_read(const char *path, char *buf, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    ssize_t n;
+    do {
+        n = read(fd, buf, size - 1);
+    } while (n < 0 && errno == EINTR);
+    close(fd);
+    if (n < 0) {
+        return -1;
+    }
+
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' ')) {
+        n--;
+    }
+    buf[n] = '\0';
+    return (int)n;
+}
+
+static int cpu_topology_read_int(const char *path, int fallback) {
+    char buf[32];
+
+    if (cpu_topology_read(path, buf, sizeof(buf)) <= 0) {
+        return fallback;
+    }
+    return atoi(buf);
+}
+
+// 列表中的下一个区间 [*first, *last]，没有时返回 NULL
+static const char *cpu_topology_next_range(const char *p, int *first, int *last) {
+    while (*p == ',' || *p == ' ') {
+        p++;
+    }
+    if (*p < '0' || *p > '9') {
+        return NULL;
+    }
+
+    char *end;
+    *first = (int)strtol(p, &end, 10);
+    *last = *first;
+    if (*end == '-') {
+        *last = (int)strtol(end + 1, &end, 10);
+    }
+    return *last >= *first ? end : NULL;
+}
+
+int cpu_topology_parse_list(const char *text, uint8_t *set, int max) {
+    int first, last, count = 0;
+    const char *p = text, *next;
+
+    while ((next = cpu_topology_next_range(p, &first, &last)) != NULL) {
+        for (int cpu = first; cpu <= last && set; cpu++) {
+            if (cpu < max) {
+                set[cpu] = 1;
+            }
+        }
+        count += last - first + 1;
+        p = next;
+    }
+
+    // 剩下的只能是分隔符与换行
+    while (*p == ',' || *p == ' ' || *p == '\n') {
+        p++;
+    }
+    return *p == '\0' ? count : -1;
+}
+
+// 列表中最大的编号，空列表返回 -1
+static int cpu_topology_list_max(const char *text) {
+    int first, last, max = -1;
+    const char *p = text;
+
+    while ((p = cpu_topology_next_range(p, &first, &last)) != NULL) {
+        if (last > max) {
+            max = last;
+        }
+    }
+    return max;
+}
+
+// 同一物理核的线程列表中编号最小的 CPU，以及 cpu 之前的线程数
+static int cpu_topology_list_rank(const char *text, int cpu, int *rank) {
+    int first, last, lowest = cpu;
+    const char *p = text;
+
+    *rank = 0;
+    while ((p = cpu_topology_next_range(p, &first, &last)) != NULL) {
+        if (first < lowest) {
+            lowest = first;
+        }
+        if (first < cpu) {
+            *rank += (last < cpu ? last : cpu - 1) - first + 1;
+        }
+    }
+    return lowest;
+}
+
+// 编号对应的连续序号，新编号追加在末尾（超过上限时归入最后一组）
+static int cpu_topology_group(int *ids, int *count, int id) {
+    for (int i = 0; i < *count; i++) {
+        if (ids[i] == id) {
+            return i;
+        }
+    }
+    if (*count == CPU_TOPOLOGY_MAX_GROUPS) {
+        return CPU_TOPOLOGY_MAX_GROUPS - 1;
+    }
+    ids[*count] = id;
+    return (*count)++;
+}
+
+// "48K"、"2048K"、"32M" 转换为 KB
+static uint64_t cpu_topology_size_kb(const char *text) {
+    char *end;
+    uint64_t value = strtoull(text, &end, 10);
+
+    switch (*end) {
+        case 'M': return value * 1024;
+        case 'G': return value * 1024 * 1024;
+        case 'K': return value;
+        default:  return value / 1024;
+    }
+}
+
+static void cpu_topology_read_caches(CpuTopology *topology, int cpu) {
+    char path[MAX_PATH_LENGTH + 64], buf[256];
+
+    for (int index = 0; topology->cache_count < CPU_TOPOLOGY_MAX_CACHES; index++) {
+        CpuTopologyCache *cache = &topology->caches[topology->cache_count];
+
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/cache/index%d/level", topology->root, cpu, index);
+        cache->level = cpu_topology_read_int(path, -1);
+        if (cache->level < 0) {
+            break;
+        }
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/cache/index%d/type", topology->root, cpu, index);
+        if (cpu_topology_read(path, cache->type, sizeof(cache->type)) < 0) {
+            snprintf(cache->type, sizeof(cache->type), "Unified");
+        }
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/cache/index%d/size", topology->root, cpu, index);
+        cache->size_kb = cpu_topology_read(path, buf, sizeof(buf)) > 0 ? cpu_topology_size_kb(buf) : 0;
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/cache/index%d/shared_cpu_list", topology->root, cpu, index);
+        cache->shared_cpus = cpu_topology_read(path, buf, sizeof(buf)) > 0 ?
+                             cpu_topology_parse_list(buf, NULL, 0) : 1;
+        if (cache->shared_cpus < 1) {
+            cache->shared_cpus = 1;
+        }
+        cache->instances = (topology->online_count + cache->shared_cpus - 1) / cache->shared_cpus;
+        topology->cache_count++;
+    }
+}
+
+// 没有 cpufreq 时的频率：建立拓扑时读一次 /proc/cpuinfo
+static double cpu_topology_cpuinfo_mhz(void) {
+    FILE *file = fopen("/proc/cpuinfo", "r");
+    char line[256];
+    double mhz = 0.0;
+
+    if (!file) {
+        return 0.0;
+    }
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "cpu MHz", 7) == 0) {
+            sscanf(line, "cpu MHz : %lf", &mhz);
+            break;
+        }
+    }
+    fclose(file);
+    return mhz;
+}
+
+static void cpu_topology_read_nodes(CpuTopology *topology, uint8_t *set) {
+    char path[MAX_PATH_LENGTH + 320], buf[4096];
+
+    snprintf(path, sizeof(path), "%s/node", topology->root);
+    DIR *dir = opendir(path);
+    if (dir) {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strncmp(entry->d_name, "node", 4) != 0 || entry->d_name[4] < '0' || entry->d_name[4] > '9') {
+                continue;
+            }
+            snprintf(path, sizeof(path), "%s/node/%s/cpulist", topology->root, entry->d_name);
+            if (cpu_topology_read(path, buf, sizeof(buf)) <= 0) {
+                continue;  // 没有 CPU 的内存节点
+            }
+
+            int node = cpu_topology_group(topology->node_ids, &topology->node_count, atoi(entry->d_name + 4));
+            memset(set, 0, (size_t)topology->cpu_count);
+            cpu_topology_parse_list(buf, set, topology->cpu_count);
+            for (int cpu = 0; cpu < topology->cpu_count; cpu++) {
+                if (set[cpu]) {
+                    topology->cpus[cpu].node = node;
+                }
+            }
+        }
+        closedir(dir);
+    }
+
+    // 没有 NUMA 信息时所有 CPU 都在节点 0
+    if (topology->node_count == 0) {
+        topology->node_ids[0] = 0;
+        topology->node_count = 1;
+    }
+}
+
+static int cpu_topology_load(CpuTopology *topology) {
+    char path[MAX_PATH_LENGTH + 64], buf[4096];
+
+    snprintf(path, sizeof(path), "%s/cpu/online", topology->root);
+    topology->online_fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (topology->online_fd >= 0) {
+        ssize_t n = pread(topology->online_fd, topology->online_mask, sizeof(topology->online_mask) - 1, 0);
+        topology->online_mask[n > 0 ? n : 0] = '\0';
+    }
+    if (topology->online_mask[0] == '\0') {
+        // 读不到在线列表时认为 0..N-1 在线
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        snprintf(topology->online_mask, sizeof(topology->online_mask), "0-%ld", count > 0 ? count - 1 : 0);
+    }
+
+    topology->cpu_count = cpu_topology_list_max(topology->online_mask) + 1;
+    if (topology->cpu_count <= 0) {
+        return SWK_ERROR;
+    }
+    topology->cpus = calloc((size_t)topology->cpu_count, sizeof(CpuTopologyCpu));
+    uint8_t *set = calloc((size_t)topology->cpu_count, 1);
+    if (!topology->cpus || !set) {
+        free(set);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    for (int cpu = 0; cpu < topology->cpu_count; cpu++) {
+        topology->cpus[cpu].freq_fd = -1;
+    }
+    topology->online_count = cpu_topology_parse_list(topology->online_mask, set, topology->cpu_count);
+    if (topology->online_count <= 0) {
+        free(set);
+        return SWK_ERROR;
+    }
+
+    int first_online = -1;
+    for (int cpu = 0; cpu < topology->cpu_count; cpu++) {
+        CpuTopologyCpu *c = &topology->cpus[cpu];
+        if (!set[cpu]) {
+            continue;
+        }
+        c->online = 1;
+        if (first_online < 0) {
+            first_online = cpu;
+        }
+
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/physical_package_id", topology->root, cpu);
+        c->package = cpu_topology_group(topology->package_ids, &topology->package_count,
+                                        cpu_topology_read_int(path, 0));
+
+        // 同一物理核中编号最小的线程代表这个核
+        // （core_cpus_list 在较旧的内核上叫 thread_siblings_list）
+        int lowest = cpu, rank = 0, length;
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/core_cpus_list", topology->root, cpu);
+        length = cpu_topology_read(path, buf, sizeof(buf));
+        if (length <= 0) {
+            snprintf(path, sizeof(path), "%s/cpu/cpu%d/topology/thread_siblings_list", topology->root, cpu);
+            length = cpu_topology_read(path, buf, sizeof(buf));
+        }
+        if (length > 0) {
+            lowest = cpu_topology_list_rank(buf, cpu, &rank);
+        }
+        if (lowest < cpu && topology->cpus[lowest].online) {
+            c->core = topology->cpus[lowest].core;
+            c->thread = rank;
+        } else {
+            c->core = topology->core_count++;
+            c->thread = 0;
+        }
+        if (c->thread + 1 > topology->threads_per_core) {
+            topology->threads_per_core = c->thread + 1;
+        }
+
+        snprintf(path, sizeof(path), "%s/cpu/cpu%d/cpufreq/scaling_cur_freq", topology->root, cpu);
+        c->freq_fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (c->freq_fd >= 0) {
+            topology->has_cpufreq = 1;
+        }
+    }
+
+    cpu_topology_read_nodes(topology, set);
+    free(set);
+
+    if (first_online >= 0) {
+        cpu_topology_read_caches(topology, first_online);
+    }
+    if (!topology->has_cpufreq) {
+        topology->base_mhz = cpu_topology_cpuinfo_mhz();
+    }
+
+    topology->generation++;
+    SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "CPU topology: %d packages, %d cores, %d CPUs, %d nodes",
+                  topology->package_count, topology->core_count, topology->online_count, topology->node_count);
+    return SWK_SUCCESS;
+}
+
+// 关闭描述符并释放，保留 root 与 generation
+static void cpu_topology_unload(CpuTopology *topology) {
+    char root[MAX_PATH_LENGTH];
+    uint64_t generation = topology->generation;
+
+    if (topology->online_fd >= 0) {
+        close(topology->online_fd);
+    }
+    for (int cpu = 0; cpu < topology->cpu_count && topology->cpus; cpu++) {
+        if (topology->cpus[cpu].freq_fd >= 0) {
+            close(topology->cpus[cpu].freq_fd);
+        }
+    }
+    free(topology->cpus);
+
+    memcpy(root, topology->root, sizeof(root));
+    memset(topology, 0, sizeof(CpuTopology));
+    memcpy(topology->root, root, sizeof(root));
+    topology->generation = generation;
+    topology->online_fd = -1;
+}
+
+int cpu_topology_build(CpuTopology *topology, const char *root) {
+    if (!topology) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(topology, 0, sizeof(CpuTopology));
+    topology->online_fd = -1;
+    snprintf(topology->root, sizeof(topology->root), "%s", root ? root : CPU_TOPOLOGY_ROOT);
+
+    int result = cpu_topology_load(topology);
+    if (result != SWK_SUCCESS) {
+        cpu_topology_unload(topology);
+    }
+    return result;
+}
+
+void cpu_topology_free(CpuTopology *topology) {
+    if (!topology) return;
+
+    cpu_topology_unload(topology);
+    topology->generation = 0;
+}
+
+int cpu_topology_check(CpuTopology *topology) {
+    char mask[CPU_TOPOLOGY_MASK_MAX];
+
+    if (!topology || topology->online_fd < 0) {
+        return 0;
+    }
+
+    ssize_t n = pread(topology->online_fd, mask, sizeof(mask) - 1, 0);
+    if (n <= 0) {
+        return 0;
+    }
+    mask[n] = '\0';
+    if (strcmp(mask, topology->online_mask) == 0) {
+        return 0;
+    }
+
+    SWK_LOG_INFO(LOG_SUBSYS_MONITOR, "Online CPUs changed, rebuilding topology");
+    cpu_topology_unload(topology);
+    if (cpu_topology_load(topology) != SWK_SUCCESS) {
+        cpu_topology_unload(topology);
+    }
+    return 1;
+}
+
+double cpu_topology_update_frequency(CpuTopology *topology) {
+    double sum = 0.0;
+    int count = 0;
+
+    if (!topology) {
+        return 0.0;
+    }
+
+    for (int cpu = 0; cpu < topology->cpu_count; cpu++) {
+        CpuTopologyCpu *c = &topology->cpus[cpu];
+        char buf[32];
+
+        if (!c->online) {
+            continue;
+        }
+        c->mhz = topology->base_mhz;
+        if (c->freq_fd >= 0) {
+            ssize_t n = pread(c->freq_fd, buf, sizeof(buf) - 1, 0);
+            if (n > 0) {
+                buf[n] = '\0';
+                c->mhz = strtod(buf, NULL) / 1000.0;  // kHz
+            }
+        }
+        sum += c->mhz;
+        count++;
+    }
+    return count > 0 ? sum / count : topology->base_mhz;
+}
+
+int cpu_topology_aggregate(const CpuTopology *topology, const CpuSampler *sampler, int by,
+                           double *usage, int max) {
+    int counts[CPU_TOPOLOGY_MAX_GROUPS] = {0};
+    int groups = by == CPU_TOPOLOGY_BY_NODE ? topology->node_count : topology->package_count;
+
+    if (groups > max) {
+        groups = max;
+    }
+    for (int i = 0; i < groups; i++) {
+        usage[i] = 0.0;
+    }
+
+    for (int cpu = 0; cpu < topology->cpu_count; cpu++) {
+        const CpuUsage *sample = cpu_sampler_cpu(sampler, cpu);
+        int group = by == CPU_TOPOLOGY_BY_NODE ? topology->cpus[cpu].node : topology->cpus[cpu].package;
+
+        if (!topology->cpus[cpu].online || !sample || !sample->online || group >= groups) {
+            continue;
+        }
+        usage[group] += sample->usage;
+        counts[group]++;
+    }
+
+    for (int i = 0; i < groups; i++) {
+        if (counts[i] > 0) {
+            usage[i] /= counts[i];
+        }
+    }
+    return groups;
+}
@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "disk_sampler.h"
+#include "logger.h"
+
+int disk_sampler_open(DiskSampler *sampler, const char *path, const char *block, const char *mountinfo) {
+    if (!sampler) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(sampler, 0, sizeof(DiskSampler));
+    snprintf(sampler->block, sizeof(sampler->block), "%s", block ? block : DISK_SAMPLER_BLOCK);
+    snprintf(sampler->mountinfo, sizeof(sampler->mountinfo), "%s", mountinfo ? mountinfo : DISK_SAMPLER_MOUNTINFO);
+    sampler->fd = open(path ? path : DISK_SAMPLER_PATH, O_RDONLY | O_CLOEXEC);
+    if (sampler->fd < 0) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Cannot open %s", path ? path : DISK_SAMPLER_PATH);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    sampler->capacity = DISK_SAMPLER_BUFFER;
+    sampler->buffer = malloc(sampler->capacity);
+    if (!sampler->buffer) {
+        disk_sampler_close(sampler);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    return SWK_SUCCESS;
+}
+
+void disk_sampler_close(DiskSampler *sampler) {
+    if (!sampler) return;
+
+    if (sampler->fd >= 0) {
+        close(sampler->fd);
+    }
+    free(sampler->buffer);
+    free(sampler->devices);
+    free(sampler->next);
+    memset(sampler, 0, sizeof(DiskSampler));
+    sampler->fd = -1;
+}
+
+// 从头读取整个文件，缓冲区被填满时加倍重读
+static ssize_t disk_sampler_read(DiskSampler *sampler) {
+    for (;;) {
+        size_t length = 0;
+
+        while (length < sampler->capacity - 1) {
+            ssize_t n = pread(sampler->fd, sampler->buffer + length, sampler->capacity - 1 - length, (off_t)length);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            if (n == 0) {
+                break;
+            }
+            length += (size_t)n;
+        }
+        if (length < sampler->capacity - 1) {
+            sampler->buffer[length] = '\0';
+            return (ssize_t)length;
+        }
+
+        char *buffer = realloc(sampler->buffer, sampler->capacity * 2);
+        if (!buffer) {
+            errno = ENOMEM;
+            return -1;
+        }
+        sampler->buffer = buffer;
+        sampler->capacity *= 2;
+    }
+}
+
+static const char *disk_sampler_number(const char *p, uint64_t *value) {
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    if (*p < '0' || *p > '9') {
+        return NULL;
+    }
+    *value = 0;
+    while (*p >= '0' && *p <= '9') {
+        *value = *value * 10 + (uint64_t)(*p++ - '0');
+    }
+    return p;
+}
+
+// 解析一行："主设备号 次设备号 名称 计数..."，缺少的计数（旧内核）为 0，
+// 多出的字段（discard、flush）忽略
+static int disk_sampler_parse_line(const char *p, DiskDevice *device) {
+    uint64_t major, minor;
+    uint64_t *fields = (uint64_t *)&device->counters;
+    const int field_count = (int)(sizeof(DiskCounters) / sizeof(uint64_t));
+
+    if (!(p = disk_sampler_number(p, &major)) || !(p = disk_sampler_number(p, &minor))) {
+        return SWK_ERROR;
+    }
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    size_t length = 0;
+    while (p[length] && p[length] != ' ' && p[length] != '\t' && p[length] != '\n') {
+        length++;
+    }
+    if (length == 0 || length >= DISK_NAME_MAX) {
+        return SWK_ERROR;
+    }
+
+    memcpy(device->name, p, length);
+    device->name[length] = '\0';
+    device->major = (unsigned int)major;
+    device->minor = (unsigned int)minor;
+    p += length;
+
+    memset(&device->counters, 0, sizeof(DiskCounters));
+    for (int i = 0; i < field_count; i++) {
+        if (!(p = disk_sampler_number(p, &fields[i]))) {
+            break;
+        }
+    }
+    return SWK_SUCCESS;
+}
+
+// 两份数组都至少能放下 count + 1 个设备
+static int disk_sampler_reserve(DiskSampler *sampler, int count) {
+    if (count < sampler->device_capacity) {
+        return SWK_SUCCESS;
+    }
+
+    int capacity = sampler->device_capacity ? sampler->device_capacity * 2 : 16;
+    DiskDevice *devices = realloc(sampler->devices, (size_t)capacity * sizeof(DiskDevice));
+    if (!devices) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    sampler->devices = devices;
+    DiskDevice *next = realloc(sampler->next, (size_t)capacity * sizeof(DiskDevice));
+    if (!next) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    sampler->next = next;
+    sampler->device_capacity = capacity;
+    return SWK_SUCCESS;
+}
+
+static uint64_t disk_sampler_delta(uint64_t before, uint64_t after) {
+    return after > before ? after - before : 0;
+}
+
+static void disk_device_rates(DiskDevice *device, const DiskCounters *before, double interval) {
+    const DiskCounters *after = &device->counters;
+    DiskRates *rates = &device->rates;
+    uint64_t reads = disk_sampler_delta(before->reads, after->reads);
+    uint64_t writes = disk_sampler_delta(before->writes, after->writes);
+    uint64_t read_ms = disk_sampler_delta(before->read_ms, after->read_ms);
+    uint64_t write_ms = disk_sampler_delta(before->write_ms, after->write_ms);
+    double elapsed_ms = interval * 1000.0;
+
+    rates->read_iops = (double)reads / interval;
+    rates->write_iops = (double)writes / interval;
+    rates->read_rate = (double)disk_sampler_delta(before->read_sectors, after->read_sectors) *
+                       DISK_SECTOR_SIZE / interval;
+    rates->write_rate = (double)disk_sampler_delta(before->write_sectors, after->write_sectors) *
+                        DISK_SECTOR_SIZE / interval;
+    rates->read_latency = reads > 0 ? (double)read_ms / (double)reads : 0.0;
+    rates->write_latency = writes > 0 ? (double)write_ms / (double)writes : 0.0;
+    rates->latency = reads + writes > 0 ? (double)(read_ms + write_ms) / (double)(reads + writes) : 0.0;
+    rates->utilization = (double)disk_sampler_delta(before->io_ms, after->io_ms) * 100.0 / elapsed_ms;
+    if (rates->utilization > 100.0) {
+        rates->utilization = 100.0;  // 采样时刻与内核更新 io_ticks 的时刻不完全对齐
+    }
+    rates->queue_depth = (double)disk_sampler_delta(before->weighted_ms, after->weighted_ms) / elapsed_ms;
+}
+
+static int disk_sampler_index(const DiskSampler *sampler, const char *name) {
+    for (int i = 0; i < sampler->count; i++) {
+        if (strcmp(sampler->devices[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// mountinfo 中的挂载点把空格、制表符、换行和反斜杠写成 \ooo
+static void disk_sampler_unescape(char *dst, size_t size, const char *src) {
+    size_t length = 0;
+
+    while (*src && length + 1 < size) {
+        if (src[0] == '\\' && src[1] >= '0' && src[1] <= '3' && src[2] >= '0' && src[2] <= '7' &&
+            src[3] >= '0' && src[3] <= '7') {
+            dst[length++] = (char)((src[1] - '0') * 64 + (src[2] - '0') * 8 + (src[3] - '0'));
+            src += 4;
+        } else {
+            dst[length++] = *src++;
+        }
+    }
+    dst[length] = '\0';
+}
+
+// 重新读取分区关系与挂载点
+static void disk_sampler_refresh(DiskSampler *sampler) {
+    char path[MAX_PATH_LENGTH + 64], resolved[PATH_MAX];
+
+    for (int i = 0; i < sampler->count; i++) {
+        DiskDevice *device = &sampler->devices[i];
+
+        device->parent = -1;
+        device->mount[0] = '\0';
+        snprintf(path, sizeof(path), "%s/%s/partition", sampler->block, device->name);
+        device->partition = access(path, F_OK) == 0;
+        if (!device->partition) {
+            continue;
+        }
+
+        // .../block/sda/sda1 -> sda
+        snprintf(path, sizeof(path), "%s/%s", sampler->block, device->name);
+        if (realpath(path, resolved)) {
+            char *slash = strrchr(resolved, '/');
+            if (slash) {
+                *slash = '\0';
+                slash = strrchr(resolved, '/');
+                device->parent = disk_sampler_index(sampler, slash ? slash + 1 : resolved);
+            }
+        }
+    }
+
+    FILE *file = fopen(sampler->mountinfo, "r");
+    if (!file) {
+        return;
+    }
+
+    char line[1024], mount[512];
+    while (fgets(line, sizeof(line), file)) {
+        unsigned int major, minor;
+
+        if (sscanf(line, "%*d %*d %u:%u %*s %511s", &major, &minor, mount) != 3) {
+            continue;
+        }
+        DiskDevice *device = (DiskDevice *)disk_sampler_find_dev(sampler, major, minor);
+        if (device && !device->mount[0]) {
+            disk_sampler_unescape(device->mount, sizeof(device->mount), mount);
+        }
+    }
+    fclose(file);
+}
+
+int disk_sampler_sample(DiskSampler *sampler, double now) {
+    if (!sampler || sampler->fd < 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    if (disk_sampler_read(sampler) < 0) {
+        return errno == ENOMEM ? SWK_ERROR_OUT_OF_MEMORY : SWK_ERROR_SYSTEM_CALL;
+    }
+
+    sampler->samples++;
+    sampler->interval = sampler->samples > 1 && now > sampler->last ? now - sampler->last : 0.0;
+    sampler->last = now;
+
+    // 解析到 next，与上一次的结果按名称对应；设备顺序通常不变，先看同一位置
+    int previous_count = sampler->count;
+    int count = 0;
+    int changed = 0;
+    const char *p = sampler->buffer;
+    while (*p) {
+        const char *newline = strchr(p, '\n');
+
+        if (disk_sampler_reserve(sampler, count) != SWK_SUCCESS) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+
+        DiskDevice *device = &sampler->next[count];
+        if (disk_sampler_parse_line(p, device) == SWK_SUCCESS) {
+            const DiskDevice *old = NULL;
+            if (count < previous_count && strcmp(sampler->devices[count].name, device->name) == 0) {
+                old = &sampler->devices[count];
+            } else {
+                old = disk_sampler_find(sampler, device->name);
+                changed = 1;
+            }
+
+            memset(&device->rates, 0, sizeof(DiskRates));
+            if (old && old->major == device->major && old->minor == device->minor) {
+                device->partition = old->partition;
+                device->parent = old->parent;
+                memcpy(device->mount, old->mount, sizeof(device->mount));
+                if (old->sampled && sampler->interval > 0.0) {
+                    disk_device_rates(device, &old->counters, sampler->interval);
+                }
+            } else {
+                device->partition = 0;
+                device->parent = -1;
+                device->mount[0] = '\0';
+                changed = 1;
+            }
+            device->sampled = 1;
+            count++;
+        }
+        p = newline ? newline + 1 : p + strlen(p);
+    }
+
+    DiskDevice *devices = sampler->devices;
+    sampler->devices = sampler->next;
+    sampler->next = devices;
+    sampler->count = count;
+
+    if (changed || count != previous_count || sampler->samples % DISK_SAMPLER_RESCAN == 1) {
+        disk_sampler_refresh(sampler);
+    }
+    return SWK_SUCCESS;
+}
+
+const DiskDevice *disk_sampler_find(const DiskSampler *sampler, const char *name) {
+    for (int i = 0; sampler && name && i < sampler->count; i++) {
+        if (strcmp(sampler->devices[i].name, name) == 0) {
+            return &sampler->devices[i];
+        }
+    }
+    return NULL;
+}
+
+const DiskDevice *disk_sampler_find_dev(const DiskSampler *sampler, unsigned int major, unsigned int minor) {
+    for (int i = 0; sampler && i < sampler->count; i++) {
+        if (sampler->devices[i].major == major && sampler->devices[i].minor == minor) {
+            return &sampler->devices[i];
+        }
+    }
+    return NULL;
+}
+
+const char *disk_sampler_mount(const DiskSampler *sampler, const DiskDevice *device) {
+    if (!sampler || !device) {
+        return "";
+    }
+    if (device->mount[0]) {
+        return device->mount;
+    }
+
+    int index = (int)(device - sampler->devices);
+    for (int i = 0; i < sampler->count; i++) {
+        if (sampler->devices[i].parent == index && sampler->devices[i].mount[0]) {
+            return sampler->devices[i].mount;
+        }
+    }
+    return "";
+}
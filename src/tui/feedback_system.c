@@ -29,7 +29,7 @@ int feedback_system_init(FeedbackSystem *fs, FeedbackLevel level) {
         return SWK_ERROR_SYSTEM_CALL;
     }
 
-    log_message(LOG_DEBUG, "Feedback system initialized (level: %d)", level);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Feedback system initialized (level: %d)", level);
     return SWK_SUCCESS;
 }
 
@@ -54,7 +54,7 @@ void feedback_system_cleanup(FeedbackSystem *fs) {
     pthread_mutex_unlock(&fs->mutex);
     pthread_mutex_destroy(&fs->mutex);
 
-    log_message(LOG_DEBUG, "Feedback system cleaned up");
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Feedback system cleaned up");
 }
 
 // 设置反馈级别
@@ -67,7 +67,7 @@ int feedback_system_set_level(FeedbackSystem *fs, FeedbackLevel level) {
     fs->level = level;
     pthread_mutex_unlock(&fs->mutex);
 
-    log_message(LOG_DEBUG, "Feedback level changed to %d", level);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Feedback level changed to %d", level);
     return SWK_SUCCESS;
 }
 
@@ -145,7 +145,7 @@ int feedback_system_add_message(FeedbackSystem *fs, FeedbackType type, const cha
             case FEEDBACK_TYPE_CRITICAL: log_level = LOG_FATAL; break;
         }
 
-        log_message(log_level, "[%s] %s", title, message);
+        SWK_LOG(LOG_SUBSYS_TUI, log_level, "[%s] %s", title, message);
     }
 
     // 播放声音提示
@@ -297,7 +297,7 @@ int feedback_system_show_progress(FeedbackSystem *fs, ProgressInfo *progress) {
     progress->start_time = time(NULL);
 
     // 这里可以实现进度显示逻辑
-    log_message(LOG_INFO, "Starting operation: %s", progress->operation);
+    SWK_LOG_INFO(LOG_SUBSYS_TUI, "Starting operation: %s", progress->operation);
 
     return SWK_SUCCESS;
 }
@@ -310,7 +310,7 @@ int feedback_system_update_progress(FeedbackSystem *fs, int current, const char
 
     // 这里可以实现进度更新显示逻辑
     if (status) {
-        log_message(LOG_DEBUG, "Progress update: %d, %s", current, status);
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Progress update: %d, %s", current, status);
     }
 
     return SWK_SUCCESS;
@@ -323,7 +323,7 @@ int feedback_system_hide_progress(FeedbackSystem *fs) {
     }
 
     // 这里可以实现隐藏进度显示逻辑
-    log_message(LOG_DEBUG, "Progress display hidden");
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Progress display hidden");
 
     return SWK_SUCCESS;
 }
@@ -335,7 +335,7 @@ int feedback_system_show_status(FeedbackSystem *fs, const char *status) {
     }
 
     // 这里可以实现状态栏显示逻辑
-    log_message(LOG_DEBUG, "Status: %s", status);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Status: %s", status);
 
     return SWK_SUCCESS;
 }
@@ -347,7 +347,7 @@ int feedback_system_update_status(FeedbackSystem *fs, const char *status) {
     }
 
     // 这里可以实现状态更新逻辑
-    log_message(LOG_DEBUG, "Status update: %s", status);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Status update: %s", status);
 
     return SWK_SUCCESS;
 }
@@ -515,7 +515,7 @@ int feedback_system_set_language(FeedbackSystem *fs, const char *language) {
     }
 
     // 这里可以实现国际化逻辑
-    log_message(LOG_DEBUG, "Language set to: %s", language);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Language set to: %s", language);
     return SWK_SUCCESS;
 }
 
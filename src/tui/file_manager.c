@@ -67,7 +67,7 @@ int file_manager_refresh(FileManager *fm) {
 
     dir = opendir(fm->current_path);
     if (!dir) {
-        log_message(LOG_ERROR, "Cannot open directory: %s", fm->current_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Cannot open directory: %s", fm->current_path);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
@@ -94,7 +94,7 @@ int file_manager_refresh(FileManager *fm) {
         // 创建文件信息节点
         FileInfo *info = malloc(sizeof(FileInfo));
         if (!info) {
-            log_message(LOG_ERROR, "Failed to allocate memory for file info");
+            SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to allocate memory for file info");
             continue;
         }
 
@@ -159,7 +159,7 @@ int file_manager_refresh(FileManager *fm) {
     }
 
     closedir(dir);
-    log_message(LOG_DEBUG, "Refreshed file list: %d files in %s", fm->file_count, fm->current_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Refreshed file list: %d files in %s", fm->file_count, fm->current_path);
     return SWK_SUCCESS;
 }
 
@@ -182,13 +182,13 @@ int file_manager_change_directory(FileManager *fm, const char *path) {
     // 标准化路径
     char resolved_path[MAX_PATH_LENGTH];
     if (realpath(new_path, resolved_path) == NULL) {
-        log_message(LOG_ERROR, "Invalid path: %s", new_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Invalid path: %s", new_path);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
     // 检查是否为目录
     if (stat(resolved_path, &statbuf) == -1 || !S_ISDIR(statbuf.st_mode)) {
-        log_message(LOG_ERROR, "Not a directory: %s", resolved_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Not a directory: %s", resolved_path);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
@@ -236,11 +236,11 @@ FileOperationResult file_manager_copy(FileManager *fm, const char *source, const
         strcpy(result.message, "File copied successfully");
         strncpy(result.source_path, source, sizeof(result.source_path) - 1);
         strncpy(result.target_path, destination, sizeof(result.target_path) - 1);
-        log_message(LOG_INFO, "Copied %s to %s", source, destination);
+        SWK_LOG_INFO(LOG_SUBSYS_TUI, "Copied %s to %s", source, destination);
     } else {
         result.code = SWK_ERROR_SYSTEM_CALL;
         snprintf(result.message, sizeof(result.message), "Failed to copy file: %s", strerror(errno));
-        log_message(LOG_ERROR, "Failed to copy %s to %s: %s", source, destination, strerror(errno));
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to copy %s to %s: %s", source, destination, strerror(errno));
     }
 
     return result;
@@ -264,11 +264,11 @@ FileOperationResult file_manager_delete(FileManager *fm, const char *path) {
         result.code = SWK_SUCCESS;
         strcpy(result.message, "File deleted successfully");
         strncpy(result.source_path, path, sizeof(result.source_path) - 1);
-        log_message(LOG_INFO, "Deleted %s", path);
+        SWK_LOG_INFO(LOG_SUBSYS_TUI, "Deleted %s", path);
     } else {
         result.code = SWK_ERROR_SYSTEM_CALL;
         snprintf(result.message, sizeof(result.message), "Failed to delete file: %s", strerror(errno));
-        log_message(LOG_ERROR, "Failed to delete %s: %s", path, strerror(errno));
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to delete %s: %s", path, strerror(errno));
     }
 
     return result;
@@ -292,11 +292,11 @@ FileOperationResult file_manager_mkdir(FileManager *fm, const char *name) {
         result.code = SWK_SUCCESS;
         strcpy(result.message, "Directory created successfully");
         strncpy(result.target_path, new_dir, sizeof(result.target_path) - 1);
-        log_message(LOG_INFO, "Created directory %s", new_dir);
+        SWK_LOG_INFO(LOG_SUBSYS_TUI, "Created directory %s", new_dir);
     } else {
         result.code = SWK_ERROR_SYSTEM_CALL;
         snprintf(result.message, sizeof(result.message), "Failed to create directory: %s", strerror(errno));
-        log_message(LOG_ERROR, "Failed to create directory %s: %s", new_dir, strerror(errno));
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to create directory %s: %s", new_dir, strerror(errno));
     }
 
     return result;
@@ -324,11 +324,11 @@ FileOperationResult file_manager_rename(FileManager *fm, const char *old_name, c
         strcpy(result.message, "File renamed successfully");
         strncpy(result.source_path, old_path, sizeof(result.source_path) - 1);
         strncpy(result.target_path, new_path, sizeof(result.target_path) - 1);
-        log_message(LOG_INFO, "Renamed %s to %s", old_path, new_path);
+        SWK_LOG_INFO(LOG_SUBSYS_TUI, "Renamed %s to %s", old_path, new_path);
     } else {
         result.code = SWK_ERROR_SYSTEM_CALL;
         snprintf(result.message, sizeof(result.message), "Failed to rename file: %s", strerror(errno));
-        log_message(LOG_ERROR, "Failed to rename %s to %s: %s", old_path, new_path, strerror(errno));
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to rename %s to %s: %s", old_path, new_path, strerror(errno));
     }
 
     return result;
@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #include "i18n.h"
 #include "logger.h"
+#include "fast_hash.h"
 
 // 全局国际化系统实例
 I18nSystem g_i18n_system;
@@ -25,6 +26,66 @@ static LanguageInfo g_language_infos[] = {
     {LANG_CODE_PT, "Portuguese", "Português", "🇵🇹"}
 };
 
+// 释放消息键索引
+static void i18n_index_reset(I18nSystem *i18n) {
+    free(i18n->key_index);
+    i18n->key_index = NULL;
+    i18n->key_index_capacity = 0;
+}
+
+// 在索引中查找消息键，返回消息下标，未找到返回 -1
+static int i18n_index_find(const I18nSystem *i18n, const char *key) {
+    if (!i18n->key_index) {
+        return -1;
+    }
+
+    size_t mask = (size_t)i18n->key_index_capacity - 1;
+    size_t slot = (size_t)fast_hash_str(key) & mask;
+
+    while (i18n->key_index[slot] != 0) {
+        int index = i18n->key_index[slot] - 1;
+        if (strcmp(i18n->messages[index].key, key) == 0) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+// 将消息加入索引，负载超过 1/2 时扩容重建
+// 重复的键保留第一条，与原先线性查找的行为一致
+static int i18n_index_insert(I18nSystem *i18n, int index) {
+    if ((index + 1) * 2 > i18n->key_index_capacity) {
+        int capacity = i18n->key_index_capacity ? i18n->key_index_capacity * 2 : 64;
+        int *table = calloc((size_t)capacity, sizeof(int));
+        if (!table) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+
+        i18n_index_reset(i18n);
+        i18n->key_index = table;
+        i18n->key_index_capacity = capacity;
+
+        for (int i = 0; i < index; i++) {
+            i18n_index_insert(i18n, i);
+        }
+    }
+
+    if (i18n_index_find(i18n, i18n->messages[index].key) >= 0) {
+        return SWK_SUCCESS;
+    }
+
+    size_t mask = (size_t)i18n->key_index_capacity - 1;
+    size_t slot = (size_t)fast_hash_str(i18n->messages[index].key) & mask;
+    while (i18n->key_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    i18n->key_index[slot] = index + 1;
+
+    return SWK_SUCCESS;
+}
+
 // 初始化国际化系统
 int i18n_init(I18nSystem *i18n, const char *locale_dir) {
     if (!i18n || !locale_dir) {
@@ -40,7 +101,7 @@ int i18n_init(I18nSystem *i18n, const char *locale_dir) {
     struct stat st = {0};
     if (stat(locale_dir, &st) == -1) {
         if (mkdir(locale_dir, 0755) != 0) {
-            log_message(LOG_ERROR, "Failed to create locale directory: %s", locale_dir);
+            SWK_LOG_ERROR(LOG_SUBSYS_I18N, "Failed to create locale directory: %s", locale_dir);
             return SWK_ERROR_SYSTEM_CALL;
         }
     }
@@ -53,12 +114,12 @@ int i18n_init(I18nSystem *i18n, const char *locale_dir) {
 
     // 加载当前语言的消息
     if (i18n_load_language(i18n, i18n->current_language) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to load language messages, using English fallback");
+        SWK_LOG_WARN(LOG_SUBSYS_I18N, "Failed to load language messages, using English fallback");
         i18n->current_language = LANG_EN;
         i18n_load_language(i18n, LANG_EN);
     }
 
-    log_message(LOG_DEBUG, "I18n system initialized (language: %s)", g_language_infos[i18n->current_language].code);
+    SWK_LOG_DEBUG(LOG_SUBSYS_I18N, "I18n system initialized (language: %s)", g_language_infos[i18n->current_language].code);
     return SWK_SUCCESS;
 }
 
@@ -72,7 +133,8 @@ void i18n_cleanup(I18nSystem *i18n) {
     }
 
     i18n->message_count = 0;
-    log_message(LOG_DEBUG, "I18n system cleaned up");
+    i18n_index_reset(i18n);
+    SWK_LOG_DEBUG(LOG_SUBSYS_I18N, "I18n system cleaned up");
 }
 
 // 设置语言
@@ -85,15 +147,26 @@ int i18n_set_language(I18nSystem *i18n, Language language) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    // 保存当前消息
+    // 保存当前消息（先摘下，避免加载时被释放）
     I18nMessage *old_messages = i18n->messages;
     int old_count = i18n->message_count;
+    int *old_index = i18n->key_index;
+    int old_capacity = i18n->key_index_capacity;
+
+    i18n->messages = NULL;
+    i18n->message_count = 0;
+    i18n->key_index = NULL;
+    i18n->key_index_capacity = 0;
 
     // 加载新语言
     if (i18n_load_language(i18n, language) != SWK_SUCCESS) {
         // 加载失败，回退到原语言
+        free(i18n->messages);
+        i18n_index_reset(i18n);
         i18n->messages = old_messages;
         i18n->message_count = old_count;
+        i18n->key_index = old_index;
+        i18n->key_index_capacity = old_capacity;
         return SWK_ERROR;
     }
 
@@ -101,9 +174,10 @@ int i18n_set_language(I18nSystem *i18n, Language language) {
     if (old_messages) {
         free(old_messages);
     }
+    free(old_index);
 
     i18n->current_language = language;
-    log_message(LOG_INFO, "Language changed to: %s", g_language_infos[language].code);
+    SWK_LOG_INFO(LOG_SUBSYS_I18N, "Language changed to: %s", g_language_infos[language].code);
     return SWK_SUCCESS;
 }
 
@@ -138,6 +212,7 @@ int i18n_load_messages(I18nSystem *i18n, const char *file_path) {
     }
 
     i18n->message_count = 0;
+    i18n_index_reset(i18n);
 
     char line[1024];
     char current_key[128] = {0};
@@ -199,7 +274,7 @@ int i18n_load_messages(I18nSystem *i18n, const char *file_path) {
     }
 
     fclose(file);
-    log_message(LOG_DEBUG, "Loaded %d messages from %s", i18n->message_count, file_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_I18N, "Loaded %d messages from %s", i18n->message_count, file_path);
     return SWK_SUCCESS;
 }
 
@@ -222,7 +297,7 @@ int i18n_add_message(I18nSystem *i18n, const char *key, const char *text) {
     strncpy(i18n->messages[i18n->message_count].text, text, sizeof(i18n->messages[i18n->message_count].text) - 1);
 
     i18n->message_count++;
-    return SWK_SUCCESS;
+    return i18n_index_insert(i18n, i18n->message_count - 1);
 }
 
 // 加载默认英语消息
@@ -237,6 +312,7 @@ int i18n_load_default_messages(I18nSystem *i18n) {
         i18n->messages = NULL;
     }
     i18n->message_count = 0;
+    i18n_index_reset(i18n);
 
     // 添加基本消息
     i18n_add_message(i18n, "app_name", "SwiKernel");
@@ -272,7 +348,7 @@ int i18n_load_default_messages(I18nSystem *i18n) {
     i18n_add_message(i18n, "menu_theme_manager", "Theme Manager");
     i18n_add_message(i18n, "menu_layout_manager", "Layout Manager");
 
-    log_message(LOG_DEBUG, "Loaded %d default English messages", i18n->message_count);
+    SWK_LOG_DEBUG(LOG_SUBSYS_I18N, "Loaded %d default English messages", i18n->message_count);
     return SWK_SUCCESS;
 }
 
@@ -280,15 +356,14 @@ int i18n_load_default_messages(I18nSystem *i18n) {
 const char *i18n_get_text(I18nSystem *i18n, const char *key) {
     if (!i18n || !key) return key;
 
-    // 在消息数组中查找
-    for (int i = 0; i < i18n->message_count; i++) {
-        if (strcmp(i18n->messages[i].key, key) == 0) {
-            // 如果翻译文本为空，返回键值
-            if (strlen(i18n->messages[i].text) == 0) {
-                return key;
-            }
-            return i18n->messages[i].text;
+    // 通过哈希索引查找
+    int index = i18n_index_find(i18n, key);
+    if (index >= 0) {
+        // 如果翻译文本为空，返回键值
+        if (i18n->messages[index].text[0] == '\0') {
+            return key;
         }
+        return i18n->messages[index].text;
     }
 
     // 未找到翻译，回退到英语或其他语言
@@ -494,6 +569,6 @@ int i18n_create_language_template(I18nSystem *i18n, Language language) {
     fprintf(file, "msgstr \"Linux Kernel Switcher\"\n\n");
 
     fclose(file);
-    log_message(LOG_INFO, "Created language template: %s", file_path);
+    SWK_LOG_INFO(LOG_SUBSYS_I18N, "Created language template: %s", file_path);
     return SWK_SUCCESS;
 }
\ No newline at end of file
@@ -21,7 +21,7 @@ int init_keyboard_handler(void) {
     curs_set(0);
 
     keyboard_initialized = 1;
-    log_message(LOG_DEBUG, "Keyboard handler initialized");
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Keyboard handler initialized");
     return 0;
 }
 
@@ -33,7 +33,7 @@ void cleanup_keyboard_handler(void) {
         nodelay(stdscr, FALSE);
         curs_set(1);
         keyboard_initialized = 0;
-        log_message(LOG_DEBUG, "Keyboard handler cleaned up");
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Keyboard handler cleaned up");
     }
 }
 
@@ -20,29 +20,29 @@ int layout_manager_init(LayoutManager *lm, const char *layout_dir) {
 
     // 检测终端能力
     if (layout_manager_detect_terminal(lm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to detect terminal capabilities");
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Failed to detect terminal capabilities");
     }
 
     // 创建布局目录（如果不存在）
     struct stat st = {0};
     if (stat(layout_dir, &st) == -1) {
         if (mkdir(layout_dir, 0755) != 0) {
-            log_message(LOG_ERROR, "Failed to create layout directory: %s", layout_dir);
+            SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to create layout directory: %s", layout_dir);
             return SWK_ERROR_SYSTEM_CALL;
         }
     }
 
     // 创建预设布局
     if (layout_manager_create_preset_layouts(lm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to create preset layouts");
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Failed to create preset layouts");
     }
 
     // 加载用户布局
     if (layout_manager_load_layouts(lm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to load user layouts");
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Failed to load user layouts");
     }
 
-    log_message(LOG_DEBUG, "Layout manager initialized with %d layouts", lm->layout_count);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Layout manager initialized with %d layouts", lm->layout_count);
     return SWK_SUCCESS;
 }
 
@@ -98,7 +98,7 @@ int layout_manager_detect_terminal(LayoutManager *lm) {
         lm->terminal_type = 0; // 传统终端
     }
 
-    log_message(LOG_DEBUG, "Terminal: %dx%d, colors: %d, type: %d",
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Terminal: %dx%d, colors: %d, type: %d",
                lm->screen_width, lm->screen_height, lm->color_support, lm->terminal_type);
     return SWK_SUCCESS;
 }
@@ -172,7 +172,7 @@ int layout_manager_create_preset_layouts(LayoutManager *lm) {
     lm->layout_count = 3;
     lm->current_layout = &lm->layouts[0]; // 默认使用紧凑布局
 
-    log_message(LOG_DEBUG, "Created %d preset layouts", lm->layout_count);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Created %d preset layouts", lm->layout_count);
     return SWK_SUCCESS;
 }
 
@@ -189,7 +189,7 @@ int layout_manager_apply_layout(LayoutManager *lm, const char *layout_name) {
             // 应用布局到当前会话
             layout_manager_apply_to_dialog(lm, NULL);
 
-            log_message(LOG_INFO, "Applied layout: %s", layout_name);
+            SWK_LOG_INFO(LOG_SUBSYS_TUI, "Applied layout: %s", layout_name);
             return SWK_SUCCESS;
         }
     }
@@ -288,7 +288,7 @@ int layout_manager_apply_to_dialog(LayoutManager *lm, const char *dialog_name) {
     // 这里可以实现将布局应用到dialog库的逻辑
     // 由于dialog库的限制，我们主要通过全局变量来影响布局
 
-    log_message(LOG_DEBUG, "Applied layout '%s' to dialogs", lm->current_layout->name);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Applied layout '%s' to dialogs", lm->current_layout->name);
     return SWK_SUCCESS;
 }
 
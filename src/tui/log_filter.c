@@ -0,0 +1,532 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "log_filter.h"
+
+static const char *const log_filter_level_names[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+static const size_t log_filter_level_lengths[] = {5, 4, 4, 5, 5};
+
+void log_filter_matcher_free(LogFilterMatcher *matcher) {
+    if (matcher->regex) {
+        regfree(&matcher->compiled);
+    }
+    free(matcher->bits);
+    memset(matcher, 0, sizeof(LogFilterMatcher));
+}
+
+void log_filter_init(LogFilter *filter) {
+    memset(filter, 0, sizeof(LogFilter));
+    filter->min_level = LOG_DEBUG;
+}
+
+void log_filter_reset(LogFilter *filter) {
+    for (int i = 0; i < LOG_FILTER_LEVELS; i++) {
+        free(filter->level_bits[i]);
+        filter->level_bits[i] = NULL;
+        filter->level_counts[i] = 0;
+    }
+    free(filter->pattern.bits);
+    free(filter->source.bits);
+    free(filter->rows);
+    filter->pattern.bits = NULL;
+    filter->pattern.lines = 0;
+    filter->source.bits = NULL;
+    filter->source.lines = 0;
+    filter->rows = NULL;
+    filter->row_count = 0;
+    filter->row_capacity = 0;
+    filter->row_lines = 0;
+    filter->rows_valid = 0;
+    filter->lines = 0;
+    filter->words = 0;
+}
+
+void log_filter_free(LogFilter *filter) {
+    log_filter_reset(filter);
+    log_filter_matcher_free(&filter->pattern);
+    log_filter_matcher_free(&filter->source);
+}
+
+// 把位图从 old_words 扩展到 words，新增部分清零
+static int log_filter_grow_bits(uint64_t **bits, size_t old_words, size_t words) {
+    uint64_t *grown = realloc(*bits, words * sizeof(uint64_t));
+    if (!grown) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    memset(grown + old_words, 0, (words - old_words) * sizeof(uint64_t));
+    *bits = grown;
+    return SWK_SUCCESS;
+}
+
+// 保证所有位图能容纳 lines 行
+static int log_filter_reserve(LogFilter *filter, size_t lines) {
+    size_t needed = (lines + 63) / 64;
+    if (needed <= filter->words) {
+        return SWK_SUCCESS;
+    }
+
+    size_t words = filter->words ? filter->words : 1024;
+    while (words < needed) {
+        words *= 2;
+    }
+
+    for (int i = 0; i < LOG_FILTER_LEVELS; i++) {
+        if (log_filter_grow_bits(&filter->level_bits[i], filter->words, words) != SWK_SUCCESS) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    LogFilterMatcher *matchers[] = {&filter->pattern, &filter->source};
+    for (int i = 0; i < 2; i++) {
+        if (matchers[i]->active &&
+            log_filter_grow_bits(&matchers[i]->bits, filter->words, words) != SWK_SUCCESS) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    filter->words = words;
+    return SWK_SUCCESS;
+}
+
+// 跳过方括号表达式，返回指向结尾 ']' 的指针（没有结尾时指向 '\0'）
+// 开头的 ']'（或 "^]"）是字面量；[:class:]、[=x=]、[.x.] 中的 ']' 不结束表达式；
+// 方括号内的 '\' 没有转义作用
+static const char *log_filter_skip_bracket(const char *p) {
+    p++;
+    if (*p == '^') {
+        p++;
+    }
+    if (*p == ']') {
+        p++;
+    }
+    while (*p && *p != ']') {
+        if (*p == '[' && (p[1] == ':' || p[1] == '=' || p[1] == '.')) {
+            char kind = p[1];
+            const char *end = p + 2;
+            while (*end && !(end[0] == kind && end[1] == ']')) {
+                end++;
+            }
+            if (!*end) {
+                return end;
+            }
+            p = end + 2;
+            continue;
+        }
+        p++;
+    }
+    return p;
+}
+
+// 只看括号外的部分，跳过带 ?、*、{ 量词的字符和 {m,n} 本身，顶层出现 '|' 时放弃
+size_t log_filter_required_literal(const char *regex, char *literal, size_t size) {
+    char run[LOG_FILTER_PATTERN_MAX];
+    size_t run_length = 0, best = 0;
+
+    for (const char *p = regex;; p++) {
+        char c = *p;
+        int plain = c && !strchr(LOG_FILTER_REGEX_CHARS, c);
+
+        // 转义的标点按字面量处理；其他转义（GNU 的 \w、\s、\b、\< 等）匹配的是
+        // 一类字符或一个位置，连同后面的字母一起结束连续段
+        if (c == '\\' && p[1] && strchr(LOG_FILTER_REGEX_CHARS, p[1])) {
+            c = *++p;
+            plain = 1;
+        } else if (c == '\\' && p[1]) {
+            p++;
+        }
+
+        if (plain && (p[1] == '?' || p[1] == '*' || p[1] == '{')) {
+            plain = 0;
+        }
+        if (plain && run_length + 1 < sizeof(run)) {
+            run[run_length++] = c;
+            // 字符后的 '+' 表示至少出现一次：该字符必定出现，但连续段到此为止
+            if (p[1] != '+') {
+                continue;
+            }
+        }
+
+        if (run_length > best && run_length < size) {
+            memcpy(literal, run, run_length);
+            best = run_length;
+        }
+        run_length = 0;
+
+        // 圆括号内可能是可选或重复的分组，整体跳过；方括号和 {m,n} 的内容不是字面量
+        if (!plain && c == '[') {
+            p = log_filter_skip_bracket(p);
+        } else if (!plain && c == '(') {
+            int depth = 1;
+            while (p[1] && depth > 0) {
+                p++;
+                if (*p == '[') {
+                    p = log_filter_skip_bracket(p);
+                    if (!*p) {
+                        break;
+                    }
+                } else if (*p == '\\' && p[1]) {
+                    p++;
+                } else if (*p == '(') {
+                    depth++;
+                } else if (*p == ')') {
+                    depth--;
+                }
+            }
+        } else if (!plain && c == '{') {
+            while (*p && *p != '}') {
+                p++;
+            }
+        }
+        if (!plain && c == '|') {
+            best = 0;
+            break;
+        }
+        if (!*p) {
+            break;
+        }
+    }
+
+    literal[best] = '\0';
+    return best;
+}
+
+int log_filter_matcher_compile(LogFilterMatcher *matcher, const char *text) {
+    log_filter_matcher_free(matcher);
+
+    if (!text || !text[0]) {
+        return 0;
+    }
+
+    strncpy(matcher->text, text, sizeof(matcher->text) - 1);
+    matcher->length = strlen(matcher->text);
+    matcher->regex = strpbrk(matcher->text, LOG_FILTER_REGEX_CHARS) != NULL &&
+                     regcomp(&matcher->compiled, matcher->text, REG_EXTENDED | REG_NOSUB) == 0;
+    if (matcher->regex) {
+        matcher->literal_length = log_filter_required_literal(matcher->text, matcher->literal,
+                                                              sizeof(matcher->literal));
+    } else {
+        memcpy(matcher->literal, matcher->text, matcher->length + 1);
+        matcher->literal_length = matcher->length;
+    }
+
+    matcher->active = 1;
+    return 1;
+}
+
+int log_filter_matcher_test(const LogFilterMatcher *matcher, const char *line, size_t length) {
+    if (!matcher->regex) {
+        return memmem(line, length, matcher->literal, matcher->literal_length) != NULL;
+    }
+
+    regmatch_t range = {0, (regoff_t)length};
+    return regexec(&matcher->compiled, line, 1, &range, REG_STARTEND) == 0;
+}
+
+// 编译匹配条件；所有按行结果需要重新计算
+static void log_filter_compile(LogFilter *filter, LogFilterMatcher *matcher, const char *text) {
+    filter->rows_valid = 0;
+
+    // 位图在下一次 log_filter_update 时按当前行数分配
+    if (log_filter_matcher_compile(matcher, text) && filter->words > 0) {
+        matcher->bits = calloc(filter->words, sizeof(uint64_t));
+        if (!matcher->bits) {
+            matcher->active = 0;
+            return;
+        }
+    }
+}
+
+void log_filter_set_level(LogFilter *filter, LogLevel min_level) {
+    if ((int)min_level < LOG_DEBUG) {
+        min_level = LOG_DEBUG;
+    } else if ((int)min_level > LOG_FATAL) {
+        min_level = LOG_FATAL;
+    }
+    if (filter->min_level != min_level) {
+        filter->min_level = min_level;
+        filter->rows_valid = 0;
+    }
+}
+
+void log_filter_set_pattern(LogFilter *filter, const char *pattern) {
+    log_filter_compile(filter, &filter->pattern, pattern);
+}
+
+void log_filter_set_source(LogFilter *filter, const char *source) {
+    log_filter_compile(filter, &filter->source, source);
+}
+
+void log_filter_set_range(LogFilter *filter, int active, size_t first, size_t end) {
+    if (!active) {
+        first = 0;
+        end = 0;
+    }
+    if (filter->range_active != active || filter->range_first != first || filter->range_end != end) {
+        filter->range_active = active;
+        filter->range_first = first;
+        filter->range_end = end;
+        filter->rows_valid = 0;
+    }
+}
+
+int log_filter_active(const LogFilter *filter) {
+    return filter->min_level > LOG_DEBUG || filter->pattern.active || filter->source.active ||
+           filter->range_active;
+}
+
+const char *log_filter_line_header(const char *line, size_t length, LogLevel *level) {
+    const char *end = line + length;
+    const char *close = memchr(line, ']', length);
+    const char *open = close ? memchr(close, '[', (size_t)(end - close)) : NULL;
+    const char *level_end = open ? memchr(open, ']', (size_t)(end - open)) : NULL;
+
+    *level = LOG_INFO;
+    if (!level_end) {
+        return line;
+    }
+
+    size_t level_length = (size_t)(level_end - open - 1);
+    for (int i = 0; i < LOG_FILTER_LEVELS; i++) {
+        if (log_filter_level_lengths[i] == level_length &&
+            strncasecmp(open + 1, log_filter_level_names[i], level_length) == 0) {
+            *level = (LogLevel)i;
+            break;
+        }
+    }
+    if (level_length == 7 && strncasecmp(open + 1, "WARNING", 7) == 0) {
+        *level = LOG_WARNING;
+    }
+
+    const char *message = level_end + 1;
+    while (message < end && *message == ' ') {
+        message++;
+    }
+    return message;
+}
+
+LogLevel log_filter_line_level(const char *line, size_t length) {
+    LogLevel level;
+
+    log_filter_line_header(line, length, &level);
+    return level;
+}
+
+// 第 line 行的内容（不含换行与行尾的 '\r'）
+static const char *log_filter_line(const char *text, size_t text_size, const LogLineIndex *index,
+                                   size_t line, size_t *length) {
+    size_t offset = index->offsets[line];
+    const char *start = text + offset;
+    const char *newline = memchr(start, '\n', text_size - offset);
+    size_t line_length = newline ? (size_t)(newline - start) : text_size - offset;
+
+    if (line_length > 0 && start[line_length - 1] == '\r') {
+        line_length--;
+    }
+    *length = line_length;
+    return start;
+}
+
+// 第 line 行是否匹配正则
+static int log_filter_regex_line(const LogFilterMatcher *matcher, const char *text, size_t text_size,
+                                 const LogLineIndex *index, size_t line) {
+    size_t length;
+    const char *start = log_filter_line(text, text_size, index, line, &length);
+
+    return log_filter_matcher_test(matcher, start, length);
+}
+
+// 补算匹配结果：字面量在整段文本上查找后映射回行号，跳过不含它的大段文本；
+// 正则先用必须出现的字面量挑出候选行，没有这样的字面量时只能逐行匹配
+static void log_filter_match(LogFilterMatcher *matcher, const char *text, size_t text_size,
+                             const LogLineIndex *index, size_t count) {
+    size_t line = matcher->lines;
+
+    if (matcher->literal_length == 0) {
+        for (; line < count; line++) {
+            if (log_filter_regex_line(matcher, text, text_size, index, line)) {
+                matcher->bits[line / 64] |= 1ULL << (line % 64);
+            }
+        }
+        matcher->lines = count;
+        return;
+    }
+
+    while (line < count) {
+        const char *from = text + index->offsets[line];
+        const char *hit = memmem(from, (size_t)(text + text_size - from), matcher->literal, matcher->literal_length);
+        if (!hit) {
+            break;
+        }
+
+        size_t hit_line = log_index_line_of(index, line, count, (uint64_t)(hit - text));
+        if (!matcher->regex || log_filter_regex_line(matcher, text, text_size, index, hit_line)) {
+            matcher->bits[hit_line / 64] |= 1ULL << (hit_line % 64);
+        }
+        line = hit_line + 1;
+    }
+
+    matcher->lines = count;
+}
+
+int log_filter_update(LogFilter *filter, const char *text, size_t text_size, const LogLineIndex *index) {
+    size_t count = index->count;
+
+    if (count < filter->lines) {
+        log_filter_reset(filter);
+    }
+    if (log_filter_reserve(filter, count) != SWK_SUCCESS) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t line = filter->lines; line < count; line++) {
+        size_t length;
+        const char *start = log_filter_line(text, text_size, index, line, &length);
+        LogLevel level = log_filter_line_level(start, length);
+
+        filter->level_bits[level][line / 64] |= 1ULL << (line % 64);
+        filter->level_counts[level]++;
+    }
+    filter->lines = count;
+
+    LogFilterMatcher *matchers[] = {&filter->pattern, &filter->source};
+    for (int i = 0; i < 2; i++) {
+        if (!matchers[i]->active || matchers[i]->lines == count) {
+            continue;
+        }
+        if (!matchers[i]->bits) {
+            matchers[i]->bits = calloc(filter->words, sizeof(uint64_t));
+            if (!matchers[i]->bits) {
+                return SWK_ERROR_OUT_OF_MEMORY;
+            }
+        }
+        log_filter_match(matchers[i], text, text_size, index, count);
+    }
+
+    return SWK_SUCCESS;
+}
+
+int log_filter_level_count(const LogFilter *filter, LogLevel level) {
+    if ((int)level < 0 || (int)level >= LOG_FILTER_LEVELS) {
+        return 0;
+    }
+    return filter->level_counts[level];
+}
+
+// 第 word 个字（64 行）中通过所有过滤条件的行
+static uint64_t log_filter_word(const LogFilter *filter, size_t word) {
+    uint64_t bits = 0;
+
+    for (int i = filter->min_level; i < LOG_FILTER_LEVELS; i++) {
+        bits |= filter->level_bits[i][word];
+    }
+    if (filter->pattern.active) {
+        bits &= filter->pattern.bits[word];
+    }
+    if (filter->source.active) {
+        bits &= filter->source.bits[word];
+    }
+    if (filter->range_active) {
+        size_t first = word * 64;
+        if (filter->range_end <= first || filter->range_first >= first + 64) {
+            return 0;
+        }
+        if (filter->range_first > first) {
+            bits &= ~0ULL << (filter->range_first - first);
+        }
+        if (filter->range_end < first + 64) {
+            bits &= (1ULL << (filter->range_end - first)) - 1;
+        }
+    }
+    return bits;
+}
+
+int log_filter_contains(const LogFilter *filter, size_t line) {
+    if (line >= filter->lines) {
+        return 0;
+    }
+    return !log_filter_active(filter) || ((log_filter_word(filter, line / 64) >> (line % 64)) & 1);
+}
+
+size_t log_filter_count(const LogFilter *filter) {
+    if (!log_filter_active(filter)) {
+        return filter->lines;
+    }
+    if (filter->rows_valid && filter->row_lines == filter->lines) {
+        return filter->row_count;
+    }
+
+    size_t count = 0;
+    size_t full = filter->lines / 64;
+    for (size_t word = 0; word < full; word++) {
+        count += (size_t)__builtin_popcountll(log_filter_word(filter, word));
+    }
+    if (filter->lines % 64) {
+        uint64_t mask = (1ULL << (filter->lines % 64)) - 1;
+        count += (size_t)__builtin_popcountll(log_filter_word(filter, full) & mask);
+    }
+    return count;
+}
+
+// 物化视图：失效时从头生成，否则只追加新覆盖的行
+static int log_filter_materialize(LogFilter *filter) {
+    if (!filter->rows_valid) {
+        filter->row_count = 0;
+        filter->row_lines = 0;
+        filter->rows_valid = 1;
+    }
+
+    size_t line = filter->row_lines;
+    while (line < filter->lines) {
+        size_t word = line / 64;
+        uint64_t bits = log_filter_word(filter, word) & (~0ULL << (line % 64));
+        size_t word_end = (word + 1) * 64 < filter->lines ? (word + 1) * 64 : filter->lines;
+
+        if (word_end % 64) {
+            bits &= (1ULL << (word_end % 64)) - 1;
+        }
+        if (filter->row_count + 64 > filter->row_capacity) {
+            size_t capacity = filter->row_capacity ? filter->row_capacity * 2 : 4096;
+            uint32_t *rows = realloc(filter->rows, capacity * sizeof(uint32_t));
+            if (!rows) {
+                filter->row_lines = line;
+                return SWK_ERROR_OUT_OF_MEMORY;
+            }
+            filter->rows = rows;
+            filter->row_capacity = capacity;
+        }
+        while (bits) {
+            filter->rows[filter->row_count++] = (uint32_t)(word * 64 + (size_t)__builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+        line = word_end;
+    }
+
+    filter->row_lines = filter->lines;
+    return SWK_SUCCESS;
+}
+
+long log_filter_row(LogFilter *filter, size_t position) {
+    if (!log_filter_active(filter)) {
+        return position < filter->lines ? (long)position : -1;
+    }
+    log_filter_materialize(filter);
+    return position < filter->row_count ? (long)filter->rows[position] : -1;
+}
+
+size_t log_filter_position(LogFilter *filter, size_t line) {
+    if (!log_filter_active(filter)) {
+        return line < filter->lines ? line : filter->lines;
+    }
+    log_filter_materialize(filter);
+
+    size_t lo = 0, hi = filter->row_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (filter->rows[mid] < line) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,358 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "log_index.h"
+#include "simd_string.h"
+#include "fast_hash.h"
+#include "logger.h"
+
+#define LOG_INDEX_BLOCK (1024 * 1024)   // 每扫描这么多字节更新一次进度
+#define LOG_INDEX_BATCH 4096            // 每次从扫描器取出的换行位置数
+#define LOG_INDEX_POLL_NS 50000000L     // 并行建立时报告进度的间隔
+
+// 一个并行块
+typedef struct {
+    const char *text;
+    size_t start;            // 块起点，总是行首
+    size_t end;
+    size_t indexed;          // 块内最后一个换行之后的偏移
+    LogLineIndex lines;
+    uint64_t *done;          // 所有块共享的已扫描字节数
+    int *finished;           // 已完成的块数
+} LogIndexChunk;
+
+void log_index_init(LogLineIndex *index) {
+    index->offsets = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
+
+void log_index_free(LogLineIndex *index) {
+    free(index->offsets);
+    log_index_init(index);
+}
+
+static int log_index_reserve(LogLineIndex *index, size_t count) {
+    if (count <= index->capacity) {
+        return SWK_SUCCESS;
+    }
+
+    size_t capacity = index->capacity ? index->capacity : 4096;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+    uint64_t *offsets = realloc(index->offsets, capacity * sizeof(uint64_t));
+    if (!offsets) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    index->offsets = offsets;
+    index->capacity = capacity;
+    return SWK_SUCCESS;
+}
+
+// 扫描 text[start, end)，每完成一个块把字节数累加到 *done（可为 NULL）
+static size_t log_index_scan_range(LogLineIndex *index, const char *text, size_t start, size_t end,
+                                   uint64_t *done, LogIndexProgress progress, void *context) {
+    uint64_t newlines[LOG_INDEX_BATCH];
+    size_t line_start = start;
+    size_t pos = start;
+
+    while (pos < end) {
+        size_t block_end = end - pos > LOG_INDEX_BLOCK ? pos + LOG_INDEX_BLOCK : end;
+        size_t block_start = pos;
+
+        while (pos < block_end) {
+            size_t scanned;
+            size_t found = fast_memchr_all(text + pos, block_end - pos, '\n', pos,
+                                           newlines, LOG_INDEX_BATCH, &scanned);
+
+            if (log_index_reserve(index, index->count + found) != SWK_SUCCESS) {
+                return line_start;
+            }
+            for (size_t i = 0; i < found; i++) {
+                size_t newline = (size_t)newlines[i];
+                // 跳过空行与只有 "\r" 的行
+                if (newline > line_start && !(newline == line_start + 1 && text[line_start] == '\r')) {
+                    index->offsets[index->count++] = line_start;
+                }
+                line_start = newline + 1;
+            }
+            pos += scanned;
+        }
+
+        if (done) {
+            uint64_t total = __atomic_add_fetch(done, block_end - block_start, __ATOMIC_RELAXED);
+            if (progress) {
+                progress(total, end - start, context);
+            }
+        }
+    }
+
+    return line_start;
+}
+
+size_t log_index_scan(LogLineIndex *index, const char *text, size_t start, size_t end) {
+    return log_index_scan_range(index, text, start, end, NULL, NULL, NULL);
+}
+
+static void *log_index_chunk_thread(void *arg) {
+    LogIndexChunk *chunk = arg;
+
+    chunk->indexed = log_index_scan_range(&chunk->lines, chunk->text, chunk->start, chunk->end,
+                                          chunk->done, NULL, NULL);
+    __atomic_add_fetch(chunk->finished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static int log_index_thread_count(size_t length) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t by_size = length / (LOG_INDEX_PARALLEL_MIN / 2);
+    int threads = cpus > 0 ? (int)cpus : 1;
+
+    if (threads > LOG_INDEX_MAX_THREADS) {
+        threads = LOG_INDEX_MAX_THREADS;
+    }
+    if ((size_t)threads > by_size) {
+        threads = (int)by_size;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+size_t log_index_build(LogLineIndex *index, const char *text, size_t start, size_t end,
+                       LogIndexProgress progress, void *context) {
+    uint64_t done = 0;
+    int threads = end - start >= LOG_INDEX_PARALLEL_MIN ? log_index_thread_count(end - start) : 1;
+
+    if (threads <= 1) {
+        return log_index_scan_range(index, text, start, end, &done, progress, context);
+    }
+
+    // 块边界放在名义切分点之后的第一个换行之后，每块都从行首开始
+    LogIndexChunk chunks[LOG_INDEX_MAX_THREADS];
+    pthread_t tids[LOG_INDEX_MAX_THREADS];
+    int started[LOG_INDEX_MAX_THREADS];
+    int finished = 0;
+    size_t step = (end - start) / (size_t)threads;
+    size_t boundary = start;
+
+    for (int i = 0; i < threads; i++) {
+        size_t chunk_end = end;
+        if (i < threads - 1) {
+            size_t nominal = start + step * (size_t)(i + 1);
+            const char *newline = nominal >= boundary ? memchr(text + nominal, '\n', end - nominal) : NULL;
+            chunk_end = nominal < boundary ? boundary : newline ? (size_t)(newline - text) + 1 : end;
+        }
+
+        chunks[i].text = text;
+        chunks[i].start = boundary;
+        chunks[i].end = chunk_end;
+        chunks[i].indexed = boundary;
+        log_index_init(&chunks[i].lines);
+        chunks[i].done = &done;
+        chunks[i].finished = &finished;
+        boundary = chunk_end;
+    }
+
+    int running = 0;
+    for (int i = 0; i < threads; i++) {
+        started[i] = pthread_create(&tids[i], NULL, log_index_chunk_thread, &chunks[i]) == 0;
+        if (started[i]) {
+            running++;
+        }
+    }
+
+    // 主线程只负责报告进度；未能启动线程的块最后在主线程中完成
+    while (__atomic_load_n(&finished, __ATOMIC_ACQUIRE) < running) {
+        struct timespec delay = {0, LOG_INDEX_POLL_NS};
+        nanosleep(&delay, NULL);
+        if (progress) {
+            progress(__atomic_load_n(&done, __ATOMIC_RELAXED), end - start, context);
+        }
+    }
+    for (int i = 0; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(tids[i], NULL);
+        } else {
+            log_index_chunk_thread(&chunks[i]);
+        }
+    }
+    if (progress) {
+        progress(done, end - start, context);
+    }
+
+    // 按顺序拼接；某块因内存不足没有扫完时，其后的块全部丢弃
+    size_t indexed = start;
+    size_t total = index->count;
+    for (int i = 0; i < threads; i++) {
+        total += chunks[i].lines.count;
+    }
+    int ok = log_index_reserve(index, total) == SWK_SUCCESS;
+
+    for (int i = 0; i < threads && ok; i++) {
+        if (chunks[i].lines.count > 0) {
+            memcpy(index->offsets + index->count, chunks[i].lines.offsets,
+                   chunks[i].lines.count * sizeof(uint64_t));
+            index->count += chunks[i].lines.count;
+        }
+        indexed = chunks[i].indexed;
+        ok = chunks[i].indexed == chunks[i].end || i == threads - 1;
+    }
+    for (int i = 0; i < threads; i++) {
+        log_index_free(&chunks[i].lines);
+    }
+
+    return indexed;
+}
+
+size_t log_index_line_of(const LogLineIndex *index, size_t first, size_t count, uint64_t offset) {
+    size_t lo = first, hi = count;
+
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->offsets[mid] <= offset) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static int log_index_read_at(int fd, void *data, size_t length, off_t offset) {
+    uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = pread(fd, p, length, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        offset += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static int log_index_write_all(int fd, const void *data, size_t length) {
+    const uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static void log_index_path(char *path, size_t size, const char *log_path) {
+    snprintf(path, size, "%s%s", log_path, LOG_INDEX_SUFFIX);
+}
+
+uint64_t log_index_fingerprint(const char *text, size_t indexed) {
+    size_t length = indexed < LOG_INDEX_TAIL_CHECK ? indexed : LOG_INDEX_TAIL_CHECK;
+
+    if (length == 0) {
+        return 0;
+    }
+    return fast_hash64(text + indexed - length, length, indexed);
+}
+
+int64_t log_index_mtime_ns(const struct stat *st) {
+    return (int64_t)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+}
+
+size_t log_index_load(LogLineIndex *index, const char *log_path, const struct stat *st, const char *text) {
+    char path[MAX_PATH_LENGTH + 16];
+    LogIndexFileHeader header;
+
+    log_index_free(index);
+    log_index_path(path, sizeof(path), log_path);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+
+    // 文件未变化时直接沿用；只是变大时还要确认已索引部分没有被改写
+    int valid = log_index_read_at(fd, &header, sizeof(header), 0) == 0 &&
+                memcmp(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == LOG_INDEX_VERSION &&
+                header.inode == (uint64_t)st->st_ino &&
+                header.indexed_size <= header.file_size &&
+                header.line_count <= header.indexed_size &&
+                (header.file_size == (uint64_t)st->st_size ?
+                     header.mtime_ns == log_index_mtime_ns(st) :
+                     header.file_size < (uint64_t)st->st_size) &&
+                log_index_fingerprint(text, header.indexed_size) == header.tail_hash;
+
+    if (valid && log_index_reserve(index, header.line_count) == SWK_SUCCESS) {
+        size_t bytes = header.line_count * sizeof(uint64_t);
+        valid = log_index_read_at(fd, index->offsets, bytes, sizeof(header)) == 0 &&
+                (header.line_count == 0 || index->offsets[header.line_count - 1] < header.indexed_size);
+        // 偏移必须严格递增，否则二分查找和按行取文本都会越界
+        for (size_t i = 1; valid && i < header.line_count; i++) {
+            valid = index->offsets[i] > index->offsets[i - 1];
+        }
+        index->count = valid ? header.line_count : 0;
+    } else {
+        valid = 0;
+    }
+    close(fd);
+
+    if (!valid) {
+        log_index_free(index);
+        return 0;
+    }
+
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded %zu line offsets from %s", index->count, path);
+    return (size_t)header.indexed_size;
+}
+
+int log_index_save(const LogLineIndex *index, const char *log_path, const struct stat *st,
+                   const char *text, size_t indexed) {
+    char path[MAX_PATH_LENGTH + 16], tmp[MAX_PATH_LENGTH + 48];
+    LogIndexFileHeader header;
+
+    log_index_path(path, sizeof(path), log_path);
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid());
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_INDEX_MAGIC, sizeof(header.magic));
+    header.version = LOG_INDEX_VERSION;
+    header.inode = (uint64_t)st->st_ino;
+    header.file_size = (uint64_t)st->st_size;
+    header.mtime_ns = log_index_mtime_ns(st);
+    header.indexed_size = indexed;
+    header.tail_hash = log_index_fingerprint(text, indexed);
+    header.line_count = index->count;
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return SWK_ERROR_PERMISSION_DENIED;
+    }
+
+    int ok = log_index_write_all(fd, &header, sizeof(header)) == 0 &&
+             log_index_write_all(fd, index->offsets, index->count * sizeof(uint64_t)) == 0;
+
+    if (close(fd) != 0 || !ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Cannot write line index %s: %s", path, strerror(errno));
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    return SWK_SUCCESS;
+}
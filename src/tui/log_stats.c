@@ -0,0 +1,453 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "log_stats.h"
+#include "log_filter.h"
+#include "log_time.h"
+#include "fast_hash.h"
+
+#define LOG_STATS_MAX_THREADS LOG_INDEX_MAX_THREADS
+#define LOG_STATS_TEMPLATE_MAX 256  // 参与哈希的模板长度
+
+static const char *const log_stats_bars[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+static void log_stats_reset_buckets(LogStatsBucket *ring, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        ring[i].key = -1;
+        ring[i].total = 0;
+        ring[i].errors = 0;
+    }
+}
+
+void log_stats_init(LogStats *stats) {
+    memset(stats, 0, sizeof(LogStats));
+    stats->first_minute = -1;
+    stats->last_minute = -1;
+    stats->stamp_minute = -1;
+    snprintf(stats->sources[LOG_STATS_SOURCES].name, LOG_STATS_SOURCE_NAME, "other");
+    log_stats_reset_buckets(stats->minutes, LOG_STATS_MINUTES);
+    log_stats_reset_buckets(stats->hours, LOG_STATS_HOURS);
+    log_stats_reset_buckets(stats->days, LOG_STATS_DAYS);
+}
+
+// 环形桶：key 对应的槽中是更早的时间时覆盖，是更晚的时间说明 key 已超出保留范围
+static void log_stats_bucket_add(LogStatsBucket *ring, size_t size, int64_t key, uint32_t total, uint32_t errors) {
+    LogStatsBucket *bucket = &ring[(uint64_t)key % size];
+
+    if (bucket->key > key) {
+        return;
+    }
+    if (bucket->key < key) {
+        bucket->key = key;
+        bucket->total = 0;
+        bucket->errors = 0;
+    }
+    bucket->total += total;
+    bucket->errors += errors;
+}
+
+static const LogStatsBucket *log_stats_bucket(const LogStatsBucket *ring, size_t size, int64_t key) {
+    if (key < 0) {
+        return NULL;
+    }
+    const LogStatsBucket *bucket = &ring[(uint64_t)key % size];
+    return bucket->key == key ? bucket : NULL;
+}
+
+const LogStatsBucket *log_stats_minute(const LogStats *stats, int64_t minute) {
+    return log_stats_bucket(stats->minutes, LOG_STATS_MINUTES, minute);
+}
+
+const LogStatsBucket *log_stats_hour(const LogStats *stats, int64_t hour) {
+    return log_stats_bucket(stats->hours, LOG_STATS_HOURS, hour);
+}
+
+const LogStatsBucket *log_stats_day(const LogStats *stats, int64_t day) {
+    return log_stats_bucket(stats->days, LOG_STATS_DAYS, day);
+}
+
+static void log_stats_add_time(LogStats *stats, int64_t minute, uint32_t total, uint32_t errors) {
+    log_stats_bucket_add(stats->minutes, LOG_STATS_MINUTES, minute, total, errors);
+    log_stats_bucket_add(stats->hours, LOG_STATS_HOURS, minute / 60, total, errors);
+    log_stats_bucket_add(stats->days, LOG_STATS_DAYS, minute / 1440, total, errors);
+}
+
+int64_t log_stats_line_minute(const char *line, size_t length) {
+    int64_t ms = log_time_parse(line, length);
+    return ms >= 0 ? ms / 60000 : -1;
+}
+
+static int log_stats_tag_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '-' || c == '.';
+}
+
+// 消息开头的 "[标签]" 或 "标签:"，没有时返回 0
+static size_t log_stats_tag(const char *message, size_t length, const char **tag) {
+    size_t start = length > 0 && message[0] == '[' ? 1 : 0;
+    size_t i = start;
+
+    while (i < length && i - start < LOG_STATS_SOURCE_NAME - 1 && log_stats_tag_char(message[i])) {
+        i++;
+    }
+    if (i == start || i >= length || message[i] != (start ? ']' : ':')) {
+        return 0;
+    }
+    *tag = message + start;
+    return i - start;
+}
+
+static LogStatsSource *log_stats_source(LogStats *stats, const char *name, size_t length) {
+    if (length == 0) {
+        return &stats->sources[LOG_STATS_SOURCES];
+    }
+    for (int i = 0; i < stats->source_count; i++) {
+        if (stats->sources[i].name[length] == '\0' && memcmp(stats->sources[i].name, name, length) == 0) {
+            return &stats->sources[i];
+        }
+    }
+    if (stats->source_count == LOG_STATS_SOURCES) {
+        return &stats->sources[LOG_STATS_SOURCES];
+    }
+
+    LogStatsSource *source = &stats->sources[stats->source_count++];
+    memcpy(source->name, name, length);
+    source->name[length] = '\0';
+    return source;
+}
+
+// 消息模板：连续的数字折叠为一个 '#'，返回长度
+static size_t log_stats_template(char *out, const char *message, size_t length) {
+    size_t n = 0;
+    int digits = 0;
+
+    // 无分支：数字写成 '#'，前一个字节也是数字时不前进
+    for (size_t i = 0; i < length && n < LOG_STATS_TEMPLATE_MAX; i++) {
+        int digit = (unsigned char)(message[i] - '0') < 10;
+        out[n] = digit ? '#' : message[i];
+        n += !(digit & digits);
+        digits = digit;
+    }
+    return n;
+}
+
+// Space-Saving：已有计数器加一；否则接管计数最小的计数器，继承其计数作为高估量
+static void log_stats_count_message(LogStats *stats, const char *message, size_t length, LogLevel level) {
+    char text[LOG_STATS_TEMPLATE_MAX];
+    size_t text_length = log_stats_template(text, message, length);
+    uint64_t hash = fast_hash64(text, text_length, 0);
+    LogStatsMessage *entry = NULL;
+
+    for (int i = 0; i < stats->top_count; i++) {
+        if (stats->top[i].hash == hash) {
+            stats->top[i].count++;
+            stats->top[i].level = level;
+            return;
+        }
+    }
+
+    if (stats->top_count < LOG_STATS_TOP) {
+        entry = &stats->top[stats->top_count++];
+        entry->count = 0;
+    } else {
+        entry = &stats->top[0];
+        for (int i = 1; i < LOG_STATS_TOP; i++) {
+            if (stats->top[i].count < entry->count) {
+                entry = &stats->top[i];
+            }
+        }
+    }
+
+    if (text_length > LOG_STATS_SAMPLE - 1) {
+        text_length = LOG_STATS_SAMPLE - 1;
+    }
+    entry->hash = hash;
+    entry->error = entry->count;
+    entry->count++;
+    entry->level = level;
+    memcpy(entry->text, text, text_length);
+    entry->text[text_length] = '\0';
+}
+
+static void log_stats_line(LogStats *stats, const char *line, size_t length) {
+    LogLevel level;
+    const char *message = log_filter_line_header(line, length, &level);
+    size_t message_length = (size_t)(line + length - message);
+    uint32_t error = level >= LOG_ERROR;
+
+    stats->level_counts[level]++;
+
+    // 相邻的行通常在同一分钟内，时间戳前缀相同时不再解析
+    int64_t minute = stats->stamp_minute;
+    if (length < LOG_TIME_STAMP_LENGTH || memcmp(line, stats->stamp, LOG_STATS_STAMP) != 0) {
+        minute = log_stats_line_minute(line, length);
+        if (minute >= 0) {
+            memcpy(stats->stamp, line, LOG_STATS_STAMP);
+            stats->stamp_minute = minute;
+        }
+    }
+    if (minute < 0) {
+        stats->untimed++;
+    } else {
+        if (stats->first_minute < 0 || minute < stats->first_minute) {
+            stats->first_minute = minute;
+        }
+        if (minute > stats->last_minute) {
+            stats->last_minute = minute;
+        }
+        log_stats_add_time(stats, minute, 1, error);
+    }
+
+    const char *tag = NULL;
+    size_t tag_length = log_stats_tag(message, message_length, &tag);
+    LogStatsSource *source = log_stats_source(stats, tag, tag_length);
+    source->count++;
+    source->errors += error;
+
+    log_stats_count_message(stats, message, message_length, level);
+}
+
+static void log_stats_range(LogStats *stats, const char *text, size_t text_size,
+                            const LogLineIndex *index, size_t first, size_t end) {
+    for (size_t line = first; line < end; line++) {
+        size_t offset = index->offsets[line];
+        size_t limit = line + 1 < index->count ? index->offsets[line + 1] : text_size;
+        const char *start = text + offset;
+        const char *newline = memchr(start, '\n', limit - offset);
+        size_t length = newline ? (size_t)(newline - start) : limit - offset;
+
+        if (length > 0 && start[length - 1] == '\r') {
+            length--;
+        }
+        log_stats_line(stats, start, length);
+    }
+    stats->lines += end - first;
+}
+
+static uint64_t log_stats_min_count(const LogStats *stats) {
+    uint64_t min = 0;
+
+    if (stats->top_count == LOG_STATS_TOP) {
+        min = stats->top[0].count;
+        for (int i = 1; i < LOG_STATS_TOP; i++) {
+            if (stats->top[i].count < min) {
+                min = stats->top[i].count;
+            }
+        }
+    }
+    return min;
+}
+
+static int log_stats_compare_count(const void *a, const void *b) {
+    const LogStatsMessage *x = a;
+    const LogStatsMessage *y = b;
+    return x->count > y->count ? -1 : x->count < y->count;
+}
+
+// 合并两个 Space-Saving 摘要：一方没有的消息按对方的最小计数补上（也计入高估量）
+static void log_stats_merge_top(LogStats *stats, const LogStats *other) {
+    LogStatsMessage merged[LOG_STATS_TOP * 2];
+    uint64_t min_self = log_stats_min_count(stats);
+    uint64_t min_other = log_stats_min_count(other);
+    int count = 0;
+
+    for (int i = 0; i < stats->top_count; i++) {
+        const LogStatsMessage *match = NULL;
+        for (int j = 0; j < other->top_count && !match; j++) {
+            if (other->top[j].hash == stats->top[i].hash) {
+                match = &other->top[j];
+            }
+        }
+
+        merged[count] = stats->top[i];
+        merged[count].count += match ? match->count : min_other;
+        merged[count].error += match ? match->error : min_other;
+        if (match) {
+            merged[count].level = match->level;
+        }
+        count++;
+    }
+
+    for (int j = 0; j < other->top_count; j++) {
+        int found = 0;
+        for (int i = 0; i < stats->top_count && !found; i++) {
+            found = stats->top[i].hash == other->top[j].hash;
+        }
+        if (!found) {
+            merged[count] = other->top[j];
+            merged[count].count += min_self;
+            merged[count].error += min_self;
+            count++;
+        }
+    }
+
+    qsort(merged, (size_t)count, sizeof(LogStatsMessage), log_stats_compare_count);
+    stats->top_count = count < LOG_STATS_TOP ? count : LOG_STATS_TOP;
+    memcpy(stats->top, merged, (size_t)stats->top_count * sizeof(LogStatsMessage));
+}
+
+void log_stats_merge(LogStats *stats, const LogStats *other) {
+    stats->lines += other->lines;
+    stats->untimed += other->untimed;
+    for (int i = 0; i < LOG_STATS_LEVELS; i++) {
+        stats->level_counts[i] += other->level_counts[i];
+    }
+
+    if (other->first_minute >= 0 && (stats->first_minute < 0 || other->first_minute < stats->first_minute)) {
+        stats->first_minute = other->first_minute;
+    }
+    if (other->last_minute > stats->last_minute) {
+        stats->last_minute = other->last_minute;
+    }
+
+    for (int i = 0; i <= LOG_STATS_SOURCES; i++) {
+        const LogStatsSource *from = &other->sources[i];
+        if (i < other->source_count || (i == LOG_STATS_SOURCES && from->count > 0)) {
+            LogStatsSource *to = i == LOG_STATS_SOURCES ? &stats->sources[LOG_STATS_SOURCES] :
+                                 log_stats_source(stats, from->name, strlen(from->name));
+            to->count += from->count;
+            to->errors += from->errors;
+        }
+    }
+
+    const LogStatsBucket *rings[] = {other->minutes, other->hours, other->days};
+    LogStatsBucket *targets[] = {stats->minutes, stats->hours, stats->days};
+    const size_t sizes[] = {LOG_STATS_MINUTES, LOG_STATS_HOURS, LOG_STATS_DAYS};
+    for (int r = 0; r < 3; r++) {
+        for (size_t i = 0; i < sizes[r]; i++) {
+            if (rings[r][i].key >= 0) {
+                log_stats_bucket_add(targets[r], sizes[r], rings[r][i].key, rings[r][i].total, rings[r][i].errors);
+            }
+        }
+    }
+
+    log_stats_merge_top(stats, other);
+}
+
+typedef struct {
+    LogStats stats;
+    const char *text;
+    size_t text_size;
+    const LogLineIndex *index;
+    size_t first;
+    size_t end;
+} LogStatsChunk;
+
+static void *log_stats_chunk_thread(void *arg) {
+    LogStatsChunk *chunk = arg;
+
+    log_stats_range(&chunk->stats, chunk->text, chunk->text_size, chunk->index, chunk->first, chunk->end);
+    return NULL;
+}
+
+static int log_stats_thread_count(size_t lines) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t by_lines = lines / (LOG_STATS_PARALLEL_MIN / 2);
+    int threads = cpus > 0 ? (int)cpus : 1;
+
+    if (threads > LOG_STATS_MAX_THREADS) {
+        threads = LOG_STATS_MAX_THREADS;
+    }
+    if ((size_t)threads > by_lines) {
+        threads = (int)by_lines;
+    }
+    return threads > 0 ? threads : 1;
+}
+
+void log_stats_update(LogStats *stats, const char *text, size_t text_size, const LogLineIndex *index) {
+    size_t first = stats->lines;
+    size_t count = index->count;
+    int threads = count - first >= LOG_STATS_PARALLEL_MIN ? log_stats_thread_count(count - first) : 1;
+
+    if (first >= count) {
+        return;
+    }
+
+    LogStatsChunk *chunks = threads > 1 ? malloc((size_t)threads * sizeof(LogStatsChunk)) : NULL;
+    if (!chunks) {
+        log_stats_range(stats, text, text_size, index, first, count);
+        return;
+    }
+
+    // 各块独立统计，再按顺序合并；未能启动线程的块在主线程中完成
+    pthread_t tids[LOG_STATS_MAX_THREADS];
+    int started[LOG_STATS_MAX_THREADS];
+    size_t step = (count - first) / (size_t)threads;
+
+    for (int i = 0; i < threads; i++) {
+        log_stats_init(&chunks[i].stats);
+        chunks[i].text = text;
+        chunks[i].text_size = text_size;
+        chunks[i].index = index;
+        chunks[i].first = first + step * (size_t)i;
+        chunks[i].end = i == threads - 1 ? count : first + step * (size_t)(i + 1);
+        started[i] = pthread_create(&tids[i], NULL, log_stats_chunk_thread, &chunks[i]) == 0;
+    }
+    for (int i = 0; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(tids[i], NULL);
+        } else {
+            log_stats_chunk_thread(&chunks[i]);
+        }
+        log_stats_merge(stats, &chunks[i].stats);
+    }
+    free(chunks);
+}
+
+int log_stats_top_messages(const LogStats *stats, LogStatsMessage *out, int max) {
+    int count = stats->top_count < max ? stats->top_count : max;
+    LogStatsMessage sorted[LOG_STATS_TOP];
+
+    memcpy(sorted, stats->top, (size_t)stats->top_count * sizeof(LogStatsMessage));
+    qsort(sorted, (size_t)stats->top_count, sizeof(LogStatsMessage), log_stats_compare_count);
+    if (count > 0) {
+        memcpy(out, sorted, (size_t)count * sizeof(LogStatsMessage));
+    }
+    return count > 0 ? count : 0;
+}
+
+size_t log_stats_error_sparkline(const LogStats *stats, int hours, char *out, size_t size) {
+    size_t length = 0;
+    double max_rate = 0;
+
+    if (size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    if (stats->last_minute < 0 || hours <= 0) {
+        return 0;
+    }
+
+    // 按窗口内的最高错误率缩放
+    int64_t last = stats->last_minute / 60;
+    for (int64_t hour = last - hours + 1; hour <= last; hour++) {
+        const LogStatsBucket *bucket = log_stats_hour(stats, hour);
+        if (bucket && bucket->total > 0 && (double)bucket->errors / bucket->total > max_rate) {
+            max_rate = (double)bucket->errors / bucket->total;
+        }
+    }
+
+    for (int64_t hour = last - hours + 1; hour <= last; hour++) {
+        const LogStatsBucket *bucket = log_stats_hour(stats, hour);
+        const char *bar = " ";
+        if (bucket && bucket->total > 0) {
+            int level = 0;
+            if (bucket->errors > 0) {
+                level = (int)((double)bucket->errors / bucket->total / max_rate * 7 + 0.5);
+                level = level < 1 ? 1 : level > 7 ? 7 : level;
+            }
+            bar = log_stats_bars[level];
+        }
+
+        size_t bar_length = strlen(bar);
+        if (length + bar_length >= size) {
+            break;
+        }
+        memcpy(out + length, bar, bar_length);
+        length += bar_length;
+    }
+    out[length] = '\0';
+    return length;
+}
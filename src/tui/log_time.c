@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "log_time.h"
+
+void log_time_init(LogTimeColumn *column) {
+    memset(column, 0, sizeof(LogTimeColumn));
+}
+
+void log_time_free(LogTimeColumn *column) {
+    free(column->bases);
+    free(column->deltas);
+    log_time_init(column);
+}
+
+static int log_time_digits(const char *p, int count) {
+    int value = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (p[i] < '0' || p[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+int64_t log_time_days(int year, int month, int day) {
+    // 三月为一年的开始，闰日落在年末
+    int y = month <= 2 ? year - 1 : year;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return (int64_t)era * 146097 + doe - 719468;
+}
+
+// "[YYYY-MM-DD HH:MM" 对应的毫秒数
+static int64_t log_time_parse_prefix(const char *line) {
+    if (line[0] != '[' || line[5] != '-' || line[8] != '-' || line[11] != ' ' || line[14] != ':') {
+        return -1;
+    }
+
+    int year = log_time_digits(line + 1, 4);
+    int month = log_time_digits(line + 6, 2);
+    int day = log_time_digits(line + 9, 2);
+    int hour = log_time_digits(line + 12, 2);
+    int minute = log_time_digits(line + 15, 2);
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+        return -1;
+    }
+    return (log_time_days(year, month, day) * 1440 + hour * 60 + minute) * 60000;
+}
+
+// ":SS.mmm]" 对应的毫秒数
+static int64_t log_time_parse_seconds(const char *line) {
+    if (line[17] != ':' || line[20] != '.' || line[24] != ']') {
+        return -1;
+    }
+
+    int second = log_time_digits(line + 18, 2);
+    int msec = log_time_digits(line + 21, 3);
+    if (second < 0 || second > 60 || msec < 0) {
+        return -1;
+    }
+    return second * 1000 + msec;
+}
+
+int64_t log_time_parse(const char *line, size_t length) {
+    if (length < LOG_TIME_STAMP_LENGTH) {
+        return -1;
+    }
+
+    int64_t minute = log_time_parse_prefix(line);
+    int64_t rest = minute >= 0 ? log_time_parse_seconds(line) : -1;
+    return rest >= 0 ? minute + rest : -1;
+}
+
+// 同 log_time_parse，前缀与上一行相同时只解析秒和毫秒
+static int64_t log_time_parse_cached(LogTimeColumn *column, const char *line, size_t length) {
+    if (length < LOG_TIME_STAMP_LENGTH) {
+        return -1;
+    }
+
+    int64_t rest = log_time_parse_seconds(line);
+    if (rest < 0) {
+        return -1;
+    }
+    if (column->prefix[0] != '[' || memcmp(line, column->prefix, LOG_TIME_PREFIX) != 0) {
+        int64_t minute = log_time_parse_prefix(line);
+        if (minute < 0) {
+            return -1;
+        }
+        memcpy(column->prefix, line, LOG_TIME_PREFIX);
+        column->prefix_ms = minute;
+    }
+    return column->prefix_ms + rest;
+}
+
+static int log_time_reserve(LogTimeColumn *column, size_t count) {
+    if (count <= column->capacity) {
+        return SWK_SUCCESS;
+    }
+
+    size_t capacity = column->capacity ? column->capacity : 64 * 1024;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    uint32_t *deltas = realloc(column->deltas, capacity * sizeof(uint32_t));
+    if (!deltas) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    column->deltas = deltas;
+
+    int64_t *bases = realloc(column->bases, (capacity / LOG_TIME_BLOCK + 1) * sizeof(int64_t));
+    if (!bases) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    column->bases = bases;
+    column->capacity = capacity;
+    return SWK_SUCCESS;
+}
+
+int log_time_update(LogTimeColumn *column, const char *text, size_t text_size, const LogLineIndex *index) {
+    size_t count = index->count;
+
+    if (count < column->count) {
+        log_time_free(column);
+    }
+    if (log_time_reserve(column, count) != SWK_SUCCESS) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t line = column->count; line < count; line++) {
+        uint64_t offset = index->offsets[line];
+        int64_t ms = log_time_parse_cached(column, text + offset, text_size - offset);
+
+        if (ms > column->last) {
+            column->last = ms;
+        }
+        if (line % LOG_TIME_BLOCK == 0) {
+            column->bases[line / LOG_TIME_BLOCK] = column->last;
+        }
+
+        // 一块内跨度超过 49 天时截断，列仍然单调
+        int64_t delta = column->last - column->bases[line / LOG_TIME_BLOCK];
+        column->deltas[line] = delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta;
+    }
+    column->count = count;
+    return SWK_SUCCESS;
+}
+
+int64_t log_time_at(const LogTimeColumn *column, size_t line) {
+    if (line >= column->count) {
+        return column->last;
+    }
+    return column->bases[line / LOG_TIME_BLOCK] + column->deltas[line];
+}
+
+size_t log_time_lower_bound(const LogTimeColumn *column, int64_t ms) {
+    size_t blocks = (column->count + LOG_TIME_BLOCK - 1) / LOG_TIME_BLOCK;
+
+    // 第一个首行不早于 ms 的块，答案在它的前一块中或就是它的首行
+    size_t lo = 0, hi = blocks;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (column->bases[mid] < ms) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return 0;
+    }
+
+    size_t first = (lo - 1) * LOG_TIME_BLOCK;
+    size_t end = lo * LOG_TIME_BLOCK < column->count ? lo * LOG_TIME_BLOCK : column->count;
+    int64_t base = column->bases[lo - 1];
+    while (first < end) {
+        size_t mid = first + (end - first) / 2;
+        if (base + column->deltas[mid] < ms) {
+            first = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return first;
+}
+
+int64_t log_time_parse_input(const char *text) {
+    static const char defaults[] = "[1970-01-01 00:00:00.000]";
+    char stamp[sizeof(defaults)];
+
+    if (!text) {
+        return -1;
+    }
+    while (*text == ' ' || *text == '[') {
+        text++;
+    }
+
+    size_t length = strlen(text);
+    while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == ']')) {
+        length--;
+    }
+    if (length < 4 || length > LOG_TIME_STAMP_LENGTH - 2) {
+        return -1;
+    }
+
+    // 省略的部分用默认值补齐后按日志中的格式解析
+    memcpy(stamp, defaults, sizeof(defaults));
+    memcpy(stamp + 1, text, length);
+    return log_time_parse(stamp, LOG_TIME_STAMP_LENGTH);
+}
+
+int64_t log_time_from_epoch(int64_t epoch_ms) {
+    time_t seconds = (time_t)(epoch_ms / 1000);
+    struct tm tm_info;
+
+    if (!localtime_r(&seconds, &tm_info)) {
+        return -1;
+    }
+    int64_t days = log_time_days(tm_info.tm_year + 1900, tm_info.tm_mon + 1, tm_info.tm_mday);
+    return ((days * 24 + tm_info.tm_hour) * 60 + tm_info.tm_min) * 60000 + tm_info.tm_sec * 1000 +
+           epoch_ms % 1000;
+}
+
+void log_time_format(int64_t ms, char *buf, size_t size) {
+    time_t seconds = (time_t)(ms / 1000);
+    struct tm tm_info;
+
+    if (ms < 0 || !gmtime_r(&seconds, &tm_info)) {
+        snprintf(buf, size, "-");
+        return;
+    }
+    snprintf(buf, size, "%04d-%02d-%02d %02d:%02d:%02d.%03d", tm_info.tm_year + 1900, tm_info.tm_mon + 1,
+             tm_info.tm_mday, tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec, (int)(ms % 1000));
+}
@@ -0,0 +1,693 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "log_timeline.h"
+#include "log_binary.h"
+#include "logger.h"
+
+#define LOG_TIMELINE_NONE UINT32_MAX
+
+/* ---------------- 块 ---------------- */
+
+static void log_timeline_block_free(LogTimelineBlock *block) {
+    free(block->buffer);
+    free(block->lines);
+    free(block->stamps);
+    memset(block, 0, sizeof(LogTimelineBlock));
+    block->number = LOG_TIMELINE_NONE;
+}
+
+// 行首是否为 "[YYYY-MM-DD HH:MM:SS.mmm]"
+static int log_timeline_has_stamp(const char *line, size_t length) {
+    return length > LOG_TIMELINE_STAMP + 1 && line[0] == '[' && line[5] == '-' && line[8] == '-' &&
+           line[11] == ' ' && line[14] == ':' && line[17] == ':' && line[20] == '.' &&
+           line[LOG_TIMELINE_STAMP + 1] == ']';
+}
+
+// 记录起点在 text[0, limit) 中的每个非空完整行，以及各行适用的时间戳
+static int log_timeline_block_lines(LogTimelineBlock *block, size_t limit) {
+    uint32_t capacity = 0;
+    uint32_t stamp = LOG_TIMELINE_NONE;
+    size_t pos = 0;
+
+    while (pos < limit && pos < block->size) {
+        const char *newline = memchr(block->text + pos, '\n', block->size - pos);
+        if (!newline) {
+            break;  // 最后一行还没写完
+        }
+        size_t end = (size_t)(newline - block->text);
+        if (end == pos) {
+            pos++;
+            continue;
+        }
+
+        if (block->line_count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            uint32_t *lines = realloc(block->lines, capacity * sizeof(uint32_t));
+            uint32_t *stamps = lines ? realloc(block->stamps, capacity * sizeof(uint32_t)) : NULL;
+            if (lines) {
+                block->lines = lines;
+            }
+            if (!stamps) {
+                return SWK_ERROR_OUT_OF_MEMORY;
+            }
+            block->stamps = stamps;
+        }
+
+        if (log_timeline_has_stamp(block->text + pos, end - pos)) {
+            stamp = (uint32_t)pos + 1;
+        }
+        block->lines[block->line_count] = (uint32_t)pos;
+        block->stamps[block->line_count++] = stamp;
+        pos = end + 1;
+    }
+
+    // 块开头没有时间戳的行使用块中第一个时间戳
+    uint32_t first = 0;
+    while (first < block->line_count && block->stamps[first] == LOG_TIMELINE_NONE) {
+        first++;
+    }
+    for (uint32_t i = 0; first < block->line_count && i < first; i++) {
+        block->stamps[i] = block->stamps[first];
+    }
+    return SWK_SUCCESS;
+}
+
+// 解码二进制帧（先喂入前导区）并渲染为文本
+static int log_timeline_render(LogTimelineBlock *block, const uint8_t *preamble, size_t preamble_length,
+                               const uint8_t *data, size_t length) {
+    LogBinaryDecoder *decoder = malloc(sizeof(LogBinaryDecoder));
+    char line[LOG_BINARY_RECORD_MAX + 64];
+    size_t capacity = length + length / 2 + 4096;
+    int result = SWK_SUCCESS;
+
+    block->buffer = malloc(capacity);
+    if (!decoder || !block->buffer) {
+        free(decoder);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    log_binary_decoder_init(decoder);
+
+    const uint8_t *parts[] = {preamble, data};
+    const size_t sizes[] = {preamble_length, length};
+    for (int part = 0; part < 2 && result == SWK_SUCCESS; part++) {
+        size_t offset = 0;
+        while (offset < sizes[part]) {
+            LogBinaryEvent event;
+            int has_event;
+            long used = log_binary_decode(decoder, parts[part] + offset, sizes[part] - offset, &event, &has_event);
+            if (used == 0) {
+                break;  // 不完整的最后一条记录
+            }
+            if (used < 0) {
+                offset += log_binary_resync(decoder, parts[part] + offset, sizes[part] - offset);
+                continue;
+            }
+            offset += (size_t)used;
+            if (!has_event) {
+                continue;
+            }
+
+            size_t line_length = log_binary_format_line(&event, line, sizeof(line));
+            if (block->size + line_length > capacity) {
+                capacity = capacity * 2 + line_length;
+                char *buffer = realloc(block->buffer, capacity);
+                if (!buffer) {
+                    result = SWK_ERROR_OUT_OF_MEMORY;
+                    break;
+                }
+                block->buffer = buffer;
+            }
+            memcpy(block->buffer + block->size, line, line_length);
+            block->size += line_length;
+        }
+    }
+
+    log_binary_decoder_free(decoder);
+    free(decoder);
+    block->text = block->buffer;
+    return result;
+}
+
+static int log_timeline_block_load(LogTimelineSource *source, LogTimelineBlock *block, uint32_t number) {
+    block->number = number;
+
+    if (source->kind == LOG_TIMELINE_TEXT) {
+        // 块包含起点落在 [number * BLOCK, (number + 1) * BLOCK) 中的行
+        size_t start = (size_t)number * LOG_TIMELINE_BLOCK;
+        if (start > 0) {
+            const char *newline = memchr(source->map + start - 1, '\n', source->map_size - start + 1);
+            start = newline ? (size_t)(newline - source->map) + 1 : source->map_size;
+        }
+        // 偏移相对于块的起点，超过 4GB 的日志也能用 32 位偏移
+        size_t limit = ((size_t)number + 1) * LOG_TIMELINE_BLOCK;
+        block->text = source->map + start;
+        block->size = source->map_size - start;
+        return start < limit ? log_timeline_block_lines(block, limit - start) : SWK_SUCCESS;
+    }
+
+    int result;
+    if (source->kind == LOG_TIMELINE_RENDERED) {
+        const LogArchiveFrame *frame = &source->archive.frames[number];
+        result = log_timeline_render(block, source->archive.preamble, frame->preamble_length,
+                                     (const uint8_t *)source->map + frame->decompressed_offset,
+                                     frame->decompressed_size);
+    } else {
+        uint8_t *data;
+        size_t length;
+        result = log_archive_read_frame(&source->archive, number, &data, &length);
+        if (result == SWK_SUCCESS && source->archive.binary) {
+            result = log_timeline_render(block, source->archive.preamble,
+                                         source->archive.frames[number].preamble_length, data, length);
+            free(data);
+        } else if (result == SWK_SUCCESS) {
+            block->buffer = (char *)data;
+            block->text = block->buffer;
+            block->size = length;
+        }
+    }
+    if (result != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Cannot read block %u of %s", number, source->path);
+        return result;
+    }
+    return log_timeline_block_lines(block, block->size);
+}
+
+// 取得第 number 块（读取失败时返回空块），替换最久未用的缓存槽
+static const LogTimelineBlock *log_timeline_block(LogTimelineSource *source, uint32_t number) {
+    LogTimelineBlock *victim = &source->cache[0];
+
+    for (int i = 0; i < LOG_TIMELINE_CACHE; i++) {
+        LogTimelineBlock *block = &source->cache[i];
+        if (block->number == number) {
+            block->used = ++source->clock;
+            return block;
+        }
+        if (block->used < victim->used) {
+            victim = block;
+        }
+    }
+
+    log_timeline_block_free(victim);
+    if (log_timeline_block_load(source, victim, number) != SWK_SUCCESS) {
+        log_timeline_block_free(victim);
+        victim->number = number;
+    }
+    victim->used = ++source->clock;
+    return victim;
+}
+
+static void log_timeline_key(const LogTimelineBlock *block, uint32_t line, char *key) {
+    uint32_t stamp = block->stamps[line];
+
+    if (stamp == LOG_TIMELINE_NONE) {
+        memset(key, 0, LOG_TIMELINE_STAMP);
+    } else {
+        memcpy(key, block->text + stamp, LOG_TIMELINE_STAMP);
+    }
+}
+
+/* ---------------- 游标 ---------------- */
+
+// 游标跳过空块，停在下一条存在的行或末尾
+static void log_timeline_normalize(LogTimelineSource *source) {
+    while (source->block < source->block_count) {
+        const LogTimelineBlock *block = log_timeline_block(source, source->block);
+        if (source->line < block->line_count) {
+            return;
+        }
+        source->block++;
+        source->line = 0;
+    }
+    source->line = 0;
+}
+
+// 游标之前的一行
+static int log_timeline_before_cursor(LogTimelineSource *source, uint32_t *block_number, uint32_t *line) {
+    if (source->block < source->block_count && source->line > 0) {
+        *block_number = source->block;
+        *line = source->line - 1;
+        return 1;
+    }
+    for (uint32_t b = source->block; b > 0; b--) {
+        const LogTimelineBlock *block = log_timeline_block(source, b - 1);
+        if (block->line_count > 0) {
+            *block_number = b - 1;
+            *line = block->line_count - 1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 游标移动后重新取得前后两行的时间戳
+static void log_timeline_refresh_keys(LogTimelineSource *source) {
+    uint32_t block_number, line;
+
+    log_timeline_normalize(source);
+    source->has_prev = log_timeline_before_cursor(source, &block_number, &line);
+    if (source->has_prev) {
+        log_timeline_key(log_timeline_block(source, block_number), line, source->prev_key);
+    }
+    source->has_next = source->block < source->block_count;
+    if (source->has_next) {
+        log_timeline_key(log_timeline_block(source, source->block), source->line, source->next_key);
+    }
+}
+
+/* ---------------- 堆 ---------------- */
+
+// 向后读取取 (时间戳, 段号) 最小的下一行，向前读取取最大的上一行
+static int log_timeline_before(const LogTimeline *tl, int heap, int a, int b) {
+    const LogTimelineSource *x = &tl->sources[a];
+    const LogTimelineSource *y = &tl->sources[b];
+
+    if (heap == LOG_TIMELINE_HEAP_NEXT) {
+        int c = memcmp(x->next_key, y->next_key, LOG_TIMELINE_STAMP);
+        return c < 0 || (c == 0 && a < b);
+    }
+    int c = memcmp(x->prev_key, y->prev_key, LOG_TIMELINE_STAMP);
+    return c > 0 || (c == 0 && a > b);
+}
+
+static void log_timeline_heap_set(LogTimeline *tl, int heap, int pos, int source) {
+    tl->heaps[heap].items[pos] = source;
+    tl->sources[source].heap_pos[heap] = pos;
+}
+
+static int log_timeline_sift_up(LogTimeline *tl, int heap, int pos) {
+    int *items = tl->heaps[heap].items;
+
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!log_timeline_before(tl, heap, items[pos], items[parent])) {
+            break;
+        }
+        int source = items[pos];
+        log_timeline_heap_set(tl, heap, pos, items[parent]);
+        log_timeline_heap_set(tl, heap, parent, source);
+        pos = parent;
+    }
+    return pos;
+}
+
+static void log_timeline_sift_down(LogTimeline *tl, int heap, int pos) {
+    int *items = tl->heaps[heap].items;
+    int count = tl->heaps[heap].count;
+
+    while (1) {
+        int best = pos;
+        for (int child = pos * 2 + 1; child <= pos * 2 + 2 && child < count; child++) {
+            if (log_timeline_before(tl, heap, items[child], items[best])) {
+                best = child;
+            }
+        }
+        if (best == pos) {
+            return;
+        }
+        int source = items[pos];
+        log_timeline_heap_set(tl, heap, pos, items[best]);
+        log_timeline_heap_set(tl, heap, best, source);
+        pos = best;
+    }
+}
+
+// 段的键变化后调整它在堆中的位置（没有下一行/上一行时移出堆）
+static void log_timeline_heap_update(LogTimeline *tl, int heap, int source) {
+    LogTimelineHeap *h = &tl->heaps[heap];
+    LogTimelineSource *s = &tl->sources[source];
+    int member = heap == LOG_TIMELINE_HEAP_NEXT ? s->has_next : s->has_prev;
+    int pos = s->heap_pos[heap];
+
+    if (pos < 0 && !member) {
+        return;
+    }
+    if (pos < 0) {
+        pos = h->count++;
+        log_timeline_heap_set(tl, heap, pos, source);
+    } else if (!member) {
+        int last = h->items[--h->count];
+        s->heap_pos[heap] = -1;
+        if (pos == h->count) {
+            return;
+        }
+        log_timeline_heap_set(tl, heap, pos, last);
+    }
+    log_timeline_sift_down(tl, heap, log_timeline_sift_up(tl, heap, pos));
+}
+
+static void log_timeline_source_moved(LogTimeline *tl, int source) {
+    log_timeline_refresh_keys(&tl->sources[source]);
+    log_timeline_heap_update(tl, LOG_TIMELINE_HEAP_NEXT, source);
+    log_timeline_heap_update(tl, LOG_TIMELINE_HEAP_PREV, source);
+}
+
+// 所有游标都被改动后重建两个堆
+static void log_timeline_rebuild(LogTimeline *tl) {
+    tl->heaps[0].count = 0;
+    tl->heaps[1].count = 0;
+    for (int i = 0; i < tl->source_count; i++) {
+        tl->sources[i].heap_pos[0] = -1;
+        tl->sources[i].heap_pos[1] = -1;
+    }
+    for (int i = 0; i < tl->source_count; i++) {
+        log_timeline_source_moved(tl, i);
+    }
+}
+
+/* ---------------- 段 ---------------- */
+
+static int log_timeline_add_source(LogTimeline *tl, const char *path) {
+    LogTimelineSource *source = &tl->sources[tl->source_count];
+    struct stat st;
+    size_t length = strlen(path);
+
+    memset(source, 0, sizeof(LogTimelineSource));
+    snprintf(source->path, sizeof(source->path), "%s", path);
+    source->fd = -1;
+    for (int i = 0; i < LOG_TIMELINE_CACHE; i++) {
+        source->cache[i].number = LOG_TIMELINE_NONE;
+    }
+
+    if (length > strlen(LOG_ARCHIVE_SUFFIX) &&
+        strcmp(path + length - strlen(LOG_ARCHIVE_SUFFIX), LOG_ARCHIVE_SUFFIX) == 0) {
+        if (log_archive_open(&source->archive, path) != SWK_SUCCESS) {
+            SWK_LOG_WARN(LOG_SUBSYS_TUI, "Skipping unreadable archive %s", path);
+            return SWK_ERROR;
+        }
+        source->kind = LOG_TIMELINE_ARCHIVE;
+        source->block_count = source->archive.frame_count;
+    } else {
+        source->fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (source->fd < 0 || fstat(source->fd, &st) != 0) {
+            if (source->fd >= 0) {
+                close(source->fd);
+            }
+            return SWK_ERROR_FILE_NOT_FOUND;
+        }
+        source->map_size = (size_t)st.st_size;
+        if (source->map_size > 0) {
+            void *map = mmap(NULL, source->map_size, PROT_READ, MAP_PRIVATE, source->fd, 0);
+            if (map == MAP_FAILED) {
+                close(source->fd);
+                return SWK_ERROR_SYSTEM_CALL;
+            }
+            source->map = map;
+        }
+
+        // 二进制日志按归档的方式在记录边界上切块，每块单独渲染
+        if (source->map && log_binary_check_magic(source->map, source->map_size)) {
+            if (log_archive_plan_binary(&source->archive, (const uint8_t *)source->map,
+                                        source->map_size) != SWK_SUCCESS) {
+                munmap((void *)source->map, source->map_size);
+                close(source->fd);
+                return SWK_ERROR_OUT_OF_MEMORY;
+            }
+            source->kind = LOG_TIMELINE_RENDERED;
+            source->block_count = source->archive.frame_count;
+        } else {
+            source->kind = LOG_TIMELINE_TEXT;
+            source->block_count = (uint32_t)((source->map_size + LOG_TIMELINE_BLOCK - 1) / LOG_TIMELINE_BLOCK);
+            if (source->map) {
+                madvise((void *)source->map, source->map_size, MADV_SEQUENTIAL);
+            }
+        }
+    }
+
+    tl->source_count++;
+    return SWK_SUCCESS;
+}
+
+static void log_timeline_source_close(LogTimelineSource *source) {
+    for (int i = 0; i < LOG_TIMELINE_CACHE; i++) {
+        log_timeline_block_free(&source->cache[i]);
+    }
+    if (source->kind == LOG_TIMELINE_ARCHIVE || source->kind == LOG_TIMELINE_RENDERED) {
+        log_archive_close(&source->archive);
+    }
+    if (source->map) {
+        munmap((void *)source->map, source->map_size);
+    }
+    if (source->fd >= 0) {
+        close(source->fd);
+    }
+}
+
+typedef struct {
+    int number;
+    int compressed;
+} LogTimelineSegment;
+
+// 编号大的段更早；同一编号同时有明文段和归档时（压缩刚完成）使用归档
+static int log_timeline_compare_segment(const void *a, const void *b) {
+    const LogTimelineSegment *x = a;
+    const LogTimelineSegment *y = b;
+
+    if (x->number != y->number) {
+        return x->number > y->number ? -1 : 1;
+    }
+    return y->compressed - x->compressed;
+}
+
+// 找出目录中 "<日志名>.N" 与 "<日志名>.N.zst"
+static int log_timeline_find_segments(const char *log_path, LogTimelineSegment *segments, int max) {
+    char dir_buf[MAX_PATH_LENGTH], base_buf[MAX_PATH_LENGTH];
+    int count = 0;
+
+    snprintf(dir_buf, sizeof(dir_buf), "%s", log_path);
+    snprintf(base_buf, sizeof(base_buf), "%s", log_path);
+    const char *base = basename(base_buf);
+    size_t base_length = strlen(base);
+
+    DIR *dir = opendir(dirname(dir_buf));
+    if (!dir) {
+        return 0;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && count < max) {
+        const char *name = entry->d_name;
+        if (strncmp(name, base, base_length) != 0 || name[base_length] != '.') {
+            continue;
+        }
+
+        char *end;
+        long number = strtol(name + base_length + 1, &end, 10);
+        if (end == name + base_length + 1 || number <= 0 || number > 1000000) {
+            continue;
+        }
+        if (*end == '\0' || strcmp(end, LOG_ARCHIVE_SUFFIX) == 0) {
+            segments[count].number = (int)number;
+            segments[count].compressed = *end != '\0';
+            count++;
+        }
+    }
+    closedir(dir);
+
+    qsort(segments, (size_t)count, sizeof(LogTimelineSegment), log_timeline_compare_segment);
+    return count;
+}
+
+int log_timeline_open(LogTimeline *tl, const char *log_path) {
+    LogTimelineSegment segments[LOG_TIMELINE_MAX_SOURCES];
+    char path[MAX_PATH_LENGTH + 32];
+
+    if (!tl || !log_path) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+    memset(tl, 0, sizeof(LogTimeline));
+    tl->sources = calloc(LOG_TIMELINE_MAX_SOURCES, sizeof(LogTimelineSource));
+    if (!tl->sources) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    int count = log_timeline_find_segments(log_path, segments, LOG_TIMELINE_MAX_SOURCES - 1);
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && segments[i].number == segments[i - 1].number) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s.%d%s", log_path, segments[i].number,
+                 segments[i].compressed ? LOG_ARCHIVE_SUFFIX : "");
+        log_timeline_add_source(tl, path);
+    }
+    log_timeline_add_source(tl, log_path);
+
+    if (tl->source_count == 0) {
+        log_timeline_close(tl);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    log_timeline_seek_start(tl);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Opened timeline of %s with %d segments", log_path, tl->source_count);
+    return SWK_SUCCESS;
+}
+
+void log_timeline_close(LogTimeline *tl) {
+    if (!tl) return;
+
+    for (int i = 0; i < tl->source_count; i++) {
+        log_timeline_source_close(&tl->sources[i]);
+    }
+    free(tl->sources);
+    memset(tl, 0, sizeof(LogTimeline));
+}
+
+const char *log_timeline_source_path(const LogTimeline *tl, int source) {
+    return source >= 0 && source < tl->source_count ? tl->sources[source].path : "";
+}
+
+/* ---------------- 读取与定位 ---------------- */
+
+static void log_timeline_copy_line(LogTimelineSource *source, uint32_t block_number, uint32_t line,
+                                   LogTimelineEntry *entry) {
+    const LogTimelineBlock *block = log_timeline_block(source, block_number);
+    const char *start = block->text + block->lines[line];
+    const char *newline = memchr(start, '\n', block->size - block->lines[line]);
+    size_t length = newline ? (size_t)(newline - start) : block->size - block->lines[line];
+
+    if (length > 0 && start[length - 1] == '\r') {
+        length--;
+    }
+    if (length >= sizeof(entry->line)) {
+        length = sizeof(entry->line) - 1;
+    }
+    memcpy(entry->line, start, length);
+    entry->line[length] = '\0';
+    entry->length = length;
+}
+
+int log_timeline_next(LogTimeline *tl, LogTimelineEntry *entry) {
+    if (!tl || tl->heaps[LOG_TIMELINE_HEAP_NEXT].count == 0) {
+        return 0;
+    }
+
+    int index = tl->heaps[LOG_TIMELINE_HEAP_NEXT].items[0];
+    LogTimelineSource *source = &tl->sources[index];
+    if (entry) {
+        log_timeline_copy_line(source, source->block, source->line, entry);
+        entry->source = index;
+    }
+    source->line++;
+    log_timeline_source_moved(tl, index);
+    return 1;
+}
+
+int log_timeline_prev(LogTimeline *tl, LogTimelineEntry *entry) {
+    if (!tl || tl->heaps[LOG_TIMELINE_HEAP_PREV].count == 0) {
+        return 0;
+    }
+
+    int index = tl->heaps[LOG_TIMELINE_HEAP_PREV].items[0];
+    LogTimelineSource *source = &tl->sources[index];
+    uint32_t block_number, line;
+    if (!log_timeline_before_cursor(source, &block_number, &line)) {
+        return 0;
+    }
+    if (entry) {
+        log_timeline_copy_line(source, block_number, line, entry);
+        entry->source = index;
+    }
+    source->block = block_number;
+    source->line = line;
+    log_timeline_source_moved(tl, index);
+    return 1;
+}
+
+void log_timeline_seek_start(LogTimeline *tl) {
+    if (!tl) return;
+
+    for (int i = 0; i < tl->source_count; i++) {
+        tl->sources[i].block = 0;
+        tl->sources[i].line = 0;
+    }
+    log_timeline_rebuild(tl);
+}
+
+void log_timeline_seek_end(LogTimeline *tl) {
+    if (!tl) return;
+
+    for (int i = 0; i < tl->source_count; i++) {
+        tl->sources[i].block = tl->sources[i].block_count;
+        tl->sources[i].line = 0;
+    }
+    log_timeline_rebuild(tl);
+}
+
+// 块中第一行是否早于 stamp（空块按早于处理）
+static int log_timeline_block_before(LogTimelineSource *source, uint32_t number, const char *stamp, size_t length) {
+    const LogTimelineBlock *block = log_timeline_block(source, number);
+    char key[LOG_TIMELINE_STAMP];
+
+    if (block->line_count == 0) {
+        return 1;
+    }
+    log_timeline_key(block, 0, key);
+    return memcmp(key, stamp, length) < 0;
+}
+
+// 在块的首行时间戳上二分，再在最后一个首行早于 stamp 的块内找到第一条不早于它的行
+static void log_timeline_source_seek(LogTimelineSource *source, const char *stamp, size_t length) {
+    uint32_t lo = 0, hi = source->block_count;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (log_timeline_block_before(source, mid, stamp, length)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    source->block = lo;
+    source->line = 0;
+    if (lo == 0) {
+        return;
+    }
+
+    const LogTimelineBlock *block = log_timeline_block(source, lo - 1);
+    for (uint32_t i = 0; i < block->line_count; i++) {
+        char key[LOG_TIMELINE_STAMP];
+        log_timeline_key(block, i, key);
+        if (memcmp(key, stamp, length) >= 0) {
+            source->block = lo - 1;
+            source->line = i;
+            return;
+        }
+    }
+}
+
+void log_timeline_seek_time(LogTimeline *tl, const char *stamp) {
+    if (!tl || !stamp) return;
+
+    size_t length = strlen(stamp);
+    if (length > LOG_TIMELINE_STAMP) {
+        length = LOG_TIMELINE_STAMP;
+    }
+    for (int i = 0; i < tl->source_count; i++) {
+        log_timeline_source_seek(&tl->sources[i], stamp, length);
+    }
+    log_timeline_rebuild(tl);
+}
+
+void log_timeline_tell(const LogTimeline *tl, LogTimelinePosition *position) {
+    memset(position, 0, sizeof(LogTimelinePosition));
+    for (int i = 0; i < tl->source_count; i++) {
+        position->block[i] = tl->sources[i].block;
+        position->line[i] = tl->sources[i].line;
+    }
+}
+
+void log_timeline_restore(LogTimeline *tl, const LogTimelinePosition *position) {
+    for (int i = 0; i < tl->source_count; i++) {
+        tl->sources[i].block = position->block[i];
+        tl->sources[i].line = position->line[i];
+    }
+    log_timeline_rebuild(tl);
+}
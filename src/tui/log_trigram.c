@@ -0,0 +1,588 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "log_trigram.h"
+#include "log_index.h"
+#include "crc32c.h"
+#include "logger.h"
+
+#define LOG_TRIGRAM_KEYS (1u << 24)
+#define LOG_TRIGRAM_QUERY_MAX 64  // 一次查询最多使用的三元组数
+
+void log_trigram_init(LogTrigramIndex *index) {
+    memset(index, 0, sizeof(LogTrigramIndex));
+}
+
+void log_trigram_free(LogTrigramIndex *index) {
+    for (uint32_t i = 0; i < index->table_size; i++) {
+        free(index->table[i].data);
+    }
+    free(index->table);
+    free(index->blocks);
+    log_trigram_init(index);
+}
+
+size_t log_trigram_covered(const LogTrigramIndex *index) {
+    return index->blocks ? (size_t)index->blocks[index->block_count] : 0;
+}
+
+static uint32_t log_trigram_slot(const LogTrigramIndex *index, uint32_t key) {
+    uint32_t mask = index->table_size - 1;
+    uint32_t slot = (key * 2654435761u) >> (32 - __builtin_ctz(index->table_size));
+
+    while (index->table[slot].count && index->table[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static const LogTrigramPosting *log_trigram_find(const LogTrigramIndex *index, uint32_t key) {
+    if (index->table_size == 0) {
+        return NULL;
+    }
+    const LogTrigramPosting *posting = &index->table[log_trigram_slot(index, key)];
+    return posting->count ? posting : NULL;
+}
+
+// 装载因子超过 0.7 时翻倍
+static int log_trigram_grow_table(LogTrigramIndex *index) {
+    if (index->table_size && (uint64_t)index->used * 10 < (uint64_t)index->table_size * 7) {
+        return SWK_SUCCESS;
+    }
+
+    LogTrigramIndex grown = *index;
+    grown.table_size = index->table_size ? index->table_size * 2 : 4096;
+    grown.table = calloc(grown.table_size, sizeof(LogTrigramPosting));
+    if (!grown.table) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i < index->table_size; i++) {
+        if (index->table[i].count) {
+            grown.table[log_trigram_slot(&grown, index->table[i].key)] = index->table[i];
+        }
+    }
+
+    free(index->table);
+    index->table = grown.table;
+    index->table_size = grown.table_size;
+    return SWK_SUCCESS;
+}
+
+// 把 block 追加到 key 的倒排表（差分 varint）
+static int log_trigram_add(LogTrigramIndex *index, uint32_t key, uint32_t block) {
+    if (log_trigram_grow_table(index) != SWK_SUCCESS) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    LogTrigramPosting *posting = &index->table[log_trigram_slot(index, key)];
+    uint32_t delta = posting->count ? block - posting->last_block : block;
+
+    if (posting->length + 5 > posting->capacity) {
+        uint32_t capacity = posting->capacity ? posting->capacity * 2 : 8;
+        uint8_t *data = realloc(posting->data, capacity);
+        if (!data) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        posting->data = data;
+        posting->capacity = capacity;
+    }
+
+    if (!posting->count) {
+        posting->key = key;
+        index->used++;
+    }
+    do {
+        uint8_t byte = delta & 0x7f;
+        delta >>= 7;
+        posting->data[posting->length++] = byte | (delta ? 0x80 : 0);
+    } while (delta);
+    posting->count++;
+    posting->last_block = block;
+    return SWK_SUCCESS;
+}
+
+// 追加一个块的起始偏移
+static int log_trigram_add_block(LogTrigramIndex *index, uint64_t start, uint64_t end) {
+    if (index->block_count + 2 > index->block_capacity) {
+        uint32_t capacity = index->block_capacity ? index->block_capacity * 2 : 1024;
+        uint64_t *blocks = realloc(index->blocks, capacity * sizeof(uint64_t));
+        if (!blocks) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        index->blocks = blocks;
+        index->block_capacity = capacity;
+    }
+
+    index->blocks[index->block_count] = start;
+    index->blocks[++index->block_count] = end;
+    return SWK_SUCCESS;
+}
+
+int log_trigram_extend(LogTrigramIndex *index, const char *text, size_t size, const int *cancel) {
+    size_t pos = log_trigram_covered(index);
+    uint64_t *seen = calloc(LOG_TRIGRAM_KEYS / 64, sizeof(uint64_t));
+    uint32_t *keys = NULL;
+    size_t key_capacity = 0;
+    int result = SWK_SUCCESS;
+
+    if (!seen) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    while (pos < size && result == SWK_SUCCESS) {
+        if (cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED)) {
+            result = SWK_ERROR;
+            break;
+        }
+
+        // 块在目标大小之后的第一个换行处结束；不足一块时截止到最后一个换行
+        const char *newline = size - pos > LOG_TRIGRAM_BLOCK ?
+                              memchr(text + pos + LOG_TRIGRAM_BLOCK - 1, '\n', size - pos - LOG_TRIGRAM_BLOCK + 1) :
+                              NULL;
+        if (!newline) {
+            newline = memrchr(text + pos, '\n', size - pos);
+        }
+        if (!newline) {
+            break;
+        }
+        size_t end = (size_t)(newline - text) + 1;
+
+        if (end - pos > key_capacity) {
+            uint32_t *grown = realloc(keys, (end - pos) * sizeof(uint32_t));
+            if (!grown) {
+                result = SWK_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+            keys = grown;
+            key_capacity = end - pos;
+        }
+
+        // 收集块内不同的三元组（不跨行）
+        size_t key_count = 0;
+        uint32_t key = 0;
+        int run = 0;
+        for (size_t i = pos; i < end; i++) {
+            unsigned char c = (unsigned char)text[i];
+            if (c == '\n') {
+                run = 0;
+                continue;
+            }
+            key = ((key << 8) | c) & (LOG_TRIGRAM_KEYS - 1);
+            if (++run >= 3 && !(seen[key / 64] & (1ULL << (key % 64)))) {
+                seen[key / 64] |= 1ULL << (key % 64);
+                keys[key_count++] = key;
+            }
+        }
+
+        uint32_t block = index->block_count;
+        if (log_trigram_add_block(index, pos, end) != SWK_SUCCESS) {
+            result = SWK_ERROR_OUT_OF_MEMORY;
+        }
+        for (size_t i = 0; i < key_count; i++) {
+            if (result == SWK_SUCCESS) {
+                result = log_trigram_add(index, keys[i], block);
+            }
+            seen[keys[i] / 64] &= ~(1ULL << (keys[i] % 64));
+        }
+        pos = end;
+    }
+
+    free(keys);
+    free(seen);
+    return result;
+}
+
+// 按顺序解码倒排表（blocks 可为 NULL，只做校验），读取不超出 length 字节。
+// 返回解码出的块数；数据截断、varint 过长或块号不递增时停在该处
+static uint32_t log_trigram_decode(const LogTrigramPosting *posting, uint32_t *blocks, uint32_t *last) {
+    uint32_t block = 0;
+    size_t offset = 0;
+    uint32_t i;
+
+    for (i = 0; i < posting->count; i++) {
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (offset >= posting->length || shift > 28) {
+                goto out;
+            }
+            byte = posting->data[offset++];
+            delta |= (uint32_t)(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        if (i > 0 && (delta == 0 || delta > UINT32_MAX - block)) {
+            break;
+        }
+        block = i == 0 ? delta : block + delta;
+        if (blocks) {
+            blocks[i] = block;
+        }
+    }
+out:
+    if (last) {
+        *last = block;
+    }
+    return i;
+}
+
+static int log_trigram_compare_count(const void *a, const void *b) {
+    const LogTrigramPosting *x = *(const LogTrigramPosting *const *)a;
+    const LogTrigramPosting *y = *(const LogTrigramPosting *const *)b;
+    return x->count < y->count ? -1 : x->count > y->count;
+}
+
+long log_trigram_candidates(const LogTrigramIndex *index, const char *literal, size_t length, uint32_t **blocks) {
+    const LogTrigramPosting *postings[LOG_TRIGRAM_QUERY_MAX];
+    size_t count = 0;
+
+    *blocks = NULL;
+    if (length < 3) {
+        return -1;
+    }
+
+    // 最稀有的倒排表先求交，模式过长时只取前一部分三元组
+    for (size_t i = 0; i + 3 <= length && count < sizeof(postings) / sizeof(postings[0]); i++) {
+        uint32_t key = ((uint32_t)(unsigned char)literal[i] << 16) |
+                       ((uint32_t)(unsigned char)literal[i + 1] << 8) | (unsigned char)literal[i + 2];
+        const LogTrigramPosting *posting = log_trigram_find(index, key);
+        if (!posting) {
+            return 0;
+        }
+        postings[count++] = posting;
+    }
+    qsort(postings, count, sizeof(postings[0]), log_trigram_compare_count);
+
+    uint32_t *result = malloc(postings[0]->count * sizeof(uint32_t));
+    uint32_t *other = malloc(postings[0]->count * sizeof(uint32_t));
+    uint32_t *decoded = NULL;
+    if (!result || !other) {
+        free(result);
+        free(other);
+        return -1;
+    }
+    size_t result_count = log_trigram_decode(postings[0], result, NULL);
+
+    for (size_t i = 1; i < count && result_count > 0; i++) {
+        if (postings[i] == postings[i - 1]) {
+            continue;
+        }
+        uint32_t *grown = realloc(decoded, postings[i]->count * sizeof(uint32_t));
+        if (!grown) {
+            free(decoded);
+            free(other);
+            free(result);
+            return -1;
+        }
+        decoded = grown;
+        size_t decoded_count = log_trigram_decode(postings[i], decoded, NULL);
+
+        size_t a = 0, b = 0, kept = 0;
+        while (a < result_count && b < decoded_count) {
+            if (result[a] < decoded[b]) {
+                a++;
+            } else if (result[a] > decoded[b]) {
+                b++;
+            } else {
+                other[kept++] = result[a];
+                a++;
+                b++;
+            }
+        }
+        uint32_t *swap = result;
+        result = other;
+        other = swap;
+        result_count = kept;
+    }
+
+    free(decoded);
+    free(other);
+    *blocks = result;
+    return (long)result_count;
+}
+
+static int log_trigram_read_at(int fd, void *data, size_t length, off_t offset) {
+    uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = pread(fd, p, length, offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        offset += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static int log_trigram_write_all(int fd, const void *data, size_t length) {
+    const uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+int log_trigram_load(LogTrigramIndex *index, const char *log_path, const struct stat *st, const char *text) {
+    char path[MAX_PATH_LENGTH + 16];
+    LogTrigramFileHeader header;
+
+    log_trigram_free(index);
+    snprintf(path, sizeof(path), "%s%s", log_path, LOG_TRIGRAM_SUFFIX);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    int valid = log_trigram_read_at(fd, &header, sizeof(header), 0) == 0 &&
+                memcmp(header.magic, LOG_TRIGRAM_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == LOG_TRIGRAM_VERSION &&
+                header.block_size == LOG_TRIGRAM_BLOCK &&
+                header.inode == (uint64_t)st->st_ino &&
+                header.covered <= header.file_size &&
+                header.block_count <= header.covered / 2 + 1 &&
+                header.trigram_count <= LOG_TRIGRAM_KEYS &&
+                header.data_size <= (uint64_t)header.block_count * 5 * LOG_TRIGRAM_KEYS &&
+                (header.file_size == (uint64_t)st->st_size ?
+                     header.mtime_ns == log_index_mtime_ns(st) :
+                     header.file_size < (uint64_t)st->st_size) &&
+                log_index_fingerprint(text, header.covered) == header.tail_hash;
+
+    uint32_t (*records)[4] = NULL;
+    uint8_t *data = NULL;
+    off_t offset = sizeof(header);
+
+    if (valid) {
+        index->block_capacity = header.block_count + 2;
+        index->blocks = malloc(index->block_capacity * sizeof(uint64_t));
+        records = malloc((header.trigram_count + 1) * sizeof(*records));
+        data = malloc(header.data_size + 1);
+        valid = index->blocks && records && data &&
+                log_trigram_read_at(fd, index->blocks, (header.block_count + 1) * sizeof(uint64_t), offset) == 0;
+        offset += (header.block_count + 1) * sizeof(uint64_t);
+        valid = valid && log_trigram_read_at(fd, records, header.trigram_count * sizeof(*records), offset) == 0;
+        offset += header.trigram_count * sizeof(*records);
+        valid = valid && log_trigram_read_at(fd, data, header.data_size, offset) == 0 &&
+                index->blocks[header.block_count] == header.covered;
+
+        // 校验和覆盖文件头之后的全部内容
+        if (valid) {
+            uint32_t crc = crc32c(0, index->blocks, (header.block_count + 1) * sizeof(uint64_t));
+            crc = crc32c(crc, records, header.trigram_count * sizeof(*records));
+            valid = crc32c(crc, data, header.data_size) == header.crc;
+        }
+        index->block_count = header.block_count;
+    }
+    close(fd);
+
+    // 逐个放回哈希表（每个倒排表单独分配，之后还能继续追加）
+    uint64_t consumed = 0;
+    for (uint32_t i = 0; valid && i < header.trigram_count; i++) {
+        uint32_t length = records[i][3];
+        if (records[i][1] == 0 || consumed + length > header.data_size ||
+            log_trigram_grow_table(index) != SWK_SUCCESS) {
+            valid = 0;
+            break;
+        }
+
+        LogTrigramPosting *posting = &index->table[log_trigram_slot(index, records[i][0])];
+        posting->data = malloc(length + 5);
+        if (!posting->data || posting->count) {
+            free(posting->data);
+            posting->data = NULL;
+            valid = 0;
+            break;
+        }
+        memcpy(posting->data, data + consumed, length);
+        posting->key = records[i][0];
+        posting->count = records[i][1];
+        posting->last_block = records[i][2];
+        posting->length = length;
+        posting->capacity = length + 5;
+        index->used++;
+        consumed += length;
+
+        // 倒排表必须完整解码出 count 个递增块号，且最后一个与记录一致
+        uint32_t last;
+        if (log_trigram_decode(posting, NULL, &last) != posting->count ||
+            last != posting->last_block || last >= header.block_count) {
+            valid = 0;
+        }
+    }
+
+    free(records);
+    free(data);
+    if (!valid) {
+        log_trigram_free(index);
+        return SWK_ERROR;
+    }
+
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded trigram index %s (%u blocks, %u trigrams)",
+                                  path, index->block_count, index->used);
+    return SWK_SUCCESS;
+}
+
+int log_trigram_save(const LogTrigramIndex *index, const char *log_path, const struct stat *st, const char *text) {
+    char path[MAX_PATH_LENGTH + 16], tmp[MAX_PATH_LENGTH + 48];
+    LogTrigramFileHeader header;
+
+    if (!index->blocks) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    snprintf(path, sizeof(path), "%s%s", log_path, LOG_TRIGRAM_SUFFIX);
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid());
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LOG_TRIGRAM_MAGIC, sizeof(header.magic));
+    header.version = LOG_TRIGRAM_VERSION;
+    header.block_size = LOG_TRIGRAM_BLOCK;
+    header.inode = (uint64_t)st->st_ino;
+    header.file_size = (uint64_t)st->st_size;
+    header.mtime_ns = log_index_mtime_ns(st);
+    header.covered = log_trigram_covered(index);
+    header.tail_hash = log_index_fingerprint(text, header.covered);
+    header.block_count = index->block_count;
+    header.trigram_count = index->used;
+
+    uint32_t (*records)[4] = malloc((index->used + 1) * sizeof(*records));
+    if (!records) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < index->table_size; i++) {
+        const LogTrigramPosting *posting = &index->table[i];
+        if (posting->count) {
+            records[n][0] = posting->key;
+            records[n][1] = posting->count;
+            records[n][2] = posting->last_block;
+            records[n][3] = posting->length;
+            header.data_size += posting->length;
+            n++;
+        }
+    }
+
+    header.crc = crc32c(0, index->blocks, (index->block_count + 1) * sizeof(uint64_t));
+    header.crc = crc32c(header.crc, records, n * sizeof(*records));
+    for (uint32_t i = 0; i < index->table_size; i++) {
+        if (index->table[i].count) {
+            header.crc = crc32c(header.crc, index->table[i].data, index->table[i].length);
+        }
+    }
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    int ok = fd >= 0 &&
+             log_trigram_write_all(fd, &header, sizeof(header)) == 0 &&
+             log_trigram_write_all(fd, index->blocks, (index->block_count + 1) * sizeof(uint64_t)) == 0 &&
+             log_trigram_write_all(fd, records, n * sizeof(*records)) == 0;
+    for (uint32_t i = 0; ok && i < index->table_size; i++) {
+        if (index->table[i].count) {
+            ok = log_trigram_write_all(fd, index->table[i].data, index->table[i].length) == 0;
+        }
+    }
+    free(records);
+
+    if (fd < 0) {
+        return SWK_ERROR_PERMISSION_DENIED;
+    }
+    if (close(fd) != 0 || !ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Cannot write trigram index %s: %s", path, strerror(errno));
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    return SWK_SUCCESS;
+}
+
+void log_trigram_builder_init(LogTrigramBuilder *builder) {
+    memset(builder, 0, sizeof(LogTrigramBuilder));
+    builder->fd = -1;
+    log_trigram_init(&builder->index);
+}
+
+// 后台线程：映射文件，先沿用索引文件，再索引其余部分；新索引的内容足够多时保存
+static void *log_trigram_builder_thread(void *arg) {
+    LogTrigramBuilder *builder = arg;
+    size_t size = (size_t)builder->st.st_size;
+    int state = LOG_TRIGRAM_FAILED;
+
+    const char *text = mmap(NULL, size, PROT_READ, MAP_PRIVATE, builder->fd, 0);
+    if (text != MAP_FAILED) {
+        size_t loaded = 0;
+        if (log_trigram_load(&builder->index, builder->path, &builder->st, text) == SWK_SUCCESS) {
+            loaded = log_trigram_covered(&builder->index);
+        }
+
+        madvise((void *)text, size, MADV_SEQUENTIAL);
+        if (log_trigram_extend(&builder->index, text, size, &builder->cancel) == SWK_SUCCESS) {
+            if (log_trigram_covered(&builder->index) - loaded >= LOG_TRIGRAM_MIN) {
+                log_trigram_save(&builder->index, builder->path, &builder->st, text);
+            }
+            state = LOG_TRIGRAM_READY;
+        }
+        munmap((void *)text, size);
+    }
+
+    close(builder->fd);
+    builder->fd = -1;
+    __atomic_store_n(&builder->state, state, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+int log_trigram_builder_start(LogTrigramBuilder *builder, int fd, const char *log_path) {
+    if (builder->state != LOG_TRIGRAM_IDLE) {
+        return SWK_ERROR;
+    }
+    if (fstat(fd, &builder->st) != 0 || builder->st.st_size < LOG_TRIGRAM_MIN) {
+        return SWK_ERROR;
+    }
+
+    builder->fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (builder->fd < 0) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    snprintf(builder->path, sizeof(builder->path), "%s", log_path);
+    builder->cancel = 0;
+    builder->state = LOG_TRIGRAM_BUILDING;
+
+    if (pthread_create(&builder->thread, NULL, log_trigram_builder_thread, builder) != 0) {
+        close(builder->fd);
+        builder->fd = -1;
+        builder->state = LOG_TRIGRAM_IDLE;
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    return SWK_SUCCESS;
+}
+
+const LogTrigramIndex *log_trigram_builder_ready(LogTrigramBuilder *builder) {
+    return __atomic_load_n(&builder->state, __ATOMIC_ACQUIRE) == LOG_TRIGRAM_READY ? &builder->index : NULL;
+}
+
+void log_trigram_builder_stop(LogTrigramBuilder *builder) {
+    if (builder->state == LOG_TRIGRAM_IDLE) {
+        return;
+    }
+
+    __atomic_store_n(&builder->cancel, 1, __ATOMIC_RELAXED);
+    pthread_join(builder->thread, NULL);
+    log_trigram_free(&builder->index);
+    builder->state = LOG_TRIGRAM_IDLE;
+}
@@ -1,24 +1,70 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <libgen.h>
 #include <unistd.h>
 #include <ctype.h>
 #include <time.h>
 #include "log_viewer.h"
 #include "logger.h"
+#include "log_binary.h"
+#include "log_archive.h"
+#include "log_sink.h"
+#include "log_filter.h"
+#include "log_trigram.h"
+#include "log_stats.h"
 #include "common_defs.h"
 
+#define LOG_VIEWER_LINE_MAX 2048     // 解析时单行保留的最大字节数
+#define LOG_VIEWER_SEARCH_WINDOW 4096  // 向前搜索时每次查找的行数
+
+// inotify 事件归类
+#define LOG_VIEWER_EVENT_MODIFIED 0x1   // 打开的文件有新内容或被截断
+#define LOG_VIEWER_EVENT_REPLACED 0x2   // 文件被移走/删除，或目录中出现了同名文件
+
+static void log_viewer_parse_into(LogEntry *entry, const char *line);
+static int log_viewer_move_to(LogViewer *lv, long position);
+
+// 清空缓存（行号与内容的对应关系变化时调用）
+static void log_viewer_reset_cache(LogViewer *lv) {
+    for (int i = 0; i < LOG_VIEWER_CACHE_SIZE; i++) {
+        lv->cache_lines[i] = -1;
+    }
+}
+
 // 初始化日志查看器
 int log_viewer_init(LogViewer *lv, const char *log_file_path) {
+    return log_viewer_open(lv, log_file_path, NULL, NULL);
+}
+
+int log_viewer_open(LogViewer *lv, const char *log_file_path, LogIndexProgress progress, void *context) {
     if (!lv || !log_file_path) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
     memset(lv, 0, sizeof(LogViewer));
+    lv->fd = -1;
+    lv->watch_fd = -1;
+    log_index_init(&lv->index);
+    log_filter_init(&lv->filter);
+    log_trigram_builder_init(&lv->search);
+    log_stats_init(&lv->stats);
+    log_time_init(&lv->times);
+    log_viewer_reset_cache(lv);
+    lv->progress = progress;
+    lv->progress_context = context;
 
     // 设置默认值
     lv->min_level = LOG_DEBUG;
+    lv->time_from = -1;
+    lv->time_to = -1;
     lv->show_timestamp = 1;
     lv->show_source_location = 1;
     lv->auto_refresh = 1;
@@ -30,151 +76,661 @@ int log_viewer_init(LogViewer *lv, const char *log_file_path) {
     return log_viewer_reload(lv);
 }
 
+// 关闭当前来源并清空索引，保留过滤条件
+static void log_viewer_close(LogViewer *lv) {
+    // 后台线程使用自己的映射和描述符，先停下再关闭文件
+    log_trigram_builder_stop(&lv->search);
+
+    if (lv->map) {
+        munmap((void *)lv->map, lv->map_size);
+        lv->map = NULL;
+        lv->map_size = 0;
+    }
+
+    if (lv->fd >= 0) {
+        close(lv->fd);
+        lv->fd = -1;
+    }
+
+    if (lv->watch_fd >= 0) {
+        close(lv->watch_fd);
+        lv->watch_fd = -1;
+    }
+
+    if (lv->decoder) {
+        log_binary_decoder_free(lv->decoder);
+        free(lv->decoder);
+        lv->decoder = NULL;
+    }
+
+    // 释放索引与缓存
+    free(lv->text_buffer);
+    log_index_free(&lv->index);
+    free(lv->cache);
+    lv->text_buffer = NULL;
+    lv->text_capacity = 0;
+    lv->text = NULL;
+    lv->text_size = 0;
+    lv->cache = NULL;
+    log_viewer_reset_cache(lv);
+
+    log_filter_reset(&lv->filter);
+    log_stats_init(&lv->stats);
+    log_time_free(&lv->times);
+
+    lv->total_entries = 0;
+    lv->current_position = -1;
+    lv->last_file_size = 0;
+}
+
 // 清理日志查看器
 void log_viewer_cleanup(LogViewer *lv) {
     if (!lv) return;
 
-    if (lv->log_file) {
-        fclose(lv->log_file);
-        lv->log_file = NULL;
+    log_viewer_close(lv);
+    log_filter_free(&lv->filter);
+}
+
+// 索引 text[start, end) 中的完整行，跳过空行，返回最后一个换行之后的偏移
+static size_t log_viewer_index_lines(LogViewer *lv, size_t start, size_t end) {
+    size_t indexed = log_index_scan(&lv->index, lv->text, start, end);
+
+    lv->total_entries = (int)lv->index.count;
+    return indexed;
+}
+
+// 把时间范围过滤换算为行号范围（时间列增长后重新换算）
+static void log_viewer_update_range(LogViewer *lv) {
+    int active = lv->time_from >= 0 || lv->time_to >= 0;
+    size_t first = lv->time_from >= 0 ? log_time_lower_bound(&lv->times, lv->time_from) : 0;
+    size_t end = lv->time_to >= 0 ? log_time_lower_bound(&lv->times, lv->time_to + 1) : SIZE_MAX;
+
+    log_filter_set_range(&lv->filter, active, first, end);
+}
+
+// 新增的行索引之后补算统计和时间列
+static void log_viewer_indexed(LogViewer *lv) {
+    log_stats_update(&lv->stats, lv->text, lv->text_size, &lv->index);
+    log_time_update(&lv->times, lv->text, lv->text_size, &lv->index);
+    log_viewer_update_range(lv);
+}
+
+// 把渲染好的文本（以换行结尾）追加到堆缓冲区并索引
+static int log_viewer_append_text(LogViewer *lv, const char *data, size_t length) {
+    if (lv->text_size + length > lv->text_capacity) {
+        size_t capacity = lv->text_capacity ? lv->text_capacity : 64 * 1024;
+        while (capacity < lv->text_size + length) {
+            capacity *= 2;
+        }
+        char *buffer = realloc(lv->text_buffer, capacity);
+        if (!buffer) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        lv->text_buffer = buffer;
+        lv->text_capacity = capacity;
     }
 
-    // 释放日志条目
-    LogEntry *current = lv->entries;
-    while (current) {
-        LogEntry *next = current->next;
-        free(current);
-        current = next;
+    memcpy(lv->text_buffer + lv->text_size, data, length);
+    lv->text = lv->text_buffer;
+    lv->text_size = log_viewer_index_lines(lv, lv->text_size, lv->text_size + length);
+    log_viewer_indexed(lv);
+    return SWK_SUCCESS;
+}
+
+// 第 position 行的内容（不含换行）
+static const char *log_viewer_line(const LogViewer *lv, int position, size_t *length) {
+    uint64_t offset = lv->index.offsets[position];
+    const char *start = lv->text + offset;
+    const char *newline = memchr(start, '\n', lv->text_size - offset);
+    size_t line_length = newline ? (size_t)(newline - start) : lv->text_size - offset;
+
+    if (line_length > 0 && start[line_length - 1] == '\r') {
+        line_length--;
     }
+    *length = line_length;
+    return start;
+}
 
-    lv->entries = NULL;
-    lv->current_entry = NULL;
-    lv->total_entries = 0;
+// 解码内存中的二进制记录并渲染为文本，返回消耗的字节数；损坏的记录跳过
+// （计入 decoder->skipped_bytes）
+static long log_viewer_decode_binary(LogViewer *lv, const uint8_t *data, size_t length) {
+    char line[LOG_BINARY_RECORD_MAX + 64];
+    size_t offset = 0;
+
+    while (offset < length) {
+        LogBinaryEvent event;
+        int has_event;
+        long used = log_binary_decode(lv->decoder, data + offset, length - offset, &event, &has_event);
+
+        if (used == 0) {
+            break;
+        }
+        if (used < 0) {
+            offset += log_binary_resync(lv->decoder, data + offset, length - offset);
+            continue;
+        }
+        offset += (size_t)used;
+
+        if (has_event) {
+            size_t line_length = log_binary_format_line(&event, line, sizeof(line));
+            if (log_viewer_append_text(lv, line, line_length) != SWK_SUCCESS) {
+                break;
+            }
+        }
+    }
+
+    return (long)offset;
 }
 
-// 重新加载日志文件
-int log_viewer_reload(LogViewer *lv) {
+// 映射日志文件的当前全部内容（文件增长后重新映射）
+static int log_viewer_map(LogViewer *lv, size_t size) {
+    if (lv->map) {
+        munmap((void *)lv->map, lv->map_size);
+        lv->map = NULL;
+        lv->map_size = 0;
+    }
+    if (size == 0) {
+        return SWK_SUCCESS;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, lv->fd, 0);
+    if (map == MAP_FAILED) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    lv->map = map;
+    lv->map_size = size;
+    if (!lv->binary) {
+        lv->text = lv->map;
+    }
+    return SWK_SUCCESS;
+}
+
+// 索引 last_file_size 之后新增的内容
+static void log_viewer_read_new(LogViewer *lv) {
+    size_t size = lv->map_size;
+
+    if (lv->binary) {
+        uint64_t skipped = lv->decoder->skipped_bytes;
+        long used = log_viewer_decode_binary(lv, (const uint8_t *)lv->map + lv->last_file_size,
+                                             size - (size_t)lv->last_file_size);
+        if (lv->decoder->skipped_bytes != skipped) {
+            SWK_LOG_WARN(LOG_SUBSYS_TUI, "Skipped %llu corrupt bytes after offset %ld in %s",
+                         (unsigned long long)(lv->decoder->skipped_bytes - skipped),
+                         lv->last_file_size, lv->log_file_path);
+        }
+        lv->last_file_size += used;
+        return;
+    }
+
+    // 最后一行还没写完时留到下次刷新
+    madvise((void *)lv->map, size, MADV_SEQUENTIAL);
+    lv->text_size = log_viewer_index_lines(lv, (size_t)lv->last_file_size, size);
+    lv->last_file_size = (long)lv->text_size;
+    log_viewer_indexed(lv);
+    madvise((void *)lv->map, size, MADV_RANDOM);
+}
+
+// 首次载入文本日志：优先沿用索引文件，其余部分并行建立；新索引的内容较多时保存索引文件
+static void log_viewer_index_file(LogViewer *lv, const struct stat *st) {
+    size_t size = lv->map_size;
+    size_t loaded = log_index_load(&lv->index, lv->log_file_path, st, lv->map);
+
+    madvise((void *)lv->map, size, MADV_SEQUENTIAL);
+    lv->text_size = log_index_build(&lv->index, lv->text, loaded, size, lv->progress, lv->progress_context);
+    lv->total_entries = (int)lv->index.count;
+    lv->last_file_size = (long)lv->text_size;
+    log_viewer_indexed(lv);
+    madvise((void *)lv->map, size, MADV_RANDOM);
+
+    if (lv->text_size - loaded >= LOG_INDEX_SAVE_MIN) {
+        log_index_save(&lv->index, lv->log_file_path, st, lv->text, lv->text_size);
+    }
+}
+
+// 视图（通过过滤的行）中的条目数；未设置过滤时就是全部行，不需要逐行计算
+static int log_viewer_view_count(LogViewer *lv) {
+    if (!log_filter_active(&lv->filter)) {
+        return lv->total_entries;
+    }
+    log_filter_update(&lv->filter, lv->text, lv->text_size, &lv->index);
+    return (int)log_filter_count(&lv->filter);
+}
+
+// 视图中第 position 条对应的行号，越界返回 -1
+static long log_viewer_view_line(LogViewer *lv, int position) {
+    if (position < 0) {
+        return -1;
+    }
+    if (!log_filter_active(&lv->filter)) {
+        return position < lv->total_entries ? position : -1;
+    }
+    log_filter_update(&lv->filter, lv->text, lv->text_size, &lv->index);
+    return log_filter_row(&lv->filter, (size_t)position);
+}
+
+// 让当前位置落在第 line 行（被过滤掉时取其后第一条通过过滤的行）
+static void log_viewer_show_line(LogViewer *lv, long line) {
+    long position = line;
+
+    if (log_filter_active(&lv->filter)) {
+        log_filter_update(&lv->filter, lv->text, lv->text_size, &lv->index);
+        position = (long)log_filter_position(&lv->filter, (size_t)(line > 0 ? line : 0));
+    }
+    if (log_viewer_move_to(lv, position) != SWK_SUCCESS) {
+        lv->current_position = -1;
+    }
+}
+
+// 移动到视图中的最后一条
+static void log_viewer_show_last(LogViewer *lv) {
+    lv->current_position = log_viewer_view_count(lv) - 1;
+}
+
+typedef struct {
+    LogViewer *lv;
+} MemoryReadState;
+
+// 内存环读取回调：在 logger 的锁内执行，不能写日志
+static void log_viewer_memory_line(LogLevel level, const char *line, size_t length, void *context) {
+    MemoryReadState *state = context;
+    (void)level;
+
+    log_viewer_append_text(state->lv, line, length);
+}
+
+// 读取内存环中 memory_cursor 之后的记录
+static void log_viewer_read_memory(LogViewer *lv) {
+    MemoryReadState state = {lv};
+
+    lv->memory_cursor = logger_memory_read(lv->memory_cursor, log_viewer_memory_line, &state);
+}
+
+// 打开 logger 内存环（替换现有条目）
+int log_viewer_open_memory(LogViewer *lv) {
     if (!lv) {
         return SWK_ERROR_INVALID_PARAM;
     }
+    if (logger_get_sink_level(LOG_SINK_MEMORY) < 0) {
+        return SWK_ERROR;
+    }
 
-    FILE *file = fopen(lv->log_file_path, "r");
-    if (!file) {
-        log_message(LOG_ERROR, "Cannot open log file: %s", lv->log_file_path);
-        return SWK_ERROR_FILE_NOT_FOUND;
+    log_viewer_close(lv);
+    lv->memory = 1;
+    lv->memory_cursor = 0;
+    snprintf(lv->log_file_path, sizeof(lv->log_file_path), "<memory>");
+
+    log_viewer_read_memory(lv);
+    log_viewer_show_last(lv);
+
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded %d log entries from the memory ring", lv->total_entries);
+    return SWK_SUCCESS;
+}
+
+// 开始用 inotify 跟随刚打开的文件；失败时 watch_fd 为 -1，刷新退回到 stat 轮询
+static void log_viewer_watch(LogViewer *lv) {
+    char dir[MAX_PATH_LENGTH];
+
+    lv->watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (lv->watch_fd < 0) {
+        return;
     }
 
-    // 关闭旧文件
-    if (lv->log_file) {
-        fclose(lv->log_file);
+    strncpy(dir, lv->log_file_path, sizeof(dir) - 1);
+    dir[sizeof(dir) - 1] = '\0';
+    lv->watch_file = inotify_add_watch(lv->watch_fd, lv->log_file_path,
+                                       IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB);
+    lv->watch_dir = inotify_add_watch(lv->watch_fd, dirname(dir), IN_CREATE | IN_MOVED_TO);
+
+    if (lv->watch_file < 0 || lv->watch_dir < 0) {
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Cannot watch %s, falling back to polling", lv->log_file_path);
+        close(lv->watch_fd);
+        lv->watch_fd = -1;
     }
+}
+
+// 读出所有待处理的 inotify 事件，返回 LOG_VIEWER_EVENT_* 的组合
+static int log_viewer_read_events(LogViewer *lv) {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    const char *name = strrchr(lv->log_file_path, '/');
+    int events = 0;
 
-    lv->log_file = file;
+    name = name ? name + 1 : lv->log_file_path;
+
+    for (;;) {
+        ssize_t n = read(lv->watch_fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
 
-    // 获取文件大小
-    struct stat statbuf;
-    if (stat(lv->log_file_path, &statbuf) == 0) {
-        lv->last_file_size = statbuf.st_size;
+        for (const char *p = buffer; p < buffer + n;) {
+            const struct inotify_event *event = (const struct inotify_event *)p;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                events |= LOG_VIEWER_EVENT_MODIFIED | LOG_VIEWER_EVENT_REPLACED;
+            } else if (event->wd == lv->watch_file) {
+                if (event->mask & IN_MODIFY) {
+                    events |= LOG_VIEWER_EVENT_MODIFIED;
+                }
+                if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB)) {
+                    events |= LOG_VIEWER_EVENT_REPLACED;
+                }
+            } else if (event->wd == lv->watch_dir && event->len > 0 && strcmp(event->name, name) == 0) {
+                events |= LOG_VIEWER_EVENT_REPLACED;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
     }
 
-    // 清空现有条目
-    log_viewer_cleanup(lv);
+    return events;
+}
 
-    // 读取所有日志条目
-    char line[2048];
-    LogEntry *tail = NULL;
+// 重新加载日志文件
+int log_viewer_reload(LogViewer *lv) {
+    if (!lv) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+    if (lv->memory) {
+        return log_viewer_open_memory(lv);
+    }
 
-    while (fgets(line, sizeof(line), file)) {
-        // 移除换行符
-        line[strcspn(line, "\n\r")] = '\0';
+    int fd = open(lv->log_file_path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Cannot open log file: %s", lv->log_file_path);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
 
-        if (strlen(line) == 0) continue;
+    // 关闭旧文件并清空现有条目
+    log_viewer_close(lv);
+    lv->fd = fd;
 
-        LogEntry *entry = parse_log_line(line);
-        if (entry) {
-            // 添加到链表
-            if (!lv->entries) {
-                lv->entries = entry;
-                tail = entry;
-            } else {
-                tail->next = entry;
-                entry->prev = tail;
-                tail = entry;
-            }
+    int result = log_viewer_map(lv, (size_t)st.st_size);
+    if (result != SWK_SUCCESS) {
+        log_viewer_close(lv);
+        return result;
+    }
 
-            lv->total_entries++;
+    // 二进制日志按文件头识别，直接解码，不需要先用 swikernel-logdump 转换
+    lv->binary = lv->map && log_binary_check_magic(lv->map, lv->map_size);
+    if (lv->binary) {
+        lv->text = NULL;
+        lv->decoder = malloc(sizeof(LogBinaryDecoder));
+        if (!lv->decoder) {
+            log_viewer_close(lv);
+            return SWK_ERROR_OUT_OF_MEMORY;
         }
+        log_binary_decoder_init(lv->decoder);
     }
 
+    if (lv->binary) {
+        log_viewer_read_new(lv);
+    } else if (lv->map) {
+        log_viewer_index_file(lv, &st);
+        log_trigram_builder_start(&lv->search, lv->fd, lv->log_file_path);
+    }
+
+    // 在打开之后才开始监视，之前的变化已经包含在刚读到的内容里
+    log_viewer_watch(lv);
+
     // 设置当前条目为最后一个
-    lv->current_entry = tail;
-    lv->current_position = lv->total_entries - 1;
+    log_viewer_show_last(lv);
 
-    log_message(LOG_DEBUG, "Loaded %d log entries from %s", lv->total_entries, lv->log_file_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Indexed %d log entries from %s", lv->total_entries, lv->log_file_path);
     return SWK_SUCCESS;
 }
 
 // 刷新日志（检查新内容）
 int log_viewer_refresh(LogViewer *lv) {
-    if (!lv || !lv->log_file) {
+    if (lv && lv->memory) {
+        log_viewer_read_memory(lv);
+        if (lv->follow_tail) {
+            log_viewer_show_last(lv);
+        }
+        return SWK_SUCCESS;
+    }
+
+    if (!lv || lv->fd < 0) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    struct stat statbuf;
-    if (stat(lv->log_file_path, &statbuf) != 0) {
-        return SWK_ERROR_FILE_NOT_FOUND;
+    // 没有 inotify 事件时文件没有变化，不做任何系统调用
+    int events = lv->watch_fd >= 0 ? log_viewer_read_events(lv) :
+                                     LOG_VIEWER_EVENT_MODIFIED | LOG_VIEWER_EVENT_REPLACED;
+    if (!events) {
+        return SWK_SUCCESS;
+    }
+
+    struct stat statbuf, current;
+    if (fstat(lv->fd, &statbuf) != 0) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    // 路径已指向另一个文件说明被轮转，重新打开；旧文件已移走而新文件
+    // 尚未创建时继续跟随旧文件，等目录中出现同名文件再切换
+    if ((events & LOG_VIEWER_EVENT_REPLACED) && stat(lv->log_file_path, &current) == 0 &&
+        (current.st_dev != statbuf.st_dev || current.st_ino != statbuf.st_ino)) {
+        return log_viewer_reload(lv);
+    }
+
+    // 被截断后重新加载
+    if ((size_t)statbuf.st_size < lv->map_size) {
+        return log_viewer_reload(lv);
     }
 
     // 检查文件是否有变化
-    if (statbuf.st_size == lv->last_file_size) {
+    if ((size_t)statbuf.st_size == lv->map_size) {
         return SWK_SUCCESS; // 无变化
     }
 
-    long current_pos = ftell(lv->log_file);
-    fseek(lv->log_file, lv->last_file_size, SEEK_SET);
+    int result = log_viewer_map(lv, (size_t)statbuf.st_size);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+    log_viewer_read_new(lv);
 
-    char line[2048];
-    LogEntry *tail = lv->current_entry;
+    // 如果跟随尾部模式，滚动到最新条目
+    if (lv->follow_tail) {
+        log_viewer_show_last(lv);
+    }
 
-    while (fgets(line, sizeof(line), lv->log_file)) {
-        line[strcspn(line, "\n\r")] = '\0';
+    return SWK_SUCCESS;
+}
 
-        if (strlen(line) == 0) continue;
+int log_viewer_get_watch_fd(LogViewer *lv) {
+    return lv && !lv->memory ? lv->watch_fd : -1;
+}
 
-        LogEntry *entry = parse_log_line(line);
-        if (entry) {
-            if (!lv->entries) {
-                lv->entries = entry;
-                tail = entry;
-            } else {
-                tail->next = entry;
-                entry->prev = tail;
-                tail = entry;
-            }
+int log_viewer_wait(LogViewer *lv, int timeout_ms) {
+    if (!lv) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    // 没有 inotify 时只能等满超时再检查
+    struct pollfd pfd = {log_viewer_get_watch_fd(lv), POLLIN, 0};
+    if (pfd.fd >= 0) {
+        poll(&pfd, 1, timeout_ms);
+    } else if (timeout_ms > 0) {
+        poll(NULL, 0, timeout_ms);
+    }
+
+    return log_viewer_refresh(lv);
+}
 
-            lv->total_entries++;
+// 把归档的第 index 帧载入为当前条目（替换现有条目）
+static int log_viewer_load_frame(LogViewer *lv, const LogArchive *archive, uint32_t index) {
+    uint8_t *data;
+    size_t length;
+
+    int result = log_archive_read_frame(archive, index, &data, &length);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    log_viewer_close(lv);
+    lv->memory = 0;
+    lv->binary = archive->binary;
+
+    if (lv->binary) {
+        lv->decoder = malloc(sizeof(LogBinaryDecoder));
+        if (!lv->decoder) {
+            free(data);
+            return SWK_ERROR_OUT_OF_MEMORY;
         }
+        log_binary_decoder_init(lv->decoder);
+
+        // 先喂入本帧所需的文件头和格式串定义
+        log_viewer_decode_binary(lv, archive->preamble, archive->frames[index].preamble_length);
+        log_viewer_decode_binary(lv, data, length);
+        if (lv->decoder->skipped_bytes > 0) {
+            SWK_LOG_WARN(LOG_SUBSYS_TUI, "Corrupt frame %u in archive %s", index, lv->log_file_path);
+        }
+        free(data);
+    } else {
+        // 文本帧直接作为索引的文本，帧总是在记录边界上切分
+        lv->text_buffer = (char *)data;
+        lv->text_capacity = length;
+        lv->text = lv->text_buffer;
+        lv->text_size = log_viewer_index_lines(lv, 0, length);
+        log_viewer_indexed(lv);
     }
 
-    lv->last_file_size = statbuf.st_size;
+    lv->archive_frame = index;
+    log_viewer_show_line(lv, 0);
+    return SWK_SUCCESS;
+}
 
-    // 如果跟随尾部模式，滚动到最新条目
-    if (lv->follow_tail) {
-        lv->current_entry = tail;
-        lv->current_position = lv->total_entries - 1;
+// 打开轮转后的压缩归档，直接定位到 time_ms 所在的帧（time_ms < 0 表示第一帧）
+// 只解压这一帧；归档不再增长，自动刷新对其无效
+int log_viewer_open_archive(LogViewer *lv, const char *archive_path, int64_t time_ms) {
+    LogArchive archive;
+
+    if (!lv || !archive_path) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    int result = log_archive_open(&archive, archive_path);
+    if (result != SWK_SUCCESS) {
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Cannot open log archive: %s", archive_path);
+        return result;
+    }
+
+    strncpy(lv->log_file_path, archive_path, sizeof(lv->log_file_path) - 1);
+    uint32_t index = time_ms < 0 ? 0 : log_archive_find_frame(&archive, time_ms);
+    result = log_viewer_load_frame(lv, &archive, index);
+    log_archive_close(&archive);
+
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    // 定位到帧内第一条不早于 time_ms 的记录
+    if (time_ms >= 0) {
+        int i = 0;
+        for (; i < lv->total_entries - 1; i++) {
+            size_t length;
+            const char *line = log_viewer_line(lv, i, &length);
+            if (log_time_parse(line, length) >= time_ms) {
+                break;
+            }
+        }
+        log_viewer_show_line(lv, i);
     }
 
-    fseek(lv->log_file, current_pos, SEEK_SET);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded frame %u (%d entries) from archive %s",
+                                  index, lv->total_entries, archive_path);
     return SWK_SUCCESS;
 }
 
-// 解析日志行
-LogEntry *parse_log_line(const char *line) {
-    if (!line) return NULL;
+// 在压缩归档中搜索 pattern，逐帧解压，停在第一处匹配所在的帧
+int log_viewer_search_archive(LogViewer *lv, const char *archive_path, const char *pattern) {
+    LogArchive archive;
 
-    LogEntry *entry = malloc(sizeof(LogEntry));
-    if (!entry) return NULL;
+    if (!lv || !archive_path || !pattern || !pattern[0]) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    int result = log_archive_open(&archive, archive_path);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    strncpy(lv->log_file_path, archive_path, sizeof(lv->log_file_path) - 1);
+    result = SWK_ERROR;
+
+    for (uint32_t i = 0; i < archive.frame_count && result != SWK_SUCCESS; i++) {
+        // 文本帧先在原始数据上粗筛，不命中就不必逐行解析
+        if (!archive.binary) {
+            uint8_t *data;
+            size_t length;
+            if (log_archive_read_frame(&archive, i, &data, &length) != SWK_SUCCESS) {
+                break;
+            }
+            int hit = memmem(data, length, pattern, strlen(pattern)) != NULL;
+            free(data);
+            if (!hit) {
+                continue;
+            }
+        }
+
+        if (log_viewer_load_frame(lv, &archive, i) != SWK_SUCCESS) {
+            break;
+        }
+        for (int j = 0; j < lv->total_entries; j++) {
+            LogEntry *entry = log_viewer_get_entry_at(lv, j);
+            if (entry && strstr(entry->message, pattern)) {
+                log_viewer_show_line(lv, j);
+                result = SWK_SUCCESS;
+                break;
+            }
+        }
+    }
+
+    log_archive_close(&archive);
+
+    if (result != SWK_SUCCESS && lv->total_entries > 0) {
+        log_viewer_show_line(lv, 0);
+    }
+    return result;
+}
+
+// 取第 position 条日志，未缓存时解析该行
+LogEntry *log_viewer_get_entry_at(LogViewer *lv, int position) {
+    if (!lv || position < 0 || position >= lv->total_entries) {
+        return NULL;
+    }
+
+    if (!lv->cache) {
+        lv->cache = malloc(LOG_VIEWER_CACHE_SIZE * sizeof(LogEntry));
+        if (!lv->cache) {
+            return NULL;
+        }
+    }
 
+    int slot = position % LOG_VIEWER_CACHE_SIZE;
+    if (lv->cache_lines[slot] != position) {
+        char line[LOG_VIEWER_LINE_MAX];
+        size_t length;
+        const char *start = log_viewer_line(lv, position, &length);
+
+        if (length >= sizeof(line)) {
+            length = sizeof(line) - 1;
+        }
+        memcpy(line, start, length);
+        line[length] = '\0';
+
+        log_viewer_parse_into(&lv->cache[slot], line);
+        lv->cache_lines[slot] = position;
+    }
+
+    return &lv->cache[slot];
+}
+
+// 解析日志行到 entry
+static void log_viewer_parse_into(LogEntry *entry, const char *line) {
     memset(entry, 0, sizeof(LogEntry));
 
     // 尝试匹配标准日志格式：[YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] message
@@ -210,7 +766,16 @@ LogEntry *parse_log_line(const char *line) {
         strcpy(entry->timestamp, "Unknown");
         entry->level = LOG_INFO;
     }
+}
+
+// 解析日志行
+LogEntry *parse_log_line(const char *line) {
+    if (!line) return NULL;
+
+    LogEntry *entry = malloc(sizeof(LogEntry));
+    if (!entry) return NULL;
 
+    log_viewer_parse_into(entry, line);
     return entry;
 }
 
@@ -251,86 +816,316 @@ const char *level_to_color(LogLevel level) {
     }
 }
 
+// 过滤条件变化后保持当前行（被过滤掉时移到其后第一条通过过滤的行）
+static void log_viewer_filter_changed(LogViewer *lv, long line) {
+    if (line >= 0) {
+        log_viewer_show_line(lv, line);
+    } else {
+        log_viewer_show_last(lv);
+    }
+}
+
 // 设置级别过滤器
 void log_viewer_set_level_filter(LogViewer *lv, LogLevel min_level) {
     if (!lv) return;
+
+    long line = log_viewer_view_line(lv, lv->current_position);
     lv->min_level = min_level;
+    log_filter_set_level(&lv->filter, min_level);
+    log_viewer_filter_changed(lv, line);
 }
 
-// 设置模式过滤器
+// 设置模式过滤器（含正则元字符时按扩展正则匹配）
 void log_viewer_set_pattern_filter(LogViewer *lv, const char *pattern) {
     if (!lv || !pattern) return;
 
-    strncpy(lv->filter_pattern, pattern, sizeof(lv->filter_pattern) - 1);
+    long line = log_viewer_view_line(lv, lv->current_position);
+    snprintf(lv->filter_pattern, sizeof(lv->filter_pattern), "%s", pattern);
+    log_filter_set_pattern(&lv->filter, lv->filter_pattern);
+    log_viewer_filter_changed(lv, line);
 }
 
 // 设置来源过滤器
 void log_viewer_set_source_filter(LogViewer *lv, const char *source) {
     if (!lv || !source) return;
 
-    strncpy(lv->source_filter, source, sizeof(lv->source_filter) - 1);
+    long line = log_viewer_view_line(lv, lv->current_position);
+    snprintf(lv->source_filter, sizeof(lv->source_filter), "%s", source);
+    log_filter_set_source(&lv->filter, lv->source_filter);
+    log_viewer_filter_changed(lv, line);
 }
 
 // 清除所有过滤器
 void log_viewer_clear_filters(LogViewer *lv) {
     if (!lv) return;
 
+    long line = log_viewer_view_line(lv, lv->current_position);
     lv->min_level = LOG_DEBUG;
     lv->filter_pattern[0] = '\0';
     lv->source_filter[0] = '\0';
+    log_filter_set_level(&lv->filter, LOG_DEBUG);
+    log_filter_set_pattern(&lv->filter, NULL);
+    log_filter_set_source(&lv->filter, NULL);
+    lv->time_from = -1;
+    lv->time_to = -1;
+    log_viewer_update_range(lv);
+    log_viewer_filter_changed(lv, line);
 }
 
-// 获取当前条目
-LogEntry *log_viewer_get_current_entry(LogViewer *lv) {
-    if (!lv) return NULL;
-    return lv->current_entry;
+// 设置时间范围过滤器
+void log_viewer_set_time_filter(LogViewer *lv, int64_t from_ms, int64_t to_ms) {
+    if (!lv) return;
+
+    long line = log_viewer_view_line(lv, lv->current_position);
+    lv->time_from = from_ms >= 0 ? from_ms : -1;
+    lv->time_to = to_ms >= 0 ? to_ms : -1;
+    log_viewer_update_range(lv);
+    log_viewer_filter_changed(lv, line);
 }
 
-// 向上滚动
-int log_viewer_scroll_up(LogViewer *lv, int lines) {
-    if (!lv || !lv->current_entry) return SWK_ERROR_INVALID_PARAM;
+// 跳到某个时间：在时间列上二分找到行，被过滤掉时取其后第一条通过过滤的行
+int log_viewer_jump_to_time(LogViewer *lv, int64_t ms) {
+    if (!lv || lv->total_entries == 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
 
-    for (int i = 0; i < lines && lv->current_entry->prev; i++) {
-        lv->current_entry = lv->current_entry->prev;
-        lv->current_position--;
+    log_viewer_show_line(lv, (long)log_time_lower_bound(&lv->times, ms));
+    return lv->current_position >= 0 ? SWK_SUCCESS : SWK_ERROR;
+}
+
+// 一次搜索的状态
+typedef struct {
+    LogFilterMatcher matcher;
+    uint32_t *blocks;           // 三元组索引给出的候选块
+    long block_count;           // 没有可用的索引时为 -1
+    const LogTrigramIndex *trigrams;
+    size_t tail_line;           // 索引未覆盖的第一行
+} LogViewerSearch;
+
+// 不早于 offset 开始的第一行
+static size_t log_viewer_first_line_at(const LogViewer *lv, uint64_t offset) {
+    size_t line = log_index_line_of(&lv->index, 0, lv->index.count, offset);
+    return lv->index.offsets[line] < offset ? line + 1 : line;
+}
+
+// 第 line 行是否匹配且通过当前过滤
+static int log_viewer_search_match(LogViewer *lv, const LogViewerSearch *search, size_t line) {
+    size_t length;
+    const char *text = log_viewer_line(lv, (int)line, &length);
+
+    return log_filter_matcher_test(&search->matcher, text, length) &&
+           (!log_filter_active(&lv->filter) || log_filter_contains(&lv->filter, line));
+}
+
+// 在 [first, end) 行中查找，direction > 0 时返回第一个匹配，否则返回最后一个
+static long log_viewer_search_scan(LogViewer *lv, const LogViewerSearch *search,
+                                   size_t first, size_t end, int direction) {
+    const LogFilterMatcher *m = &search->matcher;
+    long found = -1;
+
+    if (m->literal_length == 0) {
+        for (size_t i = 0; i < end - first; i++) {
+            size_t line = direction > 0 ? first + i : end - 1 - i;
+            if (log_viewer_search_match(lv, search, line)) {
+                return (long)line;
+            }
+        }
+        return -1;
     }
 
-    return SWK_SUCCESS;
+    // 在整段文本上查找字面量，命中后映射回行号再确认
+    uint64_t pos = lv->index.offsets[first];
+    uint64_t limit = end < lv->index.count ? lv->index.offsets[end] : lv->text_size;
+    while (pos < limit) {
+        const char *hit = memmem(lv->text + pos, limit - pos, m->literal, m->literal_length);
+        if (!hit) {
+            break;
+        }
+        size_t line = log_index_line_of(&lv->index, first, end, (uint64_t)(hit - lv->text));
+        if (log_viewer_search_match(lv, search, line)) {
+            found = (long)line;
+            if (direction > 0) {
+                break;
+            }
+        }
+        pos = line + 1 < end ? lv->index.offsets[line + 1] : limit;
+    }
+    return found;
 }
 
-// 向下滚动
-int log_viewer_scroll_down(LogViewer *lv, int lines) {
-    if (!lv || !lv->current_entry) return SWK_ERROR_INVALID_PARAM;
+// 线性查找 [first, end)；向前查找按窗口从后往前进行，找到即停
+static long log_viewer_search_linear(LogViewer *lv, const LogViewerSearch *search,
+                                     size_t first, size_t end, int direction) {
+    if (direction > 0) {
+        return log_viewer_search_scan(lv, search, first, end, direction);
+    }
 
-    for (int i = 0; i < lines && lv->current_entry->next; i++) {
-        lv->current_entry = lv->current_entry->next;
-        lv->current_position++;
+    for (size_t stop = end; stop > first;) {
+        size_t start = stop - first > LOG_VIEWER_SEARCH_WINDOW ? stop - LOG_VIEWER_SEARCH_WINDOW : first;
+        long found = log_viewer_search_scan(lv, search, start, stop, direction);
+        if (found >= 0) {
+            return found;
+        }
+        stop = start;
     }
+    return -1;
+}
 
-    return SWK_SUCCESS;
+// 查找 [first, end)：有索引时只查候选块和索引未覆盖的尾部
+static long log_viewer_search_range(LogViewer *lv, const LogViewerSearch *search,
+                                    size_t first, size_t end, int direction) {
+    if (first >= end) {
+        return -1;
+    }
+    if (search->block_count < 0) {
+        return log_viewer_search_linear(lv, search, first, end, direction);
+    }
+
+    long found = -1;
+    if (direction < 0 && search->tail_line < end) {
+        found = log_viewer_search_linear(lv, search, search->tail_line > first ? search->tail_line : first,
+                                         end, direction);
+    }
+
+    for (long i = 0; found < 0 && i < search->block_count; i++) {
+        uint32_t block = search->blocks[direction > 0 ? i : search->block_count - 1 - i];
+        size_t block_first = log_viewer_first_line_at(lv, search->trigrams->blocks[block]);
+        size_t block_end = log_viewer_first_line_at(lv, search->trigrams->blocks[block + 1]);
+
+        if (block_first < first) {
+            block_first = first;
+        }
+        if (block_end > end) {
+            block_end = end;
+        }
+        if (block_first < block_end) {
+            found = log_viewer_search_linear(lv, search, block_first, block_end, direction);
+        }
+    }
+
+    if (found < 0 && direction > 0 && search->tail_line < end) {
+        found = log_viewer_search_linear(lv, search, search->tail_line > first ? search->tail_line : first,
+                                         end, direction);
+    }
+    return found;
 }
 
-// 滚动到顶部
-int log_viewer_scroll_to_top(LogViewer *lv) {
-    if (!lv || !lv->entries) return SWK_ERROR_INVALID_PARAM;
+// 从当前行开始向后（direction > 0）或向前查找，到头后回绕
+static int log_viewer_search(LogViewer *lv, const char *pattern, int direction) {
+    LogViewerSearch search;
+
+    if (!lv || !pattern) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+    memset(&search, 0, sizeof(search));
+    if (!log_filter_matcher_compile(&search.matcher, pattern)) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
 
-    lv->current_entry = lv->entries;
-    lv->current_position = 0;
+    size_t total = lv->index.count;
+    if (log_filter_active(&lv->filter)) {
+        log_filter_update(&lv->filter, lv->text, lv->text_size, &lv->index);
+    }
+
+    // 三元组索引缩小到少数候选块
+    search.block_count = -1;
+    search.trigrams = log_trigram_builder_ready(&lv->search);
+    if (search.trigrams && total > 0) {
+        search.block_count = log_trigram_candidates(search.trigrams, search.matcher.literal,
+                                                    search.matcher.literal_length, &search.blocks);
+        search.tail_line = log_viewer_first_line_at(lv, log_trigram_covered(search.trigrams));
+    }
+
+    long current = log_viewer_view_line(lv, lv->current_position);
+    long found = -1;
+    if (total > 0 && direction > 0) {
+        size_t start = current >= 0 ? (size_t)current + 1 : 0;
+        found = log_viewer_search_range(lv, &search, start, total, direction);
+        if (found < 0) {
+            found = log_viewer_search_range(lv, &search, 0, start < total ? start : total, direction);
+        }
+    } else if (total > 0) {
+        size_t start = current >= 0 ? (size_t)current : total;
+        found = log_viewer_search_range(lv, &search, 0, start, direction);
+        if (found < 0) {
+            found = log_viewer_search_range(lv, &search, start, total, direction);
+        }
+    }
+
+    free(search.blocks);
+    log_filter_matcher_free(&search.matcher);
+
+    if (found < 0) {
+        return SWK_ERROR;
+    }
+    log_viewer_show_line(lv, found);
     return SWK_SUCCESS;
 }
 
-// 滚动到底部
-int log_viewer_scroll_to_bottom(LogViewer *lv) {
-    if (!lv || !lv->entries) return SWK_ERROR_INVALID_PARAM;
+int log_viewer_search_next(LogViewer *lv, const char *pattern) {
+    return log_viewer_search(lv, pattern, 1);
+}
 
-    while (lv->current_entry->next) {
-        lv->current_entry = lv->current_entry->next;
-        lv->current_position++;
-    }
+int log_viewer_search_prev(LogViewer *lv, const char *pattern) {
+    return log_viewer_search(lv, pattern, -1);
+}
+
+int log_viewer_search_indexed(LogViewer *lv) {
+    return lv && log_trigram_builder_ready(&lv->search) != NULL;
+}
+
+// 获取视图中的第 position 条
+LogEntry *log_viewer_get_view_entry(LogViewer *lv, int position) {
+    if (!lv) return NULL;
+
+    long line = log_viewer_view_line(lv, position);
+    return line >= 0 ? log_viewer_get_entry_at(lv, (int)line) : NULL;
+}
+
+// 获取当前条目
+LogEntry *log_viewer_get_current_entry(LogViewer *lv) {
+    return log_viewer_get_view_entry(lv, lv ? lv->current_position : -1);
+}
 
+// 移动到 position（限制在有效范围内）
+static int log_viewer_move_to(LogViewer *lv, long position) {
+    if (!lv) return SWK_ERROR_INVALID_PARAM;
+
+    int count = log_viewer_view_count(lv);
+    if (count == 0) return SWK_ERROR_INVALID_PARAM;
+
+    if (position < 0) {
+        position = 0;
+    } else if (position >= count) {
+        position = count - 1;
+    }
+    lv->current_position = (int)position;
     return SWK_SUCCESS;
 }
 
+// 向上滚动
+int log_viewer_scroll_up(LogViewer *lv, int lines) {
+    if (!lv) return SWK_ERROR_INVALID_PARAM;
+    return log_viewer_move_to(lv, (long)lv->current_position - lines);
+}
+
+// 向下滚动
+int log_viewer_scroll_down(LogViewer *lv, int lines) {
+    if (!lv) return SWK_ERROR_INVALID_PARAM;
+    return log_viewer_move_to(lv, (long)lv->current_position + lines);
+}
+
+// 滚动到顶部
+int log_viewer_scroll_to_top(LogViewer *lv) {
+    return log_viewer_move_to(lv, 0);
+}
+
+// 滚动到底部
+int log_viewer_scroll_to_bottom(LogViewer *lv) {
+    if (!lv) return SWK_ERROR_INVALID_PARAM;
+    return log_viewer_move_to(lv, (long)log_viewer_view_count(lv) - 1);
+}
+
 // 向上翻页
 int log_viewer_page_up(LogViewer *lv) {
     return log_viewer_scroll_up(lv, lv->visible_entries);
@@ -347,19 +1142,22 @@ int log_viewer_get_total_entries(LogViewer *lv) {
     return lv->total_entries;
 }
 
-// 获取按级别过滤的条目数
-int log_viewer_get_entries_by_level(LogViewer *lv, LogLevel level) {
+// 获取通过当前过滤条件的条目数
+int log_viewer_get_filtered_entries(LogViewer *lv) {
     if (!lv) return 0;
+    return log_viewer_view_count(lv);
+}
 
-    int count = 0;
-    LogEntry *current = lv->entries;
+// 获取某一级别的条目数（取自增量维护的统计）
+int log_viewer_get_entries_by_level(LogViewer *lv, LogLevel level) {
+    if (!lv || (unsigned)level >= LOG_STATS_LEVELS) return 0;
 
-    while (current) {
-        if (current->level == level) count++;
-        current = current->next;
-    }
+    return (int)lv->stats.level_counts[level];
+}
 
-    return count;
+// 获取增量维护的统计
+const LogStats *log_viewer_get_stats(LogViewer *lv) {
+    return lv ? &lv->stats : NULL;
 }
 
 // 切换时间戳显示
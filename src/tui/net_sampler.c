@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "net_sampler.h"
+#include "logger.h"
+
+#define NET_SAMPLER_LOOPBACK 772     // ARPHRD_LOOPBACK
+
+static const char *const net_counter_names[NET_COUNTERS] = {
+    "rx_bytes", "tx_bytes", "rx_packets", "tx_packets",
+    "rx_dropped", "tx_dropped", "rx_errors", "tx_errors",
+};
+
+static void net_interface_close(NetInterface *iface) {
+    for (int i = 0; i < NET_COUNTERS; i++) {
+        if (iface->fds[i] >= 0) {
+            close(iface->fds[i]);
+            iface->fds[i] = -1;
+        }
+    }
+}
+
+static int net_interface_open(NetInterface *iface, const char *root, const char *name) {
+    char path[MAX_PATH_LENGTH + 64], buf[16];
+    int opened = 0;
+
+    memset(iface, 0, sizeof(NetInterface));
+    snprintf(iface->name, sizeof(iface->name), "%s", name);
+    for (int i = 0; i < NET_COUNTERS; i++) {
+        snprintf(path, sizeof(path), "%s/%s/statistics/%s", root, name, net_counter_names[i]);
+        iface->fds[i] = open(path, O_RDONLY | O_CLOEXEC);
+        opened += iface->fds[i] >= 0;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s/type", root, name);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        ssize_t n = read(fd, buf, sizeof(buf) - 1);
+        buf[n > 0 ? n : 0] = '\0';
+        iface->loopback = atoi(buf) == NET_SAMPLER_LOOPBACK;
+        close(fd);
+    } else {
+        iface->loopback = strcmp(name, "lo") == 0;
+    }
+    return opened > 0 ? SWK_SUCCESS : SWK_ERROR_FILE_NOT_FOUND;
+}
+
+static int net_interface_compare(const void *a, const void *b) {
+    return strcmp(((const NetInterface *)a)->name, ((const NetInterface *)b)->name);
+}
+
+// 度量最小的默认路由所在的接口
+static void net_sampler_find_primary(NetSampler *sampler) {
+    FILE *file = fopen(sampler->route, "r");
+    char line[256], best[NET_IFNAME_MAX] = "";
+    int best_metric = -1;
+
+    if (file) {
+        while (fgets(line, sizeof(line), file)) {
+            char iface[NET_IFNAME_MAX], destination[16], mask[16];
+            unsigned int flags;
+            int metric;
+
+            if (sscanf(line, "%15s %15s %*s %x %*d %*d %d %15s", iface, destination, &flags, &metric, mask) == 5 &&
+                strcmp(destination, "00000000") == 0 && strcmp(mask, "00000000") == 0 && (flags & 1) &&
+                (best_metric < 0 || metric < best_metric)) {
+                snprintf(best, sizeof(best), "%s", iface);
+                best_metric = metric;
+            }
+        }
+        fclose(file);
+    }
+
+    sampler->primary = -1;
+    for (int i = 0; i < sampler->count; i++) {
+        if (best[0] ? strcmp(sampler->interfaces[i].name, best) == 0 : !sampler->interfaces[i].loopback) {
+            sampler->primary = i;
+            break;
+        }
+    }
+}
+
+// 重新枚举接口；仍然存在的接口保留上一次的计数，读取没有失败过的还保留描述符
+static int net_sampler_enumerate(NetSampler *sampler) {
+    DIR *dir = opendir(sampler->root);
+    if (!dir) {
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    NetInterface *interfaces = NULL;
+    int count = 0, capacity = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.' || strlen(entry->d_name) >= NET_IFNAME_MAX) {
+            continue;
+        }
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            NetInterface *larger = realloc(interfaces, (size_t)capacity * sizeof(NetInterface));
+            if (!larger) {
+                break;
+            }
+            interfaces = larger;
+        }
+
+        NetInterface *iface = &interfaces[count];
+        NetInterface *old = (NetInterface *)net_sampler_find(sampler, entry->d_name);
+        if (old && !old->reopen) {
+            *iface = *old;
+            memset(old->fds, -1, sizeof(old->fds));  // 描述符转交给新列表
+            count++;
+        } else if (old) {
+            // 读取失败过：重新打开，保留计数以便继续计算差值
+            NetInterface previous = *old;
+            if (net_interface_open(iface, sampler->root, entry->d_name) == SWK_SUCCESS) {
+                memcpy(iface->counters, previous.counters, sizeof(iface->counters));
+                iface->sampled = previous.sampled;
+                count++;
+            } else {
+                net_interface_close(iface);
+            }
+        } else if (net_interface_open(iface, sampler->root, entry->d_name) == SWK_SUCCESS) {
+            count++;
+        } else {
+            net_interface_close(iface);
+        }
+    }
+    closedir(dir);
+
+    for (int i = 0; i < sampler->count; i++) {
+        net_interface_close(&sampler->interfaces[i]);
+    }
+    free(sampler->interfaces);
+    if (count > 1) {
+        qsort(interfaces, (size_t)count, sizeof(NetInterface), net_interface_compare);
+    }
+    sampler->interfaces = interfaces;
+    sampler->count = count;
+    sampler->capacity = capacity;
+    sampler->rescan = 0;
+    net_sampler_find_primary(sampler);
+    return SWK_SUCCESS;
+}
+
+int net_sampler_open(NetSampler *sampler, const char *root, const char *route) {
+    if (!sampler) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(sampler, 0, sizeof(NetSampler));
+    sampler->primary = -1;
+    snprintf(sampler->root, sizeof(sampler->root), "%s", root ? root : NET_SAMPLER_ROOT);
+    snprintf(sampler->route, sizeof(sampler->route), "%s", route ? route : NET_SAMPLER_ROUTE);
+
+    int result = net_sampler_enumerate(sampler);
+    if (result != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Cannot list network interfaces in %s", sampler->root);
+    }
+    return result;
+}
+
+void net_sampler_close(NetSampler *sampler) {
+    if (!sampler) return;
+
+    for (int i = 0; i < sampler->count; i++) {
+        net_interface_close(&sampler->interfaces[i]);
+    }
+    free(sampler->interfaces);
+    memset(sampler, 0, sizeof(NetSampler));
+    sampler->primary = -1;
+}
+
+int net_sampler_sample(NetSampler *sampler, double now) {
+    if (!sampler) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    if ((sampler->rescan || (sampler->samples > 0 && sampler->samples % NET_SAMPLER_RESCAN == 0)) &&
+        net_sampler_enumerate(sampler) != SWK_SUCCESS) {
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    sampler->samples++;
+    sampler->interval = sampler->samples > 1 && now > sampler->last ? now - sampler->last : 0.0;
+    sampler->last = now;
+
+    for (int i = 0; i < sampler->count; i++) {
+        NetInterface *iface = &sampler->interfaces[i];
+
+        for (int c = 0; c < NET_COUNTERS; c++) {
+            char buf[32];
+            uint64_t value;
+
+            iface->rates[c] = 0.0;
+            if (iface->fds[c] < 0) {
+                continue;
+            }
+            ssize_t n = pread(iface->fds[c], buf, sizeof(buf) - 1, 0);
+            if (n <= 0) {
+                iface->reopen = 1;    // 接口已被删除或重建
+                sampler->rescan = 1;
+                continue;
+            }
+            buf[n] = '\0';
+            value = strtoull(buf, NULL, 10);
+
+            if (iface->sampled && sampler->interval > 0.0 && value >= iface->counters[c]) {
+                iface->rates[c] = (double)(value - iface->counters[c]) / sampler->interval;
+            }
+            iface->counters[c] = value;
+        }
+        iface->sampled = 1;
+    }
+    return SWK_SUCCESS;
+}
+
+const NetInterface *net_sampler_find(const NetSampler *sampler, const char *name) {
+    for (int i = 0; sampler && name && i < sampler->count; i++) {
+        if (strcmp(sampler->interfaces[i].name, name) == 0) {
+            return &sampler->interfaces[i];
+        }
+    }
+    return NULL;
+}
+
+const NetInterface *net_sampler_primary(const NetSampler *sampler) {
+    return sampler && sampler->primary >= 0 ? &sampler->interfaces[sampler->primary] : NULL;
+}
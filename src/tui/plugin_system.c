@@ -21,7 +21,7 @@ int plugin_system_init(PluginSystem *ps, const char *plugin_dir) {
     struct stat st = {0};
     if (stat(plugin_dir, &st) == -1) {
         if (mkdir(plugin_dir, 0755) != 0) {
-            log_message(LOG_ERROR, "Failed to create plugin directory: %s", plugin_dir);
+            SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Failed to create plugin directory: %s", plugin_dir);
             return SWK_ERROR_SYSTEM_CALL;
         }
     }
@@ -57,7 +57,7 @@ int plugin_system_scan_plugins(PluginSystem *ps) {
 
     dir = opendir(ps->plugin_dir);
     if (!dir) {
-        log_message(LOG_ERROR, "Cannot open plugin directory: %s", ps->plugin_dir);
+        SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Cannot open plugin directory: %s", ps->plugin_dir);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
@@ -77,7 +77,7 @@ int plugin_system_scan_plugins(PluginSystem *ps) {
     }
 
     closedir(dir);
-    log_message(LOG_DEBUG, "Scanned %d plugins in %s", ps->plugin_count, ps->plugin_dir);
+    SWK_LOG_DEBUG(LOG_SUBSYS_PLUGINS, "Scanned %d plugins in %s", ps->plugin_count, ps->plugin_dir);
     return SWK_SUCCESS;
 }
 
@@ -90,7 +90,7 @@ int plugin_system_load_plugin(PluginSystem *ps, const char *plugin_path) {
     // 打开动态库
     void *handle = dlopen(plugin_path, RTLD_LAZY);
     if (!handle) {
-        log_message(LOG_ERROR, "Failed to load plugin %s: %s", plugin_path, dlerror());
+        SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Failed to load plugin %s: %s", plugin_path, dlerror());
         return SWK_ERROR_SYSTEM_CALL;
     }
 
@@ -101,7 +101,7 @@ int plugin_system_load_plugin(PluginSystem *ps, const char *plugin_path) {
     PluginGetTypeFunc get_type = (PluginGetTypeFunc)dlsym(handle, "plugin_get_type");
 
     if (!get_name || !get_version || !get_description || !get_type) {
-        log_message(LOG_ERROR, "Invalid plugin %s: missing required functions", plugin_path);
+        SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Invalid plugin %s: missing required functions", plugin_path);
         dlclose(handle);
         return SWK_ERROR_INVALID_PARAM;
     }
@@ -134,7 +134,7 @@ int plugin_system_load_plugin(PluginSystem *ps, const char *plugin_path) {
         ps->enabled_count++;
     }
 
-    log_message(LOG_INFO, "Loaded plugin: %s v%s (%s)",
+    SWK_LOG_INFO(LOG_SUBSYS_PLUGINS, "Loaded plugin: %s v%s (%s)",
                plugin->name, plugin->version, plugin->description);
     return SWK_SUCCESS;
 }
@@ -174,7 +174,7 @@ int plugin_system_unload_plugin(PluginSystem *ps, const char *plugin_name) {
             ps->plugin_count--;
             free(current);
 
-            log_message(LOG_INFO, "Unloaded plugin: %s", plugin_name);
+            SWK_LOG_INFO(LOG_SUBSYS_PLUGINS, "Unloaded plugin: %s", plugin_name);
             return SWK_SUCCESS;
         }
 
@@ -199,7 +199,7 @@ int plugin_system_enable_plugin(PluginSystem *ps, const char *plugin_name) {
     if (!plugin->enabled) {
         plugin->enabled = 1;
         ps->enabled_count++;
-        log_message(LOG_INFO, "Enabled plugin: %s", plugin_name);
+        SWK_LOG_INFO(LOG_SUBSYS_PLUGINS, "Enabled plugin: %s", plugin_name);
     }
 
     return SWK_SUCCESS;
@@ -219,7 +219,7 @@ int plugin_system_disable_plugin(PluginSystem *ps, const char *plugin_name) {
     if (plugin->enabled) {
         plugin->enabled = 0;
         ps->enabled_count--;
-        log_message(LOG_INFO, "Disabled plugin: %s", plugin_name);
+        SWK_LOG_INFO(LOG_SUBSYS_PLUGINS, "Disabled plugin: %s", plugin_name);
     }
 
     return SWK_SUCCESS;
@@ -313,11 +313,11 @@ int plugin_system_execute_plugin(PluginSystem *ps, const char *name, void *data)
 
     PluginExecuteFunc execute = (PluginExecuteFunc)dlsym(plugin->handle, "plugin_execute");
     if (!execute) {
-        log_message(LOG_ERROR, "Plugin %s does not have execute function", name);
+        SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Plugin %s does not have execute function", name);
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    log_message(LOG_DEBUG, "Executing plugin: %s", name);
+    SWK_LOG_DEBUG(LOG_SUBSYS_PLUGINS, "Executing plugin: %s", name);
     return execute(data);
 }
 
@@ -378,7 +378,7 @@ int plugin_system_validate_plugin(PluginSystem *ps, const char *plugin_path) {
     // 尝试打开动态库进行基本验证
     void *handle = dlopen(plugin_path, RTLD_LAZY);
     if (!handle) {
-        log_message(LOG_WARNING, "Invalid plugin file %s: %s", plugin_path, dlerror());
+        SWK_LOG_WARN(LOG_SUBSYS_PLUGINS, "Invalid plugin file %s: %s", plugin_path, dlerror());
         return SWK_ERROR_INVALID_PARAM;
     }
 
@@ -421,7 +421,7 @@ int plugin_system_install_plugin(PluginSystem *ps, const char *plugin_file) {
     snprintf(command, sizeof(command), "cp \"%s\" \"%s\"", plugin_file, dest_path);
 
     if (system(command) != 0) {
-        log_message(LOG_ERROR, "Failed to install plugin %s", plugin_file);
+        SWK_LOG_ERROR(LOG_SUBSYS_PLUGINS, "Failed to install plugin %s", plugin_file);
         return SWK_ERROR_SYSTEM_CALL;
     }
 
@@ -446,9 +446,9 @@ int plugin_system_remove_plugin(PluginSystem *ps, const char *plugin_name) {
     if (result == SWK_SUCCESS) {
         // 删除插件文件
         if (unlink(plugin->file_path) != 0) {
-            log_message(LOG_WARNING, "Failed to remove plugin file: %s", plugin->file_path);
+            SWK_LOG_WARN(LOG_SUBSYS_PLUGINS, "Failed to remove plugin file: %s", plugin->file_path);
         } else {
-            log_message(LOG_INFO, "Removed plugin file: %s", plugin->file_path);
+            SWK_LOG_INFO(LOG_SUBSYS_PLUGINS, "Removed plugin file: %s", plugin->file_path);
         }
     }
 
@@ -0,0 +1,351 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include "proc_events.h"
+#include "logger.h"
+
+// 发送订阅/取消订阅请求
+static int proc_events_control(int fd, enum proc_cn_mcast_op op) {
+    char buffer[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))];
+    struct nlmsghdr *header = (struct nlmsghdr *)buffer;
+    struct cn_msg *message = NLMSG_DATA(header);
+
+    memset(buffer, 0, sizeof(buffer));
+    header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    header->nlmsg_type = NLMSG_DONE;
+    header->nlmsg_pid = (uint32_t)getpid();
+    message->id.idx = CN_IDX_PROC;
+    message->id.val = CN_VAL_PROC;
+    message->len = sizeof(op);
+    memcpy(message->data, &op, sizeof(op));
+
+    return send(fd, buffer, header->nlmsg_len, 0) == (ssize_t)header->nlmsg_len ? SWK_SUCCESS : SWK_ERROR_SYSTEM_CALL;
+}
+
+// 取出消息中的事件（cn_msg 的数据只按 4 字节对齐，proc_event 需要 8 字节对齐）
+static void proc_events_copy(const struct cn_msg *message, struct proc_event *event) {
+    memset(event, 0, sizeof(struct proc_event));
+    memcpy(event, message->data, message->len < sizeof(struct proc_event) ? message->len : sizeof(struct proc_event));
+}
+
+// 接收一个数据报，只接受内核（nl_pid 为 0）发来的消息；其他进程发到本套接字
+// 的数据直接丢弃，不能让它们伪造进程事件
+static ssize_t proc_events_recv(ProcEvents *events) {
+    for (;;) {
+        struct sockaddr_nl from;
+        socklen_t from_length = sizeof(from);
+        ssize_t size = recvfrom(events->fd, events->buffer, PROC_EVENTS_BUFFER, 0,
+                                (struct sockaddr *)&from, &from_length);
+        if (size >= 0 && (from_length != sizeof(from) || from.nl_family != AF_NETLINK || from.nl_pid != 0)) {
+            continue;
+        }
+        return size;
+    }
+}
+
+// 等待内核对订阅请求的确认（PROC_EVENT_NONE，err 为错误码）
+static int proc_events_wait_ack(ProcEvents *events) {
+    struct pollfd pfd = {events->fd, POLLIN, 0};
+
+    while (poll(&pfd, 1, PROC_EVENTS_ACK_MS) > 0) {
+        ssize_t size = proc_events_recv(events);
+        if (size < 0 && (errno == EINTR || errno == ENOBUFS)) {
+            continue;
+        }
+        if (size <= 0) {
+            break;
+        }
+
+        for (struct nlmsghdr *header = (struct nlmsghdr *)events->buffer; NLMSG_OK(header, (size_t)size);
+             header = NLMSG_NEXT(header, size)) {
+            const struct cn_msg *message = NLMSG_DATA(header);
+            struct proc_event event;
+            proc_events_copy(message, &event);
+            if (message->id.idx == CN_IDX_PROC && event.what == PROC_EVENT_NONE) {
+                return event.event_data.ack.err == 0 ? SWK_SUCCESS : SWK_ERROR_PERMISSION_DENIED;
+            }
+        }
+    }
+    return SWK_ERROR_PERMISSION_DENIED;
+}
+
+int proc_events_open(ProcEvents *events) {
+    if (!events) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(events, 0, sizeof(ProcEvents));
+    events->fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (events->fd < 0) {
+        SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "Process connector unavailable: %s", strerror(errno));
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = CN_IDX_PROC;
+    if (bind(events->fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        int error = errno;
+        SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "Cannot bind process connector: %s", strerror(error));
+        proc_events_close(events);
+        return error == EPERM ? SWK_ERROR_PERMISSION_DENIED : SWK_ERROR_SYSTEM_CALL;
+    }
+
+    // 事件突发时尽量不丢（SO_RCVBUFFORCE 需要 CAP_NET_ADMIN，失败时退回普通上限）
+    int size = PROC_EVENTS_RCVBUF;
+    if (setsockopt(events->fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0) {
+        setsockopt(events->fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+
+    events->buffer = malloc(PROC_EVENTS_BUFFER);
+    if (!events->buffer) {
+        proc_events_close(events);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    int result = proc_events_control(events->fd, PROC_CN_MCAST_LISTEN);
+    if (result == SWK_SUCCESS) {
+        result = proc_events_wait_ack(events);
+    }
+    if (result != SWK_SUCCESS) {
+        SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "Process connector subscription refused");
+        proc_events_close(events);
+        return result;
+    }
+
+    // 进程表在第一次采集时由完整扫描建立
+    events->resync = 1;
+    SWK_LOG_INFO(LOG_SUBSYS_MONITOR, "Tracking processes through the process connector");
+    return SWK_SUCCESS;
+}
+
+void proc_events_close(ProcEvents *events) {
+    if (!events) return;
+
+    if (events->fd >= 0) {
+        proc_events_control(events->fd, PROC_CN_MCAST_IGNORE);
+        close(events->fd);
+    }
+    free(events->buffer);
+    proc_table_free(&events->table);
+    memset(events, 0, sizeof(ProcEvents));
+    events->fd = -1;
+}
+
+int proc_events_sync(ProcEvents *events, ProcScanner *scanner) {
+    if (!events || !scanner) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    int result = proc_scanner_scan(scanner);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+    if (!events->table.slots) {
+        result = proc_table_init(&events->table, scanner->count * 2);
+        if (result != SWK_SUCCESS) {
+            return result;
+        }
+    }
+
+    proc_table_clear(&events->table);
+    for (int i = 0; i < scanner->count; i++) {
+        const ProcStat *stat = &scanner->procs[i];
+        ProcEntry *entry = proc_table_insert(&events->table, stat->pid, NULL);
+        if (!entry) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        entry->ppid = stat->ppid;
+        entry->threads = stat->threads;
+        entry->state = stat->state;
+        entry->start_time = stat->start_time;
+    }
+
+    events->process_count = scanner->process_count;
+    events->thread_count = scanner->thread_count;
+    events->zombie_count = scanner->zombie_count;
+    events->resync = 0;
+    events->polls = 0;
+    return SWK_SUCCESS;
+}
+
+// 从表中去掉一个进程并更新计数
+static void proc_events_forget(ProcEvents *events, int pid) {
+    ProcEntry *entry = proc_table_find(&events->table, pid);
+    if (!entry) {
+        return;
+    }
+
+    events->thread_count -= entry->threads;
+    events->zombie_count -= entry->state == 'Z';
+    events->process_count--;
+    proc_table_remove(&events->table, pid);
+}
+
+void proc_events_apply(ProcEvents *events, int type, int pid, int tgid, int ppid) {
+    ProcEntry *entry;
+
+    if (!events || !events->table.slots) {
+        return;
+    }
+
+    switch (type) {
+        case PROC_EVENTS_FORK:
+            if (pid != tgid) {
+                // 新线程
+                entry = proc_table_find(&events->table, tgid);
+                if (entry) {
+                    entry->threads++;
+                    events->thread_count++;
+                }
+                break;
+            }
+            events->forks++;
+            proc_events_forget(events, pid);  // PID 被复用而旧项没有被回收检查去掉
+            entry = proc_table_insert(&events->table, pid, NULL);
+            if (!entry) {
+                events->resync = 1;
+                break;
+            }
+            entry->ppid = ppid;
+            entry->threads = 1;
+            entry->state = 'R';
+            events->process_count++;
+            events->thread_count++;
+            break;
+
+        case PROC_EVENTS_EXEC:
+            events->execs++;
+            break;
+
+        case PROC_EVENTS_EXIT:
+            entry = proc_table_find(&events->table, tgid);
+            if (!entry || entry->state == 'Z') {
+                break;
+            }
+            if (pid != tgid) {
+                if (entry->threads > 1) {
+                    entry->threads--;
+                    events->thread_count--;
+                }
+                break;
+            }
+            // 组长退出后进程成为僵尸，直到被回收
+            events->exits++;
+            events->thread_count -= entry->threads;
+            entry->threads = 0;
+            entry->state = 'Z';
+            events->zombie_count++;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// 处理一批 netlink 消息
+static void proc_events_dispatch(ProcEvents *events, ssize_t size) {
+    for (struct nlmsghdr *header = (struct nlmsghdr *)events->buffer; NLMSG_OK(header, (size_t)size);
+         header = NLMSG_NEXT(header, size)) {
+        if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+            continue;
+        }
+
+        const struct cn_msg *message = NLMSG_DATA(header);
+        struct proc_event copy;
+        const struct proc_event *event = &copy;
+        if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+            continue;
+        }
+        proc_events_copy(message, &copy);
+
+        switch (event->what) {
+            case PROC_EVENT_FORK:
+                proc_events_apply(events, PROC_EVENTS_FORK, event->event_data.fork.child_pid,
+                                  event->event_data.fork.child_tgid, event->event_data.fork.parent_tgid);
+                break;
+            case PROC_EVENT_EXEC:
+                proc_events_apply(events, PROC_EVENTS_EXEC, event->event_data.exec.process_pid,
+                                  event->event_data.exec.process_tgid, 0);
+                break;
+            case PROC_EVENT_EXIT:
+                proc_events_apply(events, PROC_EVENTS_EXIT, event->event_data.exit.process_pid,
+                                  event->event_data.exit.process_tgid, 0);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// 去掉 /proc 中已经不存在（被回收）的僵尸进程
+static void proc_events_reap(ProcEvents *events, int proc_fd) {
+    int reaped[64];
+    int count;
+
+    do {
+        count = 0;
+        for (uint32_t i = 0; i <= events->table.mask && events->zombie_count > 0; i++) {
+            const ProcEntry *entry = &events->table.slots[i];
+            char name[16];
+            struct stat st;
+
+            if (entry->pid == 0 || entry->state != 'Z') {
+                continue;
+            }
+            snprintf(name, sizeof(name), "%d", entry->pid);
+            if (fstatat(proc_fd, name, &st, 0) != 0 && errno == ENOENT) {
+                reaped[count++] = entry->pid;
+                if (count == (int)(sizeof(reaped) / sizeof(reaped[0]))) {
+                    break;
+                }
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            proc_events_forget(events, reaped[i]);
+        }
+    } while (count == (int)(sizeof(reaped) / sizeof(reaped[0])));
+}
+
+int proc_events_poll(ProcEvents *events, ProcScanner *scanner) {
+    if (!events || !scanner) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    // 先取走积压的事件再扫描，只有扫描期间的事件可能被重复应用（新进程的
+    // FORK 覆盖同一 PID，已消失进程的 EXIT 被忽略），偏差由定期扫描纠正
+    while (events->fd >= 0) {
+        ssize_t size = proc_events_recv(events);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size < 0 && errno == ENOBUFS) {
+            events->overflows++;
+            events->resync = 1;
+            continue;
+        }
+        if (size <= 0) {
+            break;
+        }
+        proc_events_dispatch(events, size);
+    }
+
+    if (events->resync || !events->table.slots || ++events->polls >= PROC_EVENTS_RESYNC) {
+        return proc_events_sync(events, scanner);
+    }
+    if (events->zombie_count > 0) {
+        proc_events_reap(events, scanner->fd);
+    }
+    return SWK_SUCCESS;
+}
@@ -0,0 +1,330 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "proc_scanner.h"
+#include "logger.h"
+
+// getdents64 返回的目录项
+struct proc_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// 一个解析分片
+typedef struct {
+    int dir_fd;
+    int read_io;
+    ProcStat *procs;
+    int start;
+    int end;
+} ProcScanShard;
+
+int proc_scanner_open(ProcScanner *scanner, const char *root, int threads) {
+    if (!scanner) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(scanner, 0, sizeof(ProcScanner));
+    scanner->threads = threads < 1 ? 1 : threads > PROC_SCANNER_MAX_THREADS ? PROC_SCANNER_MAX_THREADS : threads;
+    scanner->fd = open(root ? root : PROC_SCANNER_ROOT, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (scanner->fd < 0) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Cannot open %s", root ? root : PROC_SCANNER_ROOT);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    scanner->dirents = malloc(PROC_SCANNER_DIRENTS);
+    if (!scanner->dirents) {
+        proc_scanner_close(scanner);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    return SWK_SUCCESS;
+}
+
+void proc_scanner_close(ProcScanner *scanner) {
+    if (!scanner) return;
+
+    if (scanner->fd >= 0) {
+        close(scanner->fd);
+    }
+    free(scanner->dirents);
+    free(scanner->procs);
+    memset(scanner, 0, sizeof(ProcScanner));
+    scanner->fd = -1;
+}
+
+int proc_scanner_parse_stat(const char *text, size_t length, ProcStat *stat) {
+    const char *end = text + length;
+    const char *open = memchr(text, '(', length);
+    const char *close = end;
+
+    // comm 可能含有 ')'，以最后一个 ')' 为准
+    while (close > text && close[-1] != ')') {
+        close--;
+    }
+    if (!open || close <= open + 1) {
+        return SWK_ERROR;
+    }
+    close--;
+
+    int pid = 0;
+    for (const char *p = text; p < open && *p >= '0' && *p <= '9'; p++) {
+        pid = pid * 10 + (*p - '0');
+    }
+    size_t comm = (size_t)(close - open - 1);
+    if (comm >= PROC_COMM_MAX) {
+        comm = PROC_COMM_MAX - 1;
+    }
+    memcpy(stat->comm, open + 1, comm);
+    stat->comm[comm] = '\0';
+    stat->pid = pid;
+
+    const char *p = close + 2;
+    if (p >= end) {
+        return SWK_ERROR;
+    }
+    stat->state = *p;
+    p += 2;
+
+    // 从第 4 个字段（ppid）读到第 24 个字段（rss）
+    int field;
+    for (field = 4; field <= 24 && p < end; field++) {
+        uint64_t value = 0;
+        int negative = *p == '-';
+
+        p += negative;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value = value * 10 + (uint64_t)(*p++ - '0');
+        }
+        if (p < end && *p != ' ' && *p != '\n') {
+            return SWK_ERROR;
+        }
+        p++;
+
+        switch (field) {
+            case 4:  stat->ppid = (int)value; break;
+            case 14: stat->utime = value; break;
+            case 15: stat->stime = value; break;
+            case 20: stat->threads = (int)value; break;
+            case 22: stat->start_time = value; break;
+            case 24: stat->rss = negative ? 0 : value; break;
+            default: break;
+        }
+    }
+    return field > 24 ? SWK_SUCCESS : SWK_ERROR;
+}
+
+// 从 "read_bytes: " 这样的行首读取数值
+static int proc_scanner_io_field(const char *line, const char *end, const char *name, uint64_t *value) {
+    size_t length = strlen(name);
+
+    if ((size_t)(end - line) <= length || memcmp(line, name, length) != 0) {
+        return 0;
+    }
+    const char *p = line + length;
+    while (p < end && *p == ' ') {
+        p++;
+    }
+    *value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        *value = *value * 10 + (uint64_t)(*p++ - '0');
+    }
+    return 1;
+}
+
+int proc_scanner_parse_io(const char *text, size_t length, ProcStat *stat) {
+    const char *end = text + length;
+    int found = 0;
+
+    for (const char *line = text; line < end;) {
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        const char *line_end = newline ? newline : end;
+
+        found += proc_scanner_io_field(line, line_end, "read_bytes:", &stat->read_bytes);
+        found += proc_scanner_io_field(line, line_end, "write_bytes:", &stat->write_bytes);
+        line = line_end + 1;
+    }
+    stat->has_io = found == 2;
+    return stat->has_io ? SWK_SUCCESS : SWK_ERROR;
+}
+
+// 读取 dir_fd 下的 <pid>/<name>，返回读到的字节数，失败返回 -1
+static ssize_t proc_scanner_read(int dir_fd, int pid, const char *name, char *buffer, size_t size) {
+    char path[32], digits[12];
+    int length = 0, n = 0;
+
+    for (unsigned int value = (unsigned int)pid; value > 0 || n == 0; value /= 10) {
+        digits[n++] = (char)('0' + value % 10);
+    }
+    while (n > 0) {
+        path[length++] = digits[--n];
+    }
+    path[length++] = '/';
+    memcpy(path + length, name, strlen(name) + 1);
+
+    int fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t result;
+    do {
+        result = read(fd, buffer, size);
+    } while (result < 0 && errno == EINTR);
+    close(fd);
+    return result;
+}
+
+// 读取并解析 <pid>/stat（以及 <pid>/io），进程已经消失时返回错误
+static int proc_scanner_read_stat(int dir_fd, int read_io, ProcStat *stat) {
+    char buffer[PROC_SCANNER_STAT_MAX];
+    ssize_t size = proc_scanner_read(dir_fd, stat->pid, "stat", buffer, sizeof(buffer));
+
+    if (size <= 0 || proc_scanner_parse_stat(buffer, (size_t)size, stat) != SWK_SUCCESS) {
+        return SWK_ERROR;
+    }
+
+    // 没有权限读取 io 时只是没有 I/O 数据
+    stat->has_io = 0;
+    if (read_io) {
+        size = proc_scanner_read(dir_fd, stat->pid, "io", buffer, sizeof(buffer));
+        if (size > 0) {
+            proc_scanner_parse_io(buffer, (size_t)size, stat);
+        }
+    }
+    return SWK_SUCCESS;
+}
+
+static void *proc_scanner_shard_thread(void *arg) {
+    ProcScanShard *shard = arg;
+
+    for (int i = shard->start; i < shard->end; i++) {
+        if (proc_scanner_read_stat(shard->dir_fd, shard->read_io, &shard->procs[i]) != SWK_SUCCESS) {
+            shard->procs[i].pid = 0;
+        }
+    }
+    return NULL;
+}
+
+// 用 getdents64 收集数字目录名
+static int proc_scanner_list(ProcScanner *scanner) {
+    scanner->count = 0;
+    if (lseek(scanner->fd, 0, SEEK_SET) < 0) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    for (;;) {
+        long size = syscall(SYS_getdents64, scanner->fd, scanner->dirents, PROC_SCANNER_DIRENTS);
+        if (size < 0 && errno == EINTR) {
+            continue;
+        }
+        if (size < 0) {
+            return SWK_ERROR_SYSTEM_CALL;
+        }
+        if (size == 0) {
+            return SWK_SUCCESS;
+        }
+
+        for (long offset = 0; offset < size;) {
+            const struct proc_dirent64 *entry = (const struct proc_dirent64 *)(scanner->dirents + offset);
+            const char *name = entry->d_name;
+            int pid = 0;
+
+            offset += entry->d_reclen;
+            if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+                continue;
+            }
+            while (*name >= '0' && *name <= '9') {
+                pid = pid * 10 + (*name++ - '0');
+            }
+            if (*name != '\0' || pid <= 0) {
+                continue;
+            }
+
+            if (scanner->count == scanner->capacity) {
+                int capacity = scanner->capacity ? scanner->capacity * 2 : 1024;
+                ProcStat *procs = realloc(scanner->procs, (size_t)capacity * sizeof(ProcStat));
+                if (!procs) {
+                    return SWK_ERROR_OUT_OF_MEMORY;
+                }
+                scanner->procs = procs;
+                scanner->capacity = capacity;
+            }
+            scanner->procs[scanner->count++].pid = pid;
+        }
+    }
+}
+
+int proc_scanner_scan(ProcScanner *scanner) {
+    if (!scanner || scanner->fd < 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    int result = proc_scanner_list(scanner);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    int threads = scanner->count / PROC_SCANNER_SHARD_MIN;
+    if (threads > scanner->threads) {
+        threads = scanner->threads;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    // 第 0 片在当前线程中解析；未能启动线程的分片最后也在当前线程中完成
+    ProcScanShard shards[PROC_SCANNER_MAX_THREADS];
+    pthread_t tids[PROC_SCANNER_MAX_THREADS];
+    int started[PROC_SCANNER_MAX_THREADS] = {0};
+    for (int i = 0; i < threads; i++) {
+        shards[i].dir_fd = scanner->fd;
+        shards[i].read_io = scanner->read_io;
+        shards[i].procs = scanner->procs;
+        shards[i].start = (int)((int64_t)scanner->count * i / threads);
+        shards[i].end = (int)((int64_t)scanner->count * (i + 1) / threads);
+    }
+    for (int i = 1; i < threads; i++) {
+        started[i] = pthread_create(&tids[i], NULL, proc_scanner_shard_thread, &shards[i]) == 0;
+    }
+    proc_scanner_shard_thread(&shards[0]);
+    for (int i = 1; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(tids[i], NULL);
+        } else {
+            proc_scanner_shard_thread(&shards[i]);
+        }
+    }
+
+    // 剔除解析期间消失的进程并汇总
+    int count = 0;
+    scanner->process_count = 0;
+    scanner->thread_count = 0;
+    scanner->zombie_count = 0;
+    scanner->running_count = 0;
+    for (int i = 0; i < scanner->count; i++) {
+        const ProcStat *stat = &scanner->procs[i];
+        if (stat->pid == 0) {
+            continue;
+        }
+        scanner->thread_count += stat->threads;
+        scanner->zombie_count += stat->state == 'Z';
+        scanner->running_count += stat->state == 'R';
+        if (count != i) {
+            scanner->procs[count] = *stat;
+        }
+        count++;
+    }
+    scanner->count = count;
+    scanner->process_count = count;
+    scanner->scans++;
+    return SWK_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#include <stdlib.h>
+#include <string.h>
+#include "proc_table.h"
+
+static uint32_t proc_table_slot(const ProcTable *table, int pid) {
+    return ((uint32_t)pid * 2654435761u) & table->mask;
+}
+
+int proc_table_init(ProcTable *table, int capacity) {
+    if (!table) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t size = PROC_TABLE_MIN;
+    while (size < (uint32_t)capacity && size < (1u << 30)) {
+        size <<= 1;
+    }
+
+    table->slots = calloc(size, sizeof(ProcEntry));
+    table->mask = size - 1;
+    table->count = 0;
+    return table->slots ? SWK_SUCCESS : SWK_ERROR_OUT_OF_MEMORY;
+}
+
+void proc_table_free(ProcTable *table) {
+    if (!table) return;
+
+    free(table->slots);
+    memset(table, 0, sizeof(ProcTable));
+}
+
+void proc_table_clear(ProcTable *table) {
+    if (table->slots) {
+        memset(table->slots, 0, ((size_t)table->mask + 1) * sizeof(ProcEntry));
+    }
+    table->count = 0;
+}
+
+ProcEntry *proc_table_find(const ProcTable *table, int pid) {
+    if (!table->slots || pid <= 0) {
+        return NULL;
+    }
+
+    for (uint32_t i = proc_table_slot(table, pid);; i = (i + 1) & table->mask) {
+        if (table->slots[i].pid == pid) {
+            return &table->slots[i];
+        }
+        if (table->slots[i].pid == 0) {
+            return NULL;
+        }
+    }
+}
+
+static int proc_table_grow(ProcTable *table) {
+    ProcTable larger;
+
+    if (proc_table_init(&larger, (int)((table->mask + 1) * 2)) != SWK_SUCCESS) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    for (uint32_t i = 0; i <= table->mask; i++) {
+        const ProcEntry *entry = &table->slots[i];
+        if (entry->pid == 0) {
+            continue;
+        }
+        uint32_t j = proc_table_slot(&larger, entry->pid);
+        while (larger.slots[j].pid != 0) {
+            j = (j + 1) & larger.mask;
+        }
+        larger.slots[j] = *entry;
+        larger.count++;
+    }
+
+    free(table->slots);
+    *table = larger;
+    return SWK_SUCCESS;
+}
+
+ProcEntry *proc_table_insert(ProcTable *table, int pid, int *created) {
+    if (created) {
+        *created = 0;
+    }
+    if (!table->slots || pid <= 0) {
+        return NULL;
+    }
+
+    ProcEntry *entry = proc_table_find(table, pid);
+    if (entry) {
+        return entry;
+    }
+    if ((uint64_t)(table->count + 1) * 4 > (uint64_t)(table->mask + 1) * 3 &&
+        proc_table_grow(table) != SWK_SUCCESS) {
+        return NULL;
+    }
+
+    uint32_t i = proc_table_slot(table, pid);
+    while (table->slots[i].pid != 0) {
+        i = (i + 1) & table->mask;
+    }
+    entry = &table->slots[i];
+    memset(entry, 0, sizeof(ProcEntry));
+    entry->pid = pid;
+    table->count++;
+    if (created) {
+        *created = 1;
+    }
+    return entry;
+}
+
+int proc_table_remove(ProcTable *table, int pid) {
+    ProcEntry *entry = proc_table_find(table, pid);
+    if (!entry) {
+        return 0;
+    }
+
+    // 后面探测链上的项如果能放进空出的位置就前移
+    uint32_t hole = (uint32_t)(entry - table->slots);
+    for (uint32_t i = (hole + 1) & table->mask; table->slots[i].pid != 0; i = (i + 1) & table->mask) {
+        uint32_t home = proc_table_slot(table, table->slots[i].pid);
+        if (((i - home) & table->mask) >= ((i - hole) & table->mask)) {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole].pid = 0;
+    table->count--;
+    return 1;
+}
@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "proc_top.h"
+
+int proc_top_init(ProcTop *top) {
+    if (!top) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(top, 0, sizeof(ProcTop));
+    top->ticks = sysconf(_SC_CLK_TCK);
+    top->page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    if (top->ticks <= 0) {
+        top->ticks = 100;
+    }
+    if (top->page_kb <= 0) {
+        top->page_kb = 4;
+    }
+    return proc_table_init(&top->table, 0);
+}
+
+void proc_top_free(ProcTop *top) {
+    if (!top) return;
+
+    proc_table_free(&top->table);
+    free(top->stale);
+    memset(top, 0, sizeof(ProcTop));
+}
+
+static uint64_t proc_top_delta(uint64_t before, uint64_t after) {
+    return after > before ? after - before : 0;
+}
+
+// 删除本次采样中没有出现的进程
+static int proc_top_remove_stale(ProcTop *top) {
+    int count = top->table.count;
+    int stale = 0;
+
+    if (count > top->stale_capacity) {
+        int *array = realloc(top->stale, (size_t)count * sizeof(int));
+        if (!array) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        top->stale = array;
+        top->stale_capacity = count;
+    }
+
+    for (uint32_t i = 0; i <= top->table.mask; i++) {
+        const ProcEntry *entry = &top->table.slots[i];
+        if (entry->pid != 0 && entry->seen != top->samples) {
+            top->stale[stale++] = entry->pid;
+        }
+    }
+    for (int i = 0; i < stale; i++) {
+        proc_table_remove(&top->table, top->stale[i]);
+    }
+    return SWK_SUCCESS;
+}
+
+int proc_top_update(ProcTop *top, const ProcScanner *scanner, double now) {
+    if (!top || !scanner || !top->table.slots) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    top->samples++;
+    top->interval = top->samples > 1 && now > top->last ? now - top->last : 0.0;
+    top->last = now;
+
+    for (int i = 0; i < scanner->count; i++) {
+        const ProcStat *stat = &scanner->procs[i];
+        int created;
+        ProcEntry *entry = proc_table_insert(&top->table, stat->pid, &created);
+        if (!entry) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+
+        // PID 被复用
+        if (!created && entry->start_time != stat->start_time) {
+            memset(entry, 0, sizeof(ProcEntry));
+            entry->pid = stat->pid;
+            created = 1;
+        }
+        // 第一次采样时所有进程都只是基准；之后新出现的进程从 0 开始计算
+        if (created && top->samples == 1) {
+            entry->utime = stat->utime;
+            entry->stime = stat->stime;
+            entry->read_bytes = stat->has_io ? stat->read_bytes : 0;
+            entry->write_bytes = stat->has_io ? stat->write_bytes : 0;
+        }
+
+        entry->cpu = 0.0;
+        entry->read_rate = 0.0;
+        entry->write_rate = 0.0;
+        if (top->interval > 0.0) {
+            uint64_t ticks = proc_top_delta(entry->utime, stat->utime) + proc_top_delta(entry->stime, stat->stime);
+            entry->cpu = (double)ticks * 100.0 / ((double)top->ticks * top->interval);
+            if (stat->has_io) {
+                entry->read_rate = (double)proc_top_delta(entry->read_bytes, stat->read_bytes) / top->interval;
+                entry->write_rate = (double)proc_top_delta(entry->write_bytes, stat->write_bytes) / top->interval;
+            }
+        }
+
+        entry->ppid = stat->ppid;
+        entry->threads = stat->threads;
+        entry->state = stat->state;
+        entry->start_time = stat->start_time;
+        memcpy(entry->comm, stat->comm, sizeof(entry->comm));
+        entry->utime = stat->utime;
+        entry->stime = stat->stime;
+        if (stat->has_io) {
+            entry->read_bytes = stat->read_bytes;
+            entry->write_bytes = stat->write_bytes;
+        }
+        entry->rss_kb = stat->rss * (uint64_t)top->page_kb;
+        entry->seen = top->samples;
+    }
+
+    return proc_top_remove_stale(top);
+}
+
+static double proc_top_key(const ProcEntry *entry, int metric) {
+    switch (metric) {
+        case PROC_TOP_RSS: return (double)entry->rss_kb;
+        case PROC_TOP_IO:  return entry->read_rate + entry->write_rate;
+        default:           return entry->cpu;
+    }
+}
+
+// 最小堆：堆顶是已选出的项中最小的
+static void proc_top_sift_down(const ProcEntry **heap, double *keys, int count, int i) {
+    for (;;) {
+        int smallest = i;
+        int left = 2 * i + 1, right = left + 1;
+
+        if (left < count && keys[left] < keys[smallest]) {
+            smallest = left;
+        }
+        if (right < count && keys[right] < keys[smallest]) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+
+        const ProcEntry *entry = heap[i];
+        double key = keys[i];
+        heap[i] = heap[smallest];
+        keys[i] = keys[smallest];
+        heap[smallest] = entry;
+        keys[smallest] = key;
+        i = smallest;
+    }
+}
+
+int proc_top_select(const ProcTop *top, int metric, const ProcEntry **out, int n) {
+    double keys[PROC_TOP_MAX];
+    int count = 0;
+
+    if (!top || !out || !top->table.slots) {
+        return 0;
+    }
+    if (n > PROC_TOP_MAX) {
+        n = PROC_TOP_MAX;
+    }
+    if (n <= 0) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i <= top->table.mask; i++) {
+        const ProcEntry *entry = &top->table.slots[i];
+        if (entry->pid == 0) {
+            continue;
+        }
+
+        double key = proc_top_key(entry, metric);
+        if (metric == PROC_TOP_IO && key <= 0.0) {
+            continue;
+        }
+        if (count < n) {
+            // 上浮
+            int j = count++;
+            while (j > 0 && keys[(j - 1) / 2] > key) {
+                out[j] = out[(j - 1) / 2];
+                keys[j] = keys[(j - 1) / 2];
+                j = (j - 1) / 2;
+            }
+            out[j] = entry;
+            keys[j] = key;
+        } else if (key > keys[0]) {
+            out[0] = entry;
+            keys[0] = key;
+            proc_top_sift_down(out, keys, count, 0);
+        }
+    }
+
+    // 依次把堆顶移到末尾，得到从大到小的顺序
+    for (int size = count; size > 1; size--) {
+        const ProcEntry *entry = out[0];
+        double key = keys[0];
+        out[0] = out[size - 1];
+        keys[0] = keys[size - 1];
+        out[size - 1] = entry;
+        keys[size - 1] = key;
+        proc_top_sift_down(out, keys, size - 1, 0);
+    }
+    return count;
+}
@@ -2,7 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <sys/sysmacros.h>
 #include <sys/sysinfo.h>
 #include <time.h>
 #include <dirent.h>
@@ -17,10 +19,33 @@ int system_monitor_init(SystemMonitor *sm) {
     }
 
     memset(sm, 0, sizeof(SystemMonitor));
+    sm->cpu.fd = -1;
+    sm->topology.online_fd = -1;
+    sm->procs.fd = -1;
+    sm->events.fd = -1;
+    sm->disk.fd = -1;
 
     // 设置默认配置
     system_monitor_set_default_config(sm);
 
+    if (cpu_sampler_open(&sm->cpu, NULL) != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "CPU usage sampling unavailable");
+    }
+    if (cpu_topology_build(&sm->topology, NULL) != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "CPU topology unavailable");
+    }
+    if (proc_scanner_open(&sm->procs, NULL, sm->topology.online_count) != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Process scanning unavailable");
+    }
+    if (sm->config.enable_process_events && proc_events_open(&sm->events) != SWK_SUCCESS) {
+        SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "Process events unavailable, polling /proc");
+    }
+    if (proc_top_init(&sm->top) != SWK_SUCCESS) {
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Process ranking unavailable");
+    }
+    net_sampler_open(&sm->net, NULL, NULL);
+    disk_sampler_open(&sm->disk, NULL, NULL, NULL);
+
     // 分配历史记录缓冲区
     sm->history_stats = malloc(sizeof(SystemStats) * sm->config.history_size);
     if (!sm->history_stats) {
@@ -31,10 +56,10 @@ int system_monitor_init(SystemMonitor *sm) {
 
     // 采集初始统计信息
     if (system_monitor_update(sm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to collect initial system stats");
+        SWK_LOG_WARN(LOG_SUBSYS_MONITOR, "Failed to collect initial system stats");
     }
 
-    log_message(LOG_DEBUG, "System monitor initialized");
+    SWK_LOG_DEBUG(LOG_SUBSYS_MONITOR, "System monitor initialized");
     return SWK_SUCCESS;
 }
 
@@ -46,6 +71,13 @@ void system_monitor_cleanup(SystemMonitor *sm) {
         free(sm->history_stats);
         sm->history_stats = NULL;
     }
+    cpu_sampler_close(&sm->cpu);
+    cpu_topology_free(&sm->topology);
+    proc_scanner_close(&sm->procs);
+    proc_events_close(&sm->events);
+    proc_top_free(&sm->top);
+    net_sampler_close(&sm->net);
+    disk_sampler_close(&sm->disk);
 
     sm->running = 0;
     sm->history_count = 0;
@@ -63,8 +95,9 @@ void system_monitor_set_default_config(SystemMonitor *sm) {
     sm->config.enable_disk_monitor = 1;
     sm->config.enable_network_monitor = 1;
     sm->config.enable_process_monitor = 1;
+    sm->config.enable_process_events = 1;
     strcpy(sm->config.disk_device, "/");
-    strcpy(sm->config.network_interface, "eth0");
+    sm->config.network_interface[0] = '\0';  // 默认路由所在的接口
 }
 
 // 更新系统统计信息
@@ -81,7 +114,7 @@ int system_monitor_update(SystemMonitor *sm) {
 
     // 采集各种统计信息
     if (sm->config.enable_cpu_monitor) {
-        if (system_monitor_collect_cpu_stats(current) != SWK_SUCCESS) {
+        if (system_monitor_collect_cpu_stats(sm, current) != SWK_SUCCESS) {
             result = SWK_ERROR;
         }
     }
@@ -96,16 +129,19 @@ int system_monitor_update(SystemMonitor *sm) {
         if (system_monitor_collect_disk_stats(current, sm->config.disk_device) != SWK_SUCCESS) {
             result = SWK_ERROR;
         }
+        if (sm->disk.fd >= 0 && system_monitor_collect_disk_io_stats(sm, current) != SWK_SUCCESS) {
+            result = SWK_ERROR;
+        }
     }
 
     if (sm->config.enable_process_monitor) {
-        if (system_monitor_collect_process_stats(current) != SWK_SUCCESS) {
+        if (system_monitor_collect_process_stats(sm, current) != SWK_SUCCESS) {
             result = SWK_ERROR;
         }
     }
 
     if (sm->config.enable_network_monitor) {
-        if (system_monitor_collect_network_stats(current, sm->config.network_interface) != SWK_SUCCESS) {
+        if (system_monitor_collect_network_stats(sm, current) != SWK_SUCCESS) {
             result = SWK_ERROR;
         }
     }
@@ -129,60 +165,33 @@ int system_monitor_update(SystemMonitor *sm) {
     return result;
 }
 
-// 采集CPU统计信息
-int system_monitor_collect_cpu_stats(SystemStats *stats) {
-    if (!stats) {
+// 采集CPU统计信息：使用率取与上一次采样之间的差值
+int system_monitor_collect_cpu_stats(SystemMonitor *sm, SystemStats *stats) {
+    if (!sm || !stats) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    FILE *file = fopen("/proc/stat", "r");
-    if (!file) {
-        return SWK_ERROR_FILE_NOT_FOUND;
-    }
-
-    char line[256];
-    unsigned long user, nice, system, idle, iowait, irq, softirq;
-
-    // 读取第一行（总CPU统计）
-    if (fgets(line, sizeof(line), file)) {
-        sscanf(line, "cpu %lu %lu %lu %lu %lu %lu %lu",
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq);
-
-        unsigned long total = user + nice + system + idle + iowait + irq + softirq;
-        unsigned long active = total - idle;
-
-        if (total > 0) {
-            stats->cpu_usage = (double)active * 100.0 / total;
-        }
+    int result = cpu_sampler_sample(&sm->cpu);
+    if (result != SWK_SUCCESS) {
+        return result;
     }
 
-    fclose(file);
-
-    // 获取CPU核心数
-    file = fopen("/proc/cpuinfo", "r");
-    if (file) {
-        char cpuinfo_line[256];
-        while (fgets(cpuinfo_line, sizeof(cpuinfo_line), file)) {
-            if (strncmp(cpuinfo_line, "cpu cores", 9) == 0) {
-                sscanf(cpuinfo_line, "cpu cores : %d", &stats->cpu_cores);
-                break;
-            }
-        }
-        fclose(file);
-    }
+    const CpuUsage *total = &sm->cpu.total;
+    stats->cpu_usage = total->usage;
+    stats->cpu_user = total->user;
+    stats->cpu_system = total->system;
+    stats->cpu_iowait = total->iowait;
+    stats->cpu_irq = total->irq;
+    stats->cpu_steal = total->steal;
+    stats->cpu_guest = total->guest;
+    stats->cpu_online = sm->cpu.online_count;
 
-    // 尝试读取CPU频率（如果可用）
-    file = fopen("/proc/cpuinfo", "r");
-    if (file) {
-        char cpuinfo_line[256];
-        while (fgets(cpuinfo_line, sizeof(cpuinfo_line), file)) {
-            if (strncmp(cpuinfo_line, "cpu MHz", 7) == 0) {
-                sscanf(cpuinfo_line, "cpu MHz : %lf", &stats->cpu_frequency);
-                break;
-            }
-        }
-        fclose(file);
-    }
+    // 拓扑只在在线 CPU 变化时重建，频率通过保持打开的 cpufreq 文件读取
+    cpu_topology_check(&sm->topology);
+    stats->cpu_cores = sm->topology.core_count;
+    stats->cpu_sockets = sm->topology.package_count;
+    stats->numa_nodes = sm->topology.node_count;
+    stats->cpu_frequency = cpu_topology_update_frequency(&sm->topology);
 
     return SWK_SUCCESS;
 }
@@ -246,103 +255,179 @@ int system_monitor_collect_disk_stats(SystemStats *stats, const char *device) {
 }
 
 // 采集进程统计信息
-int system_monitor_collect_process_stats(SystemStats *stats) {
-    if (!stats) {
+int system_monitor_collect_process_stats(SystemMonitor *sm, SystemStats *stats) {
+    if (!sm || !stats) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    DIR *dir = opendir("/proc");
-    if (!dir) {
-        return SWK_ERROR_FILE_NOT_FOUND;
-    }
-
-    struct dirent *entry;
-    int process_count = 0;
-    int thread_count = 0;
-    int zombie_count = 0;
-
-    while ((entry = readdir(dir)) != NULL) {
-        // 检查是否为进程目录（数字目录名）
-        if (isdigit(entry->d_name[0])) {
-            process_count++;
-
-            // 读取进程状态
-            char stat_path[256];
-            snprintf(stat_path, sizeof(stat_path), "/proc/%s/stat", entry->d_name);
-
-            FILE *stat_file = fopen(stat_path, "r");
-            if (stat_file) {
-                char stat_line[1024];
-                if (fgets(stat_line, sizeof(stat_line), stat_file)) {
-                    // 解析进程状态
-                    char state;
-                    int threads;
-                    sscanf(stat_line, "%*d %*s %c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %d",
-                           &state, &threads);
-
-                    thread_count += threads;
-
-                    if (state == 'Z') {
-                        zombie_count++;
-                    }
-                }
-                fclose(stat_file);
-            }
+    // 订阅了进程事件时由事件维护进程表，否则每次完整扫描
+    if (sm->events.fd >= 0) {
+        int result = proc_events_poll(&sm->events, &sm->procs);
+        if (result != SWK_SUCCESS) {
+            return result;
         }
+
+        stats->process_count = sm->events.process_count;
+        stats->thread_count = sm->events.thread_count;
+        stats->zombie_processes = sm->events.zombie_count;
+        stats->process_forks = (int)(sm->events.forks - sm->reported_forks);
+        stats->process_exits = (int)(sm->events.exits - sm->reported_exits);
+        sm->reported_forks = sm->events.forks;
+        sm->reported_exits = sm->events.exits;
+        return SWK_SUCCESS;
     }
 
-    closedir(dir);
+    int result = proc_scanner_scan(&sm->procs);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
 
-    stats->process_count = process_count;
-    stats->thread_count = thread_count;
-    stats->zombie_processes = zombie_count;
+    stats->process_count = sm->procs.process_count;
+    stats->thread_count = sm->procs.thread_count;
+    stats->zombie_processes = sm->procs.zombie_count;
 
     return SWK_SUCCESS;
 }
 
-// 采集网络统计信息
-int system_monitor_collect_network_stats(SystemStats *stats, const char *interface) {
-    if (!stats || !interface) {
+static double system_monitor_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+// 扫描一次（同时读取 /proc/<pid>/io）并并入排行
+static int system_monitor_sample_top(SystemMonitor *sm) {
+    sm->procs.read_io = 1;
+    int result = proc_scanner_scan(&sm->procs);
+    sm->procs.read_io = 0;
+
+    return result == SWK_SUCCESS ? proc_top_update(&sm->top, &sm->procs, system_monitor_now()) : result;
+}
+
+int system_monitor_collect_top(SystemMonitor *sm) {
+    if (!sm || !sm->top.table.slots) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    // 差值跨度太长时就不是“当前”的排行了，重新建立基准
+    if (sm->top.samples == 0 || system_monitor_now() - sm->top.last > PROC_TOP_MAX_AGE) {
+        proc_top_free(&sm->top);
+        int result = proc_top_init(&sm->top);
+        if (result == SWK_SUCCESS) {
+            result = system_monitor_sample_top(sm);
+        }
+        if (result != SWK_SUCCESS) {
+            return result;
+        }
+        struct timespec delay = {0, PROC_TOP_INTERVAL_MS * 1000000L};
+        nanosleep(&delay, NULL);
+    }
+    return system_monitor_sample_top(sm);
+}
+
+// 采集网络统计信息：所有接口的速率取与上一次采样之间的差值
+int system_monitor_collect_network_stats(SystemMonitor *sm, SystemStats *stats) {
+    if (!sm || !stats) {
         return SWK_ERROR_INVALID_PARAM;
     }
 
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/net/dev");
+    int result = net_sampler_sample(&sm->net, system_monitor_now());
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
 
-    FILE *file = fopen(path, "r");
-    if (!file) {
-        return SWK_ERROR_FILE_NOT_FOUND;
+    const NetInterface *iface = sm->config.network_interface[0] ?
+                                net_sampler_find(&sm->net, sm->config.network_interface) : NULL;
+    if (!iface) {
+        iface = net_sampler_primary(&sm->net);
+    }
+
+    stats->network_total_rx_rate = 0.0;
+    stats->network_total_tx_rate = 0.0;
+    for (int i = 0; i < sm->net.count; i++) {
+        if (!sm->net.interfaces[i].loopback) {
+            stats->network_total_rx_rate += sm->net.interfaces[i].rates[NET_RX_BYTES] / 1024.0;
+            stats->network_total_tx_rate += sm->net.interfaces[i].rates[NET_TX_BYTES] / 1024.0;
+        }
     }
 
-    char line[256];
-    unsigned long rx_bytes = 0, tx_bytes = 0;
+    if (!iface) {
+        stats->network_interface[0] = '\0';
+        return SWK_SUCCESS;
+    }
+    snprintf(stats->network_interface, sizeof(stats->network_interface), "%s", iface->name);
+    stats->network_rx_bytes = (unsigned long)iface->counters[NET_RX_BYTES];
+    stats->network_tx_bytes = (unsigned long)iface->counters[NET_TX_BYTES];
+    stats->network_rx_rate = iface->rates[NET_RX_BYTES] / 1024.0;
+    stats->network_tx_rate = iface->rates[NET_TX_BYTES] / 1024.0;
+    stats->network_rx_packets = iface->rates[NET_RX_PACKETS];
+    stats->network_tx_packets = iface->rates[NET_TX_PACKETS];
+    stats->network_drops = iface->rates[NET_RX_DROPPED] + iface->rates[NET_TX_DROPPED];
+    stats->network_errors = iface->rates[NET_RX_ERRORS] + iface->rates[NET_TX_ERRORS];
 
-    // 跳过标题行
-    fgets(line, sizeof(line), file);
+    return SWK_SUCCESS;
+}
 
-    while (fgets(line, sizeof(line), file)) {
-        char iface[32];
-        unsigned long rx_packets, rx_errors, rx_drop, rx_fifo, rx_frame;
-        unsigned long tx_packets, tx_errors, tx_drop, tx_fifo, tx_colls, tx_carrier;
+static void system_monitor_copy_disk_io(DiskIoStats *io, const DiskSampler *sampler, const DiskDevice *device) {
+    snprintf(io->name, sizeof(io->name), "%s", device->name);
+    snprintf(io->mount, sizeof(io->mount), "%s", disk_sampler_mount(sampler, device));
+    io->read_iops = device->rates.read_iops;
+    io->write_iops = device->rates.write_iops;
+    io->read_rate = device->rates.read_rate / 1024.0;
+    io->write_rate = device->rates.write_rate / 1024.0;
+    io->latency = device->rates.latency;
+    io->utilization = device->rates.utilization;
+    io->queue_depth = device->rates.queue_depth;
+}
 
-        // 解析网络接口统计
-        if (sscanf(line, "%31s %lu %lu %lu %lu %lu %lu %*u %*u %lu %lu %lu %lu %lu %lu %lu",
-                   iface, &rx_bytes, &rx_packets, &rx_errors, &rx_drop, &rx_fifo, &rx_frame,
-                   &tx_bytes, &tx_packets, &tx_errors, &tx_drop, &tx_fifo, &tx_colls, &tx_carrier) == 14) {
+// 采集块设备 I/O：速率取与上一次采样之间的差值，随统计信息一起进入历史记录
+int system_monitor_collect_disk_io_stats(SystemMonitor *sm, SystemStats *stats) {
+    if (!sm || !stats) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
 
-            // 移除接口名后的冒号
-            char *colon = strchr(iface, ':');
-            if (colon) *colon = '\0';
+    int result = disk_sampler_sample(&sm->disk, system_monitor_now());
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
 
-            if (strcmp(iface, interface) == 0) {
-                stats->network_rx_bytes = rx_bytes;
-                stats->network_tx_bytes = tx_bytes;
-                break;
-            }
+    stats->disk_io_count = 0;
+    const DiskDevice *first = NULL;
+    for (int i = 0; i < sm->disk.count && stats->disk_io_count < SYSTEM_MONITOR_MAX_DISKS; i++) {
+        const DiskDevice *device = &sm->disk.devices[i];
+        if (device->partition || device->counters.reads + device->counters.writes == 0) {
+            continue;
+        }
+        if (!first) {
+            first = device;
         }
+        system_monitor_copy_disk_io(&stats->disk_io[stats->disk_io_count++], &sm->disk, device);
     }
 
-    fclose(file);
+    // 挂载点所在的设备（分区或整个磁盘）；overlay 等没有块设备时退回第一个磁盘
+    const DiskDevice *device = NULL;
+    struct stat st;
+    if (stat(sm->config.disk_device, &st) == 0) {
+        device = disk_sampler_find_dev(&sm->disk, major(st.st_dev), minor(st.st_dev));
+    }
+    if (!device) {
+        device = first;
+    }
+    if (!device) {
+        stats->disk_device_name[0] = '\0';
+        return SWK_SUCCESS;
+    }
+
+    snprintf(stats->disk_device_name, sizeof(stats->disk_device_name), "%s", device->name);
+    stats->disk_read_iops = device->rates.read_iops;
+    stats->disk_write_iops = device->rates.write_iops;
+    stats->disk_read_rate = device->rates.read_rate / 1024.0;
+    stats->disk_write_rate = device->rates.write_rate / 1024.0;
+    stats->disk_read_latency = device->rates.read_latency;
+    stats->disk_write_latency = device->rates.write_latency;
+    stats->disk_utilization = device->rates.utilization;
+    stats->disk_queue_depth = device->rates.queue_depth;
+
     return SWK_SUCCESS;
 }
 
@@ -393,8 +478,13 @@ void system_monitor_print_stats(SystemStats *stats) {
            stats->swap_used, stats->swap_total, stats->swap_usage_percent);
     printf("磁盘使用: %lu/%lu KB (%.1f%%) [%s]\n",
            stats->disk_used, stats->disk_total, stats->disk_usage_percent, stats->disk_mount_point);
-    printf("网络流量: RX=%lu bytes, TX=%lu bytes\n",
-           stats->network_rx_bytes, stats->network_tx_bytes);
+    printf("磁盘I/O [%s]: 读 %.0f IOPS %.1f KB/s, 写 %.0f IOPS %.1f KB/s, 延迟 %.2f/%.2f ms, 利用率 %.1f%%, 队列 %.2f\n",
+           stats->disk_device_name, stats->disk_read_iops, stats->disk_read_rate,
+           stats->disk_write_iops, stats->disk_write_rate, stats->disk_read_latency, stats->disk_write_latency,
+           stats->disk_utilization, stats->disk_queue_depth);
+    printf("网络流量 [%s]: RX=%lu bytes (%.1f KB/s), TX=%lu bytes (%.1f KB/s)\n",
+           stats->network_interface, stats->network_rx_bytes, stats->network_rx_rate,
+           stats->network_tx_bytes, stats->network_tx_rate);
     printf("进程统计: %d 进程, %d 线程, %d 僵尸进程\n",
            stats->process_count, stats->thread_count, stats->zombie_processes);
     printf("系统负载: %.2f, %.2f, %.2f\n",
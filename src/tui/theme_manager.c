@@ -22,22 +22,22 @@ int theme_manager_init(ThemeManager *tm, const char *theme_dir) {
     struct stat st = {0};
     if (stat(theme_dir, &st) == -1) {
         if (mkdir(theme_dir, 0755) != 0) {
-            log_message(LOG_ERROR, "Failed to create theme directory: %s", theme_dir);
+            SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to create theme directory: %s", theme_dir);
             return SWK_ERROR_SYSTEM_CALL;
         }
     }
 
     // 创建内置主题
     if (theme_manager_create_builtin_themes(tm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to create builtin themes");
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Failed to create builtin themes");
     }
 
     // 加载用户主题
     if (theme_manager_load_themes(tm) != SWK_SUCCESS) {
-        log_message(LOG_WARNING, "Failed to load user themes");
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Failed to load user themes");
     }
 
-    log_message(LOG_DEBUG, "Theme manager initialized with %d themes", tm->theme_count);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Theme manager initialized with %d themes", tm->theme_count);
     return SWK_SUCCESS;
 }
 
@@ -123,7 +123,7 @@ int theme_manager_create_builtin_themes(ThemeManager *tm) {
     tm->themes = dark_theme;
     tm->theme_count++;
 
-    log_message(LOG_DEBUG, "Created %d builtin themes", 2);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Created %d builtin themes", 2);
     return SWK_SUCCESS;
 }
 
@@ -138,7 +138,7 @@ int theme_manager_load_themes(ThemeManager *tm) {
 
     dir = opendir(tm->theme_dir);
     if (!dir) {
-        log_message(LOG_WARNING, "Cannot open theme directory: %s", tm->theme_dir);
+        SWK_LOG_WARN(LOG_SUBSYS_TUI, "Cannot open theme directory: %s", tm->theme_dir);
         return SWK_ERROR_FILE_NOT_FOUND;
     }
 
@@ -161,7 +161,7 @@ int theme_manager_load_themes(ThemeManager *tm) {
     }
 
     closedir(dir);
-    log_message(LOG_DEBUG, "Loaded %d user themes", tm->theme_count - 2);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded %d user themes", tm->theme_count - 2);
     return SWK_SUCCESS;
 }
 
@@ -181,7 +181,7 @@ int theme_manager_apply_theme(ThemeManager *tm, const char *theme_name) {
                 theme_manager_apply_to_ui(tm);
             }
 
-            log_message(LOG_INFO, "Applied theme: %s", theme_name);
+            SWK_LOG_INFO(LOG_SUBSYS_TUI, "Applied theme: %s", theme_name);
             return SWK_SUCCESS;
         }
         theme = theme->next;
@@ -247,7 +247,7 @@ int theme_manager_apply_to_ui(ThemeManager *tm) {
     // 这里可以实现将主题应用到dialog库的逻辑
     // 由于dialog库的限制，我们主要通过颜色代码来实现主题效果
 
-    log_message(LOG_DEBUG, "Applied theme '%s' to UI", tm->current_theme->name);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Applied theme '%s' to UI", tm->current_theme->name);
     return SWK_SUCCESS;
 }
 
@@ -416,7 +416,7 @@ int theme_manager_load_from_file(ThemeManager *tm, const char *file_path, ThemeI
     fclose(file);
     *theme = new_theme;
 
-    log_message(LOG_DEBUG, "Loaded theme from file: %s", file_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Loaded theme from file: %s", file_path);
     return SWK_SUCCESS;
 }
 
@@ -452,6 +452,6 @@ int theme_manager_save_to_file(ThemeManager *tm, ThemeInfo *theme, const char *f
     fclose(file);
     theme->modified_time = time(NULL);
 
-    log_message(LOG_DEBUG, "Saved theme to file: %s", file_path);
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Saved theme to file: %s", file_path);
     return SWK_SUCCESS;
 }
\ No newline at end of file
@@ -18,7 +18,7 @@ void keyboard_handler(KeyBinding key, void* user_data) {
             break;
         case KEY_REFRESH:
             // 刷新当前视图
-            log_message(LOG_DEBUG, "Refresh requested");
+            SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Refresh requested");
             break;
         case KEY_SEARCH:
             show_search_dialog();
@@ -48,7 +48,7 @@ void keyboard_handler(KeyBinding key, void* user_data) {
             // 处理ESC键 - 返回上一级菜单
             break;
         default:
-            log_message(LOG_DEBUG, "Unhandled key: %d", key);
+            SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "Unhandled key: %d", key);
             break;
     }
 }
@@ -75,12 +75,12 @@ int tui_init(void) {
 
     // 初始化键盘处理器
     if (init_keyboard_handler() != 0) {
-        log_message(LOG_ERROR, "Failed to initialize keyboard handler");
+        SWK_LOG_ERROR(LOG_SUBSYS_TUI, "Failed to initialize keyboard handler");
         return -1;
     }
 
     dialog_initialized = 1;
-    log_message(LOG_DEBUG, "TUI system initialized");
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "TUI system initialized");
     return 0;
 }
 
@@ -96,7 +96,7 @@ void tui_cleanup(void) {
         endwin();
 
         dialog_initialized = 0;
-        log_message(LOG_DEBUG, "TUI system cleaned up");
+        SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "TUI system cleaned up");
     }
 }
 
@@ -1,11 +1,14 @@
 #include <dialog.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include "tui.h"
 #include "logger.h"
 #include "kernel_manager.h"
 #include "keyboard.h"
 #include "log_viewer.h"
+#include "log_timeline.h"
+#include "config_parser.h"
 #include "config_manager.h"
 #include "plugin_system.h"
 #include "system_monitor.h"
@@ -134,7 +137,7 @@ void install_from_source_dialog(void) {
             source_path, kernel_name);
     
     if (dialog_yesno("Confirm Installation", confirm_msg, 12, 65) == 0) {
-        log_message(LOG_INFO, "Starting kernel installation: %s from %s", 
+        SWK_LOG_INFO(LOG_SUBSYS_TUI, "Starting kernel installation: %s from %s", 
                 kernel_name, source_path);
         
         // 执行安装
@@ -200,7 +203,7 @@ void show_search_dialog(void) {
 
     if (dialog_inputbox("搜索", "请输入搜索关键词:", 10, 50, "", search_term, sizeof(search_term)) == 0) {
         if (strlen(search_term) > 0) {
-            log_message(LOG_INFO, "Searching for: %s", search_term);
+            SWK_LOG_INFO(LOG_SUBSYS_TUI, "Searching for: %s", search_term);
             // 这里可以实现搜索逻辑
             dialog_msgbox("搜索结果", "搜索功能开发中...", 8, 50);
         }
@@ -500,13 +503,28 @@ void show_rename_dialog(const char *old_name, char *new_name, size_t size) {
     dialog_inputbox("重命名", "输入新名称:", 10, 50, old_name, new_name, size);
 }
 
+// 首次为大日志建立行索引时显示进度
+static void log_viewer_index_progress(uint64_t done, uint64_t total, void *context) {
+    int *last_percent = context;
+    int percent = total > 0 ? (int)(done * 100 / total) : 100;
+
+    if (percent != *last_percent) {
+        *last_percent = percent;
+        show_status_indicator("建立日志索引", percent);
+    }
+}
+
 // 日志查看器对话框
 void show_log_viewer_dialog(void) {
     static LogViewer lv;
     static int initialized = 0;
+    static int index_percent = -1;
 
     if (!initialized) {
-        if (log_viewer_init(&lv, "/var/log/swikernel.log") != SWK_SUCCESS) {
+        // 日志文件不可读时退回到内存环中的最近日志
+        if (log_viewer_open(&lv, "/var/log/swikernel.log", log_viewer_index_progress,
+                            &index_percent) != SWK_SUCCESS &&
+            log_viewer_open_memory(&lv) != SWK_SUCCESS) {
             dialog_msgbox("错误", "无法初始化日志查看器", 8, 50);
             return;
         }
@@ -523,31 +541,29 @@ void show_log_viewer_dialog(void) {
         char display_text[MAX_BUFFER_SIZE] = {0};
         snprintf(display_text, sizeof(display_text),
                 "日志查看器 - %s\n"
-                "总条目: %d | 当前: %d\n"
+                "总条目: %d | 过滤后: %d | 当前: %d\n"
                 "级别过滤: %s | 模式过滤: %s\n\n",
                 lv.log_file_path,
                 lv.total_entries,
+                log_viewer_get_filtered_entries(&lv),
                 lv.current_position + 1,
                 level_to_string(lv.min_level),
                 strlen(lv.filter_pattern) > 0 ? lv.filter_pattern : "无");
 
-        // 显示当前条目及其周围的条目
-        LogEntry *start_entry = lv.current_entry;
-        int count = 0;
-
-        // 向上查找起始条目
-        while (start_entry && start_entry->prev && count < lv.visible_entries / 2) {
-            start_entry = start_entry->prev;
-            count++;
+        // 显示当前条目及其周围的条目（只解析屏幕上的这几行）
+        int first = lv.current_position - lv.visible_entries / 2;
+        if (first < 0) {
+            first = 0;
         }
 
-        // 显示条目
-        LogEntry *current = start_entry;
-        count = 0;
         char entry_line[1152];
 
-        while (current && count < lv.visible_entries) {
-            char marker = (current == lv.current_entry) ? '>' : ' ';
+        for (int i = first; i < first + lv.visible_entries; i++) {
+            LogEntry *current = log_viewer_get_view_entry(&lv, i);
+            if (!current) {
+                break;
+            }
+            char marker = (i == lv.current_position) ? '>' : ' ';
 
             if (lv.show_timestamp) {
                 snprintf(entry_line, sizeof(entry_line), "%c[%s] [%s] %s\n",
@@ -563,8 +579,6 @@ void show_log_viewer_dialog(void) {
             }
 
             strncat(display_text, entry_line, sizeof(display_text) - strlen(display_text) - 1);
-            current = current->next;
-            count++;
         }
 
         snprintf(display_text + strlen(display_text), sizeof(display_text) - strlen(display_text),
@@ -572,7 +586,7 @@ void show_log_viewer_dialog(void) {
 
         int choice = dialog_menu("日志查看器",
                                display_text,
-                               25, 100, 8,
+                               25, 100, 11,
                                "1", "向上滚动",
                                "2", "向下滚动",
                                "3", "翻页向上",
@@ -580,7 +594,10 @@ void show_log_viewer_dialog(void) {
                                "5", "跳到顶部",
                                "6", "跳到底部",
                                "7", "搜索",
-                               "8", "过滤器设置");
+                               "8", "过滤器设置",
+                               "9", "日志级别",
+                               "10", "历史时间线",
+                               "11", "跳到时间");
 
         switch (choice) {
             case 1:
@@ -607,6 +624,25 @@ void show_log_viewer_dialog(void) {
             case 8:
                 show_log_filter_dialog(&lv);
                 break;
+            case 9:
+                show_log_level_dialog();
+                break;
+            case 10:
+                show_log_timeline_dialog(lv.log_file_path);
+                break;
+            case 11: {
+                char stamp[64] = {0};
+                if (dialog_inputbox("跳到时间", "输入时间（YYYY-MM-DD HH:MM:SS，可只写前缀）:", 10, 60,
+                                   "", stamp, sizeof(stamp)) == 0 && strlen(stamp) > 0) {
+                    int64_t ms = log_time_parse_input(stamp);
+                    if (ms < 0) {
+                        dialog_msgbox("错误", "无法识别的时间", 8, 50);
+                    } else {
+                        log_viewer_jump_to_time(&lv, ms);
+                    }
+                }
+                break;
+            }
             case -1:
                 return;
             default:
@@ -615,6 +651,61 @@ void show_log_viewer_dialog(void) {
     }
 }
 
+// 显示日志级别对话框：按子系统调整运行时级别，立即生效
+void show_log_level_dialog(void) {
+    char items[LOG_SUBSYS_COUNT][64];
+
+    while (1) {
+        for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+            int level = logger_get_subsystem_level((LogSubsystem)i);
+            snprintf(items[i], sizeof(items[i]), "%-8s %s", logger_subsystem_name((LogSubsystem)i),
+                     level >= 0 ? logger_level_name((LogLevel)level) : "(跟随全局)");
+        }
+
+        char prompt[128];
+        snprintf(prompt, sizeof(prompt), "全局级别: %s\n选择要调整的子系统:",
+                 logger_level_name(logger_get_level()));
+
+        int choice = dialog_menu("日志级别",
+                                 prompt,
+                                 16, 60, 7,
+                                 "1", items[LOG_SUBSYS_CORE],
+                                 "2", items[LOG_SUBSYS_KERNEL],
+                                 "3", items[LOG_SUBSYS_TUI],
+                                 "4", items[LOG_SUBSYS_MONITOR],
+                                 "5", items[LOG_SUBSYS_PLUGINS],
+                                 "6", items[LOG_SUBSYS_I18N],
+                                 "7", "从配置文件重新加载");
+
+        if (choice == 7) {
+            SwikernelConfig config;
+            if (load_config(&config) == 0) {
+                apply_log_levels(&config);
+                dialog_msgbox("完成", "已按配置文件更新日志级别", 8, 50);
+            } else {
+                dialog_msgbox("错误", "未找到配置文件", 8, 50);
+            }
+            continue;
+        }
+        if (choice < 1 || choice > LOG_SUBSYS_COUNT) {
+            return;
+        }
+
+        int level_choice = dialog_menu("选择级别",
+                                       logger_subsystem_name((LogSubsystem)(choice - 1)),
+                                       12, 40, 6,
+                                       "1", "跟随全局",
+                                       "2", "DEBUG",
+                                       "3", "INFO",
+                                       "4", "WARNING",
+                                       "5", "ERROR",
+                                       "6", "FATAL");
+        if (level_choice > 0) {
+            logger_set_subsystem_level((LogSubsystem)(choice - 1), level_choice - 2);
+        }
+    }
+}
+
 // 显示日志过滤器对话框
 void show_log_filter_dialog(LogViewer *lv) {
     if (!lv) return;
@@ -629,11 +720,12 @@ void show_log_filter_dialog(LogViewer *lv) {
 
     int choice = dialog_menu("日志过滤器设置",
                            "选择过滤器类型:",
-                           12, 60, 4,
+                           13, 60, 5,
                            "1", "级别过滤",
                            "2", "模式过滤",
                            "3", "来源过滤",
-                           "4", "清除所有过滤器");
+                           "4", "时间范围",
+                           "5", "清除所有过滤器");
 
     switch (choice) {
         case 1: {
@@ -664,7 +756,30 @@ void show_log_filter_dialog(LogViewer *lv) {
                 log_viewer_set_source_filter(lv, source_filter);
             }
             break;
-        case 4:
+        case 4: {
+            char from[64] = {0}, to[64] = {0};
+            if (lv->time_from >= 0) {
+                log_time_format(lv->time_from, from, sizeof(from));
+            }
+            if (lv->time_to >= 0) {
+                log_time_format(lv->time_to, to, sizeof(to));
+            }
+            // 留空表示该端不限
+            if (dialog_inputbox("时间范围", "起始时间（YYYY-MM-DD HH:MM:SS，留空不限）:", 10, 60,
+                               from, from, sizeof(from)) == 0 &&
+                dialog_inputbox("时间范围", "结束时间（YYYY-MM-DD HH:MM:SS，留空不限）:", 10, 60,
+                               to, to, sizeof(to)) == 0) {
+                int64_t from_ms = strlen(from) > 0 ? log_time_parse_input(from) : -1;
+                int64_t to_ms = strlen(to) > 0 ? log_time_parse_input(to) : -1;
+                if ((strlen(from) > 0 && from_ms < 0) || (strlen(to) > 0 && to_ms < 0)) {
+                    dialog_msgbox("错误", "无法识别的时间", 8, 50);
+                } else {
+                    log_viewer_set_time_filter(lv, from_ms, to_ms);
+                }
+            }
+            break;
+        }
+        case 5:
             log_viewer_clear_filters(lv);
             dialog_msgbox("完成", "所有过滤器已清除", 8, 50);
             break;
@@ -689,21 +804,190 @@ void show_log_search_dialog(LogViewer *lv) {
     }
 }
 
-// 显示日志统计对话框
+// 显示历史时间线：当前日志与全部轮转段（含压缩归档）按时间合并浏览
+void show_log_timeline_dialog(const char *log_path) {
+    if (!log_path) return;
+
+    LogTimeline tl;
+    if (log_timeline_open(&tl, log_path) != SWK_SUCCESS) {
+        dialog_msgbox("错误", "无法打开日志及其轮转段", 8, 50);
+        return;
+    }
+
+    const int visible = 15;
+    LogTimelinePosition *top = malloc(sizeof(LogTimelinePosition));
+    LogTimelineEntry *entry = malloc(sizeof(LogTimelineEntry));
+    if (!top || !entry) {
+        free(top);
+        free(entry);
+        log_timeline_close(&tl);
+        return;
+    }
+    log_timeline_tell(&tl, top);
+
+    while (1) {
+        char display_text[MAX_BUFFER_SIZE * 2] = {0};
+        char line[256];
+
+        snprintf(display_text, sizeof(display_text), "历史时间线 - %s（%d 个段）\n\n",
+                 log_path, tl.source_count);
+
+        // 每次从屏幕顶部的位置向后读取一屏
+        log_timeline_restore(&tl, top);
+        for (int i = 0; i < visible && log_timeline_next(&tl, entry); i++) {
+            const char *segment = log_timeline_source_path(&tl, entry->source);
+            const char *name = strrchr(segment, '/');
+            snprintf(line, sizeof(line), "%-22.22s %.200s\n", name ? name + 1 : segment, entry->line);
+            strncat(display_text, line, sizeof(display_text) - strlen(display_text) - 1);
+        }
+
+        int choice = dialog_menu("历史时间线",
+                               display_text,
+                               25, 120, 7,
+                               "1", "向上滚动",
+                               "2", "向下滚动",
+                               "3", "翻页向上",
+                               "4", "翻页向下",
+                               "5", "跳到最早",
+                               "6", "跳到最新",
+                               "7", "跳到时间");
+
+        log_timeline_restore(&tl, top);
+        switch (choice) {
+            case 1:
+                log_timeline_prev(&tl, NULL);
+                break;
+            case 2:
+                log_timeline_next(&tl, NULL);
+                break;
+            case 3:
+                for (int i = 0; i < visible; i++) {
+                    if (!log_timeline_prev(&tl, NULL)) break;
+                }
+                break;
+            case 4:
+                for (int i = 0; i < visible; i++) {
+                    if (!log_timeline_next(&tl, NULL)) break;
+                }
+                break;
+            case 5:
+                log_timeline_seek_start(&tl);
+                break;
+            case 6:
+                log_timeline_seek_end(&tl);
+                for (int i = 0; i < visible; i++) {
+                    if (!log_timeline_prev(&tl, NULL)) break;
+                }
+                break;
+            case 7: {
+                char stamp[64] = {0};
+                if (dialog_inputbox("跳到时间", "输入时间（YYYY-MM-DD HH:MM:SS，可只写前缀）:", 10, 60,
+                                   "", stamp, sizeof(stamp)) == 0 && strlen(stamp) > 0) {
+                    log_timeline_seek_time(&tl, stamp);
+                }
+                break;
+            }
+            case -1:
+                free(top);
+                free(entry);
+                log_timeline_close(&tl);
+                return;
+            default:
+                break;
+        }
+        log_timeline_tell(&tl, top);
+    }
+}
+
+static int compare_log_sources(const void *a, const void *b) {
+    const LogStatsSource *x = a;
+    const LogStatsSource *y = b;
+    return x->count > y->count ? -1 : x->count < y->count;
+}
+
+// 分钟数（日志中的本地时间）格式化为 "YYYY-MM-DD HH:MM"
+static void format_log_minute(int64_t minute, char *buf, size_t size) {
+    time_t seconds = (time_t)(minute * 60);
+    struct tm tm_info;
+
+    if (minute < 0 || !gmtime_r(&seconds, &tm_info)) {
+        snprintf(buf, size, "-");
+        return;
+    }
+    strftime(buf, size, "%Y-%m-%d %H:%M", &tm_info);
+}
+
+// 显示日志统计对话框：只读取查看器增量维护的统计，与日志大小无关
 void show_log_statistics_dialog(LogViewer *lv) {
     if (!lv) return;
 
-    char stats_text[MAX_BUFFER_SIZE] = {0};
+    const LogStats *stats = log_viewer_get_stats(lv);
+    LoggerStats logger_stats;
+    logger_get_stats(&logger_stats);
+
+    char first[32], last[32], sparkline[LOG_STATS_HOURS * 3 + 1];
+    format_log_minute(stats->first_minute, first, sizeof(first));
+    format_log_minute(stats->last_minute, last, sizeof(last));
+    log_stats_error_sparkline(stats, 24, sparkline, sizeof(sparkline));
+
+    const LogStatsBucket *minute = log_stats_minute(stats, stats->last_minute);
+    const LogStatsBucket *hour = log_stats_hour(stats, stats->last_minute / 60);
+    const LogStatsBucket *day = log_stats_day(stats, stats->last_minute / 1440);
+
+    char stats_text[MAX_BUFFER_SIZE * 2] = {0};
+    char line[512];
     snprintf(stats_text, sizeof(stats_text),
             "日志统计信息\n"
             "==============\n\n"
             "总条目数: %d\n"
-            "DEBUG级别: %d\n"
-            "INFO级别: %d\n"
-            "WARNING级别: %d\n"
-            "ERROR级别: %d\n"
-            "FATAL级别: %d\n\n"
-            "当前过滤器:\n"
+            "过滤后条目数: %d\n"
+            "DEBUG级别: %llu\n"
+            "INFO级别: %llu\n"
+            "WARNING级别: %llu\n"
+            "ERROR级别: %llu\n"
+            "FATAL级别: %llu\n\n"
+            "时间范围: %s ~ %s\n"
+            "最后一分钟/小时/天: %u / %u / %u 条（错误 %u / %u / %u）\n"
+            "每小时错误率（最近 24 小时）:\n[%s]\n\n",
+            lv->total_entries,
+            log_viewer_get_filtered_entries(lv),
+            (unsigned long long)stats->level_counts[LOG_DEBUG],
+            (unsigned long long)stats->level_counts[LOG_INFO],
+            (unsigned long long)stats->level_counts[LOG_WARNING],
+            (unsigned long long)stats->level_counts[LOG_ERROR],
+            (unsigned long long)stats->level_counts[LOG_FATAL],
+            first, last,
+            minute ? minute->total : 0, hour ? hour->total : 0, day ? day->total : 0,
+            minute ? minute->errors : 0, hour ? hour->errors : 0, day ? day->errors : 0,
+            sparkline);
+
+    // 条目最多的来源
+    LogStatsSource sources[LOG_STATS_SOURCES + 1];
+    int source_count = stats->source_count;
+    memcpy(sources, stats->sources, (size_t)source_count * sizeof(LogStatsSource));
+    if (stats->sources[LOG_STATS_SOURCES].count > 0) {
+        sources[source_count++] = stats->sources[LOG_STATS_SOURCES];
+    }
+    qsort(sources, (size_t)source_count, sizeof(LogStatsSource), compare_log_sources);
+    strncat(stats_text, "来源:\n", sizeof(stats_text) - strlen(stats_text) - 1);
+    for (int i = 0; i < source_count && i < 6; i++) {
+        snprintf(line, sizeof(line), "  %-16s %llu（错误 %llu）\n", sources[i].name,
+                 (unsigned long long)sources[i].count, (unsigned long long)sources[i].errors);
+        strncat(stats_text, line, sizeof(stats_text) - strlen(stats_text) - 1);
+    }
+
+    // 重复最多的消息（数字折叠为 #，计数可能高估 error 条）
+    LogStatsMessage top[5];
+    int top_count = log_stats_top_messages(stats, top, 5);
+    strncat(stats_text, "\n重复最多的消息:\n", sizeof(stats_text) - strlen(stats_text) - 1);
+    for (int i = 0; i < top_count; i++) {
+        snprintf(line, sizeof(line), "  %llu× [%s] %.60s\n", (unsigned long long)top[i].count,
+                 level_to_string(top[i].level), top[i].text);
+        strncat(stats_text, line, sizeof(stats_text) - strlen(stats_text) - 1);
+    }
+
+    snprintf(line, sizeof(line),
+            "\n当前过滤器:\n"
             "级别过滤: %s\n"
             "模式过滤: %s\n"
             "来源过滤: %s\n\n"
@@ -711,13 +995,7 @@ void show_log_statistics_dialog(LogViewer *lv) {
             "显示时间戳: %s\n"
             "显示源位置: %s\n"
             "自动刷新: %s\n"
-            "跟随尾部: %s",
-            lv->total_entries,
-            log_viewer_get_entries_by_level(lv, LOG_DEBUG),
-            log_viewer_get_entries_by_level(lv, LOG_INFO),
-            log_viewer_get_entries_by_level(lv, LOG_WARNING),
-            log_viewer_get_entries_by_level(lv, LOG_ERROR),
-            log_viewer_get_entries_by_level(lv, LOG_FATAL),
+            "跟随尾部: %s\n\n",
             level_to_string(lv->min_level),
             strlen(lv->filter_pattern) > 0 ? lv->filter_pattern : "无",
             strlen(lv->source_filter) > 0 ? lv->source_filter : "无",
@@ -725,8 +1003,21 @@ void show_log_statistics_dialog(LogViewer *lv) {
             lv->show_source_location ? "是" : "否",
             lv->auto_refresh ? "是" : "否",
             lv->follow_tail ? "是" : "否");
-
-    dialog_msgbox("日志统计", stats_text, 25, 60);
+    strncat(stats_text, line, sizeof(stats_text) - strlen(stats_text) - 1);
+
+    snprintf(line, sizeof(line),
+            "日志库:\n"
+            "已写入记录: %llu\n"
+            "队列溢出丢弃: %llu\n"
+            "限流抑制: %llu\n"
+            "合并的重复记录: %llu",
+            (unsigned long long)logger_stats.records_written,
+            (unsigned long long)logger_stats.records_dropped,
+            (unsigned long long)logger_stats.records_rate_limited,
+            (unsigned long long)logger_stats.records_coalesced);
+    strncat(stats_text, line, sizeof(stats_text) - strlen(stats_text) - 1);
+
+    dialog_msgbox("日志统计", stats_text, 40, 76);
 }
 
 // 配置管理器对话框
@@ -1295,10 +1586,31 @@ void show_config_validation_dialog(ConfigManager *cm) {
             snprintf(display_text + strlen(display_text), sizeof(display_text) - strlen(display_text),
                     "│ 磁盘使用: %6.1f%% (%lu/%lu GB)  │\n"
                     "│ 挂载点: %-20s     │\n"
+                    "│ 设备: %-10s 利用率: %5.1f%%  │\n"
+                    "│ 读: %6.0f IOPS %9.1f KB/s  │\n"
+                    "│ 写: %6.0f IOPS %9.1f KB/s  │\n"
+                    "│ 延迟: %5.1f/%5.1f ms 队列: %5.2f │\n"
                     "└─────────────────────────────────┘\n\n",
                     stats->disk_usage_percent,
                     stats->disk_used / 1024 / 1024, stats->disk_total / 1024 / 1024,
-                    stats->disk_mount_point);
+                    stats->disk_mount_point,
+                    stats->disk_device_name[0] ? stats->disk_device_name : "-", stats->disk_utilization,
+                    stats->disk_read_iops, stats->disk_read_rate,
+                    stats->disk_write_iops, stats->disk_write_rate,
+                    stats->disk_read_latency, stats->disk_write_latency, stats->disk_queue_depth);
+
+            // 网络面板
+            strncat(display_text, "┌─ 网络状态 ──────────────────────┐\n", sizeof(display_text) - strlen(display_text) - 1);
+            snprintf(display_text + strlen(display_text), sizeof(display_text) - strlen(display_text),
+                    "│ 接口: %-16s          │\n"
+                    "│ 接收: %8.1f KB/s %8.0f 包/s │\n"
+                    "│ 发送: %8.1f KB/s %8.0f 包/s │\n"
+                    "│ 丢包: %6.1f/s  错误: %6.1f/s   │\n"
+                    "└─────────────────────────────────┘\n\n",
+                    stats->network_interface[0] ? stats->network_interface : "-",
+                    stats->network_rx_rate, stats->network_rx_packets,
+                    stats->network_tx_rate, stats->network_tx_packets,
+                    stats->network_drops, stats->network_errors);
 
             // 进程面板
             strncat(display_text, "┌─ 进程状态 ──────────────────────┐\n", sizeof(display_text) - strlen(display_text) - 1);
@@ -1316,12 +1628,14 @@ void show_config_validation_dialog(ConfigManager *cm) {
 
             int choice = dialog_menu("系统监控仪表盘",
                                    display_text,
-                                   25, 80, 5,
+                                   25, 80, 7,
                                    "1", "刷新统计信息",
                                    "2", "显示详细信息",
                                    "3", "进程监控面板",
                                    "4", "设置更新间隔",
-                                   "5", "返回主菜单");
+                                   "5", "网络接口",
+                                   "6", "磁盘 I/O",
+                                   "7", "返回主菜单");
 
             switch (choice) {
                 case 1:
@@ -1349,6 +1663,12 @@ void show_config_validation_dialog(ConfigManager *cm) {
                     break;
                 }
                 case 5:
+                    show_network_monitor_panel(&sm);
+                    break;
+                case 6:
+                    show_disk_monitor_panel(&sm);
+                    break;
+                case 7:
                 case -1:
                     return;
                 default:
@@ -1369,7 +1689,8 @@ void show_config_validation_dialog(ConfigManager *cm) {
                 "==============\n\n"
                 "CPU信息:\n"
                 "  使用率: %.2f%%\n"
-                "  核心数: %d\n"
+                "  用户 %.1f%% 内核 %.1f%% IO等待 %.1f%% 中断 %.1f%% 窃取 %.1f%% 虚拟机 %.1f%%\n"
+                "  拓扑: %d 插槽, %d 物理核, %d 逻辑CPU, %d NUMA节点\n"
                 "  频率: %.0f MHz\n\n"
                 "内存信息:\n"
                 "  总内存: %lu MB\n"
@@ -1391,7 +1712,9 @@ void show_config_validation_dialog(ConfigManager *cm) {
                 "  挂载点: %s\n\n"
                 "系统负载: %.2f (1分钟), %.2f (5分钟), %.2f (15分钟)",
                 stats->cpu_usage,
-                stats->cpu_cores,
+                stats->cpu_user, stats->cpu_system, stats->cpu_iowait,
+                stats->cpu_irq, stats->cpu_steal, stats->cpu_guest,
+                stats->cpu_sockets, stats->cpu_cores, stats->cpu_online, stats->numa_nodes,
                 stats->cpu_frequency,
                 stats->memory_total / 1024,
                 stats->memory_used / 1024,
@@ -1412,6 +1735,29 @@ void show_config_validation_dialog(ConfigManager *cm) {
                 stats->load_average_5,
                 stats->load_average_15);
 
+        // 缓存层次与按插槽、节点汇总的使用率
+        const CpuTopology *topology = &sm->topology;
+        strncat(info_text, "\n\n缓存:", sizeof(info_text) - strlen(info_text) - 1);
+        for (int i = 0; i < topology->cache_count; i++) {
+            const CpuTopologyCache *cache = &topology->caches[i];
+            snprintf(info_text + strlen(info_text), sizeof(info_text) - strlen(info_text),
+                    " L%d%s %lluK x%d", cache->level,
+                    cache->type[0] == 'D' ? "d" : cache->type[0] == 'I' ? "i" : "",
+                    (unsigned long long)cache->size_kb, cache->instances);
+        }
+
+        double usage[CPU_TOPOLOGY_MAX_GROUPS];
+        int groups = cpu_topology_aggregate(topology, &sm->cpu, CPU_TOPOLOGY_BY_PACKAGE, usage, CPU_TOPOLOGY_MAX_GROUPS);
+        for (int i = 0; i < groups; i++) {
+            snprintf(info_text + strlen(info_text), sizeof(info_text) - strlen(info_text),
+                    "\n插槽 %d: %.1f%%", topology->package_ids[i], usage[i]);
+        }
+        groups = cpu_topology_aggregate(topology, &sm->cpu, CPU_TOPOLOGY_BY_NODE, usage, CPU_TOPOLOGY_MAX_GROUPS);
+        for (int i = 0; i < groups && topology->node_count > 1; i++) {
+            snprintf(info_text + strlen(info_text), sizeof(info_text) - strlen(info_text),
+                    "\n节点 %d: %.1f%%", topology->node_ids[i], usage[i]);
+        }
+
         dialog_msgbox("系统详细信息", info_text, 25, 80);
     }
 
@@ -1428,39 +1774,135 @@ void show_config_validation_dialog(ConfigManager *cm) {
                 "进程统计:\n"
                 "  总进程数: %d\n"
                 "  总线程数: %d\n"
-                "  僵尸进程: %d\n\n"
-                "进程列表 (前20个):\n",
+                "  僵尸进程: %d\n",
                 stats->process_count,
                 stats->thread_count,
                 stats->zombie_processes);
 
-        // 读取进程信息
-        FILE *file = fopen("/proc/stat", "r");
-        if (file) {
-            char line[256];
-            int count = 0;
-
-            while (fgets(line, sizeof(line), file) && count < 20) {
-                if (strncmp(line, "cpu", 3) == 0) {
-                    char cpu_id[8];
-                    unsigned long user, nice, system, idle;
-                    sscanf(line, "%s %lu %lu %lu %lu", cpu_id, &user, &nice, &system, &idle);
-
-                    unsigned long total = user + nice + system + idle;
-                    unsigned long active = total - idle;
-
-                    if (total > 0) {
-                        double usage = (double)active * 100.0 / total;
-                        snprintf(process_text + strlen(process_text), sizeof(process_text) - strlen(process_text),
-                                "  %s: %.1f%%\n", cpu_id, usage);
-                    }
-                    count++;
+        // 事件跟踪时能看到两次采集之间的短命进程
+        if (sm->events.fd >= 0) {
+            snprintf(process_text + strlen(process_text), sizeof(process_text) - strlen(process_text),
+                    "  进程事件: 新建 %d, 退出 %d (溢出 %llu 次)\n",
+                    stats->process_forks, stats->process_exits,
+                    (unsigned long long)sm->events.overflows);
+        }
+
+        // 类似 top 的排行：与上一次采样之间的 CPU 与 I/O，当前的常驻内存
+        if (system_monitor_collect_top(sm) == SWK_SUCCESS) {
+            static const struct {
+                int metric;
+                int count;
+                const char *title;
+            } sections[] = {
+                {PROC_TOP_CPU, 10, "CPU"},
+                {PROC_TOP_RSS, 5, "内存"},
+                {PROC_TOP_IO, 5, "I/O"},
+            };
+            const ProcEntry *entries[PROC_TOP_MAX];
+
+            for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+                int count = proc_top_select(&sm->top, sections[i].metric, entries, sections[i].count);
+                snprintf(process_text + strlen(process_text), sizeof(process_text) - strlen(process_text),
+                        "\n按%s排序 (间隔 %.1f秒):\n"
+                        "  %7s %-16s %c %6s %9s %9s %9s\n",
+                        sections[i].title, sm->top.interval,
+                        "PID", "命令", 'S', "CPU%", "RSS(MB)", "读KB/s", "写KB/s");
+                for (int j = 0; j < count; j++) {
+                    const ProcEntry *entry = entries[j];
+                    snprintf(process_text + strlen(process_text), sizeof(process_text) - strlen(process_text),
+                            "  %7d %-16.16s %c %6.1f %9.1f %9.1f %9.1f\n",
+                            entry->pid, entry->comm, entry->state, entry->cpu,
+                            entry->rss_kb / 1024.0, entry->read_rate / 1024.0, entry->write_rate / 1024.0);
                 }
             }
-            fclose(file);
         }
 
-        dialog_msgbox("进程监控", process_text, 20, 60);
+        dialog_msgbox("进程监控", process_text, 40, 90);
+    }
+
+    // 显示网络监控面板：所有接口与上一次采样之间的速率
+    void show_network_monitor_panel(SystemMonitor *sm) {
+        if (!sm) return;
+
+        char network_text[MAX_BUFFER_SIZE] = {0};
+        const NetInterface *primary = net_sampler_primary(&sm->net);
+
+        snprintf(network_text, sizeof(network_text),
+                "网络监控面板\n"
+                "==============\n\n"
+                "默认路由接口: %s  (间隔 %.1f秒)\n\n"
+                "%-12s %10s %10s %9s %9s %7s %7s\n",
+                primary ? primary->name : "-", sm->net.interval,
+                "接口", "接收KB/s", "发送KB/s", "收包/s", "发包/s", "丢包/s", "错误/s");
+
+        for (int i = 0; i < sm->net.count; i++) {
+            const NetInterface *iface = &sm->net.interfaces[i];
+            snprintf(network_text + strlen(network_text), sizeof(network_text) - strlen(network_text),
+                    "%-12s %10.1f %10.1f %9.0f %9.0f %7.1f %7.1f\n",
+                    iface->name,
+                    iface->rates[NET_RX_BYTES] / 1024.0, iface->rates[NET_TX_BYTES] / 1024.0,
+                    iface->rates[NET_RX_PACKETS], iface->rates[NET_TX_PACKETS],
+                    iface->rates[NET_RX_DROPPED] + iface->rates[NET_TX_DROPPED],
+                    iface->rates[NET_RX_ERRORS] + iface->rates[NET_TX_ERRORS]);
+        }
+
+        dialog_msgbox("网络监控", network_text, 25, 90);
+    }
+
+    // 显示磁盘监控面板：所有块设备与上一次采样之间的 I/O，以及历史记录中的平均值
+    void show_disk_monitor_panel(SystemMonitor *sm) {
+        if (!sm) return;
+
+        char disk_text[MAX_BUFFER_SIZE] = {0};
+        const SystemStats *stats = &sm->current_stats;
+
+        snprintf(disk_text, sizeof(disk_text),
+                "磁盘监控面板\n"
+                "==============\n\n"
+                "%s 所在设备: %s  (间隔 %.1f秒)\n\n"
+                "%-10s %7s %9s %7s %9s %7s %6s %6s  %s\n",
+                stats->disk_mount_point, stats->disk_device_name[0] ? stats->disk_device_name : "-",
+                sm->disk.interval,
+                "设备", "读IOPS", "读KB/s", "写IOPS", "写KB/s", "延迟ms", "利用%", "队列", "挂载点");
+
+        for (int i = 0; i < sm->disk.count; i++) {
+            const DiskDevice *device = &sm->disk.devices[i];
+            if (device->counters.reads + device->counters.writes == 0) {
+                continue;  // 从未使用过的 loop、ram 等设备
+            }
+            snprintf(disk_text + strlen(disk_text), sizeof(disk_text) - strlen(disk_text),
+                    "%s%-*s %7.0f %9.1f %7.0f %9.1f %7.2f %6.1f %6.2f  %s\n",
+                    device->partition ? "  " : "", device->partition ? 8 : 10, device->name,
+                    device->rates.read_iops, device->rates.read_rate / 1024.0,
+                    device->rates.write_iops, device->rates.write_rate / 1024.0,
+                    device->rates.latency, device->rates.utilization, device->rates.queue_depth,
+                    device->mount[0] ? device->mount : "-");
+        }
+
+        // 同一设备在历史记录中的平均值，用于切换内核等变化前后的对比
+        int count = 0, samples = 0;
+        SystemStats *history = system_monitor_get_history(sm, &count);
+        double iops = 0.0, throughput = 0.0, busy = 0.0, utilization = 0.0, queue = 0.0;
+        for (int i = 0; history && i < count; i++) {
+            if (!stats->disk_device_name[0] || strcmp(history[i].disk_device_name, stats->disk_device_name) != 0) {
+                continue;
+            }
+            iops += history[i].disk_read_iops + history[i].disk_write_iops;
+            throughput += history[i].disk_read_rate + history[i].disk_write_rate;
+            busy += history[i].disk_read_latency * history[i].disk_read_iops +
+                    history[i].disk_write_latency * history[i].disk_write_iops;
+            utilization += history[i].disk_utilization;
+            queue += history[i].disk_queue_depth;
+            samples++;
+        }
+        if (samples > 0) {
+            snprintf(disk_text + strlen(disk_text), sizeof(disk_text) - strlen(disk_text),
+                    "\n%s 最近 %d 次采样平均: %.0f IOPS, %.1f KB/s, 延迟 %.2f ms, 利用率 %.1f%%, 队列 %.2f\n",
+                    stats->disk_device_name, samples, iops / samples, throughput / samples,
+                    iops > 0.0 ? busy / iops : 0.0, utilization / samples, queue / samples);
+        }
+
+        dialog_msgbox("磁盘监控", disk_text, 25, 100);
     }
 
     // 主题管理器对话框
@@ -2595,7 +3037,7 @@ void show_config_validation_dialog(ConfigManager *cm) {
     
             // 这里可以实现状态显示逻辑
             // 由于dialog库的限制，我们主要通过日志来显示状态
-            log_message(LOG_INFO, "Status: %s", status_text);
+            SWK_LOG_INFO(LOG_SUBSYS_TUI, "Status: %s", status_text);
         }
     }
 }
\ No newline at end of file
@@ -37,7 +37,7 @@ int load_config(SwikernelConfig *config) {
         }
         
         if (file) {
-            log_message(LOG_DEBUG, "Loading config from: %s", config_path);
+            SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Loading config from: %s", config_path);
             break;
         }
     }
@@ -51,6 +51,9 @@ int load_config(SwikernelConfig *config) {
     char line[256];
     char section[64] = {0};
     int line_num = 0;
+
+    // 文件中未出现的键保持默认值
+    set_default_config(config);
     
     while (fgets(line, sizeof(line), file)) {
         line_num++;
@@ -96,6 +99,11 @@ int load_config(SwikernelConfig *config) {
     return 0;
 }
 
+// 输出端级别名称，-1 写作 off
+static const char *sink_level_name(int level) {
+    return level >= 0 ? logger_level_name((LogLevel)level) : "off";
+}
+
 // 保存配置到文件
 int save_config(const SwikernelConfig *config, const char *filename) {
     FILE *file = fopen(filename, "w");
@@ -111,7 +119,35 @@ int save_config(const SwikernelConfig *config, const char *filename) {
     fprintf(file, "level = %d\n", config->log_level);
     fprintf(file, "file = %s\n", config->log_file);
     fprintf(file, "max_size = %d\n", config->log_max_size);
-    fprintf(file, "rotate = %d\n\n", config->log_rotate);
+    fprintf(file, "rotate = %d\n", config->log_rotate);
+    fprintf(file, "max_files = %d\n", config->log_max_files);
+    fprintf(file, "compress = %d\n", config->log_compress);
+    fprintf(file, "async = %d\n", config->log_async);
+    fprintf(file, "queue_size = %d\n", config->log_queue_size);
+    fprintf(file, "overflow = %s\n", logger_overflow_policy_name(config->log_overflow));
+    fprintf(file, "format = %s\n", logger_format_name(config->log_format));
+    fprintf(file, "rate_limit = %d\n", config->log_rate_limit);
+    fprintf(file, "rate_burst = %d\n", config->log_rate_burst);
+    fprintf(file, "coalesce = %d\n\n", config->log_coalesce);
+
+    // 子系统日志级别
+    fprintf(file, "[log_levels]\n");
+    for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+        int level = config->log_subsystem_levels[i];
+        fprintf(file, "%s = %s\n", logger_subsystem_name((LogSubsystem)i),
+                level >= 0 ? logger_level_name((LogLevel)level) : "inherit");
+    }
+    fprintf(file, "\n");
+
+    // 输出端
+    fprintf(file, "[log_sinks]\n");
+    fprintf(file, "file = %s\n", sink_level_name(config->log_sink_levels[LOG_SINK_FILE]));
+    fprintf(file, "tty = %s\n", sink_level_name(config->log_sink_levels[LOG_SINK_TTY]));
+    fprintf(file, "socket = %s\n", sink_level_name(config->log_sink_levels[LOG_SINK_SOCKET]));
+    fprintf(file, "socket_path = %s\n", config->log_socket_path);
+    fprintf(file, "socket_mode = %s\n", logger_socket_mode_name((LogSocketMode)config->log_socket_mode));
+    fprintf(file, "memory = %s\n", sink_level_name(config->log_sink_levels[LOG_SINK_MEMORY]));
+    fprintf(file, "memory_records = %d\n\n", config->log_memory_records);
     
     // 内核配置
     fprintf(file, "[kernel]\n");
@@ -145,6 +181,25 @@ void set_default_config(SwikernelConfig *config) {
     config->log_level = LOG_INFO;
     config->log_max_size = 10 * 1024 * 1024; // 10MB
     config->log_rotate = 1;
+    config->log_max_files = 10;
+    config->log_compress = 1;
+    config->log_async = 0;
+    config->log_queue_size = 4096;
+    config->log_overflow = LOG_OVERFLOW_DROP_DEBUG;
+    config->log_format = LOG_FORMAT_TEXT;
+    config->log_rate_limit = 50;
+    config->log_rate_burst = 200;
+    config->log_coalesce = 1;
+    for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+        config->log_subsystem_levels[i] = -1;
+    }
+    config->log_sink_levels[LOG_SINK_FILE] = LOG_DEBUG;
+    config->log_sink_levels[LOG_SINK_TTY] = LOG_DEBUG;
+    config->log_sink_levels[LOG_SINK_SOCKET] = LOG_INFO;
+    config->log_sink_levels[LOG_SINK_MEMORY] = LOG_DEBUG;
+    config->log_socket_path[0] = '\0';
+    config->log_socket_mode = LOG_SOCKET_DGRAM;
+    config->log_memory_records = 1000;
     
     strcpy(config->default_source_dir, "/usr/src");
     config->backup_enabled = 1;
@@ -159,20 +214,66 @@ void set_default_config(SwikernelConfig *config) {
     config->auto_complete = 1;
     config->show_progress = 1;
     
-    log_message(LOG_DEBUG, "Default configuration set");
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Default configuration set");
 }
 
 // 设置配置值
 int set_config_value(SwikernelConfig *config, const char *section, const char *key, const char *value) {
     if (strcmp(section, "logging") == 0) {
         if (strcmp(key, "level") == 0) {
-            config->log_level = atoi(value);
+            int level = logger_parse_level(value);
+            config->log_level = level >= 0 ? level : LOG_INFO;
         } else if (strcmp(key, "file") == 0) {
             strncpy(config->log_file, value, sizeof(config->log_file) - 1);
         } else if (strcmp(key, "max_size") == 0) {
             config->log_max_size = atoi(value);
         } else if (strcmp(key, "rotate") == 0) {
-            config->log_rotate = atoi(value);
+            config->log_rotate = (strcmp(value, "true") == 0) || atoi(value) != 0;
+        } else if (strcmp(key, "max_files") == 0) {
+            config->log_max_files = atoi(value);
+        } else if (strcmp(key, "compress") == 0) {
+            config->log_compress = (strcmp(value, "true") == 0) || atoi(value) != 0;
+        } else if (strcmp(key, "async") == 0) {
+            config->log_async = (strcmp(value, "true") == 0) || atoi(value) != 0;
+        } else if (strcmp(key, "queue_size") == 0) {
+            config->log_queue_size = atoi(value);
+        } else if (strcmp(key, "overflow") == 0) {
+            config->log_overflow = logger_parse_overflow_policy(value);
+        } else if (strcmp(key, "format") == 0) {
+            config->log_format = logger_parse_format(value);
+        } else if (strcmp(key, "rate_limit") == 0) {
+            config->log_rate_limit = atoi(value);
+        } else if (strcmp(key, "rate_burst") == 0) {
+            config->log_rate_burst = atoi(value);
+        } else if (strcmp(key, "coalesce") == 0) {
+            config->log_coalesce = (strcmp(value, "true") == 0) || atoi(value) != 0;
+        } else {
+            return -1;
+        }
+    } else if (strcmp(section, "log_levels") == 0) {
+        int subsystem = logger_parse_subsystem(key);
+        if (subsystem < 0) {
+            return -1;
+        }
+        // inherit 或无法识别的级别都表示跟随全局级别
+        config->log_subsystem_levels[subsystem] = logger_parse_level(value);
+    } else if (strcmp(section, "log_sinks") == 0) {
+        // off 或无法识别的级别都表示停用该输出端
+        if (strcmp(key, "file") == 0) {
+            config->log_sink_levels[LOG_SINK_FILE] = logger_parse_level(value);
+        } else if (strcmp(key, "tty") == 0) {
+            config->log_sink_levels[LOG_SINK_TTY] = logger_parse_level(value);
+        } else if (strcmp(key, "socket") == 0) {
+            config->log_sink_levels[LOG_SINK_SOCKET] = logger_parse_level(value);
+        } else if (strcmp(key, "socket_path") == 0) {
+            strncpy(config->log_socket_path, value, sizeof(config->log_socket_path) - 1);
+        } else if (strcmp(key, "socket_mode") == 0) {
+            int mode = logger_parse_socket_mode(value);
+            config->log_socket_mode = mode >= 0 ? mode : LOG_SOCKET_DGRAM;
+        } else if (strcmp(key, "memory") == 0) {
+            config->log_sink_levels[LOG_SINK_MEMORY] = logger_parse_level(value);
+        } else if (strcmp(key, "memory_records") == 0) {
+            config->log_memory_records = atoi(value);
         } else {
             return -1;
         }
@@ -215,6 +316,43 @@ int set_config_value(SwikernelConfig *config, const char *section, const char *k
     return 0;
 }
 
+// 应用日志级别配置
+void apply_log_levels(const SwikernelConfig *config) {
+    logger_set_level((LogLevel)config->log_level);
+    for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+        logger_set_subsystem_level((LogSubsystem)i, config->log_subsystem_levels[i]);
+    }
+}
+
+// 应用输出端配置（可在运行中重复调用）
+void apply_log_sinks(const SwikernelConfig *config) {
+    int socket_level = config->log_sink_levels[LOG_SINK_SOCKET];
+    int memory_level = config->log_sink_levels[LOG_SINK_MEMORY];
+
+    logger_set_sink_level(LOG_SINK_FILE, config->log_sink_levels[LOG_SINK_FILE]);
+    logger_set_sink_level(LOG_SINK_TTY, config->log_sink_levels[LOG_SINK_TTY]);
+
+    if (config->log_socket_path[0] != '\0' && socket_level >= 0) {
+        if (logger_open_socket_sink(config->log_socket_path, (LogSocketMode)config->log_socket_mode,
+                                    (LogLevel)socket_level) != SWK_SUCCESS) {
+            log_message(LOG_WARNING, "Cannot connect log socket %s (%s)", config->log_socket_path,
+                        logger_socket_mode_name((LogSocketMode)config->log_socket_mode));
+        }
+    } else {
+        logger_close_sink(LOG_SINK_SOCKET);
+    }
+
+    // 已开启的内存环只调整级别，保留其中的记录
+    if (config->log_memory_records > 0 && memory_level >= 0) {
+        if (logger_set_sink_level(LOG_SINK_MEMORY, memory_level) != SWK_SUCCESS &&
+            logger_open_memory_sink((size_t)config->log_memory_records, (LogLevel)memory_level) != SWK_SUCCESS) {
+            log_message(LOG_WARNING, "Cannot allocate log memory ring (%d records)", config->log_memory_records);
+        }
+    } else {
+        logger_close_sink(LOG_SINK_MEMORY);
+    }
+}
+
 // 去除字符串前后空白
 char* trim_whitespace(char *str) {
     char *end;
@@ -72,14 +72,14 @@ int add_rollback_step(RollbackAction action, void *data, size_t data_size) {
     rollback_stack = step;
     rollback_count++;
     
-    log_message(LOG_DEBUG, "Added rollback step %d (action: %d)", rollback_count, action);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Added rollback step %d (action: %d)", rollback_count, action);
     return 0;
 }
 
 // 执行回滚
 void execute_rollback(void) {
     if (rollback_count == 0) {
-        log_message(LOG_DEBUG, "No rollback steps to execute");
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "No rollback steps to execute");
         return;
     }
     
@@ -89,7 +89,7 @@ void execute_rollback(void) {
     int steps_executed = 0;
     
     while (current) {
-        log_message(LOG_DEBUG, "Executing rollback step %d", steps_executed + 1);
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Executing rollback step %d", steps_executed + 1);
         
         switch (current->action) {
             case ACTION_RESTORE_FILE:
@@ -143,7 +143,7 @@ void clear_rollback_stack(void) {
     
     rollback_stack = NULL;
     rollback_count = 0;
-    log_message(LOG_DEBUG, "Rollback stack cleared (%d steps)", steps_cleared);
+    SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Rollback stack cleared (%d steps)", steps_cleared);
 }
 
 // 文件备份回滚实现
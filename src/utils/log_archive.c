@@ -0,0 +1,572 @@
+// src/utils/log_archive.c
+// 轮转日志段的可随机访问压缩归档
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "log_archive.h"
+#include "log_binary.h"
+#include "crc32c.h"
+#include "log_time.h"
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+typedef struct {
+    LogArchiveFrame *frames;
+    uint32_t count;
+    uint32_t capacity;
+    uint8_t *preamble;
+    size_t preamble_size;
+    size_t preamble_capacity;
+} ArchivePlan;
+
+static int read_all(int fd, void *data, size_t length) {
+    uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = read(fd, p, length);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static int read_file(const char *path, uint8_t **data, size_t *length) {
+    struct stat st;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    *length = (size_t)st.st_size;
+    *data = malloc(*length + 1);
+    if (!*data) {
+        close(fd);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    if (*length > 0 && read_all(fd, *data, *length) != 0) {
+        free(*data);
+        close(fd);
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    close(fd);
+    return SWK_SUCCESS;
+}
+
+static int plan_add_frame(ArchivePlan *plan, uint64_t offset, uint64_t size, int64_t time_ms,
+                          size_t preamble_length) {
+    if (plan->count == plan->capacity) {
+        uint32_t capacity = plan->capacity ? plan->capacity * 2 : 16;
+        LogArchiveFrame *frames = realloc(plan->frames, capacity * sizeof(LogArchiveFrame));
+        if (!frames) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        plan->frames = frames;
+        plan->capacity = capacity;
+    }
+
+    LogArchiveFrame *frame = &plan->frames[plan->count++];
+    memset(frame, 0, sizeof(LogArchiveFrame));
+    frame->decompressed_offset = offset;
+    frame->decompressed_size = (uint32_t)size;
+    frame->first_time_ms = time_ms;
+    frame->preamble_length = (uint32_t)preamble_length;
+    return SWK_SUCCESS;
+}
+
+static int plan_add_preamble(ArchivePlan *plan, const uint8_t *data, size_t length) {
+    if (plan->preamble_size + length > plan->preamble_capacity) {
+        size_t capacity = plan->preamble_capacity ? plan->preamble_capacity : 4096;
+        while (capacity < plan->preamble_size + length) {
+            capacity *= 2;
+        }
+        uint8_t *preamble = realloc(plan->preamble, capacity);
+        if (!preamble) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        plan->preamble = preamble;
+        plan->preamble_capacity = capacity;
+    }
+
+    memcpy(plan->preamble + plan->preamble_size, data, length);
+    plan->preamble_size += length;
+    return SWK_SUCCESS;
+}
+
+// 二进制日志：按记录切块，文件头与格式串定义复制到前导区
+// 段中间出现的文件头（进程重启后追加写入）总是开始一个新块，
+// 保证每一块只依赖它之前的前导区
+static int plan_binary(ArchivePlan *plan, const uint8_t *data, size_t length) {
+    LogBinaryDecoder *decoder = malloc(sizeof(LogBinaryDecoder));
+    size_t offset = 0, frame_start = 0, frame_preamble = 0;
+    int64_t frame_time = -1;
+    int result = SWK_SUCCESS;
+
+    if (!decoder) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    log_binary_decoder_init(decoder);
+
+    while (offset < length) {
+        LogBinaryEvent event;
+        int has_event;
+        int is_header = log_binary_check_magic(data + offset, length - offset);
+        long used = log_binary_decode(decoder, data + offset, length - offset, &event, &has_event);
+
+        if (used == 0) {
+            // 截断的尾部原样放进最后一块
+            break;
+        }
+        if (used < 0) {
+            // 损坏的字节原样留在当前块中，解码时同样会跳过
+            offset += log_binary_resync(decoder, data + offset, length - offset);
+            continue;
+        }
+
+        if (is_header && offset > frame_start) {
+            result = plan_add_frame(plan, frame_start, offset - frame_start, frame_time, frame_preamble);
+            frame_start = offset;
+            frame_preamble = plan->preamble_size;
+            frame_time = -1;
+        }
+
+        int is_format = !is_header && ((const LogRecordHeader *)(data + offset))->type == LOG_RECORD_FORMAT;
+        if (result == SWK_SUCCESS && (is_header || is_format)) {
+            result = plan_add_preamble(plan, data + offset, (size_t)used);
+        }
+        if (result != SWK_SUCCESS) {
+            break;
+        }
+
+        if (has_event && frame_time < 0) {
+            frame_time = log_time_from_epoch(event.wall_ns / 1000000);
+        }
+        offset += (size_t)used;
+
+        if (offset - frame_start >= LOG_ARCHIVE_FRAME_SIZE) {
+            result = plan_add_frame(plan, frame_start, offset - frame_start, frame_time, frame_preamble);
+            frame_start = offset;
+            frame_preamble = plan->preamble_size;
+            frame_time = -1;
+        }
+    }
+
+    if (result == SWK_SUCCESS && length > frame_start) {
+        result = plan_add_frame(plan, frame_start, length - frame_start, frame_time, frame_preamble);
+    }
+
+    log_binary_decoder_free(decoder);
+    free(decoder);
+    return result;
+}
+
+static void plan_free(ArchivePlan *plan) {
+    free(plan->frames);
+    free(plan->preamble);
+}
+
+#ifdef HAVE_ZSTD
+
+static int write_all(int fd, const void *data, size_t length) {
+    const uint8_t *p = data;
+
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+// 文本日志：在换行处切块，时间戳取块内第一行
+static int plan_text(ArchivePlan *plan, const uint8_t *data, size_t length) {
+    size_t offset = 0;
+
+    while (offset < length) {
+        size_t end = offset + LOG_ARCHIVE_FRAME_SIZE;
+
+        if (end >= length) {
+            end = length;
+        } else {
+            const uint8_t *nl = memrchr(data + offset, '\n', end - offset);
+            if (!nl) {
+                nl = memchr(data + end, '\n', length - end);
+            }
+            end = nl ? (size_t)(nl - data) + 1 : length;
+        }
+
+        int64_t time_ms = log_time_parse((const char *)data + offset, end - offset);
+        if (plan_add_frame(plan, offset, end - offset, time_ms, 0) != SWK_SUCCESS) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        offset = end;
+    }
+
+    return SWK_SUCCESS;
+}
+
+// 换名之后同步所在目录，目录项本身才算落盘
+static int sync_parent_dir(const char *path) {
+    char dir[MAX_PATH_LENGTH + 16];
+    snprintf(dir, sizeof(dir), "%s", path);
+
+    char *slash = strrchr(dir, '/');
+    if (!slash) {
+        snprintf(dir, sizeof(dir), ".");
+    } else {
+        slash[slash == dir ? 1 : 0] = '\0';
+    }
+
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    int result = fsync(fd) == 0 ? SWK_SUCCESS : SWK_ERROR_SYSTEM_CALL;
+    close(fd);
+    return result;
+}
+
+// 按计划逐帧压缩写出归档和索引
+// 两个文件都先写到临时文件并 fsync，再换名并同步目录。换名之间崩溃时
+// 可能留下不配对的归档与索引，log_archive_open 用归档大小识别这种情况。
+static int write_archive(const ArchivePlan *plan, int binary, const uint8_t *data, size_t length,
+                         const char *archive_path) {
+    char archive_tmp[MAX_PATH_LENGTH + 16], index_path[MAX_PATH_LENGTH + 16], index_tmp[MAX_PATH_LENGTH + 32];
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    size_t bound = ZSTD_compressBound(LOG_ARCHIVE_FRAME_SIZE * 2);
+    uint8_t *out = NULL;
+    uint64_t compressed_offset = 0;
+    int fd = -1, result = SWK_SUCCESS;
+
+    snprintf(archive_tmp, sizeof(archive_tmp), "%s.tmp", archive_path);
+    snprintf(index_path, sizeof(index_path), "%s%s", archive_path, LOG_ARCHIVE_INDEX_SUFFIX);
+    snprintf(index_tmp, sizeof(index_tmp), "%s.tmp", index_path);
+
+    if (!cctx) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    fd = open(archive_tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ZSTD_freeCCtx(cctx);
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    for (uint32_t i = 0; i < plan->count && result == SWK_SUCCESS; i++) {
+        LogArchiveFrame *frame = &plan->frames[i];
+        size_t need = ZSTD_compressBound(frame->decompressed_size);
+
+        if (!out || need > bound) {
+            bound = need > bound ? need : bound;
+            free(out);
+            out = malloc(bound);
+            if (!out) {
+                result = SWK_ERROR_OUT_OF_MEMORY;
+                break;
+            }
+        }
+
+        frame->crc = crc32c(0, data + frame->decompressed_offset, frame->decompressed_size);
+        size_t csize = ZSTD_compressCCtx(cctx, out, bound, data + frame->decompressed_offset,
+                                         frame->decompressed_size, LOG_ARCHIVE_LEVEL);
+        if (ZSTD_isError(csize) || write_all(fd, out, csize) != 0) {
+            result = SWK_ERROR;
+            break;
+        }
+
+        frame->compressed_offset = compressed_offset;
+        frame->compressed_size = (uint32_t)csize;
+        compressed_offset += csize;
+    }
+
+    free(out);
+    ZSTD_freeCCtx(cctx);
+    if (fsync(fd) != 0 && result == SWK_SUCCESS) {
+        result = SWK_ERROR_SYSTEM_CALL;
+    }
+    close(fd);
+
+    if (result == SWK_SUCCESS) {
+        LogArchiveIndexHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_ARCHIVE_INDEX_MAGIC, sizeof(header.magic));
+        header.version = LOG_ARCHIVE_INDEX_VERSION;
+        header.frame_count = plan->count;
+        header.binary = (uint32_t)binary;
+        header.preamble_size = (uint32_t)plan->preamble_size;
+        header.total_size = length;
+        header.crc = crc32c(crc32c(0, plan->frames, plan->count * sizeof(LogArchiveFrame)),
+                            plan->preamble, plan->preamble_size);
+
+        fd = open(index_tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0 ||
+            write_all(fd, &header, sizeof(header)) != 0 ||
+            write_all(fd, plan->frames, plan->count * sizeof(LogArchiveFrame)) != 0 ||
+            write_all(fd, plan->preamble, plan->preamble_size) != 0 ||
+            fsync(fd) != 0) {
+            result = SWK_ERROR_SYSTEM_CALL;
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // 先换上归档再换上索引：读者以索引为准，看到索引时归档已经就位
+    if (result == SWK_SUCCESS &&
+        (rename(archive_tmp, archive_path) != 0 || rename(index_tmp, index_path) != 0)) {
+        result = SWK_ERROR_SYSTEM_CALL;
+    }
+    if (result != SWK_SUCCESS) {
+        unlink(archive_tmp);
+        unlink(index_tmp);
+    } else {
+        result = sync_parent_dir(archive_path);
+    }
+
+    return result;
+}
+
+#endif
+
+int log_archive_supported(void) {
+#ifdef HAVE_ZSTD
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+// 压缩一个日志段
+int log_archive_compress(const char *source, const char *archive_path) {
+#ifdef HAVE_ZSTD
+    ArchivePlan plan;
+    uint8_t *data;
+    size_t length;
+
+    if (!source || !archive_path) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    int result = read_file(source, &data, &length);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    memset(&plan, 0, sizeof(plan));
+    int binary = log_binary_check_magic(data, length);
+    result = binary ? plan_binary(&plan, data, length) : plan_text(&plan, data, length);
+    if (result == SWK_SUCCESS) {
+        result = write_archive(&plan, binary, data, length, archive_path);
+    }
+
+    plan_free(&plan);
+    free(data);
+    return result;
+#else
+    (void)source;
+    (void)archive_path;
+    return SWK_ERROR_DEPENDENCY;
+#endif
+}
+
+// 打开归档，只读取索引
+int log_archive_open(LogArchive *archive, const char *archive_path) {
+    char index_path[MAX_PATH_LENGTH + 16];
+    LogArchiveIndexHeader header;
+    uint8_t *data;
+    size_t length;
+
+    if (!archive || !archive_path) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+    memset(archive, 0, sizeof(LogArchive));
+    archive->fd = -1;
+
+    if (!log_archive_supported()) {
+        return SWK_ERROR_DEPENDENCY;
+    }
+
+    snprintf(index_path, sizeof(index_path), "%s%s", archive_path, LOG_ARCHIVE_INDEX_SUFFIX);
+    int result = read_file(index_path, &data, &length);
+    if (result != SWK_SUCCESS) {
+        return result;
+    }
+
+    if (length < sizeof(header)) {
+        free(data);
+        return SWK_ERROR;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    size_t frames_size = (size_t)header.frame_count * sizeof(LogArchiveFrame);
+    if (memcmp(header.magic, LOG_ARCHIVE_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LOG_ARCHIVE_INDEX_VERSION ||
+        length != sizeof(header) + frames_size + header.preamble_size ||
+        crc32c(0, data + sizeof(header), length - sizeof(header)) != header.crc) {
+        free(data);
+        return SWK_ERROR;
+    }
+
+    archive->frames = malloc(frames_size ? frames_size : 1);
+    archive->preamble = malloc(header.preamble_size ? header.preamble_size : 1);
+    if (!archive->frames || !archive->preamble) {
+        free(data);
+        log_archive_close(archive);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    memcpy(archive->frames, data + sizeof(header), frames_size);
+    memcpy(archive->preamble, data + sizeof(header) + frames_size, header.preamble_size);
+    free(data);
+
+    archive->frame_count = header.frame_count;
+    archive->binary = (int)header.binary;
+    archive->total_size = header.total_size;
+    archive->preamble_size = header.preamble_size;
+
+    archive->fd = open(archive_path, O_RDONLY | O_CLOEXEC);
+    if (archive->fd < 0) {
+        log_archive_close(archive);
+        return SWK_ERROR_FILE_NOT_FOUND;
+    }
+
+    // 归档必须恰好在最后一帧处结束，否则索引属于另一份归档
+    struct stat st;
+    uint64_t end = 0;
+    if (archive->frame_count > 0) {
+        const LogArchiveFrame *last = &archive->frames[archive->frame_count - 1];
+        end = last->compressed_offset + last->compressed_size;
+    }
+    if (fstat(archive->fd, &st) != 0 || (uint64_t)st.st_size != end) {
+        log_archive_close(archive);
+        return SWK_ERROR;
+    }
+
+    return SWK_SUCCESS;
+}
+
+void log_archive_close(LogArchive *archive) {
+    if (!archive) {
+        return;
+    }
+
+    if (archive->fd >= 0) {
+        close(archive->fd);
+    }
+    free(archive->frames);
+    free(archive->preamble);
+    memset(archive, 0, sizeof(LogArchive));
+    archive->fd = -1;
+}
+
+// 未压缩的二进制日志段：只建立帧表与前导区
+int log_archive_plan_binary(LogArchive *archive, const uint8_t *data, size_t length) {
+    ArchivePlan plan;
+
+    memset(archive, 0, sizeof(LogArchive));
+    archive->fd = -1;
+    if (!data || !log_binary_check_magic(data, length)) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    memset(&plan, 0, sizeof(plan));
+    int result = plan_binary(&plan, data, length);
+    if (result != SWK_SUCCESS) {
+        plan_free(&plan);
+        return result;
+    }
+
+    archive->binary = 1;
+    archive->frame_count = plan.count;
+    archive->total_size = length;
+    archive->frames = plan.frames;
+    archive->preamble = plan.preamble;
+    archive->preamble_size = plan.preamble_size;
+    return SWK_SUCCESS;
+}
+
+// 二分查找时间戳所在的帧（时间戳未知的帧视为与前一帧相同）
+uint32_t log_archive_find_frame(const LogArchive *archive, int64_t time_ms) {
+    uint32_t low = 0, high = archive->frame_count;
+
+    while (low + 1 < high) {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t probe = mid;
+
+        while (probe > low && archive->frames[probe].first_time_ms < 0) {
+            probe--;
+        }
+        if (archive->frames[probe].first_time_ms >= 0 && archive->frames[probe].first_time_ms > time_ms) {
+            high = mid;
+        } else {
+            low = mid;
+        }
+    }
+
+    return low;
+}
+
+// 解压单独一帧
+int log_archive_read_frame(const LogArchive *archive, uint32_t index, uint8_t **data, size_t *length) {
+#ifdef HAVE_ZSTD
+    if (!archive || archive->fd < 0 || index >= archive->frame_count || !data || !length) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    const LogArchiveFrame *frame = &archive->frames[index];
+    uint8_t *compressed = malloc(frame->compressed_size);
+    uint8_t *plain = malloc((size_t)frame->decompressed_size + 1);
+
+    if (!compressed || !plain) {
+        free(compressed);
+        free(plain);
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    ssize_t n = pread(archive->fd, compressed, frame->compressed_size, (off_t)frame->compressed_offset);
+    size_t size = (n == (ssize_t)frame->compressed_size) ?
+                  ZSTD_decompress(plain, frame->decompressed_size, compressed, frame->compressed_size) : 0;
+    free(compressed);
+
+    if (n != (ssize_t)frame->compressed_size || ZSTD_isError(size) || size != frame->decompressed_size ||
+        crc32c(0, plain, size) != frame->crc) {
+        free(plain);
+        return SWK_ERROR;
+    }
+
+    plain[size] = '\0';
+    *data = plain;
+    *length = size;
+    return SWK_SUCCESS;
+#else
+    (void)archive;
+    (void)index;
+    (void)data;
+    (void)length;
+    return SWK_ERROR_DEPENDENCY;
+#endif
+}
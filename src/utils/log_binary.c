@@ -0,0 +1,881 @@
+// src/utils/log_binary.c
+// 二进制日志的编码与解码
+//
+// 热路径上只做两件事：按格式串地址查表取得参数类型（无锁），再把参数按
+// 类型逐个拷贝到记录里。格式化推迟到 swikernel-logdump、日志查看器或
+// 控制台输出时进行。
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "log_binary.h"
+#include "crc32c.h"
+
+#define FORMAT_TABLE_SIZE (LOG_BINARY_MAX_FORMATS * 2)  // 开放寻址表，负载不超过 1/2
+#define FORMAT_SPEC_MAX 64
+
+static const char *const level_names[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+// 格式串地址 -> 登记信息
+typedef struct {
+    const char *key;
+    LogFormatInfo *info;
+} FormatSlot;
+
+static FormatSlot format_table[FORMAT_TABLE_SIZE];
+static LogFormatInfo format_infos[LOG_BINARY_MAX_FORMATS];
+static uint32_t format_count;
+static pthread_mutex_t format_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 一个转换说明
+typedef struct {
+    const char *start;      // 指向 '%'
+    const char *end;        // 指向转换字符之后
+    int stars;              // '*' 宽度/精度的个数，各占一个 int 参数
+    int type;               // LogArgType，0 表示 "%%"
+    char length;            // 长度修饰符（hh 记为 'h'，ll 记为 'q'），0 表示没有
+    int supported;
+} FormatSpec;
+
+static inline LogLevel clamp_level(int level) {
+    return (level < LOG_DEBUG || level > LOG_FATAL) ? LOG_FATAL : (LogLevel)level;
+}
+
+static inline int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 整数转换按长度修饰符决定读取类型
+static int integer_type(char length) {
+    switch (length) {
+        case 0:
+        case 'h': return LOG_ARG_INT;
+        case 'l': return LOG_ARG_LONG;
+        case 'q': return LOG_ARG_LLONG;
+        case 'j': return LOG_ARG_INTMAX;
+        case 'z': return LOG_ARG_SIZE;
+        case 't': return LOG_ARG_PTRDIFF;
+        default: return 0;
+    }
+}
+
+// 取出 *cursor 之后的下一个转换说明，没有时返回 0
+static int next_spec(const char **cursor, FormatSpec *spec) {
+    const char *p = strchr(*cursor, '%');
+    char length = 0;
+
+    if (!p) {
+        return 0;
+    }
+
+    spec->start = p++;
+    spec->stars = 0;
+    spec->type = 0;
+    spec->length = 0;
+    spec->supported = 1;
+
+    if (*p == '%') {
+        spec->end = p + 1;
+        *cursor = spec->end;
+        return 1;
+    }
+
+    while (*p && strchr("-+ #0'", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    } else {
+        while (is_digit(*p)) p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        } else {
+            while (is_digit(*p)) p++;
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            p++;
+            if (*p == 'h') p++;
+            length = 'h';
+            break;
+        case 'l':
+            p++;
+            if (*p == 'l') {
+                p++;
+                length = 'q';
+            } else {
+                length = 'l';
+            }
+            break;
+        case 'q': case 'L': case 'j': case 'z': case 't':
+            length = *p++;
+            break;
+        default:
+            break;
+    }
+
+    char conv = *p;
+    if (conv) {
+        p++;
+    }
+
+    switch (conv) {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            spec->type = integer_type(length);
+            spec->supported = spec->type != 0;
+            break;
+        case 'c':
+            spec->type = LOG_ARG_INT;
+            spec->supported = (length == 0);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            // %lf 与 %f 相同；%Lf 要 long double，其余修饰符没有定义
+            spec->type = LOG_ARG_DOUBLE;
+            spec->supported = (length == 0 || length == 'l');
+            break;
+        case 's':
+            spec->type = LOG_ARG_STRING;
+            spec->supported = (length == 0);
+            break;
+        case 'p':
+            spec->type = LOG_ARG_POINTER;
+            spec->supported = (length == 0);
+            break;
+        default:
+            // %n、%m、宽字符等不做延迟格式化
+            spec->supported = 0;
+            break;
+    }
+
+    spec->length = length;
+    spec->end = p;
+    *cursor = p;
+    return 1;
+}
+
+// 渲染时只接受编码端同样接受的转换：格式串来自文件，不可信
+static int spec_renderable(const FormatSpec *spec) {
+    if (!spec->supported) {
+        return 0;
+    }
+    switch (spec->type) {
+        case LOG_ARG_INT:
+            return spec->length == 0 || spec->length == 'h';
+        case LOG_ARG_LONG:
+            return spec->length == 'l';
+        case LOG_ARG_LLONG:
+            return spec->length == 'q';
+        case LOG_ARG_DOUBLE:
+            return spec->length == 0 || spec->length == 'l';
+        case LOG_ARG_SIZE:
+            return spec->length == 'z';
+        case LOG_ARG_INTMAX:
+            return spec->length == 'j';
+        case LOG_ARG_PTRDIFF:
+            return spec->length == 't';
+        case LOG_ARG_STRING:
+        case LOG_ARG_POINTER:
+            return spec->length == 0;
+        default:
+            return 0;
+    }
+}
+
+// 当前单调时钟
+int64_t log_binary_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// 填充文件头
+void log_binary_header_init(LogBinaryHeader *header) {
+    struct timespec wall;
+
+    memset(header, 0, sizeof(LogBinaryHeader));
+    memcpy(header->magic, LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_SIZE);
+    header->version = LOG_BINARY_VERSION;
+    header->header_size = sizeof(LogBinaryHeader);
+
+    clock_gettime(CLOCK_REALTIME, &wall);
+    header->mono_base_ns = log_binary_now();
+    header->wall_base_ns = (int64_t)wall.tv_sec * 1000000000LL + wall.tv_nsec;
+}
+
+// 检查文件头标识
+int log_binary_check_magic(const void *data, size_t length) {
+    return data && length >= LOG_BINARY_MAGIC_SIZE &&
+           memcmp(data, LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_SIZE) == 0;
+}
+
+int log_binary_is_binary_file(const char *path) {
+    char magic[LOG_BINARY_MAGIC_SIZE];
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return 0;
+    }
+
+    ssize_t n = read(fd, magic, sizeof(magic));
+    close(fd);
+    return n == (ssize_t)sizeof(magic) && log_binary_check_magic(magic, sizeof(magic));
+}
+
+// 解析格式串的参数类型
+int log_format_parse(const char *format, uint8_t *types, int max_types) {
+    const char *cursor = format;
+    FormatSpec spec;
+    int count = 0;
+
+    if (!format || strlen(format) > LOG_BINARY_MAX_FORMAT_LEN) {
+        return -1;
+    }
+
+    while (next_spec(&cursor, &spec)) {
+        if (!spec.supported) {
+            return -1;
+        }
+        if (spec.type == 0) {
+            continue;
+        }
+        if (count + spec.stars + 1 > max_types) {
+            return -1;
+        }
+        for (int i = 0; i < spec.stars; i++) {
+            types[count++] = LOG_ARG_INT;
+        }
+        types[count++] = (uint8_t)spec.type;
+    }
+
+    return count;
+}
+
+static inline size_t format_hash(const char *format) {
+    uint64_t h = (uint64_t)(uintptr_t)format * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h >> 32) & (FORMAT_TABLE_SIZE - 1);
+}
+
+// 慢路径：加锁登记新的格式串
+static const LogFormatInfo *format_register(const char *format) {
+    const LogFormatInfo *result = NULL;
+
+    pthread_mutex_lock(&format_mutex);
+
+    size_t index = format_hash(format);
+    for (size_t probe = 0; probe < FORMAT_TABLE_SIZE; probe++) {
+        FormatSlot *slot = &format_table[(index + probe) & (FORMAT_TABLE_SIZE - 1)];
+
+        if (slot->key == format) {
+            result = slot->info;
+            break;
+        }
+        if (slot->key == NULL) {
+            if (format_count >= LOG_BINARY_MAX_FORMATS) {
+                break;
+            }
+
+            LogFormatInfo *info = &format_infos[format_count];
+            int count = log_format_parse(format, info->types, LOG_BINARY_MAX_ARGS);
+
+            info->format = format;
+            info->id = format_count;
+            info->binary_ok = count >= 0;
+            info->arg_count = (uint16_t)(count > 0 ? count : 0);
+
+            // 先发布信息再发布键，无锁读者看到键时信息已完整
+            slot->info = info;
+            __atomic_store_n(&format_count, format_count + 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&slot->key, format, __ATOMIC_RELEASE);
+            result = info;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&format_mutex);
+    return result;
+}
+
+// 按格式串地址查找
+const LogFormatInfo *log_format_lookup(const char *format) {
+    size_t index = format_hash(format);
+
+    for (size_t probe = 0; probe < FORMAT_TABLE_SIZE; probe++) {
+        FormatSlot *slot = &format_table[(index + probe) & (FORMAT_TABLE_SIZE - 1)];
+        const char *key = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+        if (key == format) {
+            return slot->info;
+        }
+        if (key == NULL) {
+            break;
+        }
+    }
+
+    return format_register(format);
+}
+
+const LogFormatInfo *log_format_get(uint32_t id) {
+    if (id >= __atomic_load_n(&format_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    return &format_infos[id];
+}
+
+static inline void put_u64(uint8_t *p, uint64_t value) {
+    memcpy(p, &value, sizeof(value));
+}
+
+static inline uint64_t get_u64(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// 无符号变长编码（每字节 7 位），返回写入的字节数
+static inline size_t put_varint(uint8_t *p, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+// 读取变长编码，数据不完整或超长时返回 0
+static inline size_t get_varint(const uint8_t *p, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    size_t n = 0;
+
+    for (int shift = 0; shift < 64 && p + n < end; shift += 7) {
+        uint8_t byte = p[n++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return n;
+        }
+    }
+    return 0;
+}
+
+// zigzag：让绝对值小的负数也只占少量字节
+static inline uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+// 记录的校验和：crc 字段之前的记录头，接着是负载
+static uint32_t record_crc(const uint8_t *record, size_t length) {
+    uint32_t crc = crc32c(0, record, offsetof(LogRecordHeader, crc));
+    return crc32c(crc, record + sizeof(LogRecordHeader), length - sizeof(LogRecordHeader));
+}
+
+// 负载写好之后调用：填写记录头并计算校验和
+static void fill_header(uint8_t *buf, size_t length, int type, LogLevel level,
+                        uint32_t format_id, int64_t timestamp) {
+    LogRecordHeader header;
+
+    header.sync = LOG_RECORD_SYNC;
+    header.length = (uint16_t)length;
+    header.type = (uint8_t)type;
+    header.level = (uint8_t)clamp_level(level);
+    header.format_id = (uint16_t)format_id;
+    header.timestamp_ns = timestamp;
+    header.crc = 0;
+    memcpy(buf, &header, sizeof(header));
+    header.crc = record_crc(buf, length);
+    memcpy(buf + offsetof(LogRecordHeader, crc), &header.crc, sizeof(header.crc));
+}
+
+// 编码一条事件：参数按类型原样拷贝
+size_t log_binary_encode_event(uint8_t *buf, size_t size, LogLevel level, int64_t timestamp,
+                               const LogFormatInfo *info, va_list args) {
+    uint8_t *p = buf + sizeof(LogRecordHeader);
+    uint8_t *end;
+
+    if (size > LOG_BINARY_RECORD_MAX) {
+        size = LOG_BINARY_RECORD_MAX;
+    }
+    if (size < sizeof(LogRecordHeader) + (size_t)info->arg_count * 10) {
+        return 0;
+    }
+    end = buf + size;
+
+    for (int i = 0; i < info->arg_count; i++) {
+        int64_t value;
+
+        switch (info->types[i]) {
+            case LOG_ARG_INT: value = va_arg(args, int); break;
+            case LOG_ARG_LONG: value = va_arg(args, long); break;
+            case LOG_ARG_LLONG: value = va_arg(args, long long); break;
+            case LOG_ARG_SIZE: value = (int64_t)va_arg(args, size_t); break;
+            case LOG_ARG_INTMAX: value = va_arg(args, intmax_t); break;
+            case LOG_ARG_PTRDIFF: value = va_arg(args, ptrdiff_t); break;
+            case LOG_ARG_POINTER:
+                put_u64(p, (uint64_t)(uintptr_t)va_arg(args, void *));
+                p += 8;
+                continue;
+            case LOG_ARG_DOUBLE: {
+                double d = va_arg(args, double);
+                memcpy(p, &d, sizeof(d));
+                p += 8;
+                continue;
+            }
+            case LOG_ARG_STRING: {
+                const char *s = va_arg(args, const char *);
+                if (!s) {
+                    s = "(null)";
+                }
+                // 为后面的参数预留最坏情况的空间，超长字符串截断
+                size_t reserve = (size_t)(info->arg_count - i - 1) * 10 + 5;
+                size_t room = (size_t)(end - p) > reserve ? (size_t)(end - p) - reserve : 0;
+                size_t n = strnlen(s, room);
+                p += put_varint(p, n);
+                memcpy(p, s, n);
+                p += n;
+                continue;
+            }
+            default:
+                return 0;
+        }
+
+        p += put_varint(p, zigzag_encode(value));
+    }
+
+    size_t length = (size_t)(p - buf);
+    fill_header(buf, length, LOG_RECORD_EVENT, level, info->id, timestamp);
+    return length;
+}
+
+// 编码一条已格式化的消息
+size_t log_binary_encode_text(uint8_t *buf, size_t size, LogLevel level, int64_t timestamp,
+                              const char *text, size_t length) {
+    if (size > LOG_BINARY_RECORD_MAX) {
+        size = LOG_BINARY_RECORD_MAX;
+    }
+    if (size < sizeof(LogRecordHeader)) {
+        return 0;
+    }
+    if (length > size - sizeof(LogRecordHeader)) {
+        length = size - sizeof(LogRecordHeader);
+    }
+
+    memcpy(buf + sizeof(LogRecordHeader), text, length);
+    length += sizeof(LogRecordHeader);
+    fill_header(buf, length, LOG_RECORD_TEXT, level, 0, timestamp);
+    return length;
+}
+
+// 编码格式串定义
+size_t log_binary_encode_format(uint8_t *buf, size_t size, const LogFormatInfo *info) {
+    size_t format_length = strlen(info->format) + 1;
+    size_t length = sizeof(LogRecordHeader) + 1 + info->arg_count + format_length;
+    uint8_t *p = buf + sizeof(LogRecordHeader);
+
+    if (length > size) {
+        return 0;
+    }
+
+    p[0] = (uint8_t)info->arg_count;
+    memcpy(p + 1, info->types, info->arg_count);
+    memcpy(p + 1 + info->arg_count, info->format, format_length);
+    fill_header(buf, length, LOG_RECORD_FORMAT, LOG_DEBUG, info->id, 0);
+    return length;
+}
+
+// 按格式串和原始参数渲染消息，返回长度（不含 NUL）
+static size_t render_message(const char *format, const uint8_t *types, int arg_count,
+                             const uint8_t *payload, size_t payload_length,
+                             char *out, size_t size) {
+    const char *cursor = format;
+    const uint8_t *p = payload;
+    const uint8_t *end = payload + payload_length;
+    size_t used = 0;
+    int arg = 0;
+    FormatSpec spec;
+    char string_arg[LOG_BINARY_RECORD_MAX];
+
+    if (size == 0) {
+        return 0;
+    }
+
+#define EMIT(...) do {                                              \
+        int n_ = snprintf(out + used, size - used, __VA_ARGS__);    \
+        if (n_ > 0) {                                               \
+            used += (size_t)n_;                                     \
+            if (used >= size) used = size - 1;                      \
+        }                                                           \
+    } while (0)
+
+// 根据 '*' 的个数把宽度/精度一并传给 snprintf
+#define EMIT_VALUE(spec_text, value) do {                                       \
+        if (spec.stars == 0) EMIT(spec_text, value);                            \
+        else if (spec.stars == 1) EMIT(spec_text, stars[0], value);             \
+        else EMIT(spec_text, stars[0], stars[1], value);                        \
+    } while (0)
+
+    for (;;) {
+        const char *literal = cursor;
+        int found = next_spec(&cursor, &spec);
+        const char *literal_end = found ? spec.start : literal + strlen(literal);
+
+        EMIT("%.*s", (int)(literal_end - literal), literal);
+        if (!found) {
+            break;
+        }
+        if (spec.type == 0 && spec.supported) {
+            EMIT("%%");
+            continue;
+        }
+        if (!spec_renderable(&spec)) {
+            goto done;
+        }
+
+        int stars[2] = {0, 0};
+        for (int i = 0; i < spec.stars; i++) {
+            uint64_t raw;
+            size_t n = get_varint(p, end, &raw);
+            if (arg >= arg_count || types[arg] != LOG_ARG_INT || n == 0) {
+                goto done;
+            }
+            stars[i] = (int)zigzag_decode(raw);
+            p += n;
+            arg++;
+        }
+
+        char spec_text[FORMAT_SPEC_MAX];
+        size_t spec_length = (size_t)(spec.end - spec.start);
+        if (arg >= arg_count || types[arg] != spec.type || spec_length >= sizeof(spec_text)) {
+            goto done;
+        }
+        memcpy(spec_text, spec.start, spec_length);
+        spec_text[spec_length] = '\0';
+        arg++;
+
+        if (spec.type == LOG_ARG_STRING) {
+            uint64_t n;
+            size_t used_bytes = get_varint(p, end, &n);
+            if (used_bytes == 0) {
+                goto done;
+            }
+            p += used_bytes;
+            if ((uint64_t)(end - p) < n || n >= sizeof(string_arg)) {
+                goto done;
+            }
+            memcpy(string_arg, p, (size_t)n);
+            string_arg[n] = '\0';
+            p += n;
+            EMIT_VALUE(spec_text, string_arg);
+            continue;
+        }
+
+        uint64_t value;
+        if (spec.type == LOG_ARG_POINTER || spec.type == LOG_ARG_DOUBLE) {
+            if (end - p < 8) {
+                goto done;
+            }
+            value = get_u64(p);
+            p += 8;
+        } else {
+            size_t n = get_varint(p, end, &value);
+            if (n == 0) {
+                goto done;
+            }
+            value = (uint64_t)zigzag_decode(value);
+            p += n;
+        }
+
+        switch (spec.type) {
+            case LOG_ARG_INT: EMIT_VALUE(spec_text, (int)value); break;
+            case LOG_ARG_LONG: EMIT_VALUE(spec_text, (long)value); break;
+            case LOG_ARG_LLONG: EMIT_VALUE(spec_text, (long long)value); break;
+            case LOG_ARG_SIZE: EMIT_VALUE(spec_text, (size_t)value); break;
+            case LOG_ARG_INTMAX: EMIT_VALUE(spec_text, (intmax_t)value); break;
+            case LOG_ARG_PTRDIFF: EMIT_VALUE(spec_text, (ptrdiff_t)value); break;
+            case LOG_ARG_POINTER: EMIT_VALUE(spec_text, (void *)(uintptr_t)value); break;
+            case LOG_ARG_DOUBLE: {
+                double d;
+                memcpy(&d, &value, sizeof(d));
+                EMIT_VALUE(spec_text, d);
+                break;
+            }
+            default:
+                goto done;
+        }
+    }
+
+done:
+#undef EMIT_VALUE
+#undef EMIT
+    out[used] = '\0';
+    return used;
+}
+
+// 格式化时间戳
+void log_binary_format_time(int64_t wall_ns, char *out, size_t size) {
+    time_t sec = (time_t)(wall_ns / 1000000000LL);
+    long msec = (long)((wall_ns % 1000000000LL) / 1000000);
+    struct tm tm_info;
+    char stamp[32];
+
+    if (msec < 0) {
+        sec--;
+        msec += 1000;
+    }
+
+    localtime_r(&sec, &tm_info);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_info);
+    snprintf(out, size, "%s.%03ld", stamp, msec);
+}
+
+// 格式化为文本行
+size_t log_binary_format_line(const LogBinaryEvent *event, char *out, size_t size) {
+    char stamp[48];
+
+    log_binary_format_time(event->wall_ns, stamp, sizeof(stamp));
+    int n = snprintf(out, size, "[%s] [%s] %.*s\n", stamp, level_names[clamp_level(event->level)],
+                     (int)event->message_length, event->message);
+    if (n < 0) {
+        return 0;
+    }
+    if ((size_t)n >= size) {
+        // 截断时仍以换行结尾
+        n = (int)size - 1;
+        out[n - 1] = '\n';
+    }
+    return (size_t)n;
+}
+
+// 使用进程内格式串表渲染一条记录（控制台输出用）
+size_t log_binary_record_to_line(const uint8_t *record, size_t length, int64_t wall_offset_ns,
+                                 char *out, size_t size) {
+    LogRecordHeader header;
+    LogBinaryEvent event;
+    char message[LOG_BINARY_RECORD_MAX];
+
+    if (length < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, record, sizeof(header));
+
+    const uint8_t *payload = record + sizeof(header);
+    size_t payload_length = length - sizeof(header);
+
+    if (header.type == LOG_RECORD_EVENT) {
+        const LogFormatInfo *info = log_format_get(header.format_id);
+        if (!info) {
+            return 0;
+        }
+        event.message_length = render_message(info->format, info->types, info->arg_count,
+                                              payload, payload_length, message, sizeof(message));
+    } else if (header.type == LOG_RECORD_TEXT) {
+        event.message_length = payload_length < sizeof(message) ? payload_length : sizeof(message) - 1;
+        memcpy(message, payload, event.message_length);
+    } else {
+        return 0;
+    }
+
+    event.level = (LogLevel)header.level;
+    event.wall_ns = header.timestamp_ns + wall_offset_ns;
+    event.format_id = header.format_id;
+    event.message = message;
+    return log_binary_format_line(&event, out, size);
+}
+
+/* ---------------- 解码器 ---------------- */
+
+void log_binary_decoder_init(LogBinaryDecoder *decoder) {
+    memset(decoder, 0, sizeof(LogBinaryDecoder));
+}
+
+void log_binary_decoder_free(LogBinaryDecoder *decoder) {
+    if (!decoder) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < decoder->format_capacity; i++) {
+        free(decoder->formats[i].format);
+    }
+    free(decoder->formats);
+    decoder->formats = NULL;
+    decoder->format_capacity = 0;
+}
+
+// 记录格式串定义；同一编号在新文件中会重新定义，直接覆盖
+static int decoder_define(LogBinaryDecoder *decoder, const LogRecordHeader *header,
+                          const uint8_t *payload, size_t payload_length) {
+    uint32_t id = header->format_id;
+    uint8_t arg_count = payload_length > 0 ? payload[0] : 0;
+
+    if (payload_length == 0 || arg_count > LOG_BINARY_MAX_ARGS ||
+        payload_length <= 1u + arg_count ||
+        !memchr(payload + 1 + arg_count, '\0', payload_length - 1 - arg_count)) {
+        return -1;
+    }
+
+    if (id >= decoder->format_capacity) {
+        uint32_t capacity = decoder->format_capacity ? decoder->format_capacity : 64;
+        while (capacity <= id) {
+            capacity *= 2;
+        }
+
+        LogDecodedFormat *formats = realloc(decoder->formats, capacity * sizeof(LogDecodedFormat));
+        if (!formats) {
+            return -1;
+        }
+        memset(formats + decoder->format_capacity, 0,
+               (capacity - decoder->format_capacity) * sizeof(LogDecodedFormat));
+        decoder->formats = formats;
+        decoder->format_capacity = capacity;
+    }
+
+    LogDecodedFormat *entry = &decoder->formats[id];
+    char *format = strdup((const char *)payload + 1 + arg_count);
+    if (!format) {
+        return -1;
+    }
+
+    free(entry->format);
+    entry->format = format;
+    entry->arg_count = arg_count;
+    memcpy(entry->types, payload + 1, arg_count);
+    return 0;
+}
+
+// 解码一条记录
+long log_binary_decode(LogBinaryDecoder *decoder, const uint8_t *data, size_t length,
+                       LogBinaryEvent *event, int *has_event) {
+    LogRecordHeader header;
+
+    *has_event = 0;
+
+    if (log_binary_check_magic(data, length)) {
+        LogBinaryHeader file_header;
+        if (length < sizeof(file_header)) {
+            return 0;
+        }
+        memcpy(&file_header, data, sizeof(file_header));
+        if (file_header.version != LOG_BINARY_VERSION || file_header.header_size < sizeof(file_header)) {
+            return -1;
+        }
+        if (length < file_header.header_size) {
+            return 0;
+        }
+        decoder->wall_base_ns = file_header.wall_base_ns;
+        decoder->mono_base_ns = file_header.mono_base_ns;
+        decoder->have_header = 1;
+        return (long)file_header.header_size;
+    }
+
+    if (length < sizeof(header)) {
+        return 0;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.sync != LOG_RECORD_SYNC || header.length < sizeof(header) ||
+        header.length > LOG_BINARY_RECORD_MAX + sizeof(header)) {
+        return -1;
+    }
+    if (length < header.length) {
+        return 0;
+    }
+    if (record_crc(data, header.length) != header.crc) {
+        return -1;
+    }
+
+    const uint8_t *payload = data + sizeof(header);
+    size_t payload_length = header.length - sizeof(header);
+
+    switch (header.type) {
+        case LOG_RECORD_FORMAT:
+            if (decoder_define(decoder, &header, payload, payload_length) != 0) {
+                return -1;
+            }
+            return (long)header.length;
+
+        case LOG_RECORD_EVENT:
+            if (header.format_id < decoder->format_capacity && decoder->formats[header.format_id].format) {
+                const LogDecodedFormat *format = &decoder->formats[header.format_id];
+                event->message_length = render_message(format->format, format->types, format->arg_count,
+                                                       payload, payload_length,
+                                                       decoder->message, sizeof(decoder->message));
+            } else {
+                event->message_length = (size_t)snprintf(decoder->message, sizeof(decoder->message),
+                                                         "<unknown format #%u>", header.format_id);
+            }
+            break;
+
+        case LOG_RECORD_TEXT:
+            event->message_length = payload_length < sizeof(decoder->message) ?
+                                    payload_length : sizeof(decoder->message) - 1;
+            memcpy(decoder->message, payload, event->message_length);
+            decoder->message[event->message_length] = '\0';
+            break;
+
+        default:
+            // 未知记录类型：跳过，兼容以后新增的类型
+            return (long)header.length;
+    }
+
+    event->level = clamp_level(header.level);
+    event->wall_ns = header.timestamp_ns - decoder->mono_base_ns + decoder->wall_base_ns;
+    event->format_id = header.format_id;
+    event->message = decoder->message;
+    *has_event = 1;
+    return (long)header.length;
+}
+
+// 在损坏的记录之后寻找下一个可以解码的位置
+size_t log_binary_resync(LogBinaryDecoder *decoder, const uint8_t *data, size_t length) {
+    const uint16_t sync = LOG_RECORD_SYNC;
+    size_t offset;
+
+    if (length == 0) {
+        return 0;
+    }
+    for (offset = 1; offset < length; offset++) {
+        const uint8_t *p = data + offset;
+        size_t rest = length - offset;
+
+        // 数据不够判断时停下，交给调用方补齐
+        if (rest < LOG_BINARY_MAGIC_SIZE && memcmp(p, LOG_BINARY_MAGIC, rest) == 0) {
+            break;
+        }
+        if (log_binary_check_magic(p, rest)) {
+            break;
+        }
+        if (rest < sizeof(sync) ? memcmp(p, &sync, rest) != 0 : memcmp(p, &sync, sizeof(sync)) != 0) {
+            continue;
+        }
+
+        LogRecordHeader header;
+        if (rest < sizeof(header)) {
+            break;
+        }
+        memcpy(&header, p, sizeof(header));
+        if (header.length < sizeof(header) || header.length > LOG_BINARY_RECORD_MAX + sizeof(header)) {
+            continue;
+        }
+        if (rest < header.length || record_crc(p, header.length) == header.crc) {
+            break;
+        }
+    }
+
+    if (decoder) {
+        decoder->skipped_bytes += offset;
+    }
+    return offset;
+}
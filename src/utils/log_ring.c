@@ -0,0 +1,124 @@
+// src/utils/log_ring.c
+// 日志记录的多生产者单消费者无锁队列
+//
+// 采用 Vyukov 有界队列：每个槽位带一个序号，生产者在序号等于写入位置时
+// 通过 CAS 占用槽位，写完后把序号加一发布；消费者读取完成后把序号推进
+// 一整圈，交还给生产者。
+#include <stdlib.h>
+#include <string.h>
+#include "log_ring.h"
+
+// 初始化队列
+int log_ring_init(LogRing *ring, size_t capacity) {
+    if (!ring || capacity == 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    memset(ring, 0, sizeof(LogRing));
+    if (posix_memalign((void **)&ring->slots, 64, size * sizeof(LogRingSlot)) != 0) {
+        ring->slots = NULL;
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        ring->slots[i].sequence = i;
+        ring->slots[i].heap_text = NULL;
+    }
+
+    ring->capacity = size;
+    ring->mask = size - 1;
+    return SWK_SUCCESS;
+}
+
+// 销毁队列（调用方保证没有并发访问）
+void log_ring_destroy(LogRing *ring) {
+    if (!ring || !ring->slots) {
+        return;
+    }
+
+    for (size_t i = 0; i < ring->capacity; i++) {
+        free(ring->slots[i].heap_text);
+    }
+
+    free(ring->slots);
+    ring->slots = NULL;
+    ring->capacity = 0;
+}
+
+// 写入一条记录
+int log_ring_push(LogRing *ring, int level, const char *text, size_t length) {
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    LogRingSlot *slot;
+    char *heap_text = NULL;
+
+    // 超长记录先复制到堆上再占用槽位，分配失败时队列保持不变
+    if (length > LOG_RING_INLINE_SIZE) {
+        heap_text = malloc(length);
+        if (!heap_text) {
+            return SWK_ERROR_OUT_OF_MEMORY;
+        }
+        memcpy(heap_text, text, length);
+    }
+
+    for (;;) {
+        slot = &ring->slots[pos & ring->mask];
+        uint64_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            free(heap_text);
+            return SWK_ERROR;
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->level = level;
+    slot->heap_text = heap_text;
+    if (!heap_text) {
+        memcpy(slot->text, text, length);
+    }
+    slot->length = (uint32_t)length;
+
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    return SWK_SUCCESS;
+}
+
+// 查看已就绪的记录
+LogRingSlot *log_ring_peek(LogRing *ring, size_t index) {
+    uint64_t pos = ring->head + index;
+    LogRingSlot *slot = &ring->slots[pos & ring->mask];
+
+    if (index >= ring->capacity ||
+        __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != pos + 1) {
+        return NULL;
+    }
+
+    return slot;
+}
+
+// 释放队头的记录
+void log_ring_release(LogRing *ring, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t pos = ring->head;
+        LogRingSlot *slot = &ring->slots[pos & ring->mask];
+
+        if (slot->heap_text) {
+            free(slot->heap_text);
+            slot->heap_text = NULL;
+        }
+
+        __atomic_store_n(&slot->sequence, pos + ring->capacity, __ATOMIC_RELEASE);
+        __atomic_store_n(&ring->head, pos + 1, __ATOMIC_RELEASE);
+    }
+}
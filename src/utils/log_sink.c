@@ -0,0 +1,463 @@
+// src/utils/log_sink.c
+// 终端、unix 套接字与内存环汇点（文件汇点与轮转紧密相关，在 logger.c 中实现）
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include "log_sink.h"
+
+#define LOG_SINK_BATCH 128            // 单次系统调用处理的最大记录数
+
+static const char *const tty_colors[] = {
+    "\033[36m", "\033[32m", "\033[33m", "\033[31m", "\033[35m"
+};
+static const char tty_reset[] = "\033[0m\n";
+
+// journald 的 PRIORITY 字段（syslog 级别）
+static const char *const journal_priorities[] = {
+    "PRIORITY=7\n", "PRIORITY=6\n", "PRIORITY=4\n", "PRIORITY=3\n", "PRIORITY=2\n"
+};
+static const char journal_identifier[] = "SYSLOG_IDENTIFIER=swikernel\n";
+static const char journal_message[] = "MESSAGE=";
+
+static inline int clamp_level(LogLevel level) {
+    return level > LOG_FATAL ? LOG_FATAL : (int)level;
+}
+
+// 完整写出 iovec 数组；套接字用 sendmsg 以免对端关闭时收到 SIGPIPE
+static ssize_t send_all(int fd, struct iovec *iov, int count, int is_socket) {
+    ssize_t total = 0;
+
+    while (count > 0) {
+        ssize_t n;
+        if (is_socket) {
+            struct msghdr msg = {0};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = (size_t)(count > IOV_MAX ? IOV_MAX : count);
+            n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        } else {
+            n = writev(fd, iov, count > IOV_MAX ? IOV_MAX : count);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += n;
+
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+
+    return total;
+}
+
+// 文本行中 "[时间] [级别] " 之后的消息部分
+static const char *text_body(const char *text, size_t length, size_t *body_length) {
+    const char *end = text + length;
+    const char *p = text;
+
+    for (int i = 0; i < 2 && p < end; i++) {
+        const char *close = memchr(p, ']', (size_t)(end - p));
+        if (!close) {
+            p = text;
+            break;
+        }
+        p = close + 1;
+    }
+    while (p < end && *p == ' ') {
+        p++;
+    }
+
+    *body_length = (size_t)(end - p);
+    if (*body_length > 0 && p[*body_length - 1] == '\n') {
+        (*body_length)--;
+    }
+    return p;
+}
+
+/* ---------------- 终端 ---------------- */
+
+typedef struct {
+    LogSink base;
+    int fd;
+    int color;
+} TtySink;
+
+static size_t tty_write(LogSink *sink, const LogSinkRecord *records, size_t count) {
+    TtySink *tty = (TtySink *)sink;
+    struct iovec iov[LOG_SINK_BATCH * 3];
+    int used = 0;
+    size_t written = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const LogSinkRecord *record = &records[i];
+        if (!log_sink_accepts(sink, record->level) || !record->text || record->text_length == 0) {
+            continue;
+        }
+
+        if (used + 3 > (int)(sizeof(iov) / sizeof(iov[0]))) {
+            send_all(tty->fd, iov, used, 0);
+            used = 0;
+        }
+
+        if (tty->color) {
+            const char *color = tty_colors[clamp_level(record->level)];
+            iov[used++] = (struct iovec){(void *)color, strlen(color)};
+            iov[used++] = (struct iovec){(void *)record->text, record->text_length - 1};
+            iov[used++] = (struct iovec){(void *)tty_reset, sizeof(tty_reset) - 1};
+        } else {
+            iov[used++] = (struct iovec){(void *)record->text, record->text_length};
+        }
+        written++;
+    }
+
+    if (used > 0) {
+        send_all(tty->fd, iov, used, 0);
+    }
+    return written;
+}
+
+static void tty_destroy(LogSink *sink) {
+    free(sink);
+}
+
+static const LogSinkOps tty_ops = {"tty", 1, tty_write, tty_destroy};
+
+// 创建终端汇点
+LogSink *log_sink_tty_create(int fd) {
+    TtySink *tty = calloc(1, sizeof(TtySink));
+    if (!tty) {
+        return NULL;
+    }
+
+    tty->base.ops = &tty_ops;
+    tty->base.enabled = 1;
+    tty->base.min_level = LOG_DEBUG;
+    tty->fd = fd;
+    tty->color = isatty(fd);
+    return &tty->base;
+}
+
+/* ---------------- unix 套接字 ---------------- */
+
+typedef struct {
+    LogSink base;
+    int fd;
+    LogSocketMode mode;
+    struct sockaddr_un addr;
+    int64_t retry_ns;        // 断开后下一次尝试重连的时间
+} SocketSink;
+
+static int64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int socket_connect(SocketSink *sock) {
+    int type = sock->mode == LOG_SOCKET_STREAM ? SOCK_STREAM : SOCK_DGRAM;
+    int fd = socket(AF_UNIX, type | SOCK_CLOEXEC, 0);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (connect(fd, (struct sockaddr *)&sock->addr, sizeof(sock->addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // 流式连接阻塞发送，但收集器卡住时最多等 100ms，不拖住写线程
+    if (type == SOCK_STREAM) {
+        struct timeval timeout = {0, 100000};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    sock->fd = fd;
+    return 0;
+}
+
+static void socket_disconnect(SocketSink *sock) {
+    if (sock->fd >= 0) {
+        close(sock->fd);
+        sock->fd = -1;
+    }
+    sock->retry_ns = monotonic_ns() + LOG_SOCKET_RETRY_NS;
+}
+
+// 数据报与 journal：每条记录一个数据报，一次 sendmmsg 发出整批
+static size_t socket_send_datagrams(SocketSink *sock, const LogSinkRecord *records, size_t count) {
+    struct mmsghdr messages[LOG_SINK_BATCH];
+    struct iovec iov[LOG_SINK_BATCH * 5];
+    int journal = sock->mode == LOG_SOCKET_JOURNAL;
+    size_t queued = 0, sent = 0;
+    int used = 0;
+
+    memset(messages, 0, sizeof(messages));
+
+    for (size_t i = 0; i <= count; i++) {
+        if (i < count) {
+            const LogSinkRecord *record = &records[i];
+            if (!log_sink_accepts(&sock->base, record->level) || !record->text) {
+                continue;
+            }
+
+            struct iovec *first = &iov[used];
+            if (journal) {
+                size_t body_length;
+                const char *body = text_body(record->text, record->text_length, &body_length);
+                const char *priority = journal_priorities[clamp_level(record->level)];
+                iov[used++] = (struct iovec){(void *)priority, strlen(priority)};
+                iov[used++] = (struct iovec){(void *)journal_identifier, sizeof(journal_identifier) - 1};
+                iov[used++] = (struct iovec){(void *)journal_message, sizeof(journal_message) - 1};
+                iov[used++] = (struct iovec){(void *)body, body_length};
+                iov[used++] = (struct iovec){"\n", 1};
+            } else {
+                iov[used++] = (struct iovec){(void *)record->text, record->text_length - 1};
+            }
+            messages[queued].msg_hdr.msg_iov = first;
+            messages[queued].msg_hdr.msg_iovlen = (size_t)(&iov[used] - first);
+            queued++;
+
+            if (queued < LOG_SINK_BATCH) {
+                continue;
+            }
+        }
+
+        // 队列满时丢弃而不是等待，日志不能拖慢写线程
+        size_t offset = 0;
+        while (offset < queued) {
+            int n = sendmmsg(sock->fd, messages + offset, (unsigned)(queued - offset), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                __atomic_add_fetch(&sock->base.dropped, queued - offset, __ATOMIC_RELAXED);
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    socket_disconnect(sock);
+                    return sent;
+                }
+                break;
+            }
+            offset += (size_t)n;
+            sent += (size_t)n;
+        }
+
+        queued = 0;
+        used = 0;
+    }
+
+    return sent;
+}
+
+// 流式：整批拼成一次 sendmsg
+static size_t socket_send_stream(SocketSink *sock, const LogSinkRecord *records, size_t count) {
+    struct iovec iov[LOG_SINK_BATCH];
+    int used = 0;
+    size_t sent = 0;
+
+    for (size_t i = 0; i <= count; i++) {
+        if (i < count) {
+            const LogSinkRecord *record = &records[i];
+            if (!log_sink_accepts(&sock->base, record->level) || !record->text) {
+                continue;
+            }
+            iov[used++] = (struct iovec){(void *)record->text, record->text_length};
+            if (used < LOG_SINK_BATCH) {
+                continue;
+            }
+        }
+
+        if (used > 0) {
+            if (send_all(sock->fd, iov, used, 1) < 0) {
+                __atomic_add_fetch(&sock->base.dropped, (uint64_t)used, __ATOMIC_RELAXED);
+                socket_disconnect(sock);
+                return sent;
+            }
+            sent += (size_t)used;
+            used = 0;
+        }
+    }
+
+    return sent;
+}
+
+static size_t socket_write(LogSink *sink, const LogSinkRecord *records, size_t count) {
+    SocketSink *sock = (SocketSink *)sink;
+
+    // 收集器重启后自动重连，间隔内直接丢弃
+    if (sock->fd < 0) {
+        if (monotonic_ns() < sock->retry_ns || socket_connect(sock) != 0) {
+            sock->retry_ns = monotonic_ns() + LOG_SOCKET_RETRY_NS;
+            for (size_t i = 0; i < count; i++) {
+                if (log_sink_accepts(sink, records[i].level)) {
+                    __atomic_add_fetch(&sink->dropped, 1, __ATOMIC_RELAXED);
+                }
+            }
+            return 0;
+        }
+    }
+
+    if (sock->mode == LOG_SOCKET_STREAM) {
+        return socket_send_stream(sock, records, count);
+    }
+    return socket_send_datagrams(sock, records, count);
+}
+
+static void socket_destroy(LogSink *sink) {
+    SocketSink *sock = (SocketSink *)sink;
+
+    if (sock->fd >= 0) {
+        close(sock->fd);
+    }
+    free(sock);
+}
+
+static const LogSinkOps socket_ops = {"socket", 1, socket_write, socket_destroy};
+
+// 创建套接字汇点（创建时必须能连上）
+LogSink *log_sink_socket_create(const char *path, LogSocketMode mode) {
+    if (!path || strlen(path) >= sizeof(((struct sockaddr_un *)0)->sun_path)) {
+        return NULL;
+    }
+
+    SocketSink *sock = calloc(1, sizeof(SocketSink));
+    if (!sock) {
+        return NULL;
+    }
+
+    sock->base.ops = &socket_ops;
+    sock->base.enabled = 1;
+    sock->base.min_level = LOG_DEBUG;
+    sock->fd = -1;
+    sock->mode = mode;
+    sock->addr.sun_family = AF_UNIX;
+    strcpy(sock->addr.sun_path, path);
+
+    if (socket_connect(sock) != 0) {
+        free(sock);
+        return NULL;
+    }
+    return &sock->base;
+}
+
+/* ---------------- 内存环 ---------------- */
+
+typedef struct {
+    LogLevel level;
+    uint32_t length;
+    char line[LOG_MEMORY_LINE_SIZE];
+} MemorySlot;
+
+typedef struct {
+    LogSink base;
+    MemorySlot *slots;
+    size_t capacity;
+    uint64_t next;           // 下一条记录的序号
+} MemorySink;
+
+static size_t memory_write(LogSink *sink, const LogSinkRecord *records, size_t count) {
+    MemorySink *memory = (MemorySink *)sink;
+    size_t written = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const LogSinkRecord *record = &records[i];
+        if (!log_sink_accepts(sink, record->level) || !record->text || record->text_length == 0) {
+            continue;
+        }
+
+        MemorySlot *slot = &memory->slots[memory->next % memory->capacity];
+        size_t length = record->text_length;
+
+        // 截断的行仍以换行结尾
+        if (length > sizeof(slot->line)) {
+            memcpy(slot->line, record->text, sizeof(slot->line) - 1);
+            slot->line[sizeof(slot->line) - 1] = '\n';
+            length = sizeof(slot->line);
+        } else {
+            memcpy(slot->line, record->text, length);
+        }
+        slot->level = record->level;
+        slot->length = (uint32_t)length;
+        memory->next++;
+        written++;
+    }
+
+    return written;
+}
+
+static void memory_destroy(LogSink *sink) {
+    MemorySink *memory = (MemorySink *)sink;
+
+    free(memory->slots);
+    free(memory);
+}
+
+static const LogSinkOps memory_ops = {"memory", 1, memory_write, memory_destroy};
+
+// 创建内存环汇点
+LogSink *log_sink_memory_create(size_t capacity) {
+    if (capacity == 0) {
+        return NULL;
+    }
+
+    MemorySink *memory = calloc(1, sizeof(MemorySink));
+    if (!memory) {
+        return NULL;
+    }
+
+    memory->slots = calloc(capacity, sizeof(MemorySlot));
+    if (!memory->slots) {
+        free(memory);
+        return NULL;
+    }
+
+    memory->base.ops = &memory_ops;
+    memory->base.enabled = 1;
+    memory->base.min_level = LOG_DEBUG;
+    memory->capacity = capacity;
+    return &memory->base;
+}
+
+// 读取内存环
+uint64_t log_sink_memory_read(LogSink *sink, uint64_t cursor, LogMemoryCallback callback, void *context) {
+    if (!sink || sink->ops != &memory_ops || !callback) {
+        return cursor;
+    }
+
+    MemorySink *memory = (MemorySink *)sink;
+    uint64_t oldest = memory->next > memory->capacity ? memory->next - memory->capacity : 0;
+
+    if (cursor < oldest) {
+        cursor = oldest;
+    }
+    for (; cursor < memory->next; cursor++) {
+        const MemorySlot *slot = &memory->slots[cursor % memory->capacity];
+        callback(slot->level, slot->line, slot->length, context);
+    }
+
+    return cursor;
+}
+
+// 销毁汇点
+void log_sink_destroy(LogSink *sink) {
+    if (sink && sink->ops && sink->ops->destroy) {
+        sink->ops->destroy(sink);
+    }
+}
@@ -1,159 +1,1511 @@
 // src/utils/logger.c
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <time.h>
 #include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
 #include <sys/stat.h>
-#include <sys/time.h>
+#include <dirent.h>
+#include <libgen.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <pthread.h>
 #include "logger.h"
-#include "system.h"
+#include "log_ring.h"
+#include "log_binary.h"
+#include "log_archive.h"
+#include "log_sink.h"
+#include "fast_hash.h"
 
 #define LOG_BUFFER_SIZE 4096
 #define MAX_LOG_FILES 10
 #define MAX_LOG_SIZE (10 * 1024 * 1024) // 10MB
 
+#define LOG_DEFAULT_QUEUE_SIZE 4096
+#define LOG_WRITER_BATCH 64          // 每次 writev 的最大记录数
+#define LOG_WRITER_IDLE_NS 50000000L  // 写线程的最长休眠时间，决定普通记录的最大落盘延迟
+#define LOG_ROUTE_MAX (LOG_WRITER_BATCH * 2)  // 一次分发的最大记录数（含重复摘要）
+
+#define LOG_RATE_SLOTS 1024          // 限流表大小（按调用点地址直接映射）
+#define LOG_RATE_MAX 1000000         // 每秒令牌数上限
+#define LOG_SUMMARY_SIZE 160         // 重复摘要记录的最大长度
+
+// 一个调用点的令牌桶；映射到同一槽位的其他调用点会接管槽位并重新计数
+typedef struct {
+    const char *site;               // 格式串地址
+    uint32_t lock;
+    uint32_t tokens;
+    int64_t refill_ns;              // 上次补充令牌的单调时钟时间
+    uint64_t suppressed;            // 上次放行以来被抑制的条数
+} LogRateSlot;
+
+// 等待后台归档的日志段
+typedef struct PendingSegment {
+    struct PendingSegment *next;
+    char path[300];
+    int max_files;
+    int compress;
+} PendingSegment;
+
 typedef struct {
-    FILE *file;
+    int fd;
     char filename[256];
     LogLevel level;
+    int subsystem_levels[LOG_SUBSYS_COUNT];  // -1 表示跟随全局级别
     int rotate;
-    pthread_mutex_t mutex;
+    size_t max_size;
+    int max_files;
+    size_t file_size;               // 在内存中跟踪，不再每次 stat
+    pthread_mutex_t mutex;          // 保护文件描述符与轮转
+
+    // 二进制格式
+    LogFileFormat format;
+    int64_t wall_offset_ns;         // 当前文件头记录的墙钟与单调时钟之差
+    uint8_t format_emitted[LOG_BINARY_MAX_FORMATS / 8];  // 当前文件中已写出定义的格式串
+
+    // 后台归档：轮转时只把当前文件改名，重命名链和压缩由归档线程完成
+    int compress;
+    uint64_t rotation_seq;
+    pthread_t archiver;
+    int archiver_running;
+    int archive_stop;
+    int archive_busy;
+    PendingSegment *pending_head;
+    PendingSegment *pending_tail;
+    pthread_mutex_t archive_mutex;  // 保护待归档队列；同时持有时 mutex 在前
+    pthread_cond_t archive_cond;
+    pthread_cond_t archive_idle;
+
+    // 异步模式
+    int async;
+    LogOverflowPolicy overflow;
+    LogRing ring;
+    pthread_t writer;
+    int stop;
+    int rotate_requested;
+    uint32_t wake_seq;              // futex 唤醒序号
+    uint32_t writer_sleeping;
+
+    // 限流与重复合并
+    uint32_t rate_limit;            // 每个调用点每秒放行的记录数，0 表示不限流
+    uint32_t rate_burst;
+    int coalesce;
+    int have_last;                  // last_key 是否有效
+    uint64_t last_key;              // 上一条写出记录去掉时间戳后的指纹
+    LogLevel last_level;
+    uint64_t repeat_count;          // 上一条记录之后被合并的重复次数
+
+    // 输出端：文件汇点内嵌，其余按需创建，都在 mutex 下写出
+    LogSink file_sink;
+    LogSink *sinks[LOG_SINK_COUNT];
+    char *render_buffer;            // 二进制记录渲染出的文本，按需分配
+
+    LoggerStats stats;
 } Logger;
 
-static Logger logger = {0};
+static size_t file_sink_write(LogSink *sink, const LogSinkRecord *records, size_t count);
+
+static const LogSinkOps file_sink_ops = {"file", 0, file_sink_write, NULL};
+
+static Logger logger = {
+    .fd = -1,
+    .subsystem_levels = {-1, -1, -1, -1, -1, -1},
+    .max_size = MAX_LOG_SIZE,
+    .max_files = MAX_LOG_FILES,
+    .compress = 1,
+    .file_sink = {&file_sink_ops, 1, LOG_DEBUG, 0, 0},
+    .sinks = {&logger.file_sink},
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .archive_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .archive_cond = PTHREAD_COND_INITIALIZER,
+    .archive_idle = PTHREAD_COND_INITIALIZER
+};
+
+// 初始全局级别为 DEBUG（0），与 logger.level 一致
+uint8_t logger_thresholds[LOG_SUBSYS_COUNT];
+
+static LogRateSlot rate_slots[LOG_RATE_SLOTS];
+
+static const char *const level_names[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+static const char *const subsystem_names[LOG_SUBSYS_COUNT] = {
+    "core", "kernel", "tui", "monitor", "plugins", "i18n"
+};
+static const char *const socket_mode_names[] = {"dgram", "stream", "journal"};
+
+// 每个线程独立的格式化缓冲区和按秒缓存的时间戳
+static __thread char tls_buffer[LOG_BUFFER_SIZE];
+static __thread char tls_message[LOG_BUFFER_SIZE];  // 二进制模式下退回文本记录时使用
+static __thread time_t tls_stamp_sec = -1;
+static __thread char tls_stamp[32];
+static __thread int tls_is_writer;
+
+static void logger_rotate_locked(void);
+static void logger_update_thresholds_locked(void);
+
+static inline LogLevel clamp_level(LogLevel level) {
+    return (level > LOG_FATAL) ? LOG_FATAL : level;
+}
+
+// 格式化一条记录到 buf，返回长度（含换行）
+static size_t format_record(char *buf, size_t size, LogLevel level, const char *format, va_list args) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    if (ts.tv_sec != tls_stamp_sec) {
+        struct tm tm_info;
+        localtime_r(&ts.tv_sec, &tm_info);
+        strftime(tls_stamp, sizeof(tls_stamp), "%Y-%m-%d %H:%M:%S", &tm_info);
+        tls_stamp_sec = ts.tv_sec;
+    }
+
+    int prefix = snprintf(buf, size, "[%s.%03ld] [%s] ",
+                          tls_stamp, ts.tv_nsec / 1000000, level_names[clamp_level(level)]);
+    size_t room = size - (size_t)prefix - 1;  // 为换行预留一个字节
+    int body = vsnprintf(buf + prefix, room, format, args);
+
+    if (body < 0) {
+        body = 0;
+    } else if ((size_t)body >= room) {
+        body = (int)room - 1;
+    }
+
+    size_t length = (size_t)prefix + (size_t)body;
+    buf[length++] = '\n';
+    return length;
+}
+
+// 编码一条二进制记录：只拷贝原始参数，不做格式化
+static size_t encode_binary(char *buf, size_t size, LogLevel level, const char *format, va_list args) {
+    const LogFormatInfo *info = log_format_lookup(format);
+    int64_t now = log_binary_now();
+
+    if (info && info->binary_ok) {
+        return log_binary_encode_event((uint8_t *)buf, size, level, now, info, args);
+    }
+
+    // 格式串不支持延迟格式化（如 %m）或登记表已满
+    int length = vsnprintf(tls_message, sizeof(tls_message), format, args);
+    if (length < 0) {
+        length = 0;
+    } else if ((size_t)length >= sizeof(tls_message)) {
+        length = (int)sizeof(tls_message) - 1;
+    }
+    return log_binary_encode_text((uint8_t *)buf, size, level, now, tls_message, (size_t)length);
+}
+
+// 按当前文件格式生成一条记录
+static inline size_t encode_record(char *buf, size_t size, LogLevel level, const char *format, va_list args) {
+    if (__atomic_load_n(&logger.format, __ATOMIC_RELAXED) == LOG_FORMAT_BINARY) {
+        return encode_binary(buf, size, level, format, args);
+    }
+    return format_record(buf, size, level, format, args);
+}
+
+static size_t format_internal(char *buf, size_t size, LogLevel level, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t length = encode_record(buf, size, level, format, args);
+    va_end(args);
+    return length;
+}
+
+// 完整写出 iovec 数组，处理部分写入和 EINTR
+static ssize_t write_all_iov(int fd, struct iovec *iov, int count) {
+    ssize_t total = 0;
+
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        total += n;
+
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+
+    return total;
+}
+
+// 写出文件头，之后的事件重新写出格式串定义（调用方持有 mutex）
+static void logger_write_header_locked(void) {
+    LogBinaryHeader header;
+    struct iovec iov;
+
+    log_binary_header_init(&header);
+    iov.iov_base = &header;
+    iov.iov_len = sizeof(header);
+    if (write_all_iov(logger.fd, &iov, 1) > 0) {
+        logger.file_size += sizeof(header);
+    }
+
+    logger.wall_offset_ns = header.wall_base_ns - header.mono_base_ns;
+    memset(logger.format_emitted, 0, sizeof(logger.format_emitted));
+}
+
+// 事件所用格式串在当前文件中首次出现时先写出它的定义（调用方持有 mutex）
+static void logger_emit_format_locked(const char *record, size_t length) {
+    LogRecordHeader header;
+    uint8_t definition[LOG_BINARY_RECORD_MAX];
+
+    if (length < sizeof(header)) {
+        return;
+    }
+    memcpy(&header, record, sizeof(header));
+
+    uint32_t id = header.format_id;
+    if (header.type != LOG_RECORD_EVENT || (logger.format_emitted[id / 8] & (1u << (id % 8)))) {
+        return;
+    }
+
+    const LogFormatInfo *info = log_format_get(id);
+    size_t size = info ? log_binary_encode_format(definition, sizeof(definition), info) : 0;
+    struct iovec iov = {definition, size};
+    if (size > 0 && write_all_iov(logger.fd, &iov, 1) > 0) {
+        logger.file_size += size;
+        __atomic_add_fetch(&logger.stats.bytes_written, size, __ATOMIC_RELAXED);
+        logger.format_emitted[id / 8] |= (uint8_t)(1u << (id % 8));
+    }
+}
+
+// 记录去掉时间戳后的指纹（级别与消息内容都参与计算）
+static uint64_t record_key(const char *record, size_t length, int binary) {
+    if (binary) {
+        if (length < sizeof(LogRecordHeader)) {
+            return fast_hash64(record, length, 0);
+        }
+        uint64_t seed = fast_hash64(record, offsetof(LogRecordHeader, timestamp_ns), 0);
+        return fast_hash64(record + sizeof(LogRecordHeader), length - sizeof(LogRecordHeader), seed);
+    }
+
+    // 文本记录跳过开头的 "[YYYY-MM-DD HH:MM:SS.mmm]"
+    const char *body = memchr(record, ']', length);
+    body = body ? body + 1 : record;
+    return fast_hash64(body, length - (size_t)(body - record), 0);
+}
+
+// 判断是否与上一条记录重复（调用方持有 mutex）
+// 返回 -1 表示重复、已计数，应跳过；否则返回需先写出的重复摘要长度（0 表示没有）
+static long logger_coalesce_locked(LogLevel level, const char *record, size_t length,
+                                   char *summary, LogLevel *summary_level) {
+    if (!logger.coalesce) {
+        return 0;
+    }
+
+    uint64_t key = record_key(record, length, logger.format == LOG_FORMAT_BINARY);
+    if (logger.have_last && key == logger.last_key) {
+        logger.repeat_count++;
+        __atomic_add_fetch(&logger.stats.records_coalesced, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    size_t summary_length = 0;
+    if (logger.repeat_count > 0) {
+        summary_length = format_internal(summary, LOG_SUMMARY_SIZE, logger.last_level,
+                                         "Last message repeated %llu times",
+                                         (unsigned long long)logger.repeat_count);
+        *summary_level = logger.last_level;
+        logger.repeat_count = 0;
+    }
+
+    logger.have_last = 1;
+    logger.last_level = level;
+    logger.last_key = key;
+    return (long)summary_length;
+}
+
+/* ---------------- 输出端 ---------------- */
+
+static inline LogSinkRecord sink_record(LogLevel level, const char *data, size_t length) {
+    return (LogSinkRecord){level, data, length, data, length};
+}
+
+// 文件汇点：轮转、二进制文件头和格式串定义只与它有关（调用方持有 mutex）
+static size_t file_sink_write(LogSink *sink, const LogSinkRecord *records, size_t count) {
+    struct iovec iov[LOG_ROUTE_MAX];
+    size_t used = 0, bytes = 0;
+
+    for (size_t i = 0; i < count && used < LOG_ROUTE_MAX; i++) {
+        if (log_sink_accepts(sink, records[i].level)) {
+            iov[used++] = (struct iovec){(void *)records[i].data, records[i].length};
+            bytes += records[i].length;
+        }
+    }
+    if (used == 0) {
+        return 0;
+    }
+
+    if (logger.rotate && logger.file_size + bytes > logger.max_size) {
+        logger_rotate_locked();
+    }
+    if (logger.fd < 0) {
+        return 0;
+    }
+
+    if (logger.format == LOG_FORMAT_BINARY) {
+        for (size_t i = 0; i < used; i++) {
+            logger_emit_format_locked(iov[i].iov_base, iov[i].iov_len);
+        }
+    }
+
+    if (write_all_iov(logger.fd, iov, (int)used) <= 0) {
+        return 0;
+    }
+    logger.file_size += bytes;
+    __atomic_add_fetch(&logger.stats.records_written, used, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&logger.stats.bytes_written, bytes, __ATOMIC_RELAXED);
+    return used;
+}
+
+// 二进制记录渲染成文本，需要文本的汇点共用同一份（调用方持有 mutex）
+// 只渲染至少有一个文本汇点会接收的记录
+static void logger_render_text_locked(LogSinkRecord *records, size_t count) {
+    int min_level = LOG_FATAL + 1;
+
+    for (int i = 0; i < LOG_SINK_COUNT; i++) {
+        LogSink *sink = logger.sinks[i];
+        if (sink && sink->enabled && sink->ops->needs_text && sink->min_level < min_level) {
+            min_level = sink->min_level;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        records[i].text = NULL;
+        records[i].text_length = 0;
+
+        if ((int)records[i].level < min_level) {
+            continue;
+        }
+        if (!logger.render_buffer) {
+            logger.render_buffer = malloc((size_t)LOG_ROUTE_MAX * LOG_BUFFER_SIZE);
+            if (!logger.render_buffer) {
+                return;
+            }
+        }
+
+        char *line = logger.render_buffer + i * LOG_BUFFER_SIZE;
+        records[i].text_length = log_binary_record_to_line((const uint8_t *)records[i].data, records[i].length,
+                                                           logger.wall_offset_ns, line, LOG_BUFFER_SIZE);
+        if (records[i].text_length > 0) {
+            records[i].text = line;
+        }
+    }
+}
+
+// 把一批记录分发给所有启用的汇点（调用方持有 mutex，count 不超过 LOG_ROUTE_MAX）
+static void logger_route_locked(LogSinkRecord *records, size_t count) {
+    if (logger.format == LOG_FORMAT_BINARY) {
+        logger_render_text_locked(records, count);
+    }
+
+    for (int i = 0; i < LOG_SINK_COUNT; i++) {
+        LogSink *sink = logger.sinks[i];
+        if (sink && sink->enabled) {
+            sink->written += sink->ops->write(sink, records, count);
+        }
+    }
+}
+
+// 同步写入一条记录，连续的重复记录只计数（调用方持有 mutex）
+static void logger_write_locked(LogLevel level, const char *line, size_t length) {
+    char summary[LOG_SUMMARY_SIZE];
+    LogLevel summary_level = level;
+    LogSinkRecord records[2];
+    size_t count = 0;
+    long summary_length = logger_coalesce_locked(level, line, length, summary, &summary_level);
+
+    if (summary_length < 0) {
+        return;
+    }
+    if (summary_length > 0) {
+        records[count++] = sink_record(summary_level, summary, (size_t)summary_length);
+    }
+    records[count++] = sink_record(level, line, length);
+    logger_route_locked(records, count);
+}
+
+// 写出尚未报告的重复次数（调用方持有 mutex）
+static void logger_flush_repeats_locked(void) {
+    if (logger.repeat_count == 0) {
+        return;
+    }
+
+    char summary[LOG_SUMMARY_SIZE];
+    size_t length = format_internal(summary, sizeof(summary), logger.last_level,
+                                    "Last message repeated %llu times",
+                                    (unsigned long long)logger.repeat_count);
+    logger.repeat_count = 0;
+    logger.have_last = 0;
+
+    LogSinkRecord record = sink_record(logger.last_level, summary, length);
+    logger_route_locked(&record, 1);
+}
+
+// 需要时创建 tty 汇点（调用方持有 mutex）
+static LogSink *logger_tty_sink_locked(void) {
+    if (!logger.sinks[LOG_SINK_TTY]) {
+        logger.sinks[LOG_SINK_TTY] = log_sink_tty_create(STDERR_FILENO);
+    }
+    return logger.sinks[LOG_SINK_TTY];
+}
+
+/* ---------------- 后台归档线程 ---------------- */
+
+static void archive_name(char *buf, size_t size, const char *base, int index, const char *suffix) {
+    snprintf(buf, size, "%s.%d%s", base, index, suffix);
+}
+
+// 归档编号 from 改为 to（压缩归档、索引与未压缩段一并处理）
+static void archive_shift(const char *base, int from, int to) {
+    static const char *const suffixes[] = {"", LOG_ARCHIVE_SUFFIX, LOG_ARCHIVE_SUFFIX LOG_ARCHIVE_INDEX_SUFFIX};
+    char old_name[320], new_name[320];
+
+    for (size_t i = 0; i < sizeof(suffixes) / sizeof(suffixes[0]); i++) {
+        archive_name(old_name, sizeof(old_name), base, from, suffixes[i]);
+        if (to > 0) {
+            archive_name(new_name, sizeof(new_name), base, to, suffixes[i]);
+            rename(old_name, new_name);
+        } else {
+            unlink(old_name);
+        }
+    }
+}
+
+// 归档一个日志段：腾出 .1 的位置，再把段压缩（或改名）成 .1
+// 返回 SWK_ERROR 表示压缩失败、已退回未压缩的归档
+static int logger_archive_segment(const PendingSegment *segment) {
+    char base[300], target[320];
+    int keep = segment->max_files - 1;  // 当前文件之外保留的归档数
+    int status = SWK_SUCCESS;
+
+    // 段名为 "<日志文件>.rotating.<pid>.<序号>"
+    snprintf(base, sizeof(base), "%s", segment->path);
+    char *mark = strstr(base, ".rotating.");
+    if (mark) {
+        *mark = '\0';
+    }
+
+    archive_shift(base, keep, 0);
+    for (int i = keep - 1; i > 0; i--) {
+        archive_shift(base, i, i + 1);
+    }
+
+    if (segment->compress && log_archive_supported()) {
+        archive_name(target, sizeof(target), base, 1, LOG_ARCHIVE_SUFFIX);
+        if (log_archive_compress(segment->path, target) == SWK_SUCCESS) {
+            unlink(segment->path);
+            return SWK_SUCCESS;
+        }
+        status = SWK_ERROR;
+    }
+
+    archive_name(target, sizeof(target), base, 1, "");
+    rename(segment->path, target);
+    return status;
+}
+
+static void *logger_archiver_main(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&logger.archive_mutex);
+    for (;;) {
+        while (!logger.pending_head && !logger.archive_stop) {
+            pthread_cond_wait(&logger.archive_cond, &logger.archive_mutex);
+        }
+        if (!logger.pending_head) {
+            break;
+        }
+
+        PendingSegment *segment = logger.pending_head;
+        logger.pending_head = segment->next;
+        if (!logger.pending_head) {
+            logger.pending_tail = NULL;
+        }
+        logger.archive_busy = 1;
+        pthread_mutex_unlock(&logger.archive_mutex);
+
+        if (logger_archive_segment(segment) != SWK_SUCCESS) {
+            log_message(LOG_WARNING, "Failed to compress rotated log %s, kept it uncompressed", segment->path);
+        }
+        free(segment);
+
+        pthread_mutex_lock(&logger.archive_mutex);
+        logger.archive_busy = 0;
+        pthread_cond_broadcast(&logger.archive_idle);
+    }
+    pthread_mutex_unlock(&logger.archive_mutex);
+
+    return NULL;
+}
+
+// 把日志段交给归档线程（首次使用时启动线程）
+static void logger_archive_enqueue(const char *path, int max_files, int compress) {
+    PendingSegment *segment = calloc(1, sizeof(PendingSegment));
+
+    if (!segment) {
+        return;
+    }
+    snprintf(segment->path, sizeof(segment->path), "%s", path);
+    segment->max_files = max_files;
+    segment->compress = compress;
+
+    pthread_mutex_lock(&logger.archive_mutex);
+
+    if (!logger.archiver_running) {
+        logger.archive_stop = 0;
+        if (pthread_create(&logger.archiver, NULL, logger_archiver_main, NULL) != 0) {
+            // 无法启动线程时同步归档
+            pthread_mutex_unlock(&logger.archive_mutex);
+            logger_archive_segment(segment);
+            free(segment);
+            return;
+        }
+        logger.archiver_running = 1;
+    }
+
+    if (logger.pending_tail) {
+        logger.pending_tail->next = segment;
+    } else {
+        logger.pending_head = segment;
+    }
+    logger.pending_tail = segment;
+
+    pthread_cond_signal(&logger.archive_cond);
+    pthread_mutex_unlock(&logger.archive_mutex);
+}
+
+// 等待归档队列清空
+static void logger_archive_wait(void) {
+    pthread_mutex_lock(&logger.archive_mutex);
+    while (logger.pending_head || logger.archive_busy) {
+        pthread_cond_wait(&logger.archive_idle, &logger.archive_mutex);
+    }
+    pthread_mutex_unlock(&logger.archive_mutex);
+}
+
+// 处理完剩余的日志段后停止归档线程
+static void logger_archive_stop(void) {
+    pthread_mutex_lock(&logger.archive_mutex);
+    if (!logger.archiver_running) {
+        pthread_mutex_unlock(&logger.archive_mutex);
+        return;
+    }
+    logger.archive_stop = 1;
+    pthread_cond_signal(&logger.archive_cond);
+    pthread_mutex_unlock(&logger.archive_mutex);
+
+    pthread_join(logger.archiver, NULL);
+    logger.archiver_running = 0;
+}
+
+typedef struct {
+    char path[300];
+    struct timespec mtime;       // 段的最后写入时间
+    unsigned long long sequence; // 段名末尾的轮转序号
+} RecoveredSegment;
+
+// 先轮转出来的段先归档：按最后写入时间，同一时刻按序号
+static int compare_recovered(const void *a, const void *b) {
+    const RecoveredSegment *x = a;
+    const RecoveredSegment *y = b;
+
+    if (x->mtime.tv_sec != y->mtime.tv_sec) {
+        return x->mtime.tv_sec < y->mtime.tv_sec ? -1 : 1;
+    }
+    if (x->mtime.tv_nsec != y->mtime.tv_nsec) {
+        return x->mtime.tv_nsec < y->mtime.tv_nsec ? -1 : 1;
+    }
+    return (x->sequence > y->sequence) - (x->sequence < y->sequence);
+}
+
+// 接管上次运行遗留的待归档段（进程在归档完成前退出）
+// 每个段归档时都会把已有归档后移一位，所以必须从最旧的段开始入队，
+// 不能按 readdir 的顺序
+static void logger_recover_segments(const char *filename) {
+    char dir_buf[256], base_buf[256], prefix[300];
+    struct dirent *entry;
+    RecoveredSegment *segments = NULL;
+    size_t count = 0, capacity = 0;
+
+    snprintf(dir_buf, sizeof(dir_buf), "%s", filename);
+    snprintf(base_buf, sizeof(base_buf), "%s", filename);
+    const char *dir = dirname(dir_buf);
+    int prefix_length = snprintf(prefix, sizeof(prefix), "%s.rotating.", basename(base_buf));
+
+    DIR *dp = opendir(dir);
+    if (!dp) {
+        return;
+    }
+
+    while ((entry = readdir(dp)) != NULL) {
+        if (strncmp(entry->d_name, prefix, (size_t)prefix_length) != 0) {
+            continue;
+        }
+        if (count == capacity) {
+            size_t grown = capacity ? capacity * 2 : 8;
+            RecoveredSegment *bigger = realloc(segments, grown * sizeof(RecoveredSegment));
+            if (!bigger) {
+                break;
+            }
+            segments = bigger;
+            capacity = grown;
+        }
+
+        // 段名为 "<日志文件>.rotating.<pid>.<序号>"
+        RecoveredSegment *segment = &segments[count];
+        struct stat st;
+        const char *dot = strrchr(entry->d_name, '.');
+        snprintf(segment->path, sizeof(segment->path), "%s/%s", dir, entry->d_name);
+        segment->sequence = dot ? strtoull(dot + 1, NULL, 10) : 0;
+        if (stat(segment->path, &st) != 0) {
+            continue;
+        }
+        segment->mtime = st.st_mtim;
+        count++;
+    }
+    closedir(dp);
+
+    if (count > 1) {
+        qsort(segments, count, sizeof(RecoveredSegment), compare_recovered);
+    }
+    for (size_t i = 0; i < count; i++) {
+        logger_archive_enqueue(segments[i].path, logger.max_files, logger.compress);
+    }
+    free(segments);
+}
+
+/* ---------------- 异步写线程 ---------------- */
+
+static void logger_wake_writer(int force) {
+    // 与写线程的 writer_sleeping 标记配合（Dekker 式），保证不会丢失唤醒
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (force || __atomic_load_n(&logger.writer_sleeping, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&logger.wake_seq, 1, __ATOMIC_SEQ_CST);
+        syscall(SYS_futex, &logger.wake_seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+    }
+}
+
+static void logger_writer_wait(void) {
+    uint32_t seq = __atomic_load_n(&logger.wake_seq, __ATOMIC_SEQ_CST);
+
+    __atomic_store_n(&logger.writer_sleeping, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (!log_ring_peek(&logger.ring, 0) &&
+        !__atomic_load_n(&logger.stop, __ATOMIC_ACQUIRE) &&
+        !__atomic_load_n(&logger.rotate_requested, __ATOMIC_ACQUIRE)) {
+        struct timespec timeout = {0, LOG_WRITER_IDLE_NS};
+        syscall(SYS_futex, &logger.wake_seq, FUTEX_WAIT_PRIVATE, seq, &timeout, NULL, 0);
+    }
+
+    __atomic_store_n(&logger.writer_sleeping, 0, __ATOMIC_RELAXED);
+}
+
+// 写出一批记录：每个汇点各用一次系统调用
+// 重复记录在这里合并，重复摘要按原有顺序插入到批次中
+static void logger_write_batch(size_t count) {
+    LogSinkRecord records[LOG_ROUTE_MAX];
+    char summaries[LOG_WRITER_BATCH][LOG_SUMMARY_SIZE];
+    size_t used = 0, summary_count = 0;
+
+    pthread_mutex_lock(&logger.mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        LogRingSlot *slot = log_ring_peek(&logger.ring, i);
+        const char *text = log_ring_slot_text(slot);
+        LogLevel level = (LogLevel)slot->level;
+        LogLevel summary_level = level;
+        char *summary = summaries[summary_count];
+        long summary_length = logger_coalesce_locked(level, text, slot->length, summary, &summary_level);
+
+        if (summary_length < 0) {
+            continue;
+        }
+        if (summary_length > 0) {
+            records[used++] = sink_record(summary_level, summary, (size_t)summary_length);
+            summary_count++;
+        }
+        records[used++] = sink_record(level, text, slot->length);
+    }
+
+    if (used > 0) {
+        logger_route_locked(records, used);
+    }
+
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+static void *logger_writer_main(void *arg) {
+    (void)arg;
+    tls_is_writer = 1;
+    uint64_t reported_drops = 0;
+
+    for (;;) {
+        size_t count = 0;
+        while (count < LOG_WRITER_BATCH && log_ring_peek(&logger.ring, count)) {
+            count++;
+        }
+
+        if (count > 0) {
+            uint64_t depth = __atomic_load_n(&logger.ring.tail, __ATOMIC_RELAXED) - logger.ring.head;
+            if (depth > logger.stats.queue_high_water) {
+                __atomic_store_n(&logger.stats.queue_high_water, depth, __ATOMIC_RELAXED);
+            }
+
+            logger_write_batch(count);
+            log_ring_release(&logger.ring, count);
+        }
+
+        // 丢弃计数变化时写一条说明，便于事后确认日志是否完整
+        uint64_t drops = __atomic_load_n(&logger.stats.records_dropped, __ATOMIC_RELAXED);
+        if (drops != reported_drops) {
+            char notice[256];
+            size_t length = format_internal(notice, sizeof(notice), LOG_WARNING,
+                                            "Log queue overflow: %llu records dropped so far",
+                                            (unsigned long long)drops);
+            pthread_mutex_lock(&logger.mutex);
+            logger_write_locked(LOG_WARNING, notice, length);
+            pthread_mutex_unlock(&logger.mutex);
+            reported_drops = drops;
+        }
+
+        if (__atomic_exchange_n(&logger.rotate_requested, 0, __ATOMIC_ACQ_REL)) {
+            pthread_mutex_lock(&logger.mutex);
+            logger_rotate_locked();
+            pthread_mutex_unlock(&logger.mutex);
+        }
+
+        if (count == 0) {
+            // 队列空闲时把积攒的重复次数写出，摘要最多延迟一个空闲周期
+            pthread_mutex_lock(&logger.mutex);
+            logger_flush_repeats_locked();
+            pthread_mutex_unlock(&logger.mutex);
+
+            if (__atomic_load_n(&logger.stop, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            logger_writer_wait();
+        }
+    }
+
+    return NULL;
+}
+
+// 按溢出策略入队
+static void logger_enqueue(LogLevel level, const char *line, size_t length) {
+    char truncated[LOG_RING_INLINE_SIZE];
+    int attempts = 0;
+    int result;
+
+    while ((result = log_ring_push(&logger.ring, level, line, length)) != SWK_SUCCESS) {
+        if (result == SWK_ERROR_OUT_OF_MEMORY) {
+            // 二进制记录截断后记录头中的长度就不对了，只能丢弃；文本行截断并保留换行
+            if (__atomic_load_n(&logger.format, __ATOMIC_RELAXED) == LOG_FORMAT_BINARY) {
+                __atomic_add_fetch(&logger.stats.records_dropped, 1, __ATOMIC_RELAXED);
+                return;
+            }
+            memcpy(truncated, line, sizeof(truncated) - 1);
+            truncated[sizeof(truncated) - 1] = '\n';
+            line = truncated;
+            length = sizeof(truncated);
+            continue;
+        }
+        if (logger.overflow == LOG_OVERFLOW_DROP ||
+            (logger.overflow == LOG_OVERFLOW_DROP_DEBUG && level == LOG_DEBUG)) {
+            __atomic_add_fetch(&logger.stats.records_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+
+        logger_wake_writer(1);
+        if (++attempts < 64) {
+            sched_yield();
+        } else {
+            struct timespec pause = {0, 50000};
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    // 积压到队列的 1/8 或遇到 ERROR 以上级别时才唤醒写线程，
+    // 其余情况由写线程定时醒来批量写出，避免每条记录一次上下文切换
+    uint64_t depth = __atomic_load_n(&logger.ring.tail, __ATOMIC_RELAXED) -
+                     __atomic_load_n(&logger.ring.head, __ATOMIC_RELAXED);
+    if (level >= LOG_ERROR || depth >= logger.ring.capacity / 8) {
+        logger_wake_writer(0);
+    }
+}
+
+/* ---------------- 公共接口 ---------------- */
 
 // 初始化日志系统
 int logger_init(const char *filename, LogLevel level, int rotate) {
-    if (logger.file) {
-        fclose(logger.file);
+    pthread_mutex_lock(&logger.mutex);
+
+    if (logger.fd >= 0) {
+        close(logger.fd);
     }
-    
-    logger.file = fopen(filename, "a");
-    if (!logger.file) {
+
+    __atomic_store_n(&logger.fd, open(filename, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644),
+                     __ATOMIC_RELAXED);
+    if (logger.fd < 0) {
+        pthread_mutex_unlock(&logger.mutex);
         return -1;
     }
-    
+
+    struct stat st;
+    logger.file_size = (fstat(logger.fd, &st) == 0) ? (size_t)st.st_size : 0;
+
+    // 已有内容时沿用文件原来的格式，避免在配置加载前把文本追加进二进制文件；
+    // 配置指定的格式不同时由 logger_set_format 轮转
+    if (logger.file_size > 0) {
+        __atomic_store_n(&logger.format,
+                         log_binary_is_binary_file(filename) ? LOG_FORMAT_BINARY : LOG_FORMAT_TEXT,
+                         __ATOMIC_RELAXED);
+    }
+
+    // 追加到已有的二进制日志时重新写一个文件头，以本进程的时钟为基准
+    if (logger.format == LOG_FORMAT_BINARY) {
+        logger_write_header_locked();
+    }
+
     strncpy(logger.filename, filename, sizeof(logger.filename) - 1);
+    logger.have_last = 0;
+    logger.repeat_count = 0;
     logger.level = level;
+    logger_update_thresholds_locked();
     logger.rotate = rotate;
-    
-    // 初始化互斥锁
-    if (pthread_mutex_init(&logger.mutex, NULL) != 0) {
-        fclose(logger.file);
-        logger.file = NULL;
-        return -1;
+    logger_tty_sink_locked();
+
+    pthread_mutex_unlock(&logger.mutex);
+
+    if (rotate) {
+        logger_recover_segments(filename);
     }
-    
+
     log_message(LOG_INFO, "Logger initialized (level: %d, file: %s)", level, filename);
     return 0;
 }
 
-// 记录日志消息
-void log_message(LogLevel level, const char *format, ...) {
-    if (level < logger.level || !logger.file) {
+// 按调用点限流，放行时通过 *suppressed 返回此前被抑制的条数
+static int logger_rate_allow(const char *site, uint64_t *suppressed) {
+    uint32_t rate = __atomic_load_n(&logger.rate_limit, __ATOMIC_RELAXED);
+
+    *suppressed = 0;
+    if (rate == 0) {
+        return 1;
+    }
+
+    uint32_t burst = __atomic_load_n(&logger.rate_burst, __ATOMIC_RELAXED);
+    uint64_t hash = ((uint64_t)(uintptr_t)site >> 3) * 0x9e3779b97f4a7c15ULL;
+    LogRateSlot *slot = &rate_slots[hash >> 54];  // 高 10 位
+    int64_t now = log_binary_now();
+
+    // 只有映射到同一槽位的调用点之间才会竞争
+    while (__atomic_exchange_n(&slot->lock, 1, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+
+    if (slot->site != site) {
+        slot->site = site;
+        slot->tokens = burst;
+        slot->refill_ns = now;
+        slot->suppressed = 0;
+    } else {
+        int64_t elapsed = now - slot->refill_ns;
+        uint64_t added = elapsed >= 60 * 1000000000LL ? burst : (uint64_t)elapsed * rate / 1000000000ULL;
+        if (added > 0) {
+            if (slot->tokens + added >= burst) {
+                slot->tokens = burst;
+                slot->refill_ns = now;
+            } else {
+                slot->tokens += (uint32_t)added;
+                slot->refill_ns += (int64_t)(added * 1000000000ULL / rate);
+            }
+        }
+    }
+
+    int allow = slot->tokens > 0;
+    if (allow) {
+        slot->tokens--;
+        *suppressed = slot->suppressed;
+        slot->suppressed = 0;
+    } else {
+        slot->suppressed++;
+    }
+
+    __atomic_store_n(&slot->lock, 0, __ATOMIC_RELEASE);
+
+    if (!allow) {
+        __atomic_add_fetch(&logger.stats.records_rate_limited, 1, __ATOMIC_RELAXED);
+    }
+    return allow;
+}
+
+// 提交一条已编码的记录
+static void logger_submit(LogLevel level, const char *record, size_t length) {
+    // 异步模式下只入队；写线程自身产生的日志直接写出，避免等待自己
+    if (__atomic_load_n(&logger.async, __ATOMIC_ACQUIRE) && !tls_is_writer) {
+        logger_enqueue(level, record, length);
         return;
     }
-    
+
     pthread_mutex_lock(&logger.mutex);
-    
-    // 检查日志文件大小，需要时轮转
-    if (logger.rotate) {
-        struct stat st;
-        if (stat(logger.filename, &st) == 0 && st.st_size > MAX_LOG_SIZE) {
-            rotate_log_files();
-        }
-    }
-    
-    // 获取高精度时间戳
-    struct timeval tv;
-    struct tm *tm_info;
-    char timestamp[64];
-    
-    gettimeofday(&tv, NULL);
-    tm_info = localtime(&tv.tv_sec);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", tm_info);
-    
-    // 日志级别字符串
-    const char *level_str = "DEBUG";
-    const char *color_code = "";
-    const char *reset_code = "";
-    
-    switch (level) {
-        case LOG_DEBUG: level_str = "DEBUG"; color_code = "\033[36m"; break;
-        case LOG_INFO: level_str = "INFO"; color_code = "\033[32m"; break;
-        case LOG_WARNING: level_str = "WARN"; color_code = "\033[33m"; break;
-        case LOG_ERROR: level_str = "ERROR"; color_code = "\033[31m"; break;
-        case LOG_FATAL: level_str = "FATAL"; color_code = "\033[35m"; break;
-    }
-    
-    // 格式化日志消息
-    char message[LOG_BUFFER_SIZE];
+    logger_write_locked(level, record, length);
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 格式化并写出一条记录（级别已检查）
+static void logger_vemit(LogLevel level, const char *format, va_list args) {
+    uint64_t suppressed = 0;
+
+    // 限流在格式化之前进行，被抑制的记录不产生任何格式化开销
+    if (level < LOG_FATAL && !logger_rate_allow(format, &suppressed)) {
+        return;
+    }
+
+    if (suppressed > 0) {
+        char notice[256];
+        size_t length = format_internal(notice, sizeof(notice), LOG_WARNING,
+                                        "Rate limit: suppressed %llu messages like \"%.96s\"",
+                                        (unsigned long long)suppressed, format);
+        if (length > 0) {
+            logger_submit(LOG_WARNING, notice, length);
+        }
+    }
+
+    size_t length = encode_record(tls_buffer, sizeof(tls_buffer), level, format, args);
+    if (length > 0) {
+        logger_submit(level, tls_buffer, length);
+    }
+}
+
+// 记录日志消息（归入 core 子系统）
+void log_message(LogLevel level, const char *format, ...) {
+    if (!logger_enabled(LOG_SUBSYS_CORE, level)) {
+        return;
+    }
+
     va_list args;
     va_start(args, format);
-    vsnprintf(message, sizeof(message), format, args);
+    logger_vemit(level, format, args);
+    va_end(args);
+}
+
+// SWK_LOG 的出口：调用方已按子系统检查过级别
+void logger_emit(LogLevel level, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    logger_vemit(level, format, args);
     va_end(args);
-    
-    // 写入日志文件（无颜色）
-    fprintf(logger.file, "[%s.%.3ld] [%s] %s\n", 
-            timestamp, tv.tv_usec / 1000, level_str, message);
-    fflush(logger.file);
-    
-    // 控制台输出（带颜色）
-    fprintf(stderr, "%s[%s.%.3ld] [%s] %s%s\n", 
-            color_code, timestamp, tv.tv_usec / 1000, level_str, message, reset_code);
-    
-    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 日志文件轮转（调用方持有 mutex）
+// 持锁期间只做一次改名和一次打开，旧文件交给归档线程
+static void logger_rotate_locked(void) {
+    char segment[300];
+
+    if (logger.fd >= 0) {
+        close(logger.fd);
+    }
+
+    snprintf(segment, sizeof(segment), "%s.rotating.%d.%llu", logger.filename, (int)getpid(),
+             (unsigned long long)++logger.rotation_seq);
+    int moved = rename(logger.filename, segment) == 0;
+
+    // 重新打开主日志文件
+    __atomic_store_n(&logger.fd, open(logger.filename, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644),
+                     __ATOMIC_RELAXED);
+    logger.file_size = 0;
+    __atomic_add_fetch(&logger.stats.rotations, 1, __ATOMIC_RELAXED);
+
+    if (moved) {
+        logger_archive_enqueue(segment, logger.max_files, logger.compress);
+    }
+
+    if (logger.fd >= 0) {
+        if (logger.format == LOG_FORMAT_BINARY) {
+            logger_write_header_locked();
+        }
+
+        // 说明只写入新文件，不经过其他汇点
+        char notice[128];
+        size_t length = format_internal(notice, sizeof(notice), LOG_INFO, "Log file rotated successfully");
+        LogSinkRecord record = sink_record(LOG_INFO, notice, length);
+        logger.file_sink.written += file_sink_write(&logger.file_sink, &record, 1);
+    }
 }
 
 // 日志文件轮转
 void rotate_log_files(void) {
-    fclose(logger.file);
-    
-    // 轮转现有的日志文件
-    for (int i = MAX_LOG_FILES - 1; i > 0; i--) {
-        char old_name[256], new_name[256];
-        if (i == 1) {
-            snprintf(old_name, sizeof(old_name), "%s", logger.filename);
-        } else {
-            snprintf(old_name, sizeof(old_name), "%s.%d", logger.filename, i - 1);
+    if (__atomic_load_n(&logger.async, __ATOMIC_ACQUIRE) && !tls_is_writer) {
+        // 交给写线程，保证轮转发生在两个批次之间
+        __atomic_store_n(&logger.rotate_requested, 1, __ATOMIC_RELEASE);
+        logger_wake_writer(1);
+        return;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    logger_rotate_locked();
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置轮转参数
+void logger_set_rotation(size_t max_size, int max_files) {
+    pthread_mutex_lock(&logger.mutex);
+    if (max_size > 0) {
+        logger.max_size = max_size;
+    }
+    if (max_files > 1) {
+        logger.max_files = max_files;
+    }
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置轮转出的日志段是否压缩归档
+void logger_set_compression(int enabled) {
+    pthread_mutex_lock(&logger.mutex);
+    logger.compress = enabled;
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置按调用点限流
+void logger_set_rate_limit(unsigned per_second, unsigned burst) {
+    if (per_second > LOG_RATE_MAX) {
+        per_second = LOG_RATE_MAX;
+    }
+    if (burst == 0) {
+        burst = per_second;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    __atomic_store_n(&logger.rate_burst, burst, __ATOMIC_RELAXED);
+    __atomic_store_n(&logger.rate_limit, per_second, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置是否合并连续的相同记录
+void logger_set_coalescing(int enabled) {
+    pthread_mutex_lock(&logger.mutex);
+    logger_flush_repeats_locked();
+    logger.coalesce = enabled;
+    logger.have_last = 0;
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置控制台输出
+void logger_set_console(int enabled) {
+    pthread_mutex_lock(&logger.mutex);
+    LogSink *tty = logger_tty_sink_locked();
+    if (tty) {
+        tty->enabled = enabled;
+    }
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 设置汇点的级别过滤，-1 停用（全局与子系统级别之后的第二道过滤）
+int logger_set_sink_level(LogSinkType type, int level) {
+    if ((unsigned)type >= LOG_SINK_COUNT || level < -1 || level > LOG_FATAL) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    LogSink *sink = type == LOG_SINK_TTY ? logger_tty_sink_locked() : logger.sinks[type];
+    if (!sink) {
+        pthread_mutex_unlock(&logger.mutex);
+        return SWK_ERROR;
+    }
+    if (level < 0) {
+        sink->enabled = 0;
+    } else {
+        sink->enabled = 1;
+        sink->min_level = level;
+    }
+    pthread_mutex_unlock(&logger.mutex);
+    return SWK_SUCCESS;
+}
+
+// 汇点的生效级别，未开启或已停用时返回 -1
+int logger_get_sink_level(LogSinkType type) {
+    int level = -1;
+
+    if ((unsigned)type >= LOG_SINK_COUNT) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    LogSink *sink = logger.sinks[type];
+    if (sink && sink->enabled) {
+        level = sink->min_level;
+    }
+    pthread_mutex_unlock(&logger.mutex);
+    return level;
+}
+
+// 替换指定位置的汇点，旧汇点在锁外销毁
+static void logger_replace_sink(LogSinkType type, LogSink *sink) {
+    pthread_mutex_lock(&logger.mutex);
+    LogSink *old = logger.sinks[type];
+    logger.sinks[type] = sink;
+    pthread_mutex_unlock(&logger.mutex);
+
+    log_sink_destroy(old);
+}
+
+// 打开 unix 套接字汇点（已打开的先关闭）
+int logger_open_socket_sink(const char *path, LogSocketMode mode, LogLevel level) {
+    if (!path || (unsigned)mode > LOG_SOCKET_JOURNAL) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    LogSink *sink = log_sink_socket_create(path, mode);
+    if (!sink) {
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+    sink->min_level = clamp_level(level);
+    logger_replace_sink(LOG_SINK_SOCKET, sink);
+    return SWK_SUCCESS;
+}
+
+// 打开内存环汇点（已打开的先关闭，之前的记录随之丢弃）
+int logger_open_memory_sink(size_t capacity, LogLevel level) {
+    if (capacity == 0) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    LogSink *sink = log_sink_memory_create(capacity);
+    if (!sink) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+    sink->min_level = clamp_level(level);
+    logger_replace_sink(LOG_SINK_MEMORY, sink);
+    return SWK_SUCCESS;
+}
+
+// 关闭汇点；文件汇点只能停用
+void logger_close_sink(LogSinkType type) {
+    if (type == LOG_SINK_FILE) {
+        logger_set_sink_level(LOG_SINK_FILE, -1);
+    } else if ((unsigned)type < LOG_SINK_COUNT) {
+        logger_replace_sink(type, NULL);
+    }
+}
+
+// 解析套接字发送方式（配置文件使用），未知名称返回 -1
+int logger_parse_socket_mode(const char *name) {
+    if (!name) {
+        return -1;
+    }
+    for (int i = 0; i <= LOG_SOCKET_JOURNAL; i++) {
+        if (strcasecmp(name, socket_mode_names[i]) == 0) {
+            return i;
         }
-        snprintf(new_name, sizeof(new_name), "%s.%d", logger.filename, i);
-        
-        rename(old_name, new_name);
     }
-    
-    // 重新打开主日志文件
-    logger.file = fopen(logger.filename, "w");
-    if (logger.file) {
-        log_message(LOG_INFO, "Log file rotated successfully");
+    return -1;
+}
+
+const char *logger_socket_mode_name(LogSocketMode mode) {
+    return (unsigned)mode <= LOG_SOCKET_JOURNAL ? socket_mode_names[mode] : "unknown";
+}
+
+// 读取内存环（持有 mutex，读取期间写入会等待）
+uint64_t logger_memory_read(uint64_t cursor, LogMemoryCallback callback, void *context) {
+    pthread_mutex_lock(&logger.mutex);
+    cursor = log_sink_memory_read(logger.sinks[LOG_SINK_MEMORY], cursor, callback, context);
+    pthread_mutex_unlock(&logger.mutex);
+    return cursor;
+}
+
+// 切换文件格式（需在启动异步模式之前调用）
+// 当前文件已有另一种格式的内容时先轮转，保证每个文件只含一种格式
+int logger_set_format(LogFileFormat format) {
+    if (__atomic_load_n(&logger.async, __ATOMIC_ACQUIRE)) {
+        return SWK_ERROR;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+
+    if (format == logger.format) {
+        pthread_mutex_unlock(&logger.mutex);
+        return SWK_SUCCESS;
+    }
+
+    __atomic_store_n(&logger.format, format, __ATOMIC_RELAXED);
+
+    if (logger.fd >= 0) {
+        int has_binary = log_binary_is_binary_file(logger.filename);
+        if (logger.file_size > 0 && has_binary != (format == LOG_FORMAT_BINARY)) {
+            logger_rotate_locked();
+        } else if (format == LOG_FORMAT_BINARY) {
+            logger_write_header_locked();
+        }
+    }
+
+    pthread_mutex_unlock(&logger.mutex);
+    return SWK_SUCCESS;
+}
+
+LogFileFormat logger_get_format(void) {
+    return __atomic_load_n(&logger.format, __ATOMIC_RELAXED);
+}
+
+// 解析文件格式名称（配置文件使用）
+LogFileFormat logger_parse_format(const char *name) {
+    if (name && strcmp(name, "binary") == 0) {
+        return LOG_FORMAT_BINARY;
+    }
+    return LOG_FORMAT_TEXT;
+}
+
+const char *logger_format_name(LogFileFormat format) {
+    return format == LOG_FORMAT_BINARY ? "binary" : "text";
+}
+
+// 启动异步模式
+int logger_start_async(size_t queue_size, LogOverflowPolicy policy) {
+    if (logger.fd < 0) {
+        return SWK_ERROR;
+    }
+    if (logger.async) {
+        return SWK_SUCCESS;
+    }
+
+    if (log_ring_init(&logger.ring, queue_size ? queue_size : LOG_DEFAULT_QUEUE_SIZE) != SWK_SUCCESS) {
+        return SWK_ERROR_OUT_OF_MEMORY;
+    }
+
+    logger.overflow = policy;
+    logger.stop = 0;
+    logger.rotate_requested = 0;
+
+    if (pthread_create(&logger.writer, NULL, logger_writer_main, NULL) != 0) {
+        log_ring_destroy(&logger.ring);
+        return SWK_ERROR_SYSTEM_CALL;
+    }
+
+    __atomic_store_n(&logger.async, 1, __ATOMIC_RELEASE);
+    log_message(LOG_DEBUG, "Async logging enabled (queue: %zu, overflow: %d)",
+                logger.ring.capacity, policy);
+    return SWK_SUCCESS;
+}
+
+// 停止异步模式：写出队列中剩余的记录后退回同步模式
+// 调用方需保证此时没有其它线程仍在记录日志
+void logger_stop_async(void) {
+    if (!logger.async) {
+        return;
+    }
+
+    __atomic_store_n(&logger.async, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&logger.stop, 1, __ATOMIC_RELEASE);
+    logger_wake_writer(1);
+    pthread_join(logger.writer, NULL);
+
+    log_ring_destroy(&logger.ring);
+}
+
+// 是否处于异步模式
+int logger_is_async(void) {
+    return __atomic_load_n(&logger.async, __ATOMIC_ACQUIRE);
+}
+
+// 等待已入队的记录全部写出，并等待进行中的归档完成
+void logger_flush(void) {
+    if (tls_is_writer) {
+        return;
+    }
+
+    if (__atomic_load_n(&logger.async, __ATOMIC_ACQUIRE)) {
+        uint64_t target = __atomic_load_n(&logger.ring.tail, __ATOMIC_ACQUIRE);
+        while (__atomic_load_n(&logger.ring.head, __ATOMIC_ACQUIRE) < target) {
+            logger_wake_writer(1);
+            struct timespec pause = {0, 100000};
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    logger_flush_repeats_locked();
+    pthread_mutex_unlock(&logger.mutex);
+
+    logger_archive_wait();
+}
+
+// 获取统计信息
+void logger_get_stats(LoggerStats *stats) {
+    if (!stats) {
+        return;
+    }
+
+    stats->records_written = __atomic_load_n(&logger.stats.records_written, __ATOMIC_RELAXED);
+    stats->records_dropped = __atomic_load_n(&logger.stats.records_dropped, __ATOMIC_RELAXED);
+    stats->bytes_written = __atomic_load_n(&logger.stats.bytes_written, __ATOMIC_RELAXED);
+    stats->rotations = __atomic_load_n(&logger.stats.rotations, __ATOMIC_RELAXED);
+    stats->queue_high_water = __atomic_load_n(&logger.stats.queue_high_water, __ATOMIC_RELAXED);
+    stats->records_rate_limited = __atomic_load_n(&logger.stats.records_rate_limited, __ATOMIC_RELAXED);
+    stats->records_coalesced = __atomic_load_n(&logger.stats.records_coalesced, __ATOMIC_RELAXED);
+
+    stats->sink_dropped = 0;
+    pthread_mutex_lock(&logger.mutex);
+    for (int i = 0; i < LOG_SINK_COUNT; i++) {
+        if (logger.sinks[i]) {
+            stats->sink_dropped += __atomic_load_n(&logger.sinks[i]->dropped, __ATOMIC_RELAXED);
+        }
+    }
+    pthread_mutex_unlock(&logger.mutex);
+}
+
+// 解析溢出策略名称（配置文件使用）
+LogOverflowPolicy logger_parse_overflow_policy(const char *name) {
+    if (!name) {
+        return LOG_OVERFLOW_BLOCK;
+    }
+    if (strcmp(name, "drop_debug") == 0 || strcmp(name, "drop-debug") == 0) {
+        return LOG_OVERFLOW_DROP_DEBUG;
+    }
+    if (strcmp(name, "drop") == 0) {
+        return LOG_OVERFLOW_DROP;
+    }
+    return LOG_OVERFLOW_BLOCK;
+}
+
+// 溢出策略名称
+const char *logger_overflow_policy_name(LogOverflowPolicy policy) {
+    switch (policy) {
+        case LOG_OVERFLOW_DROP_DEBUG: return "drop_debug";
+        case LOG_OVERFLOW_DROP: return "drop";
+        default: return "block";
     }
 }
 
 // 清理日志系统
 void logger_cleanup(void) {
+    logger_stop_async();
+
     pthread_mutex_lock(&logger.mutex);
-    
-    if (logger.file) {
-        log_message(LOG_INFO, "Logger shutting down");
-        fclose(logger.file);
-        logger.file = NULL;
+
+    if (logger.fd >= 0) {
+        char notice[128];
+        size_t length = format_internal(notice, sizeof(notice), LOG_INFO, "Logger shutting down");
+        logger_write_locked(LOG_INFO, notice, length);
+        close(logger.fd);
+        __atomic_store_n(&logger.fd, -1, __ATOMIC_RELAXED);
     }
-    
+
+    free(logger.render_buffer);
+    logger.render_buffer = NULL;
+
     pthread_mutex_unlock(&logger.mutex);
-    pthread_mutex_destroy(&logger.mutex);
+
+    logger_close_sink(LOG_SINK_SOCKET);
+    logger_close_sink(LOG_SINK_MEMORY);
+    logger_archive_stop();
+}
+
+// 重新计算各子系统的生效级别（调用方持有 mutex）
+static void logger_update_thresholds_locked(void) {
+    for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+        int level = logger.subsystem_levels[i] >= 0 ? logger.subsystem_levels[i] : (int)logger.level;
+        __atomic_store_n(&logger_thresholds[i], (uint8_t)level, __ATOMIC_RELAXED);
+    }
 }
 
 // 设置日志级别
 void logger_set_level(LogLevel level) {
     pthread_mutex_lock(&logger.mutex);
-    logger.level = level;
+    logger.level = clamp_level(level);
+    logger_update_thresholds_locked();
     pthread_mutex_unlock(&logger.mutex);
-    
+
     log_message(LOG_DEBUG, "Log level changed to %d", level);
 }
 
+// 设置子系统级别，-1 恢复为跟随全局级别
+int logger_set_subsystem_level(LogSubsystem subsystem, int level) {
+    if ((unsigned)subsystem >= LOG_SUBSYS_COUNT || level < -1 || level > LOG_FATAL) {
+        return SWK_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&logger.mutex);
+    logger.subsystem_levels[subsystem] = level;
+    logger_update_thresholds_locked();
+    pthread_mutex_unlock(&logger.mutex);
+
+    log_message(LOG_DEBUG, "Log level of %s changed to %d", subsystem_names[subsystem], level);
+    return SWK_SUCCESS;
+}
+
+// 获取子系统单独设置的级别（-1 表示跟随全局级别）
+int logger_get_subsystem_level(LogSubsystem subsystem) {
+    if ((unsigned)subsystem >= LOG_SUBSYS_COUNT) {
+        return -1;
+    }
+    return logger.subsystem_levels[subsystem];
+}
+
+// 获取子系统实际生效的级别
+LogLevel logger_get_effective_level(LogSubsystem subsystem) {
+    if ((unsigned)subsystem >= LOG_SUBSYS_COUNT) {
+        return logger.level;
+    }
+    return (LogLevel)__atomic_load_n(&logger_thresholds[subsystem], __ATOMIC_RELAXED);
+}
+
+const char *logger_subsystem_name(LogSubsystem subsystem) {
+    return (unsigned)subsystem < LOG_SUBSYS_COUNT ? subsystem_names[subsystem] : "unknown";
+}
+
+// 按名称查找子系统，未知时返回 -1
+int logger_parse_subsystem(const char *name) {
+    for (int i = 0; name && i < LOG_SUBSYS_COUNT; i++) {
+        if (strcasecmp(name, subsystem_names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 解析级别名或数字
+int logger_parse_level(const char *name) {
+    if (!name || !*name) {
+        return -1;
+    }
+    if (name[0] >= '0' && name[0] <= '9' && name[1] == '\0') {
+        int level = name[0] - '0';
+        return level <= LOG_FATAL ? level : -1;
+    }
+    for (int i = 0; i <= LOG_FATAL; i++) {
+        if (strcasecmp(name, level_names[i]) == 0) {
+            return i;
+        }
+    }
+    if (strcasecmp(name, "WARNING") == 0) {
+        return LOG_WARNING;
+    }
+    return -1;
+}
+
+const char *logger_level_name(LogLevel level) {
+    return level_names[clamp_level(level)];
+}
+
 // 获取当前日志级别
 LogLevel logger_get_level(void) {
     return logger.level;
-}
\ No newline at end of file
+}
@@ -50,7 +50,7 @@ void show_progress_bar(const char *label, int current, int total, ProgressBarTyp
     // 完成后换行
     if (current >= total) {
         printf("\n");
-        log_message(LOG_DEBUG, "Progress completed: %s", label);
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Progress completed: %s", label);
     }
 }
 
@@ -111,7 +111,7 @@ void show_download_progress(const char *label, long long current, long long tota
     
     if (current >= total) {
         printf("\n");
-        log_message(LOG_DEBUG, "Download completed: %s", label);
+        SWK_LOG_DEBUG(LOG_SUBSYS_CORE, "Download completed: %s", label);
     }
 }
 
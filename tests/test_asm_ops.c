@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../include/common_defs.h"
+#include "../include/asm_optimized/cpu_features.h"
+#include "../include/asm_optimized/crc32c.h"
+#include "../include/asm_optimized/simd_string.h"
+#include "../include/asm_optimized/fast_hash.h"
+
+// 测试 CRC32C 标准向量
+void test_crc32c_vectors(void) {
+    printf("Testing CRC32C known vectors (%s)...\n", crc32c_impl_name());
+
+    assert(crc32c(0, "", 0) == 0);
+    assert(crc32c(0, "123456789", 9) == 0xE3069283u);
+
+    unsigned char zeros[32] = {0};
+    unsigned char ones[32];
+    memset(ones, 0xff, sizeof(ones));
+    assert(crc32c(0, zeros, sizeof(zeros)) == 0x8A9136AAu);
+    assert(crc32c(0, ones, sizeof(ones)) == 0x62A8AB43u);
+
+    // 分段计算应与一次性计算一致
+    uint32_t crc = crc32c(0, "1234", 4);
+    crc = crc32c(crc, "56789", 5);
+    assert(crc == 0xE3069283u);
+
+    printf("CRC32C vector tests passed!\n");
+}
+
+// 各实现在不同长度和对齐上的结果必须一致
+void test_crc32c_implementations(void) {
+    printf("Testing CRC32C implementation agreement...\n");
+
+    size_t max_len = 3 * 8192 * 2 + 4099;
+    unsigned char *buf = malloc(max_len + 8);
+    assert(buf != NULL);
+
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < max_len + 8; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(seed >> 16);
+    }
+
+    const CpuFeatures *cpu = cpu_features_get();
+    size_t lengths[] = {0, 1, 7, 8, 15, 63, 255, 383, 384, 767, 768, 1000,
+                        4096, 12288, 24575, 24576, 50000, max_len};
+
+    for (size_t a = 0; a < 8; a++) {
+        for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+            uint32_t expected = crc32c_sw(0, buf + a, lengths[i]);
+            if (cpu->sse42) {
+                assert(crc32c_sse42(0, buf + a, lengths[i]) == expected);
+            }
+            if (cpu->sse42 && cpu->pclmul) {
+                assert(crc32c_pclmul(0, buf + a, lengths[i]) == expected);
+            }
+            assert(crc32c(0, buf + a, lengths[i]) == expected);
+        }
+    }
+
+    free(buf);
+    printf("CRC32C implementation tests passed!\n");
+}
+
+static int compare_u64(const void *x, const void *y) {
+    uint64_t a = *(const uint64_t *)x;
+    uint64_t b = *(const uint64_t *)y;
+    return (a > b) - (a < b);
+}
+
+// 与 libc 差分测试：所有可用实现、不同长度和对齐
+void test_string_ops_differential(void) {
+    const StringOpsImpl *impls;
+    int count = string_ops_get_impls(&impls);
+
+    printf("Testing string ops against libc (active: %s)...\n", string_ops_impl_name());
+
+    size_t cap = 9000;
+    char *a = malloc(cap + 128);
+    assert(a != NULL);
+
+    for (int n = 0; n < count; n++) {
+        const StringOpsImpl *impl = &impls[n];
+        if (!impl->available) {
+            continue;
+        }
+
+        for (size_t align = 0; align < 64; align += 7) {
+            for (size_t len = 0; len < cap; len = len < 80 ? len + 1 : len * 3 / 2) {
+                char *s = a + align;
+                for (size_t i = 0; i < len; i++) {
+                    s[i] = (char)('a' + (i * 7 + len) % 26);
+                }
+                s[len] = '\0';
+
+                assert(impl->strlen_fn(s) == strlen(s));
+            }
+        }
+    }
+
+    free(a);
+    printf("String ops differential tests passed!\n");
+}
+
+// memchr_all：不同匹配密度与输出容量下分批收集的位置与逐字节扫描一致
+void test_memchr_all_differential(void) {
+    const StringOpsImpl *impls;
+    int count = string_ops_get_impls(&impls);
+
+    printf("Testing memchr_all against byte scan...\n");
+
+    size_t cap = 5000;
+    unsigned char *buf = malloc(cap + 64);
+    uint64_t *expected = malloc(sizeof(uint64_t) * cap);
+    uint64_t *found = malloc(sizeof(uint64_t) * cap);
+    assert(buf != NULL && expected != NULL && found != NULL);
+
+    const int densities[] = {1, 3, 40, 1000};
+    const size_t limits[] = {1, 7, 64, 65, 100000};
+
+    for (int n = 0; n < count; n++) {
+        const StringOpsImpl *impl = &impls[n];
+        if (!impl->available) {
+            continue;
+        }
+
+        for (int d = 0; d < 4; d++) {
+            for (size_t align = 0; align < 64; align += 13) {
+                unsigned char *p = buf + align;
+                size_t expected_count = 0;
+                for (size_t i = 0; i < cap; i++) {
+                    p[i] = (unsigned char)(((i * 2654435761u) >> 7) % (size_t)densities[d] == 0 ? '\n' : 'a' + i % 26);
+                    if (p[i] == '\n') {
+                        expected[expected_count++] = 1000 + i;
+                    }
+                }
+
+                for (int l = 0; l < 5; l++) {
+                    size_t total = 0, pos = 0;
+                    while (pos < cap) {
+                        size_t scanned = 0;
+                        size_t max = limits[l] < cap - total ? limits[l] : cap - total;
+                        size_t got = impl->memchr_all_fn(p + pos, cap - pos, '\n', 1000 + pos,
+                                                         found + total, max, &scanned);
+                        assert(got <= max && scanned <= cap - pos);
+                        assert(got > 0 || scanned == cap - pos);
+                        total += got;
+                        pos += scanned;
+                    }
+                    assert(total == expected_count);
+                    assert(memcmp(found, expected, total * sizeof(uint64_t)) == 0);
+                }
+            }
+        }
+    }
+
+    free(buf);
+    free(expected);
+    free(found);
+    printf("memchr_all differential tests passed!\n");
+}
+
+// 字符串紧贴不可访问页时不能越界读取
+void test_string_ops_page_boundary(void) {
+    printf("Testing string ops at page boundaries...\n");
+
+    long page = sysconf(_SC_PAGESIZE);
+    char *region = mmap(NULL, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(region != MAP_FAILED);
+    assert(mprotect(region + page, page, PROT_NONE) == 0);
+
+    const StringOpsImpl *impls;
+    int count = string_ops_get_impls(&impls);
+
+    for (int n = 0; n < count; n++) {
+        if (!impls[n].available) {
+            continue;
+        }
+        for (size_t len = 0; len < 200; len++) {
+            char *s = region + page - len - 1;
+            memset(s, 'k', len);
+            s[len] = '\0';
+            assert(impls[n].strlen_fn(s) == len);
+
+            // 文件映射的末尾同样紧贴不可访问页
+            uint64_t hit;
+            size_t scanned;
+            s[len] = '\n';
+            assert(impls[n].memchr_all_fn(s, len + 1, '\n', 0, &hit, 1, &scanned) == 1 && hit == len);
+        }
+    }
+
+    munmap(region, page * 2);
+    printf("Page boundary tests passed!\n");
+}
+
+// 各实现在所有路径（内联、中等长度、分块累加）上的结果必须一致
+void test_fast_hash_implementations(void) {
+    const FastHashImpl *impls;
+    int count = fast_hash_get_impls(&impls);
+
+    printf("Testing fast hash implementation agreement (active: %s)...\n", fast_hash_impl_name());
+
+    size_t max_len = 5000;
+    unsigned char *buf = malloc(max_len + 64);
+    assert(buf != NULL);
+
+    uint32_t seed = 777;
+    for (size_t i = 0; i < max_len + 64; i++) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (unsigned char)(seed >> 16);
+    }
+
+    for (size_t len = 0; len <= max_len; len = len < 1100 ? len + 1 : len + 97) {
+        for (size_t a = 0; a < 64; a += 21) {
+            uint64_t expected = impls[0].hash_fn(buf + a, len, 42);
+            assert(fast_hash64(buf + a, len, 42) == expected);
+            for (int n = 1; n < count; n++) {
+                if (impls[n].available) {
+                    assert(impls[n].hash_fn(buf + a, len, 42) == expected);
+                }
+            }
+        }
+    }
+
+    // 字符串入口与种子 0 一致
+    assert(fast_hash_str("menu_log_viewer") == fast_hash64("menu_log_viewer", 15, 0));
+
+    free(buf);
+    printf("Fast hash implementation tests passed!\n");
+}
+
+// SMHasher 风格雪崩测试：翻转任意输入位，每个输出位翻转的概率应接近 1/2
+static void check_avalanche(size_t len, int trials, size_t bit_step, double tolerance) {
+    unsigned char *key = malloc(len);
+    int *flips = calloc(len * 8 * 64, sizeof(int));
+    assert(key != NULL && flips != NULL);
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ len;
+    for (int t = 0; t < trials; t++) {
+        for (size_t i = 0; i < len; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            key[i] = (unsigned char)(state >> 56);
+        }
+        uint64_t h = fast_hash64(key, len, 0);
+
+        for (size_t bit = 0; bit < len * 8; bit += bit_step) {
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            uint64_t diff = h ^ fast_hash64(key, len, 0);
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            for (int out = 0; out < 64; out++) {
+                flips[bit * 64 + out] += (int)((diff >> out) & 1);
+            }
+        }
+    }
+
+    double worst = 0.0;
+    for (size_t bit = 0; bit < len * 8; bit += bit_step) {
+        for (int out = 0; out < 64; out++) {
+            double bias = (double)flips[bit * 64 + out] / trials - 0.5;
+            if (bias < 0) bias = -bias;
+            if (bias > worst) worst = bias;
+        }
+    }
+    assert(worst < tolerance);
+
+    free(flips);
+    free(key);
+}
+
+void test_fast_hash_avalanche(void) {
+    printf("Testing fast hash avalanche...\n");
+
+    // 覆盖 2-3、4-16 内联路径，中等长度路径以及分块累加路径
+    size_t short_lens[] = {2, 3, 4, 8, 12, 16, 17, 24, 48, 49, 100};
+    for (size_t i = 0; i < sizeof(short_lens) / sizeof(short_lens[0]); i++) {
+        check_avalanche(short_lens[i], 2000, 1, 0.06);
+    }
+    check_avalanche(512, 1000, 13, 0.1);
+    check_avalanche(2100, 1000, 97, 0.1);
+
+    printf("Fast hash avalanche tests passed!\n");
+}
+
+// 相似键、稀疏键和种子不应产生碰撞，低位分布应均匀
+void test_fast_hash_collisions(void) {
+    printf("Testing fast hash collisions and distribution...\n");
+
+    int count = 200000;
+    uint64_t *hashes = malloc(sizeof(uint64_t) * count);
+    assert(hashes != NULL);
+
+    char key[64];
+    for (int i = 0; i < count; i++) {
+        int len = snprintf(key, sizeof(key), "config.key_%d", i);
+        hashes[i] = fast_hash64(key, (size_t)len, 0);
+    }
+
+    // 低 12 位的桶分布：期望每桶约 48.8 个
+    int buckets[4096] = {0};
+    for (int i = 0; i < count; i++) {
+        buckets[hashes[i] & 4095]++;
+    }
+    double chi2 = 0.0;
+    double expected = (double)count / 4096;
+    for (int i = 0; i < 4096; i++) {
+        chi2 += (buckets[i] - expected) * (buckets[i] - expected) / expected;
+    }
+    // 自由度 4095，均值 4095，标准差约 90.5
+    assert(chi2 < 4095 + 6 * 90.5);
+
+    qsort(hashes, count, sizeof(uint64_t), compare_u64);
+    for (int i = 1; i < count; i++) {
+        assert(hashes[i] != hashes[i - 1]);
+    }
+
+    // 全零键：不同长度必须得到不同哈希
+    unsigned char zeros[2048] = {0};
+    int zero_count = 0;
+    for (size_t len = 0; len < sizeof(zeros); len++) {
+        hashes[zero_count++] = fast_hash64(zeros, len, 0);
+    }
+    qsort(hashes, zero_count, sizeof(uint64_t), compare_u64);
+    for (int i = 1; i < zero_count; i++) {
+        assert(hashes[i] != hashes[i - 1]);
+    }
+
+    // 种子必须改变结果
+    assert(fast_hash64("app_name", 8, 0) != fast_hash64("app_name", 8, 1));
+    assert(fast_hash64(zeros, 1000, 0) != fast_hash64(zeros, 1000, 1));
+
+    free(hashes);
+    printf("Fast hash collision tests passed!\n");
+}
+
+int main(void) {
+    printf("Starting SwiKernel optimized primitive tests...\n\n");
+
+    test_crc32c_vectors();
+    test_crc32c_implementations();
+    test_string_ops_differential();
+    test_memchr_all_differential();
+    test_string_ops_page_boundary();
+    test_fast_hash_implementations();
+    test_fast_hash_avalanche();
+    test_fast_hash_collisions();
+
+    printf("\nAll optimized primitive tests passed! ✓\n");
+    return 0;
+}
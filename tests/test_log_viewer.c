@@ -0,0 +1,935 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/common_defs.h"
+#include "../include/utils/logger.h"
+#include "../include/tui/log_viewer.h"
+#include "../include/tui/log_trigram.h"
+#include "../include/tui/log_timeline.h"
+#include "../include/asm_optimized/crc32c.h"
+#include "../include/utils/log_archive.h"
+
+#define TEST_VIEWER_LOG "/tmp/swikernel_viewer_test.log"
+#define TEST_VIEWER_LINES 20000
+
+static const char *const test_levels[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+// 写出 count 行文本日志，第 i 行的级别为 i % 5
+static void write_text_log(const char *path, const char *mode, int first, int count) {
+    FILE *fp = fopen(path, mode);
+    assert(fp);
+    for (int i = first; i < first + count; i++) {
+        fprintf(fp, "[2024-01-01 00:00:%02d.000] [%s] message %d\n", i % 60, test_levels[i % 5], i);
+        if (i % 1000 == 0) {
+            fprintf(fp, "\n");  // 空行不计入条目
+        }
+    }
+    fclose(fp);
+}
+
+// 行索引：随机访问、按级别计数、增量刷新与轮转
+void test_line_index(void) {
+    printf("Testing log viewer line index...\n");
+
+    LogViewer lv;
+
+    unlink(TEST_VIEWER_LOG);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, TEST_VIEWER_LINES);
+
+    // 最后一行没有换行时暂不索引
+    FILE *fp = fopen(TEST_VIEWER_LOG, "a");
+    fprintf(fp, "[2024-01-01 00:00:00.000] [ERROR] partial");
+    fclose(fp);
+
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(lv.total_entries == TEST_VIEWER_LINES);
+    assert(lv.current_position == TEST_VIEWER_LINES - 1);
+
+    LogEntry *entry = log_viewer_get_entry_at(&lv, 12346);
+    assert(entry && strcmp(entry->message, "message 12346") == 0 && entry->level == LOG_INFO);
+    assert(strcmp(entry->timestamp, "2024-01-01 00:00:46.000") == 0);
+    entry = log_viewer_get_entry_at(&lv, 0);
+    assert(entry && strcmp(entry->message, "message 0") == 0 && entry->level == LOG_DEBUG);
+    assert(log_viewer_get_entry_at(&lv, TEST_VIEWER_LINES) == NULL);
+    assert(log_viewer_get_entries_by_level(&lv, LOG_ERROR) == TEST_VIEWER_LINES / 5);
+
+    // 缓存中的条目在同一槽位被复用前保持有效
+    LogEntry *first = log_viewer_get_entry_at(&lv, 100);
+    LogEntry *second = log_viewer_get_entry_at(&lv, 101);
+    assert(first != second && strcmp(first->message, "message 100") == 0);
+
+    // 导航
+    assert(log_viewer_scroll_to_top(&lv) == SWK_SUCCESS && lv.current_position == 0);
+    assert(log_viewer_scroll_up(&lv, 5) == SWK_SUCCESS && lv.current_position == 0);
+    log_viewer_page_down(&lv);
+    assert(lv.current_position == lv.visible_entries);
+    log_viewer_scroll_to_bottom(&lv);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 19999") == 0);
+
+    // 补全最后一行并追加新内容后增量索引
+    fp = fopen(TEST_VIEWER_LOG, "a");
+    fprintf(fp, " line\n");
+    fclose(fp);
+    write_text_log(TEST_VIEWER_LOG, "a", TEST_VIEWER_LINES, 10);
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    assert(lv.total_entries == TEST_VIEWER_LINES + 11);
+    assert(strcmp(log_viewer_get_entry_at(&lv, TEST_VIEWER_LINES)->message, "partial line") == 0);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 20009") == 0);
+
+    // 文件被替换后重新加载
+    unlink(TEST_VIEWER_LOG);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, 3);
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    assert(lv.total_entries == 3);
+
+    log_viewer_cleanup(&lv);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log viewer line index test passed!\n");
+}
+
+// 过滤：级别位图、字面量与正则匹配、组合条件、视图导航和增量更新
+void test_filters(void) {
+    printf("Testing log viewer filters...\n");
+
+    LogViewer lv;
+    unlink(TEST_VIEWER_LOG);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, TEST_VIEWER_LINES);
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(log_viewer_get_filtered_entries(&lv) == TEST_VIEWER_LINES);
+
+    // 改变过滤条件时保持在当前行或其后第一条通过过滤的行
+    lv.current_position = 12346;
+    log_viewer_set_level_filter(&lv, LOG_ERROR);
+    assert(log_viewer_get_filtered_entries(&lv) == TEST_VIEWER_LINES * 2 / 5);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 12348") == 0);
+    log_viewer_scroll_down(&lv, 1);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 12349") == 0);
+    log_viewer_scroll_down(&lv, 1);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 12353") == 0);
+
+    // 字面量与级别组合：1234 与 12340..12349 中级别不低于 ERROR 的
+    log_viewer_set_pattern_filter(&lv, "message 1234");
+    assert(log_viewer_get_filtered_entries(&lv) == 5);
+    const char *expected[] = {"message 1234", "message 12343", "message 12344", "message 12348", "message 12349"};
+    for (int i = 0; i < 5; i++) {
+        assert(strcmp(log_viewer_get_view_entry(&lv, i)->message, expected[i]) == 0);
+    }
+    assert(log_viewer_get_view_entry(&lv, 5) == NULL);
+
+    // 正则（$ 匹配行尾）
+    log_viewer_set_level_filter(&lv, LOG_DEBUG);
+    log_viewer_set_pattern_filter(&lv, "message 1(23|99)4$");
+    assert(log_viewer_get_filtered_entries(&lv) == 2);
+    assert(strcmp(log_viewer_get_view_entry(&lv, 1)->message, "message 1994") == 0);
+
+    // 必含字面量：{m,n} 与方括号的内容不算字面量
+    static const struct { const char *regex; const char *literal; } required[] = {
+        {"x{100}", ""}, {"ab{10,20}", "a"}, {"[]abc]", ""}, {"[]abc]def", "def"},
+        {"[^]x]yz", "yz"}, {"[[:alpha:]]]k", "k"}, {"(a[)]b)cd", "cd"}, {"err\\(+x", "err("},
+        {"message 1(23|99)4$", "message 1"}, {"disk\\wfull", "disk"}, {"a\\Wbcdef", "bcdef"},
+        {"x\\<word", "word"}, {"\\bdisk\\b", "disk"}
+    };
+    char literal[64];
+    for (size_t i = 0; i < sizeof(required) / sizeof(required[0]); i++) {
+        log_filter_required_literal(required[i].regex, literal, sizeof(literal));
+        assert(strcmp(literal, required[i].literal) == 0);
+    }
+    log_viewer_set_pattern_filter(&lv, "message\\s1224\\b");
+    assert(log_viewer_get_filtered_entries(&lv) == 1);
+    log_viewer_set_pattern_filter(&lv, "message 12{2}4$");
+    assert(log_viewer_get_filtered_entries(&lv) == 1);
+    assert(strcmp(log_viewer_get_view_entry(&lv, 0)->message, "message 1224") == 0);
+
+    // 来源与模式同时生效
+    log_viewer_set_pattern_filter(&lv, "9$");
+    log_viewer_set_source_filter(&lv, "message 1234");
+    assert(log_viewer_get_filtered_entries(&lv) == 1);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 12349") == 0);
+
+    // 新追加的行按需补算
+    write_text_log(TEST_VIEWER_LOG, "a", 123409, 1);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    assert(log_viewer_get_filtered_entries(&lv) == 2);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 123409") == 0);
+
+    log_viewer_clear_filters(&lv);
+    assert(log_viewer_get_filtered_entries(&lv) == TEST_VIEWER_LINES + 1);
+    assert(log_viewer_get_entries_by_level(&lv, LOG_FATAL) == TEST_VIEWER_LINES / 5 + 1);
+
+    log_viewer_cleanup(&lv);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log viewer filters test passed!\n");
+}
+
+// inotify 跟随：追加、轮转（移走后新建同名文件）和截断
+void test_follow_tail(void) {
+    printf("Testing log viewer inotify tail following...\n");
+
+    char rotated[256];
+    LogViewer lv;
+    snprintf(rotated, sizeof(rotated), "%s.1", TEST_VIEWER_LOG);
+    unlink(TEST_VIEWER_LOG);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, 10);
+
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(log_viewer_get_watch_fd(&lv) >= 0);
+    assert(lv.total_entries == 10);
+
+    // 没有变化时刷新立即返回
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS && lv.total_entries == 10);
+
+    write_text_log(TEST_VIEWER_LOG, "a", 10, 5);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    assert(lv.total_entries == 15);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 14") == 0);
+
+    // 移走后、新文件出现前继续跟随旧文件
+    assert(rename(TEST_VIEWER_LOG, rotated) == 0);
+    write_text_log(rotated, "a", 15, 1);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    assert(lv.total_entries == 16);
+
+    write_text_log(TEST_VIEWER_LOG, "w", 100, 3);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    assert(lv.total_entries == 3);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "message 102") == 0);
+
+    // 原地截断后重新加载
+    write_text_log(TEST_VIEWER_LOG, "w", 200, 2);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    assert(lv.total_entries == 2);
+    assert(strcmp(log_viewer_get_entry_at(&lv, 0)->message, "message 200") == 0);
+
+    log_viewer_cleanup(&lv);
+    unlink(TEST_VIEWER_LOG);
+    unlink(rotated);
+    printf("Log viewer inotify tail following test passed!\n");
+}
+
+static void record_progress(uint64_t done, uint64_t total, void *context) {
+    uint64_t *last = context;
+
+    assert(done <= total && done >= last[0]);
+    last[0] = done;
+    last[1] = total;
+}
+
+// 并行建立的索引与逐行扫描一致；索引文件在日志未变化时直接载入，追加后沿用已有部分
+void test_index_build_and_sidecar(void) {
+    printf("Testing log line index build and sidecar...\n");
+
+    size_t size = LOG_INDEX_PARALLEL_MIN * 2 + 12345;
+    char *text = malloc(size);
+    assert(text);
+    for (size_t i = 0; i < size; i++) {
+        size_t mix = (i * 2654435761u) >> 5;
+        text[i] = mix % 97 == 0 ? '\n' : mix % 991 == 0 ? '\r' : 'a' + (char)(i % 26);
+    }
+
+    LogLineIndex serial, parallel;
+    uint64_t progress[2] = {0, 0};
+    log_index_init(&serial);
+    log_index_init(&parallel);
+    size_t serial_end = log_index_scan(&serial, text, 0, size);
+    size_t parallel_end = log_index_build(&parallel, text, 0, size, record_progress, progress);
+    assert(serial_end == parallel_end && serial.count == parallel.count && serial.count > 0);
+    assert(memcmp(serial.offsets, parallel.offsets, serial.count * sizeof(uint64_t)) == 0);
+    assert(progress[0] == size && progress[1] == size);
+    log_index_free(&serial);
+    log_index_free(&parallel);
+    free(text);
+
+    // 超过 LOG_INDEX_SAVE_MIN 的日志在首次打开时写出索引文件
+    char sidecar[256];
+    int lines = LOG_INDEX_SAVE_MIN / 40;
+    LogViewer lv;
+    snprintf(sidecar, sizeof(sidecar), "%s%s", TEST_VIEWER_LOG, LOG_INDEX_SUFFIX);
+    unlink(TEST_VIEWER_LOG);
+    unlink(sidecar);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, lines);
+
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(lv.total_entries == lines);
+    assert(access(sidecar, F_OK) == 0);
+    log_viewer_cleanup(&lv);
+
+    struct stat st;
+    LogLineIndex loaded;
+    int fd = open(TEST_VIEWER_LOG, O_RDONLY);
+    assert(fd >= 0 && fstat(fd, &st) == 0);
+    char *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(map != MAP_FAILED);
+    log_index_init(&loaded);
+    assert(log_index_load(&loaded, TEST_VIEWER_LOG, &st, map) == (size_t)st.st_size);
+    assert(loaded.count == (size_t)lines);
+    off_t indexed = st.st_size;
+
+    // 偏移不递增的索引文件被拒绝
+    uint64_t saved[2], swapped[2];
+    int sfd = open(sidecar, O_RDWR);
+    assert(sfd >= 0 && pread(sfd, saved, sizeof(saved), sizeof(LogIndexFileHeader)) == sizeof(saved));
+    swapped[0] = saved[1];
+    swapped[1] = saved[0];
+    assert(pwrite(sfd, swapped, sizeof(swapped), sizeof(LogIndexFileHeader)) == sizeof(swapped));
+    assert(log_index_load(&loaded, TEST_VIEWER_LOG, &st, map) == 0 && loaded.count == 0);
+    assert(pwrite(sfd, saved, sizeof(saved), sizeof(LogIndexFileHeader)) == sizeof(saved));
+    close(sfd);
+    munmap(map, (size_t)st.st_size);
+    close(fd);
+
+    // 追加后只索引新增部分
+    write_text_log(TEST_VIEWER_LOG, "a", lines, 10);
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(lv.total_entries == lines + 10);
+    char expected[64];
+    snprintf(expected, sizeof(expected), "message %d", lines + 9);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, expected) == 0);
+    log_viewer_cleanup(&lv);
+
+    // 已索引部分被改写后不再信任索引文件
+    fd = open(TEST_VIEWER_LOG, O_RDWR);
+    assert(fd >= 0 && pwrite(fd, "#", 1, indexed - 20) == 1 && fstat(fd, &st) == 0);
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(map != MAP_FAILED);
+    assert(log_index_load(&loaded, TEST_VIEWER_LOG, &st, map) == 0 && loaded.count == 0);
+    munmap(map, (size_t)st.st_size);
+    close(fd);
+
+    unlink(TEST_VIEWER_LOG);
+    unlink(sidecar);
+    snprintf(sidecar, sizeof(sidecar), "%s%s", TEST_VIEWER_LOG, LOG_TRIGRAM_SUFFIX);
+    unlink(sidecar);
+    printf("Log line index build and sidecar test passed!\n");
+}
+
+static const char *current_message(LogViewer *lv) {
+    LogEntry *entry = log_viewer_get_current_entry(lv);
+    assert(entry);
+    return entry->message;
+}
+
+// 三元组索引：候选块包含所有真正含有字面量的块，索引文件载入后结果相同
+void test_trigram_index(void) {
+    printf("Testing log trigram index...\n");
+
+    size_t size = LOG_TRIGRAM_MIN + 4321;
+    char *text = malloc(size);
+    assert(text);
+    for (size_t i = 0; i < size; i++) {
+        size_t mix = (i * 2654435761u) >> 7;
+        text[i] = mix % 61 == 0 ? '\n' : 'a' + (char)(mix % 11);
+    }
+    // 最后一个换行之后的部分不索引
+    size_t last = size;
+    while (text[last - 1] != '\n') {
+        last--;
+    }
+
+    LogTrigramIndex index, loaded;
+    log_trigram_init(&index);
+    log_trigram_init(&loaded);
+    assert(log_trigram_extend(&index, text, size / 2, NULL) == SWK_SUCCESS);
+    assert(log_trigram_covered(&index) <= size / 2);
+    assert(log_trigram_extend(&index, text, size, NULL) == SWK_SUCCESS);
+    assert(log_trigram_covered(&index) == last);
+
+    const char *literals[] = {"abcab", "kkkkk", "fed", "aaaaaaa", "hijk", "zzz"};
+    for (size_t n = 0; n < sizeof(literals) / sizeof(literals[0]); n++) {
+        uint32_t *blocks;
+        long count = log_trigram_candidates(&index, literals[n], strlen(literals[n]), &blocks);
+        assert(count >= 0);
+        for (uint32_t b = 0, c = 0; b < index.block_count; b++) {
+            while (c < (uint32_t)count && blocks[c] < b) {
+                c++;
+            }
+            const char *start = text + index.blocks[b];
+            size_t length = index.blocks[b + 1] - index.blocks[b];
+            if (memmem(start, length, literals[n], strlen(literals[n]))) {
+                assert(c < (uint32_t)count && blocks[c] == b);
+            }
+        }
+        free(blocks);
+    }
+    uint32_t *blocks;
+    assert(log_trigram_candidates(&index, "ab", 2, &blocks) == -1);
+
+    // 索引文件：文件未变化时载入，内容变化后拒绝
+    int fd = open(TEST_VIEWER_LOG, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    struct stat st;
+    assert(fd >= 0 && write(fd, text, size) == (ssize_t)size && fstat(fd, &st) == 0);
+    assert(log_trigram_save(&index, TEST_VIEWER_LOG, &st, text) == SWK_SUCCESS);
+    assert(log_trigram_load(&loaded, TEST_VIEWER_LOG, &st, text) == SWK_SUCCESS);
+    assert(loaded.block_count == index.block_count && loaded.used == index.used);
+    assert(memcmp(loaded.blocks, index.blocks, (index.block_count + 1) * sizeof(uint64_t)) == 0);
+    uint32_t *a, *b;
+    long count = log_trigram_candidates(&index, "hijk", 4, &a);
+    assert(log_trigram_candidates(&loaded, "hijk", 4, &b) == count);
+    assert(count == 0 || memcmp(a, b, (size_t)count * sizeof(uint32_t)) == 0);
+    free(a);
+    free(b);
+
+    // 索引文件内容损坏：校验和不符时拒绝；校验和被一并改写时，
+    // 截断的倒排表（最后一个 varint 缺少结尾）也会被拒绝
+    char sidecar[256];
+    snprintf(sidecar, sizeof(sidecar), "%s%s", TEST_VIEWER_LOG, LOG_TRIGRAM_SUFFIX);
+    int sfd = open(sidecar, O_RDWR);
+    struct stat sst;
+    assert(sfd >= 0 && fstat(sfd, &sst) == 0 && sst.st_size > (off_t)sizeof(LogTrigramFileHeader));
+    uint8_t *body = malloc((size_t)sst.st_size);
+    assert(body && pread(sfd, body, (size_t)sst.st_size, 0) == sst.st_size);
+    LogTrigramFileHeader *sheader = (LogTrigramFileHeader *)body;
+    body[sst.st_size - 1] = 0x80;
+    assert(pwrite(sfd, body, (size_t)sst.st_size, 0) == sst.st_size);
+    assert(log_trigram_load(&loaded, TEST_VIEWER_LOG, &st, text) != SWK_SUCCESS);
+    assert(loaded.used == 0);
+    sheader->crc = crc32c(0, body + sizeof(*sheader), (size_t)sst.st_size - sizeof(*sheader));
+    assert(pwrite(sfd, body, (size_t)sst.st_size, 0) == sst.st_size);
+    assert(log_trigram_load(&loaded, TEST_VIEWER_LOG, &st, text) != SWK_SUCCESS);
+    assert(loaded.used == 0);
+    free(body);
+    close(sfd);
+    assert(log_trigram_save(&index, TEST_VIEWER_LOG, &st, text) == SWK_SUCCESS);
+
+    text[last - 10] = '#';
+    assert(log_trigram_load(&loaded, TEST_VIEWER_LOG, &st, text) != SWK_SUCCESS);
+    assert(loaded.used == 0);
+
+    log_trigram_free(&index);
+    log_trigram_free(&loaded);
+    close(fd);
+    free(text);
+
+    unlink(TEST_VIEWER_LOG);
+    unlink(sidecar);
+    printf("Log trigram index test passed!\n");
+}
+
+// 搜索：从当前行向后/向前查找并回绕，遵守当前过滤；大日志使用三元组索引
+void test_search(void) {
+    printf("Testing log viewer search...\n");
+
+    LogViewer lv;
+
+    unlink(TEST_VIEWER_LOG);
+    write_text_log(TEST_VIEWER_LOG, "w", 0, TEST_VIEWER_LINES);
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(!log_viewer_search_indexed(&lv));
+
+    assert(log_viewer_search_next(&lv, "message 12345") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 12345") == 0);
+    assert(log_viewer_search_next(&lv, "message 1234") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 12346") == 0);
+    assert(log_viewer_search_prev(&lv, "message 1234") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 12345") == 0);
+    assert(log_viewer_search_prev(&lv, "message 123[0-9]$") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 1239") == 0);
+    assert(log_viewer_search_prev(&lv, "message 19999") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 19999") == 0);
+    assert(log_viewer_search_next(&lv, "no such text") == SWK_ERROR);
+    assert(strcmp(current_message(&lv), "message 19999") == 0);
+
+    // 只在通过过滤的行中查找
+    log_viewer_set_level_filter(&lv, LOG_ERROR);
+    assert(log_viewer_search_next(&lv, "message 1234") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 1234") == 0);
+    assert(log_viewer_search_next(&lv, "message 1234") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 12343") == 0);
+    assert(log_viewer_search_prev(&lv, "message 1234") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 1234") == 0);
+    log_viewer_cleanup(&lv);
+
+    // 大日志等后台索引建立完成后再查找，之后追加的内容线性查找
+    int lines = LOG_TRIGRAM_MIN / 40 + 20000;
+    write_text_log(TEST_VIEWER_LOG, "w", 0, lines);
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    for (int i = 0; i < 1000 && !log_viewer_search_indexed(&lv); i++) {
+        usleep(10000);
+    }
+    assert(log_viewer_search_indexed(&lv));
+
+    char expected[64];
+    assert(log_viewer_search_next(&lv, "message 77777") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 77777") == 0);
+    assert(log_viewer_search_next(&lv, "message 7777") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 77778") == 0);
+    assert(log_viewer_search_prev(&lv, "message 7777") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 77777") == 0);
+    assert(log_viewer_search_prev(&lv, "FATAL] message 4$") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 4") == 0);
+    assert(log_viewer_search_prev(&lv, "message 0$") == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), "message 0") == 0);
+    assert(log_viewer_search_next(&lv, "no such text") == SWK_ERROR);
+
+    write_text_log(TEST_VIEWER_LOG, "a", lines, 5);
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    snprintf(expected, sizeof(expected), "message %d", lines + 3);
+    assert(log_viewer_search_prev(&lv, expected) == SWK_SUCCESS);
+    assert(strcmp(current_message(&lv), expected) == 0);
+    log_viewer_cleanup(&lv);
+
+    // 再次打开时载入索引文件
+    char sidecar[256];
+    snprintf(sidecar, sizeof(sidecar), "%s%s", TEST_VIEWER_LOG, LOG_TRIGRAM_SUFFIX);
+    assert(access(sidecar, F_OK) == 0);
+
+    char lidx[256];
+    snprintf(lidx, sizeof(lidx), "%s%s", TEST_VIEWER_LOG, LOG_INDEX_SUFFIX);
+    unlink(TEST_VIEWER_LOG);
+    unlink(sidecar);
+    unlink(lidx);
+    printf("Log viewer search test passed!\n");
+}
+
+// 统计：级别、来源、时间桶与重复消息随索引和跟随尾部增量更新；并行统计与逐行统计一致
+void test_stats(void) {
+    printf("Testing log viewer statistics...\n");
+
+    assert(log_stats_line_minute("[2024-01-01 00:00:00.000] [INFO] x", 34) == 19723LL * 1440);
+    assert(log_stats_line_minute("[2024-03-01 13:05:00.000]", 25) == (19783LL * 1440 + 13 * 60 + 5));
+    assert(log_stats_line_minute("no timestamp here at all", 24) == -1);
+
+    // 两小时内每分钟若干条，第二个小时的错误更多
+    FILE *fp = fopen(TEST_VIEWER_LOG, "w");
+    assert(fp);
+    for (int i = 0; i < 1200; i++) {
+        int hour = i / 600, minute = (i % 600) / 10;
+        const char *level = i % (hour ? 4 : 20) == 0 ? "ERROR" : "INFO";
+        if (i % 3 == 0) {
+            fprintf(fp, "[2024-01-01 %02d:%02d:00.000] [%s] disk: sda%d is %d%% full\n", hour, minute, level, i % 4, i % 100);
+        } else if (i % 3 == 1) {
+            fprintf(fp, "[2024-01-01 %02d:%02d:00.000] [%s] [net] eth0 dropped %d packets\n", hour, minute, level, i);
+        } else {
+            fprintf(fp, "[2024-01-01 %02d:%02d:00.000] [%s] unique message %c%c\n", hour, minute, level,
+                    'a' + i % 26, 'a' + i / 26 % 26);
+        }
+    }
+    fprintf(fp, "continuation line without timestamp\n");
+    fclose(fp);
+
+    LogViewer lv;
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    const LogStats *stats = log_viewer_get_stats(&lv);
+    assert(stats->lines == 1201 && stats->untimed == 1);
+    assert(stats->level_counts[LOG_ERROR] == 30 + 150);
+    assert(log_viewer_get_entries_by_level(&lv, LOG_ERROR) == 180);
+    assert(stats->level_counts[LOG_INFO] == 1201 - 180);
+
+    int64_t base = 19723LL * 1440;
+    assert(stats->first_minute == base && stats->last_minute == base + 119);
+    assert(log_stats_minute(stats, base + 61)->total == 10);
+    assert(log_stats_hour(stats, base / 60)->total == 600 && log_stats_hour(stats, base / 60)->errors == 30);
+    assert(log_stats_hour(stats, base / 60 + 1)->errors == 150);
+    assert(log_stats_day(stats, base / 1440)->total == 1200);
+    assert(log_stats_hour(stats, base / 60 + 2) == NULL);
+
+    int disk = -1, net = -1;
+    for (int i = 0; i < stats->source_count; i++) {
+        if (strcmp(stats->sources[i].name, "disk") == 0) disk = i;
+        if (strcmp(stats->sources[i].name, "net") == 0) net = i;
+    }
+    assert(disk >= 0 && net >= 0);
+    assert(stats->sources[disk].count == 400 && stats->sources[net].count == 400);
+    assert(stats->sources[LOG_STATS_SOURCES].count == 401);
+
+    // 数字折叠后两类消息各 400 条，远多于其他消息
+    LogStatsMessage top[3];
+    assert(log_stats_top_messages(stats, top, 3) == 3);
+    assert(top[0].count >= 400 && top[1].count >= 400 && top[2].count < top[1].count);
+    assert(strcmp(top[0].text, "disk: sda# is #% full") == 0 || strcmp(top[1].text, "disk: sda# is #% full") == 0);
+    assert(top[0].count - top[0].error <= 400);
+
+    // 第二个小时的错误率是第一个的五倍
+    char sparkline[64];
+    assert(log_stats_error_sparkline(stats, 3, sparkline, sizeof(sparkline)) == 1 + 3 + 3);
+    assert(strcmp(sparkline, " ▁█") == 0 || strcmp(sparkline, " ▂█") == 0);
+
+    // 跟随尾部时只统计新增的行
+    fp = fopen(TEST_VIEWER_LOG, "a");
+    fprintf(fp, "[2024-01-01 02:00:00.000] [FATAL] net: link down\n");
+    fclose(fp);
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    assert(stats->lines == 1202 && stats->level_counts[LOG_FATAL] == 1);
+    assert(stats->last_minute == base + 120 && log_stats_hour(stats, base / 60 + 2)->errors == 1);
+    assert(stats->sources[net].count == 401);
+    log_viewer_cleanup(&lv);
+
+    // 并行统计后合并与逐行统计一致（计数与时间桶完全相同）
+    int lines = LOG_STATS_PARALLEL_MIN * 2 + 7;
+    write_text_log(TEST_VIEWER_LOG, "w", 0, lines);
+    int fd = open(TEST_VIEWER_LOG, O_RDONLY);
+    struct stat st;
+    assert(fd >= 0 && fstat(fd, &st) == 0);
+    char *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(map != MAP_FAILED);
+
+    LogLineIndex index;
+    LogStats *serial = malloc(sizeof(LogStats)), *parallel = malloc(sizeof(LogStats));
+    assert(serial && parallel);
+    log_index_init(&index);
+    log_index_scan(&index, map, 0, (size_t)st.st_size);
+    assert(index.count == (size_t)lines);
+    log_stats_init(parallel);
+    log_stats_update(parallel, map, (size_t)st.st_size, &index);
+
+    // 逐行统计：每次只给一行
+    log_stats_init(serial);
+    LogLineIndex partial = index;
+    for (size_t i = 1; i <= index.count; i += 997) {
+        partial.count = i;
+        log_stats_update(serial, map, (size_t)st.st_size, &partial);
+    }
+    log_stats_update(serial, map, (size_t)st.st_size, &index);
+
+    assert(serial->lines == parallel->lines && serial->lines == (size_t)lines);
+    assert(memcmp(serial->level_counts, parallel->level_counts, sizeof(serial->level_counts)) == 0);
+    assert(memcmp(serial->minutes, parallel->minutes, sizeof(serial->minutes)) == 0);
+    assert(memcmp(serial->hours, parallel->hours, sizeof(serial->hours)) == 0);
+    assert(serial->level_counts[LOG_ERROR] == (uint64_t)(lines + 1) / 5);
+    assert(log_stats_top_messages(serial, top, 1) == 1 && strcmp(top[0].text, "message #") == 0);
+    assert(log_stats_top_messages(parallel, top, 1) == 1 && strcmp(top[0].text, "message #") == 0);
+    assert(top[0].count == (uint64_t)lines);
+
+    free(serial);
+    free(parallel);
+    log_index_free(&index);
+    munmap(map, (size_t)st.st_size);
+    close(fd);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log viewer statistics test passed!\n");
+}
+
+// 二进制日志与内存环都渲染成文本后建立同样的索引
+void test_rendered_sources(void) {
+    printf("Testing log viewer rendered sources...\n");
+
+    LogViewer lv;
+
+    unlink(TEST_VIEWER_LOG);
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+    assert(logger_init(TEST_VIEWER_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_open_memory_sink(16, LOG_INFO) == SWK_SUCCESS);
+    for (int i = 0; i < 100; i++) {
+        log_message(LOG_WARNING, "binary entry %d", i);
+    }
+
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(lv.binary);
+    assert(log_viewer_get_entries_by_level(&lv, LOG_WARNING) == 100);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "binary entry 99") == 0);
+
+    log_message(LOG_ERROR, "binary tail");
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "binary tail") == 0);
+
+    // 内存环只保留最近 16 条（INFO 以上，查看器自身的 DEBUG 日志不进入）
+    assert(log_viewer_open_memory(&lv) == SWK_SUCCESS);
+    assert(lv.total_entries == 16);
+    assert(strcmp(log_viewer_get_entry_at(&lv, 0)->message, "binary entry 85") == 0);
+    log_message(LOG_INFO, "memory tail");
+    assert(log_viewer_refresh(&lv) == SWK_SUCCESS);
+    assert(lv.total_entries == 17);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "memory tail") == 0);
+
+    log_viewer_cleanup(&lv);
+    logger_cleanup();
+
+    // 时间线按记录边界把未压缩的二进制日志切成多块，逐块渲染
+    unlink(TEST_VIEWER_LOG);
+    assert(logger_init(TEST_VIEWER_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    for (int i = 0; i < 20000; i++) {
+        log_message(LOG_INFO, "timeline entry %d", i);
+    }
+    logger_cleanup();
+
+    LogTimeline tl;
+    LogTimelineEntry entry;
+    int next = 0;
+    assert(log_timeline_open(&tl, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(tl.source_count == 1 && tl.sources[0].block_count > 1);
+    while (log_timeline_next(&tl, &entry)) {
+        const char *text = strstr(entry.line, "timeline entry ");
+        if (text) {
+            assert(atoi(text + 15) == next);
+            next++;
+        }
+    }
+    assert(next == 20000);
+    log_timeline_close(&tl);
+
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log viewer rendered sources test passed!\n");
+}
+
+// 时间列测试日志：第 i 行时间为 2024-03-10 23:59:00 之后 i * 250 毫秒（跨过午夜），
+// 每 7 行后跟一行续行，每 500 行有一行时间倒退 5 秒
+static int64_t time_test_ms(int i) {
+    return log_time_parse("[2024-03-10 23:59:00.000]", 25) + (int64_t)i * 250 - (i > 0 && i % 500 == 0 ? 5000 : 0);
+}
+
+static void write_time_log(const char *mode, int first, int count) {
+    FILE *fp = fopen(TEST_VIEWER_LOG, mode);
+    char stamp[32];
+    assert(fp);
+    for (int i = first; i < first + count; i++) {
+        log_time_format(time_test_ms(i), stamp, sizeof(stamp));
+        fprintf(fp, "[%s] [%s] tick %d\n", stamp, test_levels[i % 5], i);
+        if (i % 7 == 0) {
+            fprintf(fp, "  detail of tick %d\n", i);
+        }
+    }
+    fclose(fp);
+}
+
+// 时间戳解析、时间列二分、跳到时间与时间范围过滤
+void test_time_column(void) {
+    printf("Testing log viewer time column...\n");
+
+    // 定长解析与 timegm 一致
+    assert(log_time_parse("[1970-01-01 00:00:01.500] x", 27) == 1500);
+    assert(log_time_parse("[2024-13-01 00:00:00.000]", 25) == -1);
+    assert(log_time_parse("[2024-01-01 00:00:00.000", 24) == -1);
+    assert(log_time_parse("2024-01-01 00:00:00.000] x", 26) == -1);
+    srand(42);
+    for (int i = 0; i < 1000; i++) {
+        struct tm tm_info = {0};
+        char line[64];
+        tm_info.tm_year = 70 + rand() % 100;
+        tm_info.tm_mon = rand() % 12;
+        tm_info.tm_mday = 1 + rand() % 28;
+        tm_info.tm_hour = rand() % 24;
+        tm_info.tm_min = rand() % 60;
+        tm_info.tm_sec = rand() % 60;
+        int msec = rand() % 1000;
+        snprintf(line, sizeof(line), "[%04d-%02d-%02d %02d:%02d:%02d.%03d] [INFO] x", tm_info.tm_year + 1900,
+                 tm_info.tm_mon + 1, tm_info.tm_mday, tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec, msec);
+        assert(log_time_parse(line, strlen(line)) == (int64_t)timegm(&tm_info) * 1000 + msec);
+    }
+
+    // 输入可以只写前缀
+    const char *full = "[2024-03-11 00:01:02.003]";
+    assert(log_time_parse_input("2024-03-11 00:01:02.003") == log_time_parse(full, 25));
+    assert(log_time_parse_input(" [2024-03-11 00:01] ") == log_time_parse("[2024-03-11 00:01:00.000]", 25));
+    assert(log_time_parse_input("2024-03-11") == log_time_parse("[2024-03-11 00:00:00.000]", 25));
+    assert(log_time_parse_input("2024") == log_time_parse("[2024-01-01 00:00:00.000]", 25));
+    assert(log_time_parse_input("20x4") == -1 && log_time_parse_input("") == -1);
+
+    // 系统时间换算为日志中的本地时间
+    struct tm local = {.tm_year = 124, .tm_mon = 2, .tm_mday = 11, .tm_min = 1, .tm_sec = 2, .tm_isdst = -1};
+    int64_t epoch_ms = (int64_t)mktime(&local) * 1000 + 3;
+    assert(log_time_from_epoch(epoch_ms) == log_time_parse(full, 25));
+
+    LogViewer lv;
+    int lines = 5000;
+    unlink(TEST_VIEWER_LOG);
+    write_time_log("w", 0, lines);
+    assert(log_viewer_init(&lv, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(lv.times.count == (size_t)lv.total_entries);
+
+    // 列单调不减，二分与线性查找一致
+    for (size_t line = 1; line < lv.times.count; line++) {
+        assert(log_time_at(&lv.times, line) >= log_time_at(&lv.times, line - 1));
+    }
+    for (int64_t ms = time_test_ms(0) - 1000; ms < time_test_ms(lines) + 1000; ms += 37) {
+        size_t expected = 0;
+        while (expected < lv.times.count && log_time_at(&lv.times, expected) < ms) {
+            expected++;
+        }
+        assert(log_time_lower_bound(&lv.times, ms) == expected);
+    }
+
+    // 跳到时间
+    assert(log_viewer_jump_to_time(&lv, time_test_ms(1234)) == SWK_SUCCESS);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "tick 1234") == 0);
+    assert(log_viewer_jump_to_time(&lv, time_test_ms(1234) - 1) == SWK_SUCCESS);
+    assert(strcmp(log_viewer_get_current_entry(&lv)->message, "tick 1234") == 0);
+    assert(log_viewer_jump_to_time(&lv, 0) == SWK_SUCCESS && lv.current_position == 0);
+    assert(log_viewer_jump_to_time(&lv, time_test_ms(lines - 1) + 1) == SWK_SUCCESS);
+    assert(lv.current_position == lv.total_entries - 1);
+
+    // 时间范围（含两端）与级别过滤组合；第 2000 行时间倒退到范围内，同样计入
+    int expected = 0, expected_errors = 0;
+    for (int i = 1001; i <= 2000; i++) {
+        expected += 1 + (i % 7 == 0);
+        expected_errors += i % 5 >= LOG_ERROR;
+    }
+    log_viewer_set_time_filter(&lv, time_test_ms(1001), time_test_ms(1999));
+    assert(log_viewer_get_filtered_entries(&lv) == expected);
+    assert(strcmp(log_viewer_get_view_entry(&lv, 0)->message, "tick 1001") == 0);
+    log_viewer_set_level_filter(&lv, LOG_ERROR);
+    assert(log_viewer_get_filtered_entries(&lv) == expected_errors);
+
+    // 结束时间不限时，新追加的行进入范围
+    log_viewer_set_level_filter(&lv, LOG_DEBUG);
+    log_viewer_set_time_filter(&lv, time_test_ms(lines - 10), -1);
+    int before = log_viewer_get_filtered_entries(&lv);
+    write_time_log("a", lines, 100);
+    assert(log_viewer_wait(&lv, 1000) == SWK_SUCCESS);
+    int appended = 0;
+    for (int i = lines; i < lines + 100; i++) {
+        appended += 1 + (i % 7 == 0);
+    }
+    assert(log_viewer_get_filtered_entries(&lv) == before + appended);
+
+    log_viewer_clear_filters(&lv);
+    assert(lv.time_from == -1 && log_viewer_get_filtered_entries(&lv) == lv.total_entries);
+
+    log_viewer_cleanup(&lv);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log viewer time column test passed!\n");
+}
+
+#define TEST_TIMELINE_LINES 30000
+
+// 写出一个轮转段：第 i 行的时间为 (i * 3 + offset) 毫秒，每 100 行后跟一行无时间戳的续行
+static void write_timeline_segment(const char *path, int offset) {
+    FILE *fp = fopen(path, "w");
+    assert(fp);
+    for (int i = 0; i < TEST_TIMELINE_LINES; i++) {
+        int t = i * 3 + offset;
+        fprintf(fp, "[2024-01-01 %02d:%02d:%02d.%03d] [INFO] seg %d t %d\n",
+                t / 3600000, t / 60000 % 60, t / 1000 % 60, t % 1000, offset, t);
+        if (i % 100 == 0) {
+            fprintf(fp, "    continuation of %d\n", t);
+        }
+    }
+    fclose(fp);
+}
+
+// 行的标识：带时间戳的行为其时间，续行为 -(所属行的时间) - 1
+static int timeline_entry_id(const LogTimelineEntry *entry) {
+    const char *t = strstr(entry->line, " t ");
+    const char *c = strstr(entry->line, "continuation of ");
+    if (t) {
+        return atoi(t + 3);
+    }
+    assert(c);
+    return -atoi(c + 16) - 1;
+}
+
+// 合并时间线：压缩归档与明文段按时间交错，前后读取互逆，按时间跳转
+void test_timeline(void) {
+    printf("Testing log timeline...\n");
+
+    char path[256];
+    int total = TEST_TIMELINE_LINES + TEST_TIMELINE_LINES / 100;
+    int count = total * 3;
+
+    // .2 最早（压缩），.1 其次，当前日志最新；三段时间互相重叠
+    snprintf(path, sizeof(path), "%s.2", TEST_VIEWER_LOG);
+    write_timeline_segment(path, 0);
+    if (log_archive_supported()) {
+        char archive[256];
+        snprintf(archive, sizeof(archive), "%s.2.zst", TEST_VIEWER_LOG);
+        assert(log_archive_compress(path, archive) == SWK_SUCCESS);
+        unlink(path);
+    }
+    snprintf(path, sizeof(path), "%s.1", TEST_VIEWER_LOG);
+    write_timeline_segment(path, 1);
+    write_timeline_segment(TEST_VIEWER_LOG, 2);
+
+    LogTimeline tl;
+    LogTimelineEntry entry;
+    int *ids = malloc(sizeof(int) * (size_t)count);
+    assert(ids);
+    assert(log_timeline_open(&tl, TEST_VIEWER_LOG) == SWK_SUCCESS);
+    assert(tl.source_count == 3);
+    assert(strstr(log_timeline_source_path(&tl, 0), log_archive_supported() ? ".2.zst" : ".2"));
+
+    // 向后读取：时间严格递增，续行紧跟所属的行
+    int n = 0;
+    while (log_timeline_next(&tl, &entry)) {
+        assert(n < count);
+        ids[n] = timeline_entry_id(&entry);
+        if (ids[n] >= 0) {
+            assert(entry.source == ids[n] % 3);
+        } else {
+            assert(n > 0 && ids[n - 1] == -ids[n] - 1);
+        }
+        n++;
+    }
+    assert(n == count);
+    int last = -1;
+    for (int i = 0; i < n; i++) {
+        if (ids[i] >= 0) {
+            assert(ids[i] == last + 1);
+            last = ids[i];
+        }
+    }
+    assert(!log_timeline_next(&tl, &entry));
+
+    // 从末尾向前读取得到相反的顺序
+    log_timeline_seek_end(&tl);
+    for (int i = n - 1; i >= 0; i--) {
+        assert(log_timeline_prev(&tl, &entry));
+        assert(timeline_entry_id(&entry) == ids[i]);
+    }
+    assert(!log_timeline_prev(&tl, &entry));
+
+    // 按时间跳转：完整时间戳与前缀
+    log_timeline_seek_time(&tl, "2024-01-01 00:00:12.345");
+    assert(log_timeline_next(&tl, &entry) && timeline_entry_id(&entry) == 12345);
+    assert(log_timeline_prev(&tl, &entry) && timeline_entry_id(&entry) == 12345);
+    assert(log_timeline_prev(&tl, &entry) && timeline_entry_id(&entry) == 12344);
+    log_timeline_seek_time(&tl, "2024-01-01 00:01");
+    assert(log_timeline_next(&tl, &entry) && timeline_entry_id(&entry) == 60000);
+    log_timeline_seek_time(&tl, "2025");
+    assert(!log_timeline_next(&tl, &entry));
+    assert(log_timeline_prev(&tl, &entry) && timeline_entry_id(&entry) == TEST_TIMELINE_LINES * 3 - 1);
+    log_timeline_seek_time(&tl, "2023");
+    assert(log_timeline_next(&tl, &entry) && timeline_entry_id(&entry) == 0);
+
+    // 记住位置后再回来
+    LogTimelinePosition *position = malloc(sizeof(LogTimelinePosition));
+    assert(position);
+    log_timeline_seek_time(&tl, "2024-01-01 00:00:30");
+    log_timeline_tell(&tl, position);
+    for (int i = 0; i < 500; i++) {
+        assert(log_timeline_next(&tl, &entry));
+    }
+    log_timeline_restore(&tl, position);
+    assert(log_timeline_next(&tl, &entry) && timeline_entry_id(&entry) == 30000);
+    assert(log_timeline_prev(&tl, &entry) && log_timeline_prev(&tl, &entry));
+    assert(timeline_entry_id(&entry) == 29999);
+
+    free(position);
+    free(ids);
+    log_timeline_close(&tl);
+    snprintf(path, sizeof(path), "%s.1", TEST_VIEWER_LOG);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.2.zst", TEST_VIEWER_LOG);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.2.zst.idx", TEST_VIEWER_LOG);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s.2", TEST_VIEWER_LOG);
+    unlink(path);
+    unlink(TEST_VIEWER_LOG);
+    printf("Log timeline test passed!\n");
+}
+
+int main(void) {
+    printf("Starting SwiKernel log viewer tests...\n\n");
+
+    test_line_index();
+    test_follow_tail();
+    test_filters();
+    test_index_build_and_sidecar();
+    test_trigram_index();
+    test_search();
+    test_stats();
+    test_rendered_sources();
+    test_time_column();
+    test_timeline();
+
+    printf("\nAll log viewer tests passed! ✓\n");
+    return 0;
+}
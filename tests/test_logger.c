@@ -0,0 +1,999 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../include/common_defs.h"
+#include "../include/utils/logger.h"
+#include "../include/utils/log_binary.h"
+#include "../include/utils/log_archive.h"
+#include "../include/asm_optimized/crc32c.h"
+#include "../include/tui/log_time.h"
+
+#define TEST_LOG "/tmp/swikernel_logger_test.log"
+#define TEST_SOCKET "/tmp/swikernel_logger_test.sock"
+#define THREADS 4
+#define PER_THREAD 5000
+
+// 统计文件中包含 needle 的行数
+static int count_lines(const char *path, const char *needle) {
+    FILE *fp = fopen(path, "r");
+    char line[8192];
+    int count = 0;
+
+    if (!fp) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        if (!needle || strstr(line, needle)) {
+            count++;
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+static void remove_logs(void) {
+    char name[128];
+    unlink(TEST_LOG);
+    for (int i = 1; i < 10; i++) {
+        snprintf(name, sizeof(name), "%s.%d", TEST_LOG, i);
+        unlink(name);
+        snprintf(name, sizeof(name), "%s.%d.zst", TEST_LOG, i);
+        unlink(name);
+        snprintf(name, sizeof(name), "%s.%d.zst.idx", TEST_LOG, i);
+        unlink(name);
+    }
+}
+
+// 第 index 个归档是否存在（压缩或未压缩）
+static int archive_exists(int index) {
+    char name[128];
+    snprintf(name, sizeof(name), "%s.%d%s", TEST_LOG, index, log_archive_supported() ? ".zst" : "");
+    return access(name, F_OK) == 0;
+}
+
+// 同步模式：格式与原实现一致
+void test_sync_logging(void) {
+    printf("Testing synchronous logging...\n");
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+
+    log_message(LOG_DEBUG, "sync debug %d", 1);
+    log_message(LOG_WARNING, "sync warning %s", "two");
+
+    FILE *fp = fopen(TEST_LOG, "r");
+    char line[512];
+    int found = 0;
+    assert(fp != NULL);
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, "sync warning two")) {
+            // [YYYY-MM-DD HH:MM:SS.mmm] [WARN] msg
+            assert(line[0] == '[' && line[5] == '-' && line[11] == ' ' && line[20] == '.');
+            assert(strncmp(line + 24, "] [WARN] sync warning two\n", 26) == 0);
+            found = 1;
+        }
+    }
+    fclose(fp);
+    assert(found);
+    assert(count_lines(TEST_LOG, "sync debug 1") == 1);
+
+    logger_cleanup();
+    printf("Synchronous logging test passed!\n");
+}
+
+static int evaluated;
+
+static int side_effect(int value) {
+    evaluated++;
+    return value;
+}
+
+// 子系统级别：未启用的 SWK_LOG 调用不求值参数，子系统可以比全局级别更详细
+void test_subsystem_levels(void) {
+    printf("Testing per-subsystem log levels...\n");
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_INFO, 0) == 0);
+    logger_set_console(0);
+
+    assert(logger_parse_level("warning") == LOG_WARNING);
+    assert(logger_parse_level("WARN") == LOG_WARNING);
+    assert(logger_parse_level("3") == LOG_ERROR);
+    assert(logger_parse_level("inherit") == -1);
+    assert(logger_parse_subsystem("Kernel") == LOG_SUBSYS_KERNEL);
+    assert(logger_parse_subsystem("nope") == -1);
+    assert(logger_set_subsystem_level(LOG_SUBSYS_COUNT, LOG_INFO) == SWK_ERROR_INVALID_PARAM);
+
+    evaluated = 0;
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "kernel debug %d", side_effect(1));
+    assert(evaluated == 0);
+
+    // kernel 单独开到 DEBUG，其余子系统仍跟随 INFO
+    assert(logger_set_subsystem_level(LOG_SUBSYS_KERNEL, LOG_DEBUG) == SWK_SUCCESS);
+    assert(logger_get_effective_level(LOG_SUBSYS_KERNEL) == LOG_DEBUG);
+    assert(logger_get_effective_level(LOG_SUBSYS_TUI) == LOG_INFO);
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "kernel debug %d", side_effect(2));
+    SWK_LOG_DEBUG(LOG_SUBSYS_TUI, "tui debug %d", side_effect(3));
+    assert(evaluated == 1);
+
+    // 调高全局级别不影响单独设置的子系统
+    logger_set_level(LOG_ERROR);
+    SWK_LOG_INFO(LOG_SUBSYS_TUI, "tui info %d", 4);
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "kernel debug %d", 5);
+    log_message(LOG_WARNING, "core warning %d", 6);
+
+    // 恢复跟随全局级别
+    assert(logger_set_subsystem_level(LOG_SUBSYS_KERNEL, -1) == SWK_SUCCESS);
+    assert(logger_get_subsystem_level(LOG_SUBSYS_KERNEL) == -1);
+    SWK_LOG_WARN(LOG_SUBSYS_KERNEL, "kernel warning %d", 7);
+    SWK_LOG_ERROR(LOG_SUBSYS_I18N, "i18n error %d", 8);
+
+    // 编译期最低级别：宏在展开处取值，这里临时提高到 INFO
+#undef SWK_LOG_MIN_LEVEL
+#define SWK_LOG_MIN_LEVEL LOG_INFO
+    assert(logger_set_subsystem_level(LOG_SUBSYS_KERNEL, LOG_DEBUG) == SWK_SUCCESS);
+    evaluated = 0;
+    SWK_LOG_DEBUG(LOG_SUBSYS_KERNEL, "compiled out %d", side_effect(9));
+    assert(evaluated == 0);
+#undef SWK_LOG_MIN_LEVEL
+#define SWK_LOG_MIN_LEVEL 0
+
+    logger_cleanup();
+    assert(count_lines(TEST_LOG, "kernel debug 2") == 1);
+    assert(count_lines(TEST_LOG, "tui debug") == 0);
+    assert(count_lines(TEST_LOG, "tui info") == 0);
+    assert(count_lines(TEST_LOG, "kernel debug 5") == 1);
+    assert(count_lines(TEST_LOG, "core warning") == 0);
+    assert(count_lines(TEST_LOG, "kernel warning") == 0);
+    assert(count_lines(TEST_LOG, "i18n error 8") == 1);
+    assert(count_lines(TEST_LOG, "compiled out") == 0);
+
+    for (int i = 0; i < LOG_SUBSYS_COUNT; i++) {
+        logger_set_subsystem_level((LogSubsystem)i, -1);
+    }
+    logger_set_level(LOG_DEBUG);
+    remove_logs();
+    printf("Per-subsystem log levels test passed!\n");
+}
+
+// 累加文件中 "Last message repeated N times" 的 N
+static long sum_repeats(const char *path) {
+    FILE *fp = fopen(path, "r");
+    char line[512];
+    long total = 0;
+
+    assert(fp != NULL);
+    while (fgets(line, sizeof(line), fp)) {
+        const char *summary = strstr(line, "Last message repeated ");
+        if (summary) {
+            total += atol(summary + strlen("Last message repeated "));
+        }
+    }
+    fclose(fp);
+    return total;
+}
+
+// 重复合并与按调用点限流
+void test_rate_limit_and_coalescing(void) {
+    printf("Testing rate limiting and coalescing...\n");
+
+    LoggerStats before, after;
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    logger_set_coalescing(1);
+    logger_get_stats(&before);
+
+    // 同步模式：100 条相同记录只写出一条，加一条摘要
+    for (int i = 0; i < 100; i++) {
+        log_message(LOG_ERROR, "disk %s failed", "sda");
+    }
+    log_message(LOG_INFO, "different message");
+    assert(count_lines(TEST_LOG, "disk sda failed") == 1);
+    assert(count_lines(TEST_LOG, "[ERROR] Last message repeated 99 times") == 1);
+    assert(count_lines(TEST_LOG, "different message") == 1);
+
+    // 没有后续记录时由 logger_flush 写出摘要
+    log_message(LOG_INFO, "tail %d", 1);
+    log_message(LOG_INFO, "tail %d", 1);
+    logger_flush();
+    assert(count_lines(TEST_LOG, "Last message repeated 1 times") == 1);
+
+    // 异步模式：批量写出时同样合并，写出的条数加摘要次数等于提交的条数
+    assert(logger_start_async(1024, LOG_OVERFLOW_BLOCK) == SWK_SUCCESS);
+    for (int i = 0; i < 5000; i++) {
+        log_message(LOG_WARNING, "async repeat");
+    }
+    logger_flush();
+    logger_stop_async();
+    assert(count_lines(TEST_LOG, "async repeat") + sum_repeats(TEST_LOG) - 100 == 5000);
+    assert(count_lines(TEST_LOG, "async repeat") < 50);
+
+    logger_get_stats(&after);
+    assert(after.records_coalesced - before.records_coalesced == 99 + 1 + 5000 - (uint64_t)count_lines(TEST_LOG, "async repeat"));
+    logger_set_coalescing(0);
+
+    // 限流：每秒 10 条、突发 5 条，紧密循环中其余记录被抑制
+    logger_set_rate_limit(10, 5);
+    logger_get_stats(&before);
+    for (int i = 0; i < 200; i++) {
+        log_message(LOG_INFO, "flood %d", i);
+    }
+    log_message(LOG_INFO, "other site");
+    logger_get_stats(&after);
+    int written = count_lines(TEST_LOG, "flood ");
+    assert(written >= 5 && written <= 10);
+    assert(after.records_rate_limited - before.records_rate_limited == (uint64_t)(200 - written));
+    assert(count_lines(TEST_LOG, "other site") == 1);
+
+    // 令牌补充后放行，并报告此前被抑制的条数
+    struct timespec pause = {0, 300000000};
+    nanosleep(&pause, NULL);
+    log_message(LOG_INFO, "flood %d", 999);
+    assert(count_lines(TEST_LOG, "flood 999") == 1);
+    assert(count_lines(TEST_LOG, "Rate limit: suppressed") == 1);
+
+    // FATAL 不受限制
+    for (int i = 0; i < 20; i++) {
+        log_message(LOG_FATAL, "fatal %d", i);
+    }
+    assert(count_lines(TEST_LOG, "fatal ") == 20);
+
+    logger_set_rate_limit(0, 0);
+    logger_cleanup();
+    remove_logs();
+    printf("Rate limiting and coalescing test passed!\n");
+}
+
+static void *producer_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+    for (int i = 0; i < PER_THREAD; i++) {
+        log_message(LOG_INFO, "producer %d seq %d", id, i);
+    }
+    return NULL;
+}
+
+// 异步模式：多线程写入，记录不丢失，每个线程内部顺序保持
+void test_async_logging(void) {
+    printf("Testing asynchronous logging...\n");
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_start_async(256, LOG_OVERFLOW_BLOCK) == SWK_SUCCESS);
+    assert(logger_is_async());
+
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, producer_thread, (void *)(intptr_t)i) == 0);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // 超过内联大小的记录走堆分配
+    char big[2000];
+    memset(big, 'z', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    log_message(LOG_ERROR, "big %s end", big);
+
+    logger_flush();
+    assert(count_lines(TEST_LOG, "producer ") == THREADS * PER_THREAD);
+    assert(count_lines(TEST_LOG, "zzz end") == 1);
+
+    // 每个生产者的序号必须递增
+    FILE *fp = fopen(TEST_LOG, "r");
+    char line[4096];
+    int next[THREADS] = {0};
+    while (fgets(line, sizeof(line), fp)) {
+        int id, seq;
+        char *p = strstr(line, "producer ");
+        if (p && sscanf(p, "producer %d seq %d", &id, &seq) == 2) {
+            assert(seq == next[id]);
+            next[id]++;
+        }
+    }
+    fclose(fp);
+
+    LoggerStats stats;
+    logger_get_stats(&stats);
+    assert(stats.records_dropped == 0);
+    assert(stats.records_written >= (uint64_t)(THREADS * PER_THREAD + 1));
+
+    logger_cleanup();
+    assert(!logger_is_async());
+    printf("Asynchronous logging test passed!\n");
+}
+
+// 丢弃策略：队列满时计数而不阻塞
+void test_async_overflow(void) {
+    printf("Testing async overflow policy...\n");
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+
+    LoggerStats before;
+    logger_get_stats(&before);
+
+    assert(logger_start_async(2, LOG_OVERFLOW_DROP) == SWK_SUCCESS);
+    for (int i = 0; i < 20000; i++) {
+        log_message(LOG_DEBUG, "flood %d", i);
+    }
+    logger_flush();
+
+    LoggerStats after;
+    logger_get_stats(&after);
+    int written = count_lines(TEST_LOG, "flood ");
+    assert(written > 0);
+    assert((uint64_t)written + (after.records_dropped - before.records_dropped) == 20000);
+
+    logger_cleanup();
+    assert(count_lines(TEST_LOG, "records dropped") >= 1);
+
+    assert(logger_parse_overflow_policy("drop_debug") == LOG_OVERFLOW_DROP_DEBUG);
+    assert(logger_parse_overflow_policy("drop") == LOG_OVERFLOW_DROP);
+    assert(logger_parse_overflow_policy("block") == LOG_OVERFLOW_BLOCK);
+
+    printf("Async overflow test passed!\n");
+}
+
+// 轮转依据内存中的文件大小，在写线程中完成
+void test_async_rotation(void) {
+    printf("Testing async rotation...\n");
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 1) == 0);
+    logger_set_console(0);
+    logger_set_rotation(16 * 1024, 3);
+    assert(logger_start_async(1024, LOG_OVERFLOW_BLOCK) == SWK_SUCCESS);
+
+    for (int i = 0; i < 2000; i++) {
+        log_message(LOG_INFO, "rotation line %d", i);
+    }
+    logger_flush();
+
+    LoggerStats stats;
+    logger_get_stats(&stats);
+    assert(stats.rotations > 0);
+    assert(archive_exists(1));
+    assert(!archive_exists(3));
+
+    logger_cleanup();
+    remove_logs();
+    printf("Async rotation test passed!\n");
+}
+
+// 上次运行遗留的段按轮转的先后归档，最新的成为 .1
+void test_recover_segments(void) {
+    printf("Testing segment recovery...\n");
+
+    // 序号与写入时间的先后不一致，也与名字的字典序不一致
+    static const struct { unsigned seq; const char *text; } segments[] = {
+        {2, "oldest\n"}, {10, "middle\n"}, {3, "newest\n"}
+    };
+    char name[128], line[64];
+
+    remove_logs();
+    for (int i = 0; i < 3; i++) {
+        snprintf(name, sizeof(name), "%s.rotating.1.%u", TEST_LOG, segments[i].seq);
+        FILE *fp = fopen(name, "w");
+        assert(fp != NULL);
+        fputs(segments[i].text, fp);
+        fclose(fp);
+        struct timespec times[2] = {{1700000000 + i, 0}, {1700000000 + i, 0}};
+        assert(utimensat(AT_FDCWD, name, times, 0) == 0);
+    }
+
+    logger_set_compression(0);
+    logger_set_rotation(1 << 20, 5);
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 1) == 0);
+    logger_set_console(0);
+    logger_cleanup();
+    logger_set_compression(1);
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(name, sizeof(name), "%s.%d", TEST_LOG, 3 - i);
+        FILE *fp = fopen(name, "r");
+        assert(fp != NULL && fgets(line, sizeof(line), fp) != NULL);
+        assert(strcmp(line, segments[i].text) == 0);
+        fclose(fp);
+    }
+
+    remove_logs();
+    printf("Segment recovery test passed!\n");
+}
+
+// 解码整个二进制日志文件，返回事件数，消息依次写入 messages
+static int decode_file(const char *path, char messages[][256], int max_messages, LogLevel *levels) {
+    static uint8_t data[1 << 20];
+    static LogBinaryDecoder decoder;
+    FILE *fp = fopen(path, "rb");
+    size_t length, offset = 0;
+    int count = 0;
+
+    if (!fp) {
+        return -1;
+    }
+    length = fread(data, 1, sizeof(data), fp);
+    fclose(fp);
+
+    log_binary_decoder_init(&decoder);
+    while (offset < length) {
+        LogBinaryEvent event;
+        int has_event;
+        long used = log_binary_decode(&decoder, data + offset, length - offset, &event, &has_event);
+        assert(used > 0);
+        offset += (size_t)used;
+        if (has_event && count < max_messages) {
+            snprintf(messages[count], 256, "%.*s", (int)event.message_length, event.message);
+            if (levels) {
+                levels[count] = event.level;
+            }
+            count++;
+        }
+    }
+    log_binary_decoder_free(&decoder);
+    return count;
+}
+
+// 解码内存中的记录，损坏处重新对齐后继续；offsets 记录每条事件的起始位置
+static int decode_resync(const uint8_t *data, size_t length, char messages[][256], size_t *offsets,
+                         int max_messages, uint64_t *skipped) {
+    static LogBinaryDecoder decoder;
+    size_t offset = 0;
+    int count = 0;
+
+    log_binary_decoder_init(&decoder);
+    while (offset < length) {
+        LogBinaryEvent event;
+        int has_event;
+        long used = log_binary_decode(&decoder, data + offset, length - offset, &event, &has_event);
+        if (used == 0) {
+            break;
+        }
+        if (used < 0) {
+            offset += log_binary_resync(&decoder, data + offset, length - offset);
+            continue;
+        }
+        if (has_event && count < max_messages) {
+            snprintf(messages[count], 256, "%.*s", (int)event.message_length, event.message);
+            offsets[count++] = offset;
+        }
+        offset += (size_t)used;
+    }
+    *skipped = decoder.skipped_bytes;
+    log_binary_decoder_free(&decoder);
+    return count;
+}
+
+// 把手工构造的格式串定义与事件交给解码器，返回渲染出的消息
+static const char *decode_crafted(LogBinaryDecoder *decoder, const char *format, const uint8_t *types,
+                                  int arg_count, const uint8_t *payload, size_t payload_length) {
+    uint8_t record[512];
+    LogFormatInfo info = {format, 0, (uint16_t)arg_count, 1, {0}};
+    LogRecordHeader header = {0};
+    LogBinaryEvent event;
+    int has_event;
+
+    memcpy(info.types, types, (size_t)arg_count);
+    size_t length = log_binary_encode_format(record, sizeof(record), &info);
+    assert(length > 0 && log_binary_decode(decoder, record, length, &event, &has_event) == (long)length);
+
+    header.sync = LOG_RECORD_SYNC;
+    header.length = (uint16_t)(sizeof(header) + payload_length);
+    header.type = LOG_RECORD_EVENT;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), payload, payload_length);
+    header.crc = crc32c(crc32c(0, record, offsetof(LogRecordHeader, crc)), payload, payload_length);
+    memcpy(record, &header, sizeof(header));
+    assert(log_binary_decode(decoder, record, header.length, &event, &has_event) == (long)header.length);
+    assert(has_event);
+    return event.message;
+}
+
+// 二进制模式：解码结果与 printf 格式化完全一致
+void test_binary_format(void) {
+    printf("Testing binary log format...\n");
+
+    char messages[64][256];
+    char expected[256];
+    LogLevel levels[64];
+    int value = -42;
+
+    uint8_t types[LOG_BINARY_MAX_ARGS];
+    assert(log_format_parse("%d %5.2f %-8s %zu %p %%", types, LOG_BINARY_MAX_ARGS) == 5);
+    assert(types[0] == LOG_ARG_INT && types[1] == LOG_ARG_DOUBLE && types[2] == LOG_ARG_STRING);
+    assert(types[3] == LOG_ARG_SIZE && types[4] == LOG_ARG_POINTER);
+    assert(log_format_parse("%.*s", types, LOG_BINARY_MAX_ARGS) == 2 && types[0] == LOG_ARG_INT);
+    assert(log_format_parse("errno %m", types, LOG_BINARY_MAX_ARGS) == -1);
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+    assert(logger_get_format() == LOG_FORMAT_BINARY);
+
+    log_message(LOG_DEBUG, "int %d uint %u hex %#x char %c", value, 4000000000u, 255, 'q');
+    log_message(LOG_INFO, "long %ld llong %lld size %zu", -1234567890123L, 9876543210LL, (size_t)77);
+    log_message(LOG_WARNING, "double %8.3f %e %g", 3.14159, 1e-9, 2.5);
+    log_message(LOG_ERROR, "str [%-10s] [%5s] [%.3s] [%.*s] %s", "left", "r", "truncate", 2, "abc", (char *)NULL);
+    log_message(LOG_FATAL, "pointer %p percent %%", (void *)0x1234);
+    log_message(LOG_INFO, "fallback %m");
+    for (int i = 0; i < 3; i++) {
+        log_message(LOG_INFO, "repeat %d", i);
+    }
+    logger_cleanup();
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+
+    assert(log_binary_is_binary_file(TEST_LOG));
+    int count = decode_file(TEST_LOG, messages, 64, levels);
+    assert(count >= 9);
+
+    // messages[0] 是 "Logger initialized"，最后一条是 "Logger shutting down"
+    snprintf(expected, sizeof(expected), "int %d uint %u hex %#x char %c", value, 4000000000u, 255, 'q');
+    assert(strcmp(messages[1], expected) == 0 && levels[1] == LOG_DEBUG);
+    snprintf(expected, sizeof(expected), "long %ld llong %lld size %zu", -1234567890123L, 9876543210LL, (size_t)77);
+    assert(strcmp(messages[2], expected) == 0);
+    snprintf(expected, sizeof(expected), "double %8.3f %e %g", 3.14159, 1e-9, 2.5);
+    assert(strcmp(messages[3], expected) == 0 && levels[3] == LOG_WARNING);
+    assert(strcmp(messages[4], "str [left      ] [    r] [tru] [ab] (null)") == 0);
+    snprintf(expected, sizeof(expected), "pointer %p percent %%", (void *)0x1234);
+    assert(strcmp(messages[5], expected) == 0 && levels[5] == LOG_FATAL);
+    assert(strncmp(messages[6], "fallback ", 9) == 0);
+    assert(strcmp(messages[9], "repeat 2") == 0);
+    assert(strcmp(messages[count - 1], "Logger shutting down") == 0);
+
+    // 损坏的记录只影响它自己：之后的记录按同步标记与校验和重新对齐
+    static uint8_t data[1 << 16];
+    char damaged[64][256];
+    size_t offsets[64], damaged_offsets[64];
+    uint64_t skipped;
+    FILE *fp = fopen(TEST_LOG, "rb");
+    assert(fp);
+    size_t data_length = fread(data, 1, sizeof(data), fp);
+    fclose(fp);
+    assert(decode_resync(data, data_length, messages, offsets, 64, &skipped) == count && skipped == 0);
+
+    LogRecordHeader header4, header7;
+    memcpy(&header4, data + offsets[4], sizeof(header4));
+    memcpy(&header7, data + offsets[7], sizeof(header7));
+    uint64_t lost = (uint64_t)header4.length + header7.length;
+    data[offsets[4] + sizeof(LogRecordHeader) + 2] ^= 0x55;       // 负载中的一个字节
+    data[offsets[7] + offsetof(LogRecordHeader, length)] ^= 0x40; // 记录长度
+    assert(decode_resync(data, data_length, damaged, damaged_offsets, 64, &skipped) == count - 2);
+    assert(skipped == lost);
+    assert(strcmp(damaged[3], messages[3]) == 0 && strcmp(damaged[4], messages[5]) == 0);
+    assert(strcmp(damaged[5], messages[6]) == 0 && strcmp(damaged[6], messages[8]) == 0);
+    assert(strcmp(damaged[count - 3], "Logger shutting down") == 0);
+
+    // 文件中的格式串不可信：编码端不会产生的转换与参数类型不符的 '*' 都不渲染
+    LogBinaryDecoder decoder;
+    const uint8_t string_type[] = {LOG_ARG_STRING}, double_type[] = {LOG_ARG_DOUBLE};
+    const uint8_t int_type[] = {LOG_ARG_INT}, star_types[] = {LOG_ARG_STRING, LOG_ARG_INT};
+    const uint8_t string_payload[] = {3, 'a', 'b', 'c'}, double_payload[8] = {0};
+    const uint8_t int_payload[] = {10}, star_payload[] = {3, 'a', 'b', 'c', 10};
+    log_binary_decoder_init(&decoder);
+    assert(strcmp(decode_crafted(&decoder, "%d ok", int_type, 1, int_payload, 1), "5 ok") == 0);
+    assert(strcmp(decode_crafted(&decoder, "a%lsb", string_type, 1, string_payload, 4), "a") == 0);
+    assert(strcmp(decode_crafted(&decoder, "x%Lf", double_type, 1, double_payload, 8), "x") == 0);
+    assert(strcmp(decode_crafted(&decoder, "%hs", string_type, 1, string_payload, 4), "") == 0);
+    assert(strcmp(decode_crafted(&decoder, "%lp", double_type, 1, double_payload, 8), "") == 0);
+    assert(strcmp(decode_crafted(&decoder, "n%n", int_type, 1, int_payload, 1), "n") == 0);
+    assert(strcmp(decode_crafted(&decoder, "w%*d", star_types, 2, star_payload, 5), "w") == 0);
+    log_binary_decoder_free(&decoder);
+
+    // 文本行格式与文本模式一致
+    LogBinaryEvent event = {LOG_WARNING, 0, 0, "msg", 3};
+    char line[128];
+    size_t length = log_binary_format_line(&event, line, sizeof(line));
+    assert(length == 37 && line[0] == '[' && strcmp(line + 24, "] [WARN] msg\n") == 0);
+
+    remove_logs();
+    printf("Binary log format test passed!\n");
+}
+
+// 二进制 + 异步：多线程写入后解码，记录不丢失且体积明显小于文本
+void test_binary_async(void) {
+    printf("Testing binary async logging...\n");
+
+    uint64_t text_bytes, binary_bytes;
+    LoggerStats before_stats, stats;
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    for (int i = 0; i < PER_THREAD; i++) {
+        log_message(LOG_DEBUG, "sampler %d value %d", i % 7, i);
+    }
+    logger_cleanup();
+    struct stat st;
+    assert(stat(TEST_LOG, &st) == 0);
+    text_bytes = (uint64_t)st.st_size;
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+    logger_get_stats(&before_stats);
+    assert(logger_start_async(256, LOG_OVERFLOW_BLOCK) == SWK_SUCCESS);
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_ERROR);
+
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, producer_thread, (void *)(intptr_t)i) == 0);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    logger_flush();
+    logger_get_stats(&stats);
+    assert(stats.records_dropped == before_stats.records_dropped);
+    logger_stop_async();
+
+    off_t before = 0;
+    assert(stat(TEST_LOG, &st) == 0);
+    before = st.st_size;
+    for (int i = 0; i < PER_THREAD; i++) {
+        log_message(LOG_DEBUG, "sampler %d value %d", i % 7, i);
+    }
+    logger_cleanup();
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+    assert(stat(TEST_LOG, &st) == 0);
+    binary_bytes = (uint64_t)(st.st_size - before);
+
+    // 同样的负载，二进制至少小一半
+    assert(binary_bytes * 2 < text_bytes);
+
+    static char messages[THREADS * PER_THREAD + PER_THREAD + 16][256];
+    int total = decode_file(TEST_LOG, messages, THREADS * PER_THREAD + PER_THREAD + 16, NULL);
+    int next[THREADS] = {0};
+    int producers = 0;
+    for (int i = 0; i < total; i++) {
+        int id, seq;
+        if (sscanf(messages[i], "producer %d seq %d", &id, &seq) == 2) {
+            assert(seq == next[id]);
+            next[id]++;
+            producers++;
+        }
+    }
+    assert(producers == THREADS * PER_THREAD);
+
+    remove_logs();
+    printf("Binary async logging test passed!\n");
+}
+
+// 二进制轮转：每个文件都以文件头开始，可以独立解码
+void test_binary_rotation(void) {
+    printf("Testing binary rotation...\n");
+
+    static char messages[4096][256];
+
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 1) == 0);
+    logger_set_console(0);
+    logger_set_rotation(8 * 1024, 3);
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+
+    for (int i = 0; i < 2000; i++) {
+        log_message(LOG_INFO, "rotation line %d", i);
+    }
+    logger_cleanup();
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+
+    assert(log_binary_is_binary_file(TEST_LOG));
+    assert(archive_exists(1) && archive_exists(2) && !archive_exists(3));
+    if (!log_archive_supported()) {
+        assert(log_binary_is_binary_file(TEST_LOG ".1"));
+        assert(decode_file(TEST_LOG ".1", messages, 4096, NULL) > 0);
+    }
+    int count = decode_file(TEST_LOG, messages, 4096, NULL);
+    assert(count > 0);
+    assert(strcmp(messages[count - 2], "rotation line 1999") == 0);
+
+    remove_logs();
+    printf("Binary rotation test passed!\n");
+}
+
+// 归档：逐帧解压与原文件一致，可以按时间直接定位到某一帧
+void test_log_archive(void) {
+    printf("Testing log archive...\n");
+
+    if (!log_archive_supported()) {
+        printf("Log archive test skipped (built without zstd)\n");
+        return;
+    }
+
+    const char *segment = TEST_LOG ".segment";
+    const char *archive_path = TEST_LOG ".segment.zst";
+    LogArchive archive;
+    uint8_t *frame;
+    size_t length;
+
+    // 文本段：每秒一行的时间序列，约 2 MB
+    FILE *fp = fopen(segment, "w");
+    assert(fp != NULL);
+    for (int i = 0; i < 30000; i++) {
+        int s = i % 60, m = (i / 60) % 60, h = i / 3600;
+        fprintf(fp, "[2025-01-02 %02d:%02d:%02d.000] [INFO] sample line %d with some padding text\n", h, m, s, i);
+    }
+    fclose(fp);
+
+    assert(log_archive_compress(segment, archive_path) == SWK_SUCCESS);
+    assert(log_archive_open(&archive, archive_path) == SWK_SUCCESS);
+    assert(archive.frame_count > 4 && !archive.binary);
+
+    struct stat st;
+    assert(stat(segment, &st) == 0 && archive.total_size == (uint64_t)st.st_size);
+
+    // 每一帧都以完整的行开始和结束
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < archive.frame_count; i++) {
+        assert(log_archive_read_frame(&archive, i, &frame, &length) == SWK_SUCCESS);
+        assert(frame[0] == '[' && frame[length - 1] == '\n');
+        assert(archive.frames[i].first_time_ms == log_time_parse((char *)frame, length));
+        total += length;
+        free(frame);
+    }
+    assert(total == archive.total_size);
+
+    // 按时间定位：包含第 20000 行的帧
+    int64_t target = log_time_parse("[2025-01-02 05:33:20.000]", 25);
+    uint32_t index = log_archive_find_frame(&archive, target);
+    assert(log_archive_read_frame(&archive, index, &frame, &length) == SWK_SUCCESS);
+    assert(strstr((char *)frame, "sample line 20000 ") != NULL);
+    free(frame);
+
+    // 帧内容与索引都带 CRC32C：校验和对不上时读取失败
+    archive.frames[index].crc ^= 1;
+    assert(log_archive_read_frame(&archive, index, &frame, &length) != SWK_SUCCESS);
+    archive.frames[index].crc ^= 1;
+    log_archive_close(&archive);
+
+    int fd = open(TEST_LOG ".segment.zst.idx", O_RDWR);
+    uint8_t byte;
+    off_t at = (off_t)(sizeof(LogArchiveIndexHeader) + sizeof(LogArchiveFrame) + 1);
+    assert(fd >= 0 && pread(fd, &byte, 1, at) == 1);
+    byte ^= 0x40;
+    assert(pwrite(fd, &byte, 1, at) == 1);
+    close(fd);
+    assert(log_archive_open(&archive, archive_path) != SWK_SUCCESS);
+
+    // 二进制段：任意一帧配合前导区即可独立解码
+    remove_logs();
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+    for (int i = 0; i < 60000; i++) {
+        log_message(LOG_INFO, "binary sample %d %s", i, "payload-payload-payload");
+    }
+    logger_cleanup();
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+
+    assert(log_archive_compress(TEST_LOG, archive_path) == SWK_SUCCESS);
+    assert(log_archive_open(&archive, archive_path) == SWK_SUCCESS);
+    assert(archive.binary && archive.frame_count > 2 && archive.preamble_size > 0);
+
+    index = archive.frame_count / 2;
+    assert(log_archive_read_frame(&archive, index, &frame, &length) == SWK_SUCCESS);
+
+    static LogBinaryDecoder decoder;
+    LogBinaryEvent event;
+    int has_event;
+    long used;
+    size_t offset = 0;
+    log_binary_decoder_init(&decoder);
+    while (offset < archive.frames[index].preamble_length) {
+        used = log_binary_decode(&decoder, archive.preamble + offset,
+                                 archive.frames[index].preamble_length - offset, &event, &has_event);
+        assert(used > 0);
+        offset += (size_t)used;
+    }
+    offset = 0;
+    int events = 0, first = -1;
+    while (offset < length) {
+        used = log_binary_decode(&decoder, frame + offset, length - offset, &event, &has_event);
+        assert(used > 0);
+        offset += (size_t)used;
+        if (has_event) {
+            int seq;
+            assert(sscanf(event.message, "binary sample %d payload-payload-payload", &seq) == 1);
+            if (first < 0) {
+                first = seq;
+                assert(log_time_from_epoch(event.wall_ns / 1000000) == archive.frames[index].first_time_ms);
+            }
+            assert(seq == first + events);
+            events++;
+        }
+    }
+    assert(first > 0 && events > 0);
+    log_binary_decoder_free(&decoder);
+    free(frame);
+    log_archive_close(&archive);
+
+    // 归档与索引不配对（大小对不上）时拒绝打开
+    assert(stat(archive_path, &st) == 0 && truncate(archive_path, st.st_size - 1) == 0);
+    assert(log_archive_open(&archive, archive_path) != SWK_SUCCESS);
+
+    unlink(segment);
+    unlink(archive_path);
+    unlink(TEST_LOG ".segment.zst.idx");
+    remove_logs();
+    printf("Log archive test passed!\n");
+}
+
+typedef struct {
+    int count;
+    int matches;
+    const char *needle;
+    char last[512];
+} MemoryLines;
+
+static void collect_line(LogLevel level, const char *line, size_t length, void *context) {
+    MemoryLines *lines = context;
+    (void)level;
+
+    assert(length > 0 && length < sizeof(lines->last) && line[length - 1] == '\n');
+    memcpy(lines->last, line, length);
+    lines->last[length] = '\0';
+    lines->count++;
+    if (lines->needle && strstr(lines->last, lines->needle)) {
+        lines->matches++;
+    }
+}
+
+// 读出接收端当前排队的所有数据报，返回包含 needle 的个数
+static int drain_socket(int fd, const char *needle, char *last, size_t size) {
+    char buf[1024];
+    int matches = 0;
+    ssize_t n;
+
+    while ((n = recv(fd, buf, sizeof(buf) - 1, MSG_DONTWAIT)) > 0) {
+        buf[n] = '\0';
+        if (strstr(buf, needle)) {
+            matches++;
+            snprintf(last, size, "%s", buf);
+        }
+    }
+    return matches;
+}
+
+// 多汇点：各自的级别过滤，数据报/journal 套接字与内存环
+void test_log_sinks(void) {
+    printf("Testing log sinks...\n");
+
+    struct sockaddr_un addr = {0};
+    char datagram[1024];
+    MemoryLines lines = {0};
+    LoggerStats before, after;
+
+    remove_logs();
+    unlink(TEST_SOCKET);
+    int receiver = socket(AF_UNIX, SOCK_DGRAM, 0);
+    assert(receiver >= 0);
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, TEST_SOCKET);
+    assert(bind(receiver, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+
+    assert(logger_init(TEST_LOG, LOG_DEBUG, 0) == 0);
+    logger_set_console(0);
+    assert(logger_get_sink_level(LOG_SINK_TTY) == -1);
+    assert(logger_get_sink_level(LOG_SINK_SOCKET) == -1);
+    assert(logger_set_sink_level(LOG_SINK_SOCKET, LOG_INFO) == SWK_ERROR);
+    assert(logger_parse_socket_mode("journal") == LOG_SOCKET_JOURNAL);
+    assert(logger_parse_socket_mode("bogus") == -1);
+
+    assert(logger_open_memory_sink(64, LOG_WARNING) == SWK_SUCCESS);
+    assert(logger_open_socket_sink(TEST_SOCKET, LOG_SOCKET_DGRAM, LOG_INFO) == SWK_SUCCESS);
+    assert(logger_set_sink_level(LOG_SINK_FILE, LOG_ERROR) == SWK_SUCCESS);
+    assert(logger_get_sink_level(LOG_SINK_FILE) == LOG_ERROR);
+
+    log_message(LOG_DEBUG, "sink debug");
+    log_message(LOG_INFO, "sink info");
+    log_message(LOG_WARNING, "sink warn");
+    log_message(LOG_ERROR, "sink error");
+
+    // 文件只有 ERROR，套接字 INFO 以上，内存环 WARN 以上
+    assert(count_lines(TEST_LOG, "sink ") == 1);
+    assert(count_lines(TEST_LOG, "[ERROR] sink error") == 1);
+    assert(drain_socket(receiver, "sink ", datagram, sizeof(datagram)) == 3);
+    assert(strstr(datagram, "[ERROR] sink error") && datagram[strlen(datagram) - 1] != '\n');
+
+    lines.needle = "sink ";
+    assert(logger_memory_read(0, collect_line, &lines) == 2);
+    assert(lines.count == 2 && lines.matches == 2);
+    assert(strstr(lines.last, "[ERROR] sink error"));
+
+    // journal 协议：字段按行发送，MESSAGE 不含时间戳和级别前缀
+    assert(logger_open_socket_sink(TEST_SOCKET, LOG_SOCKET_JOURNAL, LOG_INFO) == SWK_SUCCESS);
+    log_message(LOG_ERROR, "journal %d", 7);
+    assert(drain_socket(receiver, "journal 7", datagram, sizeof(datagram)) == 1);
+    assert(strcmp(datagram, "PRIORITY=3\nSYSLOG_IDENTIFIER=swikernel\nMESSAGE=journal 7\n") == 0);
+
+    // 内存环写满后只保留最近的记录，游标之后没有新记录时不回调
+    assert(logger_open_memory_sink(4, LOG_DEBUG) == SWK_SUCCESS);
+    for (int i = 0; i < 10; i++) {
+        log_message(LOG_DEBUG, "ring %d", i);
+    }
+    memset(&lines, 0, sizeof(lines));
+    lines.needle = "ring ";
+    uint64_t cursor = logger_memory_read(0, collect_line, &lines);
+    assert(cursor == 10 && lines.matches == 4);
+    assert(strstr(lines.last, "ring 9"));
+    memset(&lines, 0, sizeof(lines));
+    assert(logger_memory_read(cursor, collect_line, &lines) == cursor && lines.count == 0);
+
+    // 二进制格式下文件写原始记录，内存环拿到渲染后的文本
+    assert(logger_set_format(LOG_FORMAT_BINARY) == SWK_SUCCESS);
+    assert(logger_start_async(256, LOG_OVERFLOW_BLOCK) == SWK_SUCCESS);
+    log_message(LOG_ERROR, "binary %d", 42);
+    logger_flush();
+    logger_stop_async();
+    memset(&lines, 0, sizeof(lines));
+    lines.needle = "[ERROR] binary 42";
+    logger_memory_read(cursor, collect_line, &lines);
+    assert(lines.matches == 1);
+    assert(drain_socket(receiver, "MESSAGE=binary 42", datagram, sizeof(datagram)) == 1);
+
+    // 收集器消失后记录被丢弃并计数，不影响其他汇点
+    close(receiver);
+    unlink(TEST_SOCKET);
+    logger_get_stats(&before);
+    log_message(LOG_ERROR, "collector gone");
+    log_message(LOG_ERROR, "still gone");
+    logger_get_stats(&after);
+    assert(after.sink_dropped - before.sink_dropped == 2);
+    memset(&lines, 0, sizeof(lines));
+    lines.needle = "gone";
+    logger_memory_read(0, collect_line, &lines);
+    assert(lines.matches == 2);
+
+    logger_close_sink(LOG_SINK_SOCKET);
+    logger_close_sink(LOG_SINK_MEMORY);
+    assert(logger_memory_read(0, collect_line, &lines) == 0);
+    assert(logger_set_sink_level(LOG_SINK_FILE, LOG_DEBUG) == SWK_SUCCESS);
+    assert(logger_set_format(LOG_FORMAT_TEXT) == SWK_SUCCESS);
+    logger_cleanup();
+
+    // 日志文件关闭后其他汇点照常收到记录
+    assert(logger_open_memory_sink(16, LOG_DEBUG) == SWK_SUCCESS);
+    log_message(LOG_ERROR, "no file %d", 1);
+    memset(&lines, 0, sizeof(lines));
+    lines.needle = "[ERROR] no file 1";
+    logger_memory_read(0, collect_line, &lines);
+    assert(lines.matches == 1);
+    logger_close_sink(LOG_SINK_MEMORY);
+    remove_logs();
+    printf("Log sinks test passed!\n");
+}
+
+int main(void) {
+    printf("Starting SwiKernel logger tests...\n\n");
+
+    test_sync_logging();
+    test_subsystem_levels();
+    test_rate_limit_and_coalescing();
+    test_log_sinks();
+    test_async_logging();
+    test_async_overflow();
+    test_async_rotation();
+    test_recover_segments();
+    test_binary_format();
+    test_binary_async();
+    test_binary_rotation();
+    test_log_archive();
+
+    printf("\nAll logger tests passed! ✓\n");
+    return 0;
+}
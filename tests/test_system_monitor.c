@@ -0,0 +1,854 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#include "../include/common_defs.h"
+#include "../include/tui/cpu_sampler.h"
+#include "../include/tui/cpu_topology.h"
+#include "../include/tui/proc_scanner.h"
+#include "../include/tui/proc_events.h"
+#include "../include/tui/proc_top.h"
+#include "../include/tui/net_sampler.h"
+#include "../include/tui/disk_sampler.h"
+
+#define TEST_STAT "/tmp/swikernel_monitor_test.stat"
+#define TEST_SYSFS "/tmp/swikernel_monitor_sysfs"
+#define TEST_PROC "/tmp/swikernel_monitor_proc"
+#define TEST_PROC_COUNT 5000
+#define TEST_NET "/tmp/swikernel_monitor_net"
+#define TEST_ROUTE "/tmp/swikernel_monitor_route"
+#define TEST_DISK "/tmp/swikernel_monitor_disk"
+
+static int near(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+static double elapsed_us(const struct timespec *start, const struct timespec *end) {
+    return (double)(end->tv_sec - start->tv_sec) * 1e6 + (double)(end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+// 覆盖写（保持同一个 inode，采样器的描述符读到新内容）
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    assert(fp);
+    fputs(content, fp);
+    fclose(fp);
+}
+
+// CPU 采样：按差值计算、guest 不重复计入、CPU 上下线与大量 CPU
+void test_cpu_sampler(void) {
+    printf("Testing CPU sampler...\n");
+
+    CpuSampler sampler;
+
+    // 第一次采样与全 0 比较，即开机以来的平均值
+    write_file(TEST_STAT,
+               "cpu  100 0 50 800 10 5 5 30 0 0\n"
+               "cpu0 50 0 25 400 5 5 0 15 0 0\n"
+               "cpu1 50 0 25 400 5 0 5 15 0 0\n"
+               "intr 12345 1 2 3\n"
+               "ctxt 99\n");
+    assert(cpu_sampler_open(&sampler, TEST_STAT) == SWK_SUCCESS);
+    assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+    assert(near(sampler.total.usage, 19.0));
+    assert(near(sampler.total.steal, 3.0));
+    assert(sampler.cpu_count == 2 && sampler.online_count == 2);
+
+    // 第二次：user +100（其中 guest +50），system +50，idle +300，iowait +20，steal +30；
+    // cpu1 下线，cpu3 上线
+    write_file(TEST_STAT,
+               "cpu  200 0 100 1100 30 5 5 60 50 0\n"
+               "cpu0 150 0 75 700 25 5 0 45 50 0\n"
+               "cpu3 10 0 10 80 0 0 0 0 0 0\n"
+               "intr 12345 1 2 3\n");
+    assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+    assert(near(sampler.total.usage, 36.0));
+    assert(near(sampler.total.user, 10.0) && near(sampler.total.guest, 10.0));
+    assert(near(sampler.total.system, 10.0) && near(sampler.total.iowait, 4.0));
+    assert(near(sampler.total.steal, 6.0) && near(sampler.total.irq, 0.0));
+    assert(near(cpu_sampler_cpu(&sampler, 0)->usage, 36.0));
+    assert(!cpu_sampler_cpu(&sampler, 1)->online && !cpu_sampler_cpu(&sampler, 2)->online);
+    assert(cpu_sampler_cpu(&sampler, 3)->online && near(cpu_sampler_cpu(&sampler, 3)->usage, 20.0));
+    assert(sampler.cpu_count == 4 && sampler.online_count == 2);
+    assert(cpu_sampler_cpu(&sampler, 4) == NULL);
+
+    // 计数倒退（CPU 重新上线后被重置）时差值按 0 处理
+    write_file(TEST_STAT, "cpu  10 0 10 10 0 0 0 0 0 0\n");
+    assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+    assert(near(sampler.total.usage, 0.0));
+
+    // 300 个 CPU 与很长的 intr 行：cpu 行超出初始缓冲区时加倍重读
+    size_t size = 300 * 80 + 200000;
+    char *content = malloc(size);
+    assert(content);
+    size_t length = (size_t)snprintf(content, size, "cpu  300 0 300 3000 0 0 0 0 0 0\n");
+    for (int i = 0; i < 300; i++) {
+        length += (size_t)snprintf(content + length, size - length,
+                                   "cpu%d 1000000001 0 1000000001 10000000001 0 0 0 0 0 0\n", i);
+    }
+    length += (size_t)snprintf(content + length, size - length, "intr");
+    while (length < size - 16) {
+        length += (size_t)snprintf(content + length, size - length, " 1");
+    }
+    snprintf(content + length, size - length, "\n");
+    write_file(TEST_STAT, content);
+    free(content);
+    assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+    assert(sampler.cpu_count == 300 && sampler.online_count == 300);
+    assert(sampler.capacity > CPU_SAMPLER_BUFFER);
+    assert(cpu_sampler_cpu(&sampler, 299)->online);
+    cpu_sampler_close(&sampler);
+    assert(sampler.fd == -1);
+
+    // 真实的 /proc/stat：两次采样之间的使用率在 0 到 100 之间
+    if (cpu_sampler_open(&sampler, NULL) == SWK_SUCCESS) {
+        struct timespec start, end;
+        assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < 100; i++) {
+            assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        assert(sampler.total.usage >= 0.0 && sampler.total.usage <= 100.0);
+        assert(sampler.online_count > 0 && sampler.online_count == sysconf(_SC_NPROCESSORS_ONLN));
+        printf("  %d CPUs, %.1f us per sample\n", sampler.online_count, elapsed_us(&start, &end) / 100);
+        cpu_sampler_close(&sampler);
+    }
+
+    unlink(TEST_STAT);
+    printf("CPU sampler test passed!\n");
+}
+
+// 在 TEST_SYSFS 下写入一个文件（父目录不存在时先创建）
+static void write_sysfs(const char *relative, const char *content) {
+    char command[600], path[512];
+
+    snprintf(path, sizeof(path), "%s/%s", TEST_SYSFS, relative);
+    snprintf(command, sizeof(command), "mkdir -p $(dirname %s)", path);
+    assert(system(command) == 0);
+    write_file(path, content);
+}
+
+// CPU 拓扑：2 插槽 x 2 物理核 x 2 线程，兄弟线程编号相差 4，2 个 NUMA 节点
+void test_cpu_topology(void) {
+    printf("Testing CPU topology...\n");
+
+    char relative[256], content[64];
+    uint8_t set[16] = {0};
+
+    assert(cpu_topology_parse_list("0-3,8,10-11\n", set, 16) == 7);
+    assert(set[0] && set[3] && !set[4] && set[8] && !set[9] && set[11]);
+    assert(cpu_topology_parse_list("", set, 16) == 0);
+    assert(cpu_topology_parse_list("3-1", set, 16) == -1);
+    assert(cpu_topology_parse_list("0-1,x", set, 16) == -1);
+
+    system("rm -rf " TEST_SYSFS);
+    write_sysfs("cpu/online", "0-7\n");
+    for (int cpu = 0; cpu < 8; cpu++) {
+        snprintf(relative, sizeof(relative), "cpu/cpu%d/topology/physical_package_id", cpu);
+        write_sysfs(relative, (cpu % 4) < 2 ? "0\n" : "1\n");
+        snprintf(relative, sizeof(relative), "cpu/cpu%d/topology/core_cpus_list", cpu);
+        snprintf(content, sizeof(content), "%d,%d\n", cpu % 4, cpu % 4 + 4);
+        write_sysfs(relative, content);
+        snprintf(relative, sizeof(relative), "cpu/cpu%d/cpufreq/scaling_cur_freq", cpu);
+        snprintf(content, sizeof(content), "%d\n", (cpu + 1) * 1000000);
+        write_sysfs(relative, content);
+    }
+    write_sysfs("node/node0/cpulist", "0-3\n");
+    write_sysfs("node/node1/cpulist", "4-7\n");
+    write_sysfs("node/node2/cpulist", "\n");
+    write_sysfs("cpu/cpu0/cache/index0/level", "1\n");
+    write_sysfs("cpu/cpu0/cache/index0/type", "Data\n");
+    write_sysfs("cpu/cpu0/cache/index0/size", "48K\n");
+    write_sysfs("cpu/cpu0/cache/index0/shared_cpu_list", "0,4\n");
+    write_sysfs("cpu/cpu0/cache/index1/level", "2\n");
+    write_sysfs("cpu/cpu0/cache/index1/type", "Unified\n");
+    write_sysfs("cpu/cpu0/cache/index1/size", "2048K\n");
+    write_sysfs("cpu/cpu0/cache/index1/shared_cpu_list", "0,4\n");
+    write_sysfs("cpu/cpu0/cache/index2/level", "3\n");
+    write_sysfs("cpu/cpu0/cache/index2/type", "Unified\n");
+    write_sysfs("cpu/cpu0/cache/index2/size", "32M\n");
+    write_sysfs("cpu/cpu0/cache/index2/shared_cpu_list", "0-1,4-5\n");
+
+    CpuTopology topology;
+    assert(cpu_topology_build(&topology, TEST_SYSFS) == SWK_SUCCESS);
+    assert(topology.cpu_count == 8 && topology.online_count == 8);
+    assert(topology.package_count == 2 && topology.core_count == 4);
+    assert(topology.threads_per_core == 2 && topology.node_count == 2);
+    assert(topology.cpus[4].core == topology.cpus[0].core && topology.cpus[4].thread == 1);
+    assert(topology.cpus[2].package == 1 && topology.cpus[6].package == 1 && topology.cpus[5].package == 0);
+    assert(topology.cpus[3].node == 0 && topology.cpus[4].node == 1);
+    assert(topology.cache_count == 3);
+    assert(topology.caches[0].level == 1 && strcmp(topology.caches[0].type, "Data") == 0);
+    assert(topology.caches[0].size_kb == 48 && topology.caches[0].instances == 4);
+    assert(topology.caches[2].size_kb == 32 * 1024 && topology.caches[2].instances == 2);
+    assert(topology.has_cpufreq && topology.generation == 1);
+    assert(near(cpu_topology_update_frequency(&topology), 4500.0));
+
+    // 每个 CPU 的使用率为 10% * (编号 + 1)
+    CpuSampler sampler;
+    char stat[1024];
+    size_t length = (size_t)snprintf(stat, sizeof(stat), "cpu  360 0 0 440 0 0 0 0 0 0\n");
+    for (int cpu = 0; cpu < 8; cpu++) {
+        length += (size_t)snprintf(stat + length, sizeof(stat) - length, "cpu%d %d 0 0 %d 0 0 0 0 0 0\n",
+                                   cpu, (cpu + 1) * 10, 100 - (cpu + 1) * 10);
+    }
+    write_file(TEST_STAT, stat);
+    assert(cpu_sampler_open(&sampler, TEST_STAT) == SWK_SUCCESS);
+    assert(cpu_sampler_sample(&sampler) == SWK_SUCCESS);
+
+    double usage[CPU_TOPOLOGY_MAX_GROUPS];
+    assert(cpu_topology_aggregate(&topology, &sampler, CPU_TOPOLOGY_BY_PACKAGE, usage, CPU_TOPOLOGY_MAX_GROUPS) == 2);
+    assert(near(usage[0], 35.0) && near(usage[1], 55.0));
+    assert(cpu_topology_aggregate(&topology, &sampler, CPU_TOPOLOGY_BY_NODE, usage, 1) == 1);
+    assert(near(usage[0], 25.0));
+    assert(cpu_topology_aggregate(&topology, &sampler, CPU_TOPOLOGY_BY_NODE, usage, CPU_TOPOLOGY_MAX_GROUPS) == 2);
+    assert(near(usage[1], 65.0));
+    cpu_sampler_close(&sampler);
+
+    // 没有变化时不重建；下线兄弟线程后重建
+    assert(cpu_topology_check(&topology) == 0);
+    write_sysfs("cpu/online", "0-3\n");
+    assert(cpu_topology_check(&topology) == 1);
+    assert(topology.generation == 2 && topology.online_count == 4);
+    assert(topology.core_count == 4 && topology.threads_per_core == 1);
+    assert(near(cpu_topology_update_frequency(&topology), 2500.0));
+    assert(cpu_topology_check(&topology) == 0);
+    cpu_topology_free(&topology);
+    assert(topology.online_fd == -1 && topology.cpus == NULL);
+
+    // 真实的 sysfs：逻辑 CPU 数与 sysconf 一致
+    if (cpu_topology_build(&topology, NULL) == SWK_SUCCESS) {
+        struct timespec start, end;
+        assert(topology.online_count == sysconf(_SC_NPROCESSORS_ONLN));
+        assert(topology.core_count >= 1 && topology.core_count <= topology.online_count);
+        assert(topology.package_count >= 1 && topology.node_count >= 1);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < 100; i++) {
+            assert(cpu_topology_check(&topology) == 0);
+            cpu_topology_update_frequency(&topology);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("  %d packages, %d cores, %d CPUs, %d nodes, %d caches, %.1f us per check\n",
+               topology.package_count, topology.core_count, topology.online_count,
+               topology.node_count, topology.cache_count, elapsed_us(&start, &end) / 100);
+        cpu_topology_free(&topology);
+    }
+
+    system("rm -rf " TEST_SYSFS);
+    unlink(TEST_STAT);
+    printf("CPU topology test passed!\n");
+}
+
+// 在 TEST_PROC 下写入一个进程的 stat
+static void write_proc_stat(int pid, const char *comm, char state, int threads, unsigned long long utime) {
+    char path[256], content[512];
+
+    snprintf(path, sizeof(path), "mkdir -p %s/%d", TEST_PROC, pid);
+    assert(system(path) == 0);
+    snprintf(path, sizeof(path), "%s/%d/stat", TEST_PROC, pid);
+    snprintf(content, sizeof(content),
+             "%d (%s) %c 1 %d %d 0 -1 4194560 120 0 0 0 %llu %llu 0 0 20 0 %d 0 %llu 12345678 %d "
+             "18446744073709551615 1 1 0 0 0 0 0 0 0 0 0 0 17 0 0 0 0 0 0\n",
+             pid, comm, state, pid, pid, utime, utime / 2, threads, 1000ULL + (unsigned long long)pid, pid * 10);
+    write_file(path, content);
+}
+
+// 进程扫描：特殊的 comm、非进程目录、消失的进程、分片解析与真实的 /proc
+void test_proc_scanner(void) {
+    printf("Testing process scanner...\n");
+
+    ProcStat stat;
+    const char *line = "42 (a) b) (c) Z 7 42 42 0 -1 4194560 1 0 0 0 15 25 0 0 20 0 3 0 9876 1000 -1 0\n";
+    assert(proc_scanner_parse_stat(line, strlen(line), &stat) == SWK_SUCCESS);
+    assert(stat.pid == 42 && strcmp(stat.comm, "a) b) (c") == 0 && stat.state == 'Z');
+    assert(stat.ppid == 7 && stat.utime == 15 && stat.stime == 25);
+    assert(stat.threads == 3 && stat.start_time == 9876 && stat.rss == 0);
+    assert(proc_scanner_parse_stat("42 (x) S 1 2 3", 14, &stat) != SWK_SUCCESS);
+    assert(proc_scanner_parse_stat("42 x S 1", 8, &stat) != SWK_SUCCESS);
+
+    system("rm -rf " TEST_PROC);
+    write_proc_stat(1, "init", 'S', 1, 100);
+    write_proc_stat(42, "my (odd) name", 'R', 4, 200);
+    write_proc_stat(100, "defunct", 'Z', 0, 0);
+    assert(system("mkdir -p " TEST_PROC "/7 " TEST_PROC "/self " TEST_PROC "/12ab") == 0);
+    write_file(TEST_PROC "/uptime", "1.0 1.0\n");
+
+    ProcScanner scanner;
+    assert(proc_scanner_open(&scanner, TEST_PROC, 1) == SWK_SUCCESS);
+    assert(proc_scanner_scan(&scanner) == SWK_SUCCESS);
+    assert(scanner.process_count == 3 && scanner.count == 3);
+    assert(scanner.thread_count == 5 && scanner.zombie_count == 1 && scanner.running_count == 1);
+    for (int i = 0; i < scanner.count; i++) {
+        if (scanner.procs[i].pid == 42) {
+            assert(strcmp(scanner.procs[i].comm, "my (odd) name") == 0);
+            assert(scanner.procs[i].utime == 200 && scanner.procs[i].rss == 420);
+            assert(scanner.procs[i].start_time == 1042);
+        }
+    }
+
+    // 重复扫描得到同样的结果
+    assert(proc_scanner_scan(&scanner) == SWK_SUCCESS);
+    assert(scanner.process_count == 3 && scanner.scans == 2);
+    proc_scanner_close(&scanner);
+    assert(scanner.fd == -1);
+
+    // 足够多的进程时按线程分片，结果与单线程一致
+    for (int pid = 1000; pid < 1000 + TEST_PROC_COUNT; pid++) {
+        write_proc_stat(pid, "worker", pid % 7 == 0 ? 'Z' : 'S', pid % 5 + 1, (unsigned long long)pid);
+    }
+    int expected_threads = 5, expected_zombies = 1;
+    for (int pid = 1000; pid < 1000 + TEST_PROC_COUNT; pid++) {
+        expected_threads += pid % 5 + 1;
+        expected_zombies += pid % 7 == 0;
+    }
+    for (int threads = 1; threads <= 4; threads += 3) {
+        assert(proc_scanner_open(&scanner, TEST_PROC, threads) == SWK_SUCCESS);
+        assert(proc_scanner_scan(&scanner) == SWK_SUCCESS);
+        assert(scanner.process_count == TEST_PROC_COUNT + 3);
+        assert(scanner.thread_count == expected_threads && scanner.zombie_count == expected_zombies);
+        proc_scanner_close(&scanner);
+    }
+
+    // 真实的 /proc：包含当前进程
+    if (proc_scanner_open(&scanner, NULL, 4) == SWK_SUCCESS) {
+        struct timespec start, end;
+        int found = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 0; i < 20; i++) {
+            assert(proc_scanner_scan(&scanner) == SWK_SUCCESS);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        for (int i = 0; i < scanner.count; i++) {
+            if (scanner.procs[i].pid == getpid()) {
+                found = 1;
+                assert(scanner.procs[i].state == 'R' && scanner.procs[i].threads >= 1);
+            }
+        }
+        assert(found && scanner.thread_count >= scanner.process_count);
+        printf("  %d processes, %d threads, %.1f us per scan\n",
+               scanner.process_count, scanner.thread_count, elapsed_us(&start, &end) / 20);
+        proc_scanner_close(&scanner);
+    }
+
+    system("rm -rf " TEST_PROC);
+    printf("Process scanner test passed!\n");
+}
+
+// 进程表：随机插入删除与数组对照，跨越扩容
+void test_proc_table(void) {
+    printf("Testing process table...\n");
+
+    ProcTable table;
+    static uint8_t present[200000];
+    int count = 0;
+
+    memset(present, 0, sizeof(present));
+    assert(proc_table_init(&table, 0) == SWK_SUCCESS);
+    assert(table.mask + 1 == PROC_TABLE_MIN);
+    srand(12345);
+    for (int i = 0; i < 400000; i++) {
+        int pid = 1 + rand() % 199999;
+        int created;
+        if (rand() % 3 != 0) {
+            ProcEntry *entry = proc_table_insert(&table, pid, &created);
+            assert(entry && entry->pid == pid && created == !present[pid]);
+            entry->threads = pid % 9;
+            count += created;
+            present[pid] = 1;
+        } else {
+            assert(proc_table_remove(&table, pid) == present[pid]);
+            count -= present[pid];
+            present[pid] = 0;
+        }
+    }
+    assert(table.count == count && table.mask + 1 > PROC_TABLE_MIN);
+    for (int pid = 1; pid < 200000; pid++) {
+        const ProcEntry *entry = proc_table_find(&table, pid);
+        assert((entry != NULL) == present[pid]);
+        assert(!entry || entry->threads == pid % 9);
+    }
+    assert(proc_table_find(&table, 0) == NULL && proc_table_insert(&table, -1, NULL) == NULL);
+    proc_table_clear(&table);
+    assert(table.count == 0 && proc_table_find(&table, 1) == NULL);
+    proc_table_free(&table);
+    printf("Process table test passed!\n");
+}
+
+// 进程事件：事件增量维护进程表，僵尸回收检查，定期与溢出后重新扫描
+void test_proc_events(void) {
+    printf("Testing process events...\n");
+
+    system("rm -rf " TEST_PROC);
+    write_proc_stat(1, "init", 'S', 1, 100);
+    write_proc_stat(42, "daemon", 'S', 4, 200);
+
+    ProcScanner scanner;
+    ProcEvents events;
+    memset(&events, 0, sizeof(events));
+    events.fd = -1;
+    assert(proc_scanner_open(&scanner, TEST_PROC, 1) == SWK_SUCCESS);
+    assert(proc_events_sync(&events, &scanner) == SWK_SUCCESS);
+    assert(events.process_count == 2 && events.thread_count == 5 && events.zombie_count == 0);
+
+    // 新进程、新线程、exec、线程退出
+    proc_events_apply(&events, PROC_EVENTS_FORK, 500, 500, 42);
+    proc_events_apply(&events, PROC_EVENTS_FORK, 501, 500, 500);
+    proc_events_apply(&events, PROC_EVENTS_EXEC, 500, 500, 0);
+    proc_events_apply(&events, PROC_EVENTS_FORK, 43, 42, 42);
+    proc_events_apply(&events, PROC_EVENTS_EXIT, 43, 42, 0);
+    assert(events.process_count == 3 && events.thread_count == 7);
+    assert(proc_table_find(&events.table, 500)->ppid == 42);
+    assert(proc_table_find(&events.table, 500)->threads == 2);
+    assert(events.forks == 1 && events.execs == 1 && events.exits == 0);
+
+    // 两次采集之间出现又退出的短命进程
+    proc_events_apply(&events, PROC_EVENTS_FORK, 600, 600, 1);
+    proc_events_apply(&events, PROC_EVENTS_EXIT, 600, 600, 0);
+    proc_events_apply(&events, PROC_EVENTS_EXIT, 500, 500, 0);
+    assert(events.exits == 2 && events.zombie_count == 2 && events.process_count == 4);
+    assert(events.thread_count == 5);
+
+    // 600 在 /proc 中不存在（已回收），500 作为僵尸还在
+    write_proc_stat(500, "child", 'Z', 0, 0);
+    assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+    assert(events.zombie_count == 1 && events.process_count == 3);
+    assert(proc_table_find(&events.table, 600) == NULL);
+    assert(proc_table_find(&events.table, 500)->state == 'Z');
+
+    // PID 复用：旧的僵尸被替换
+    proc_events_apply(&events, PROC_EVENTS_FORK, 500, 500, 1);
+    assert(events.zombie_count == 0 && events.process_count == 3 && events.thread_count == 6);
+
+    // 丢失事件后重新扫描，以 /proc 为准
+    events.resync = 1;
+    assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+    assert(events.resync == 0 && events.process_count == 3);
+    assert(events.thread_count == 5 && events.zombie_count == 1);
+
+    // 每 PROC_EVENTS_RESYNC 次采集完整扫描一次
+    write_proc_stat(700, "late", 'S', 1, 0);
+    for (int i = 1; i < PROC_EVENTS_RESYNC; i++) {
+        assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+    }
+    assert(events.process_count == 3);
+    assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+    assert(events.process_count == 4 && events.polls == 0);
+    proc_events_close(&events);
+    proc_scanner_close(&scanner);
+    assert(events.fd == -1 && events.table.slots == NULL);
+
+    // 真实的进程连接器：需要 CAP_NET_ADMIN，没有权限时打开失败并由调用方轮询
+    int result = proc_events_open(&events);
+    if (result == SWK_SUCCESS) {
+        assert(proc_scanner_open(&scanner, NULL, 1) == SWK_SUCCESS);
+        assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+        uint64_t forks = events.forks, exits = events.exits;
+        for (int i = 0; i < 5; i++) {
+            pid_t child = fork();
+            if (child == 0) {
+                _exit(0);
+            }
+            assert(child > 0 && waitpid(child, NULL, 0) == child);
+        }
+        usleep(10000);
+        assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+        assert(events.forks >= forks + 5 && events.exits >= exits + 5);
+
+        // 其他进程发来的伪造事件被丢弃
+        struct sockaddr_nl local, target;
+        socklen_t local_length = sizeof(local);
+        assert(getsockname(events.fd, (struct sockaddr *)&local, &local_length) == 0);
+        memset(&target, 0, sizeof(target));
+        target.nl_family = AF_NETLINK;
+        target.nl_pid = local.nl_pid;
+
+        char forged[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(struct proc_event))];
+        struct nlmsghdr *header = (struct nlmsghdr *)forged;
+        struct cn_msg *message = NLMSG_DATA(header);
+        struct proc_event fork_event;
+        memset(forged, 0, sizeof(forged));
+        memset(&fork_event, 0, sizeof(fork_event));
+        header->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(fork_event));
+        header->nlmsg_type = NLMSG_DONE;
+        message->id.idx = CN_IDX_PROC;
+        message->id.val = CN_VAL_PROC;
+        message->len = sizeof(fork_event);
+        fork_event.what = PROC_EVENT_FORK;
+        fork_event.event_data.fork.parent_pid = fork_event.event_data.fork.parent_tgid = 1;
+        fork_event.event_data.fork.child_pid = fork_event.event_data.fork.child_tgid = 4000000;
+        memcpy(message->data, &fork_event, sizeof(fork_event));
+
+        int sender = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+        assert(sender >= 0);
+        int sent = 0;
+        for (int i = 0; i < 100; i++) {
+            sent += sendto(sender, forged, header->nlmsg_len, 0, (struct sockaddr *)&target,
+                           sizeof(target)) == (ssize_t)header->nlmsg_len;
+        }
+        close(sender);
+        forks = events.forks;
+        assert(proc_events_poll(&events, &scanner) == SWK_SUCCESS);
+        assert(sent == 0 || events.forks < forks + 100);
+        printf("  process connector: %llu forks, %d processes, %d zombies, %d forged messages dropped\n",
+               (unsigned long long)events.forks, events.process_count, events.zombie_count, sent);
+        proc_scanner_close(&scanner);
+        proc_events_close(&events);
+    } else {
+        assert(events.fd == -1);
+        printf("  process connector unavailable (%d), polling /proc\n", result);
+    }
+
+    system("rm -rf " TEST_PROC);
+    printf("Process events test passed!\n");
+}
+
+static int compare_double_desc(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+// 进程排行：差值、PID 复用、消失的进程、I/O 与大量进程时的堆选择
+void test_proc_top(void) {
+    printf("Testing process ranking...\n");
+
+    ProcStat stat;
+    const char *io = "rchar: 100\nwchar: 200\nsyscr: 1\nsyscw: 2\nread_bytes: 4096\n"
+                     "write_bytes: 8192\ncancelled_write_bytes: 0\n";
+    assert(proc_scanner_parse_io(io, strlen(io), &stat) == SWK_SUCCESS);
+    assert(stat.has_io && stat.read_bytes == 4096 && stat.write_bytes == 8192);
+    assert(proc_scanner_parse_io("rchar: 1\n", 9, &stat) != SWK_SUCCESS && !stat.has_io);
+
+    // 通过文件：scanner 读取 io
+    system("rm -rf " TEST_PROC);
+    write_proc_stat(1, "init", 'S', 1, 100);
+    write_proc_stat(42, "reader", 'R', 2, 1000);
+    write_file(TEST_PROC "/42/io", io);
+    ProcScanner scanner;
+    assert(proc_scanner_open(&scanner, TEST_PROC, 1) == SWK_SUCCESS);
+    scanner.read_io = 1;
+    assert(proc_scanner_scan(&scanner) == SWK_SUCCESS);
+    for (int i = 0; i < scanner.count; i++) {
+        assert(scanner.procs[i].has_io == (scanner.procs[i].pid == 42));
+    }
+    proc_scanner_close(&scanner);
+    system("rm -rf " TEST_PROC);
+
+    // 直接构造扫描结果
+    ProcTop top;
+    ProcStat procs[4];
+    memset(&scanner, 0, sizeof(scanner));
+    scanner.procs = procs;
+    assert(proc_top_init(&top) == SWK_SUCCESS);
+
+    memset(procs, 0, sizeof(procs));
+    for (int i = 0; i < 3; i++) {
+        procs[i].pid = 10 + i;
+        procs[i].start_time = 500;
+        procs[i].utime = 1000;
+        procs[i].rss = (uint64_t)(i + 1) * 256;
+        procs[i].has_io = 1;
+        procs[i].read_bytes = 1 << 20;
+        snprintf(procs[i].comm, sizeof(procs[i].comm), "p%d", i);
+    }
+    scanner.count = 3;
+    assert(proc_top_update(&top, &scanner, 100.0) == SWK_SUCCESS);
+    assert(top.table.count == 3 && top.interval == 0.0);
+    assert(proc_table_find(&top.table, 10)->cpu == 0.0);
+
+    // 2 秒后：10 用了 1 秒 CPU，11 读了 2MB；12 退出，PID 11 没有被复用，13 是新进程
+    procs[0].utime += (uint64_t)top.ticks / 2;
+    procs[0].stime += (uint64_t)top.ticks / 2;
+    procs[1].read_bytes += 2 << 20;
+    procs[2].pid = 13;
+    procs[2].utime = (uint64_t)top.ticks;
+    procs[2].start_time = 700;
+    procs[2].has_io = 0;
+    assert(proc_top_update(&top, &scanner, 102.0) == SWK_SUCCESS);
+    assert(top.table.count == 3 && proc_table_find(&top.table, 12) == NULL);
+    assert(near(top.interval, 2.0));
+    assert(near(proc_table_find(&top.table, 10)->cpu, 50.0));
+    assert(near(proc_table_find(&top.table, 11)->read_rate, 1 << 20));
+    assert(near(proc_table_find(&top.table, 13)->cpu, 50.0));
+
+    const ProcEntry *entries[PROC_TOP_MAX];
+    assert(proc_top_select(&top, PROC_TOP_IO, entries, 5) == 1 && entries[0]->pid == 11);
+    assert(proc_top_select(&top, PROC_TOP_RSS, entries, 2) == 2);
+    assert(entries[0]->pid == 13 && entries[1]->pid == 11);
+    assert(entries[0]->rss_kb == 768 * (uint64_t)top.page_kb);
+    assert(strcmp(entries[0]->comm, "p2") == 0);
+
+    // PID 11 被新进程复用：不与旧进程的累计值相减
+    procs[1].start_time = 900;
+    procs[1].read_bytes = 0;
+    procs[1].utime = 0;
+    assert(proc_top_update(&top, &scanner, 104.0) == SWK_SUCCESS);
+    assert(proc_table_find(&top.table, 11)->start_time == 900);
+    assert(proc_table_find(&top.table, 11)->read_rate == 0.0);
+    assert(proc_table_find(&top.table, 10)->cpu == 0.0);
+    proc_top_free(&top);
+
+    // 10 万个进程：堆选出的前 20 与完整排序一致
+    int count = 100000;
+    ProcStat *many = calloc((size_t)count, sizeof(ProcStat));
+    double *expected = malloc((size_t)count * sizeof(double));
+    assert(many && expected);
+    for (int i = 0; i < count; i++) {
+        many[i].pid = i + 1;
+        many[i].start_time = 1;
+    }
+    scanner.procs = many;
+    scanner.count = count;
+    assert(proc_top_init(&top) == SWK_SUCCESS);
+    assert(proc_top_update(&top, &scanner, 0.0) == SWK_SUCCESS);
+    srand(7);
+    for (int i = 0; i < count; i++) {
+        many[i].utime = (uint64_t)(rand() % 100000);
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    assert(proc_top_update(&top, &scanner, 1.0) == SWK_SUCCESS);
+    int selected = proc_top_select(&top, PROC_TOP_CPU, entries, 20);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int i = 0; i < count; i++) {
+        expected[i] = (double)many[i].utime * 100.0 / (double)top.ticks;
+    }
+    qsort(expected, (size_t)count, sizeof(double), compare_double_desc);
+    assert(selected == 20);
+    for (int i = 0; i < selected; i++) {
+        assert(near(entries[i]->cpu, expected[i]));
+    }
+    printf("  %d processes: update + top 20 in %.1f ms\n", count, elapsed_us(&start, &end) / 1000);
+    proc_top_free(&top);
+    free(many);
+    free(expected);
+
+    printf("Process ranking test passed!\n");
+}
+
+// 在 TEST_NET 下写入一个接口的全部计数：rx_bytes 为 base，其余依次递增
+static void write_net_interface(const char *name, int type, uint64_t base) {
+    static const char *counters[] = {
+        "rx_bytes", "tx_bytes", "rx_packets", "tx_packets", "rx_dropped", "tx_dropped", "rx_errors", "tx_errors",
+    };
+    char path[256], content[32];
+
+    snprintf(path, sizeof(path), "mkdir -p %s/%s/statistics", TEST_NET, name);
+    assert(system(path) == 0);
+    snprintf(path, sizeof(path), "%s/%s/type", TEST_NET, name);
+    snprintf(content, sizeof(content), "%d\n", type);
+    write_file(path, content);
+    for (int i = 0; i < 8; i++) {
+        snprintf(path, sizeof(path), "%s/%s/statistics/%s", TEST_NET, name, counters[i]);
+        snprintf(content, sizeof(content), "%llu\n", (unsigned long long)(base * (uint64_t)(i + 1)));
+        write_file(path, content);
+    }
+}
+
+// 网络接口：所有接口的速率、默认路由选出主接口、接口消失与新增、计数重置
+void test_net_sampler(void) {
+    printf("Testing network sampler...\n");
+
+    system("rm -rf " TEST_NET);
+    write_net_interface("lo", 772, 1000);
+    write_net_interface("eth1", 1, 1000000);
+    write_net_interface("wlan0", 1, 5000);
+    write_file(TEST_ROUTE,
+               "Iface\tDestination\tGateway \tFlags\tRefCnt\tUse\tMetric\tMask\t\tMTU\tWindow\tIRTT\n"
+               "wlan0\t00000000\t0101A8C0\t0003\t0\t0\t600\t00000000\t0\t0\t0\n"
+               "eth1\t00000000\t010010AC\t0003\t0\t0\t100\t00000000\t0\t0\t0\n"
+               "eth1\t000010AC\t00000000\t0001\t0\t0\t100\t0000FFFF\t0\t0\t0\n");
+
+    NetSampler sampler;
+    assert(net_sampler_open(&sampler, TEST_NET, TEST_ROUTE) == SWK_SUCCESS);
+    assert(sampler.count == 3);
+    assert(strcmp(sampler.interfaces[0].name, "eth1") == 0 && strcmp(sampler.interfaces[1].name, "lo") == 0);
+    assert(sampler.interfaces[1].loopback && !sampler.interfaces[0].loopback);
+    assert(strcmp(net_sampler_primary(&sampler)->name, "eth1") == 0);
+
+    assert(net_sampler_sample(&sampler, 10.0) == SWK_SUCCESS);
+    assert(sampler.interfaces[0].counters[NET_RX_BYTES] == 1000000);
+    assert(sampler.interfaces[0].counters[NET_TX_ERRORS] == 8000000);
+    assert(sampler.interfaces[0].rates[NET_RX_BYTES] == 0.0);
+
+    // 2 秒后每个计数增加 base * (i + 1)
+    write_net_interface("eth1", 1, 2000000);
+    write_net_interface("wlan0", 1, 10000);
+    assert(net_sampler_sample(&sampler, 12.0) == SWK_SUCCESS);
+    const NetInterface *eth1 = net_sampler_find(&sampler, "eth1");
+    assert(near(eth1->rates[NET_RX_BYTES], 500000.0) && near(eth1->rates[NET_TX_BYTES], 1000000.0));
+    assert(near(eth1->rates[NET_RX_DROPPED], 2500000.0));
+    assert(near(net_sampler_find(&sampler, "wlan0")->rates[NET_RX_PACKETS], 7500.0));
+    assert(net_sampler_find(&sampler, "lo")->rates[NET_RX_BYTES] == 0.0);
+
+    // wlan0 被删除（计数读不到），eth1 的计数被重置；下一次采样重新枚举
+    write_file(TEST_NET "/wlan0/statistics/rx_bytes", "");
+    system("rm -rf " TEST_NET "/wlan0");
+    write_net_interface("eth1", 1, 10);
+    int eth1_fd = net_sampler_find(&sampler, "eth1")->fds[NET_RX_BYTES];
+    assert(net_sampler_sample(&sampler, 14.0) == SWK_SUCCESS);
+    assert(sampler.rescan && net_sampler_find(&sampler, "wlan0")->reopen);
+    assert(!net_sampler_find(&sampler, "eth1")->reopen && net_sampler_find(&sampler, "eth1")->rates[NET_RX_BYTES] == 0.0);
+    write_net_interface("eth1", 1, 20);
+    write_net_interface("veth0", 1, 1);
+    assert(net_sampler_sample(&sampler, 16.0) == SWK_SUCCESS);
+    assert(sampler.count == 3 && net_sampler_find(&sampler, "wlan0") == NULL);
+    assert(net_sampler_find(&sampler, "veth0")->rates[NET_RX_BYTES] == 0.0);
+    assert(near(net_sampler_find(&sampler, "eth1")->rates[NET_RX_BYTES], 5.0));
+    assert(net_sampler_find(&sampler, "eth1")->fds[NET_RX_BYTES] == eth1_fd);  // 只有失败的接口重新打开
+    assert(strcmp(net_sampler_primary(&sampler)->name, "eth1") == 0);
+
+    // 没有默认路由时取第一个不是 lo 的接口
+    write_file(TEST_ROUTE, "Iface\tDestination\tGateway \tFlags\tRefCnt\tUse\tMetric\tMask\t\tMTU\tWindow\tIRTT\n");
+    sampler.rescan = 1;
+    assert(net_sampler_sample(&sampler, 18.0) == SWK_SUCCESS);
+    assert(strcmp(net_sampler_primary(&sampler)->name, "eth1") == 0);
+    net_sampler_close(&sampler);
+    assert(sampler.count == 0 && sampler.primary == -1);
+
+    // 真实的 /sys/class/net
+    if (net_sampler_open(&sampler, NULL, NULL) == SWK_SUCCESS) {
+        struct timespec start, end;
+        assert(net_sampler_sample(&sampler, 0.0) == SWK_SUCCESS);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 1; i <= 100; i++) {
+            assert(net_sampler_sample(&sampler, (double)i) == SWK_SUCCESS);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        assert(sampler.count > 0 && net_sampler_find(&sampler, "lo") != NULL);
+        printf("  %d interfaces, primary %s, %.1f us per sample\n", sampler.count,
+               net_sampler_primary(&sampler) ? net_sampler_primary(&sampler)->name : "-",
+               elapsed_us(&start, &end) / 100);
+        net_sampler_close(&sampler);
+    }
+
+    system("rm -rf " TEST_NET);
+    unlink(TEST_ROUTE);
+    printf("Network sampler test passed!\n");
+}
+
+// sda 的每个累计计数乘以 scale；sdb 是旧内核的 4 字段格式
+static void write_diskstats(uint64_t scale, int with_nvme) {
+    char buf[1024];
+
+    snprintf(buf, sizeof(buf),
+             "   8       0 sda %llu 0 %llu %llu %llu 0 %llu %llu 1 %llu %llu 0 0 0 0\n"
+             "   8       1 sda1 %llu 0 %llu %llu %llu 0 %llu %llu 0 %llu %llu\n"
+             "   8      16 sdb 5 10 15 20\n"
+             "   7       0 loop0 0 0 0 0 0 0 0 0 0 0 0\n"
+             "%s",
+             (unsigned long long)(100 * scale), (unsigned long long)(800 * scale),
+             (unsigned long long)(scale * scale * 50), (unsigned long long)(200 * scale),
+             (unsigned long long)(1600 * scale), (unsigned long long)(scale * scale * 100),
+             (unsigned long long)(500 * scale - 200), (unsigned long long)(1500 * scale - 500),
+             (unsigned long long)(100 * scale), (unsigned long long)(800 * scale),
+             (unsigned long long)(scale * scale * 50), (unsigned long long)(200 * scale),
+             (unsigned long long)(1600 * scale), (unsigned long long)(scale * scale * 100),
+             (unsigned long long)(500 * scale - 200), (unsigned long long)(1500 * scale - 500),
+             with_nvme ? " 259       0 nvme0n1 1 0 8 1 0 0 0 0 0 1 1\n" : "");
+    write_file(TEST_DISK "/diskstats", buf);
+}
+
+void test_disk_sampler(void) {
+    printf("Testing disk sampler...\n");
+
+    system("rm -rf " TEST_DISK);
+    system("mkdir -p " TEST_DISK "/devices/sda/sda1 " TEST_DISK "/devices/sdb " TEST_DISK "/devices/loop0 "
+           TEST_DISK "/devices/nvme0n1 " TEST_DISK "/block");
+    write_file(TEST_DISK "/devices/sda/sda1/partition", "1\n");
+    assert(symlink("../devices/sda", TEST_DISK "/block/sda") == 0);
+    assert(symlink("../devices/sda/sda1", TEST_DISK "/block/sda1") == 0);
+    assert(symlink("../devices/sdb", TEST_DISK "/block/sdb") == 0);
+    assert(symlink("../devices/loop0", TEST_DISK "/block/loop0") == 0);
+    assert(symlink("../devices/nvme0n1", TEST_DISK "/block/nvme0n1") == 0);
+    write_file(TEST_DISK "/mountinfo",
+               "22 1 8:1 / / rw,relatime shared:1 - ext4 /dev/sda1 rw\n"
+               "23 22 8:16 / /mnt/my\\040data rw - xfs /dev/sdb rw\n"
+               "24 22 0:5 / /proc rw - proc proc rw\n"
+               "25 22 8:1 /home /home rw - ext4 /dev/sda1 rw\n");
+    write_diskstats(1, 0);
+
+    DiskSampler sampler;
+    assert(disk_sampler_open(&sampler, TEST_DISK "/diskstats", TEST_DISK "/block", TEST_DISK "/mountinfo") == SWK_SUCCESS);
+    assert(disk_sampler_sample(&sampler, 10.0) == SWK_SUCCESS);
+    assert(sampler.count == 4 && sampler.interval == 0.0);
+
+    const DiskDevice *sda = disk_sampler_find(&sampler, "sda");
+    const DiskDevice *sda1 = disk_sampler_find_dev(&sampler, 8, 1);
+    const DiskDevice *sdb = disk_sampler_find(&sampler, "sdb");
+    assert(sda && !sda->partition && sda->parent == -1 && sda->mount[0] == '\0');
+    assert(sda1 && sda1->partition && sda1->parent == 0 && strcmp(sda1->mount, "/") == 0);
+    assert(strcmp(disk_sampler_mount(&sampler, sda), "/") == 0);
+    assert(strcmp(sdb->mount, "/mnt/my data") == 0 && !sdb->partition);
+    assert(sdb->counters.reads == 5 && sdb->counters.read_ms == 20 && sdb->counters.io_ms == 0);
+    assert(sda->counters.weighted_ms == 1000 && sda->counters.in_flight == 1);
+    assert(strcmp(disk_sampler_mount(&sampler, disk_sampler_find(&sampler, "loop0")), "") == 0);
+
+    // 2 秒后：读 +200 次 +1600 扇区 +400ms，写 +400 次 +3200 扇区 +800ms，io_ticks +1000ms，排队 +3000ms
+    write_diskstats(3, 0);
+    assert(disk_sampler_sample(&sampler, 12.0) == SWK_SUCCESS);
+    sda = disk_sampler_find(&sampler, "sda");
+    assert(near(sampler.interval, 2.0));
+    assert(near(sda->rates.read_iops, 100.0) && near(sda->rates.write_iops, 200.0));
+    assert(near(sda->rates.read_rate, 1600.0 * 512 / 2) && near(sda->rates.write_rate, 3200.0 * 512 / 2));
+    assert(near(sda->rates.read_latency, 400.0 / 200) && near(sda->rates.write_latency, 800.0 / 400));
+    assert(near(sda->rates.latency, 1200.0 / 600));
+    assert(near(sda->rates.utilization, 50.0) && near(sda->rates.queue_depth, 1.5));
+    assert(near(disk_sampler_find(&sampler, "sda1")->rates.read_iops, 100.0));
+    assert(disk_sampler_find(&sampler, "sdb")->rates.read_iops == 0.0);
+
+    // 新设备出现，sda 的计数被重置：新设备只建立基准，重置的差值记为 0
+    write_diskstats(1, 1);
+    assert(disk_sampler_sample(&sampler, 14.0) == SWK_SUCCESS);
+    assert(sampler.count == 5);
+    const DiskDevice *nvme = disk_sampler_find(&sampler, "nvme0n1");
+    assert(nvme && nvme->major == 259 && !nvme->partition && nvme->rates.read_iops == 0.0);
+    sda = disk_sampler_find(&sampler, "sda");
+    assert(sda->rates.read_iops == 0.0 && sda->rates.utilization == 0.0);
+    assert(disk_sampler_find(&sampler, "sda1")->parent == (int)(sda - sampler.devices));
+    disk_sampler_close(&sampler);
+    assert(sampler.count == 0 && sampler.fd == -1);
+
+    // 真实的 /proc/diskstats
+    if (disk_sampler_open(&sampler, NULL, NULL, NULL) == SWK_SUCCESS) {
+        struct timespec start, end;
+        assert(disk_sampler_sample(&sampler, 0.0) == SWK_SUCCESS);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int i = 1; i <= 100; i++) {
+            assert(disk_sampler_sample(&sampler, (double)i) == SWK_SUCCESS);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        for (int i = 0; i < sampler.count; i++) {
+            assert(sampler.devices[i].rates.utilization >= 0.0 && sampler.devices[i].rates.utilization <= 100.0);
+        }
+        printf("  %d block devices, %.1f us per sample\n", sampler.count, elapsed_us(&start, &end) / 100);
+        disk_sampler_close(&sampler);
+    }
+
+    system("rm -rf " TEST_DISK);
+    printf("Disk sampler test passed!\n");
+}
+
+int main(void) {
+    printf("Starting SwiKernel system monitor tests...\n\n");
+
+    test_cpu_sampler();
+    test_cpu_topology();
+    test_proc_scanner();
+    test_proc_table();
+    test_proc_events();
+    test_proc_top();
+    test_net_sampler();
+    test_disk_sampler();
+
+    printf("\nAll system monitor tests passed! ✓\n");
+    return 0;
+}
@@ -0,0 +1,203 @@
+// tools/logdump.c
+// swikernel-logdump：把二进制日志还原为文本
+//
+// 输出与文本模式完全一致的 "[YYYY-MM-DD HH:MM:SS.mmm] [LEVEL] msg" 行。
+// 可以一次传入多个文件（例如按轮转顺序 swikernel.log.2 swikernel.log.1 swikernel.log），
+// 不给文件或文件名为 "-" 时从标准输入读取。
+//
+// 用法: swikernel-logdump [-l level] [-c] [file ...]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/common_defs.h"
+#include "../include/utils/log_binary.h"
+
+#define READ_CHUNK (64 * 1024)
+
+typedef struct {
+    LogLevel min_level;
+    int count_only;
+    uint64_t events;
+} DumpOptions;
+
+static int parse_level(const char *name, LogLevel *level) {
+    static const char *const names[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+    for (int i = 0; i <= LOG_FATAL; i++) {
+        if (strcasecmp(name, names[i]) == 0) {
+            *level = (LogLevel)i;
+            return 0;
+        }
+    }
+    if (strcasecmp(name, "WARNING") == 0) {
+        *level = LOG_WARNING;
+        return 0;
+    }
+    return -1;
+}
+
+// 解码一个文件描述符中的全部记录
+static int dump_fd(int fd, const char *name, LogBinaryDecoder *decoder, DumpOptions *options) {
+    size_t capacity = READ_CHUNK * 2;
+    uint8_t *buffer = malloc(capacity);
+    size_t start = 0, end = 0;
+    uint64_t offset = 0;
+    char line[LOG_BINARY_RECORD_MAX + 64];
+    int result = 0;
+
+    if (!buffer) {
+        fprintf(stderr, "swikernel-logdump: out of memory\n");
+        return -1;
+    }
+
+    for (;;) {
+        // 把未解码完的尾部移到缓冲区开头，再读入新数据
+        if (start > 0) {
+            memmove(buffer, buffer + start, end - start);
+            end -= start;
+            start = 0;
+        }
+
+        ssize_t n = read(fd, buffer + end, capacity - end);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "swikernel-logdump: %s: %s\n", name, strerror(errno));
+            result = -1;
+            break;
+        }
+        end += (size_t)n;
+
+        if (offset == 0 && end >= LOG_BINARY_MAGIC_SIZE && !log_binary_check_magic(buffer, end)) {
+            fprintf(stderr, "swikernel-logdump: %s: not a binary log\n", name);
+            result = -1;
+            break;
+        }
+
+        for (;;) {
+            LogBinaryEvent event;
+            int has_event;
+            long used = log_binary_decode(decoder, buffer + start, end - start, &event, &has_event);
+
+            if (used == 0 && n > 0) {
+                break;
+            }
+            if (used <= 0) {
+                // 损坏的记录（或文件末尾永远不会完整的候选记录）：跳到下一条完好的记录
+                size_t skip = log_binary_resync(decoder, buffer + start, end - start);
+                if (used == 0 && skip == end - start) {
+                    break;
+                }
+                fprintf(stderr, "swikernel-logdump: %s: skipped %zu corrupt bytes at offset %llu\n",
+                        name, skip, (unsigned long long)offset);
+                result = -1;
+                start += skip;
+                offset += skip;
+                continue;
+            }
+
+            start += (size_t)used;
+            offset += (uint64_t)used;
+
+            if (has_event && event.level >= options->min_level) {
+                options->events++;
+                if (!options->count_only) {
+                    size_t length = log_binary_format_line(&event, line, sizeof(line));
+                    fwrite(line, 1, length, stdout);
+                }
+            }
+        }
+
+        if (n == 0) {
+            if (end > start) {
+                // 写入中途被截断的最后一条记录
+                fprintf(stderr, "swikernel-logdump: %s: %zu trailing bytes ignored\n", name, end - start);
+            }
+            break;
+        }
+    }
+
+    free(buffer);
+    return result;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [-l level] [-c] [file ...]\n"
+            "  -l level  only show records at or above level (DEBUG, INFO, WARN, ERROR, FATAL)\n"
+            "  -c        print the number of matching records instead of the records\n"
+            "  -h        show this help\n"
+            "Reads standard input when no file (or \"-\") is given.\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    DumpOptions options = {LOG_DEBUG, 0, 0};
+    LogBinaryDecoder *decoder;
+    int opt, status = 0;
+
+    while ((opt = getopt(argc, argv, "l:ch")) != -1) {
+        switch (opt) {
+            case 'l':
+                if (parse_level(optarg, &options.min_level) != 0) {
+                    fprintf(stderr, "swikernel-logdump: unknown level: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'c':
+                options.count_only = 1;
+                break;
+            case 'h':
+                usage(argv[0]);
+                return 0;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    // 解码器含 4 KB 消息缓冲区，放在堆上
+    decoder = malloc(sizeof(LogBinaryDecoder));
+    if (!decoder) {
+        return 1;
+    }
+    log_binary_decoder_init(decoder);
+
+    if (optind >= argc) {
+        status = dump_fd(STDIN_FILENO, "<stdin>", decoder, &options) == 0 ? 0 : 1;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        if (strcmp(argv[i], "-") == 0) {
+            if (dump_fd(STDIN_FILENO, "<stdin>", decoder, &options) != 0) {
+                status = 1;
+            }
+            continue;
+        }
+
+        int fd = open(argv[i], O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            fprintf(stderr, "swikernel-logdump: %s: %s\n", argv[i], strerror(errno));
+            status = 1;
+            continue;
+        }
+        if (dump_fd(fd, argv[i], decoder, &options) != 0) {
+            status = 1;
+        }
+        close(fd);
+    }
+
+    if (options.count_only) {
+        printf("%llu\n", (unsigned long long)options.events);
+    }
+
+    log_binary_decoder_free(decoder);
+    free(decoder);
+    return status;
+}